@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <cstdio>
+#include <vector>
 
 #include "itkIndent.h"
 #include "itkObject.h"
@@ -81,6 +82,27 @@ namespace otb
  * GetHeightAboveEllipsoid() method.
  *
  * DEM directory can either contain DTED or SRTM formats.
+ *
+ * Ossim elevation queries are not designed for concurrent accesses.
+ * For multi-threaded callers, an elevation cache can be enabled with
+ * SetElevationCacheSpacing() (or the OTB_DEM_CACHE_SPACING environment
+ * variable). Heights above MSL and above ellipsoid are then sampled
+ * from ossim once, on a regular grid of posts with the given spacing
+ * (in degrees), into immutable tiles. Queries read these tiles without
+ * locking and interpolate bilinearly between posts. Results are
+ * identical to the direct queries at the posts, so choosing the DEM
+ * post spacing (for instance 1/1200 degree for SRTM 3 arc-seconds)
+ * gives the same interpolation as ossim. Tiles of 64x64 posts are
+ * computed on demand and looked up in a table of 512 entries, the
+ * least recently used tile being replaced on a miss. Replaced tiles
+ * stay allocated, since other threads may still read them, until the
+ * cache is cleared: each time the DEM configuration changes, or with
+ * ClearElevationCache(). At most 2048 tiles are allocated, the
+ * elevations outside of the cached tiles being then queried from
+ * ossim directly. As for ossim, the configuration must not be
+ * changed, nor the cache cleared, while other threads query
+ * elevations.
+ *
  * \ingroup Images
  *
  *
@@ -143,6 +165,12 @@ public:
   virtual double GetHeightAboveEllipsoid(double lon, double lat) const;
   virtual double GetHeightAboveEllipsoid(const PointType& geoPoint) const;
 
+  /** Compute the heights above MSL of a set of geographic points. */
+  virtual void GetHeightAboveMSL(const std::vector<PointType>& geoPoints, std::vector<double>& heights) const;
+
+  /** Compute the heights above ellipsoid of a set of geographic points. */
+  virtual void GetHeightAboveEllipsoid(const std::vector<PointType>& geoPoints, std::vector<double>& heights) const;
+
   /** Set the default height above ellipsoid in case no information is available*/
   virtual void SetDefaultHeightAboveEllipsoid(double h);
 
@@ -167,9 +195,20 @@ public:
    */
   void ClearDEMs();
 
+  /** Set the spacing of the elevation cache posts, in degrees. A null
+   *  spacing disables the cache. */
+  void SetElevationCacheSpacing(double spacing);
+
+  /** Get the spacing of the elevation cache posts, in degrees */
+  double GetElevationCacheSpacing() const;
+
+  /** Remove all the cached elevation tiles. Must not be called while
+   *  other threads query elevations. */
+  void ClearElevationCache();
+
 protected:
   DEMHandler();
-  ~DEMHandler() ITK_OVERRIDE {}
+  ~DEMHandler() ITK_OVERRIDE;
 
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
@@ -183,6 +222,12 @@ protected:
 
   static Pointer m_Singleton;
 
+private:
+  class ElevationCache;
+
+  /** Cache of elevation tiles */
+  ElevationCache * m_ElevationCache;
+
 };
 
 } // namespace otb
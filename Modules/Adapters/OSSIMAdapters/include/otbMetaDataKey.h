@@ -67,6 +67,7 @@ namespace MetaDataKey
   extern OTBOSSIMAdapters_EXPORT char const* ResolutionFactor;
   extern OTBOSSIMAdapters_EXPORT char const* SubDatasetIndex;
   extern OTBOSSIMAdapters_EXPORT char const* CacheSizeInBytes;
+  extern OTBOSSIMAdapters_EXPORT char const* NumberOfReadThreads;
 
   extern OTBOSSIMAdapters_EXPORT char const* TileHintX;
   extern OTBOSSIMAdapters_EXPORT char const* TileHintY;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbRPCModelEvaluator_h
+#define otbRPCModelEvaluator_h
+
+#include <cstddef>
+
+#include "OTBOSSIMAdaptersExport.h"
+
+namespace otb
+{
+
+/** \class RPCModelEvaluator
+ *
+ * \brief Batch evaluation of a rational polynomial camera model
+ *
+ * This class evaluates the 20-terms rational polynomials of a RPC model
+ * on arrays of coordinates (structure of arrays layout), without any
+ * virtual call or allocation per point, so that the inner loops can be
+ * vectorized by the compiler.
+ *
+ * GroundToImage() evaluates the model (lon, lat, h) -> (line, sample),
+ * and ImageToGround() inverts it for given heights with a Newton
+ * iteration on each point of the batch.
+ *
+ * Coefficients can be given in the RPC00A or RPC00B terms ordering, and
+ * the image coordinates follow the OSSIM convention (center of the first
+ * pixel at 0). The in-track/cross-track offsets and the map rotation of
+ * the OSSIM adjustable RPC model are supported.
+ *
+ * This class is used by SensorModelAdapter to speed-up the batch
+ * transforms of RPC based sensor models.
+ *
+ * \sa SensorModelAdapter
+ *
+ * \ingroup OTBOSSIMAdapters
+ */
+class OTBOSSIMAdapters_EXPORT RPCModelEvaluator
+{
+public:
+  /** Number of terms of the polynomials */
+  static const unsigned int NumberOfTerms = 20;
+
+  /** Parameters of the model */
+  struct ParametersType
+  {
+    /** Terms ordering: 'A' (RPC00A) or 'B' (RPC00B) */
+    char   Type;
+
+    double LineOffset;
+    double SampleOffset;
+    double LatOffset;
+    double LonOffset;
+    double HeightOffset;
+
+    double LineScale;
+    double SampleScale;
+    double LatScale;
+    double LonScale;
+    double HeightScale;
+
+    double LineNumCoef[NumberOfTerms];
+    double LineDenCoef[NumberOfTerms];
+    double SampleNumCoef[NumberOfTerms];
+    double SampleDenCoef[NumberOfTerms];
+
+    /** Adjustments, in pixels and degrees */
+    double IntrackOffset;
+    double CrtrackOffset;
+    double MapRotation;
+
+    ParametersType();
+  };
+
+  RPCModelEvaluator();
+
+  /** Set the parameters of the model. Coefficients are reordered
+   *  internally so that both types share the same evaluation code. */
+  void SetParameters(const ParametersType & parameters);
+  const ParametersType & GetParameters() const
+  {
+    return m_Parameters;
+  }
+
+  /** Set/Get the convergence threshold of ImageToGround(), in pixels */
+  void SetConvergenceThreshold(double threshold)
+  {
+    m_ConvergenceThreshold = threshold;
+  }
+  double GetConvergenceThreshold() const
+  {
+    return m_ConvergenceThreshold;
+  }
+
+  /** Set/Get the maximum number of Newton iterations of ImageToGround() */
+  void SetMaximumNumberOfIterations(unsigned int nbIterations)
+  {
+    m_MaximumNumberOfIterations = nbIterations;
+  }
+  unsigned int GetMaximumNumberOfIterations() const
+  {
+    return m_MaximumNumberOfIterations;
+  }
+
+  /** Compute the image coordinates of n ground points. Heights are above
+   *  ellipsoid, NaN heights are handled as OSSIM does. */
+  void GroundToImage(const double * lon, const double * lat, const double * h,
+                     std::size_t n, double * line, double * sample) const;
+
+  /** Compute the ground coordinates of n image points at the given
+   *  heights. Points for which the iteration does not converge get the
+   *  last estimate. */
+  void ImageToGround(const double * line, const double * sample, const double * h,
+                     std::size_t n, double * lon, double * lat) const;
+
+private:
+  /** Evaluate the 4 polynomials and their derivatives with respect to
+   *  the normalized latitude and longitude at one normalized point */
+  void EvaluateWithDerivatives(double P, double L, double H,
+                               double & line, double & sample,
+                               double & dLineDP, double & dLineDL,
+                               double & dSampleDP, double & dSampleDL) const;
+
+  /** Parameters as given by the user */
+  ParametersType m_Parameters;
+
+  /** Coefficients in RPC00B order */
+  double m_LineNum[NumberOfTerms];
+  double m_LineDen[NumberOfTerms];
+  double m_SampleNum[NumberOfTerms];
+  double m_SampleDen[NumberOfTerms];
+
+  double m_CosMapRotation;
+  double m_SinMapRotation;
+
+  double       m_ConvergenceThreshold;
+  unsigned int m_MaximumNumberOfIterations;
+};
+
+} // end namespace otb
+
+#endif
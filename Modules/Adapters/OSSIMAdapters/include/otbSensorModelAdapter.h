@@ -21,6 +21,8 @@
 #ifndef otbSensorModelAdapter_h
 #define otbSensorModelAdapter_h
 
+#include <vector>
+
 #include "otbDEMHandler.h"
 
 class ossimProjection;
@@ -30,6 +32,7 @@ namespace otb
 {
 
 class ImageKeywordlist;
+class RPCModelEvaluator;
 
 /**
  * \class SensorModelAdapter
@@ -39,6 +42,15 @@ class ImageKeywordlist;
  * InverseSensorModel and ForwardSensorModel. If you feel that you need to use
  * it directly, think again!
  *
+ * The batch methods (ForwardTransformPoints(), InverseTransformPoints())
+ * process whole arrays of coordinates. When the sensor model is a RPC
+ * model, they use a native RPCModelEvaluator instead of calling OSSIM
+ * for each point. The native evaluator is only enabled if it reproduces
+ * the OSSIM inverse model on a set of control points, otherwise the
+ * batch methods fall back to the OSSIM per point evaluation. Note that
+ * the native forward model iterates until convergence at 1e-6 pixel,
+ * while OSSIM stops at 0.1 pixel.
+ *
  * \sa InverseSensorModel
  * \sa ForwardSensorModel
  * \ingroup Projection
@@ -88,6 +100,35 @@ public:
                              double& x, double& y, double& z) const;
 
 
+  /** Batch forward sensor modelling with elevations (above ellipsoid)
+   *  provided by the user */
+  void ForwardTransformPoints(const std::vector<double>& x,
+                              const std::vector<double>& y,
+                              const std::vector<double>& z,
+                              std::vector<double>& lon,
+                              std::vector<double>& lat,
+                              std::vector<double>& h) const;
+
+  /** Batch inverse sensor modelling with elevations (above ellipsoid)
+   *  provided by the user */
+  void InverseTransformPoints(const std::vector<double>& lon,
+                              const std::vector<double>& lat,
+                              const std::vector<double>& h,
+                              std::vector<double>& x,
+                              std::vector<double>& y,
+                              std::vector<double>& z) const;
+
+  /** Batch inverse sensor modelling with elevations (above ellipsoid)
+   *  from DEMHandler */
+  void InverseTransformPoints(const std::vector<double>& lon,
+                              const std::vector<double>& lat,
+                              std::vector<double>& x,
+                              std::vector<double>& y,
+                              std::vector<double>& z) const;
+
+  /** Return true if the batch methods use the native RPC evaluator */
+  bool UsesNativeRPCEvaluator() const;
+
   /** Add a tie point with elevation (above ellipsoid) provided by the user */
   void AddTiePoint(double x, double y, double z, double lon, double lat);
 
@@ -117,8 +158,15 @@ private:
   SensorModelAdapter(const Self &); //purposely not implemented
   void operator =(const Self&); //purposely not implemented
 
+  /** Build the native RPC evaluator if the sensor model is a RPC model
+   *  that it reproduces, or reset it otherwise */
+  void UpdateRPCEvaluator();
+
   InternalMapProjectionPointer m_SensorModel;
 
+  /** Native evaluator of RPC models (null if not applicable) */
+  RPCModelEvaluator * m_RPCEvaluator;
+
   InternalTiePointsContainerPointer m_TiePoints;
 
   /** Object that read and use DEM */
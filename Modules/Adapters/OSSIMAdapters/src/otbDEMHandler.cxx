@@ -20,8 +20,14 @@
 
 #include "otbDEMHandler.h"
 #include "otbMacro.h"
+#include "otbConfigurationManager.h"
+#include "itkFastMutexLock.h"
+#include "vnl/vnl_math.h"
 
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <vector>
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -50,6 +56,304 @@
 
 namespace otb
 {
+
+namespace
+{
+/** Query ossim elevation manager */
+double ElevManagerHeight(double lon, double lat, bool aboveEllipsoid)
+{
+  ossimGpt ossimWorldPoint;
+
+  ossimWorldPoint.lon = lon;
+  ossimWorldPoint.lat = lat;
+
+  assert( ossimElevManager::instance()!=NULL );
+
+  if (aboveEllipsoid)
+    {
+    return ossimElevManager::instance()->getHeightAboveEllipsoid(ossimWorldPoint);
+    }
+  return ossimElevManager::instance()->getHeightAboveMSL(ossimWorldPoint);
+}
+
+/** Integer division rounding towards minus infinity */
+inline long FloorDivide(long a, long b)
+{
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+}
+
+/** \class DEMHandler::ElevationCache
+ *
+ * Heights sampled from ossim on a regular grid of posts, stored in
+ * immutable tiles. The tiles are referenced by a set-associative table
+ * of atomic raw pointers: lookups neither take the cache mutexes nor
+ * update reference counts. Each set holds a few tiles, the least
+ * recently used one being replaced on a miss. A replaced tile may still
+ * be read by other threads, so it is only deleted when the cache is
+ * cleared or destroyed, which must not happen while elevations are
+ * queried. Once MaximumNumberOfTiles tiles are allocated, the heights
+ * missing from the table are queried from ossim directly. Missing
+ * tiles are computed under a mutex serializing the ossim queries, the
+ * table mutex being only held to publish them.
+ */
+class DEMHandler::ElevationCache
+{
+public:
+  /** Number of post intervals along each side of a tile */
+  static const long TileSize = 64;
+
+  /** Number of sets of the tile table (power of 2) */
+  static const unsigned long NumberOfSets = 128;
+
+  /** Number of tiles in each set of the tile table */
+  static const unsigned long NumberOfWays = 4;
+
+  /** Maximum number of tiles allocated between two Clear() */
+  static const unsigned long MaximumNumberOfTiles = 2048;
+
+  struct Tile
+  {
+    long X;
+    long Y;
+    std::vector<double> HeightAboveMSL;
+    std::vector<double> HeightAboveEllipsoid;
+  };
+
+  ElevationCache() : m_Spacing(0.), m_Clock(0), m_Generation(0)
+  {
+    for (unsigned long i = 0; i < NumberOfSets; ++i)
+      {
+      for (unsigned long w = 0; w < NumberOfWays; ++w)
+        {
+        m_Entries[i][w].TilePointer.store(ITK_NULLPTR, std::memory_order_relaxed);
+        m_Entries[i][w].LastUse.store(0, std::memory_order_relaxed);
+        }
+      }
+  }
+
+  ~ElevationCache()
+  {
+    Clear();
+  }
+
+  void SetSpacing(double spacing)
+  {
+    Clear();
+    m_Spacing = (spacing > 0.) ? spacing : 0.;
+  }
+
+  double GetSpacing() const
+  {
+    return m_Spacing;
+  }
+
+  bool IsEnabled() const
+  {
+    return m_Spacing > 0.;
+  }
+
+  /** Remove and delete all the tiles. No other thread may be querying
+   *  elevations. */
+  void Clear()
+  {
+    m_Mutex.Lock();
+    ++m_Generation;
+    for (unsigned long i = 0; i < NumberOfSets; ++i)
+      {
+      for (unsigned long w = 0; w < NumberOfWays; ++w)
+        {
+        m_Entries[i][w].TilePointer.store(ITK_NULLPTR, std::memory_order_relaxed);
+        m_Entries[i][w].LastUse.store(0, std::memory_order_relaxed);
+        }
+      }
+    for (std::vector<const Tile *>::iterator it = m_Tiles.begin(); it != m_Tiles.end(); ++it)
+      {
+      delete *it;
+      }
+    m_Tiles.clear();
+    m_Mutex.Unlock();
+  }
+
+  /** Bilinear interpolation between the posts surrounding the point */
+  double GetHeight(double lon, double lat, bool aboveEllipsoid)
+  {
+    if (vnl_math_isnan(lon) || vnl_math_isnan(lat))
+      {
+      return QueryHeight(lon, lat, aboveEllipsoid);
+      }
+
+    const double u = lon / m_Spacing;
+    const double v = lat / m_Spacing;
+    const double fu = std::floor(u);
+    const double fv = std::floor(v);
+    const long px = static_cast<long>(fu);
+    const long py = static_cast<long>(fv);
+    const long tx = FloorDivide(px, TileSize);
+    const long ty = FloorDivide(py, TileSize);
+
+    const Tile * tile = GetTile(tx, ty);
+    if (tile == ITK_NULLPTR)
+      {
+      // The cache is full
+      return QueryHeight(lon, lat, aboveEllipsoid);
+      }
+
+    const std::vector<double> & heights = aboveEllipsoid ? tile->HeightAboveEllipsoid : tile->HeightAboveMSL;
+    const double * p = &heights[(py - ty*TileSize)*(TileSize+1) + (px - tx*TileSize)];
+
+    const double h00 = p[0];
+    const double h10 = p[1];
+    const double h01 = p[TileSize+1];
+    const double h11 = p[TileSize+2];
+
+    if (vnl_math_isnan(h00) || vnl_math_isnan(h10) || vnl_math_isnan(h01) || vnl_math_isnan(h11))
+      {
+      // No data around the point: ask ossim directly
+      return QueryHeight(lon, lat, aboveEllipsoid);
+      }
+
+    const double du = u - fu;
+    const double dv = v - fv;
+
+    return (1-dv) * ((1-du) * h00 + du * h10) + dv * ((1-du) * h01 + du * h11);
+  }
+
+private:
+  struct Entry
+  {
+    std::atomic<const Tile *> TilePointer;
+    /** Value of the miss clock when the tile was last used */
+    std::atomic<unsigned long> LastUse;
+  };
+
+  double QueryHeight(double lon, double lat, bool aboveEllipsoid)
+  {
+    m_ElevManagerMutex.Lock();
+    const double height = ElevManagerHeight(lon, lat, aboveEllipsoid);
+    m_ElevManagerMutex.Unlock();
+    return height;
+  }
+
+  /** Look for a tile in a set, and mark it as used */
+  const Tile * FindTile(Entry * set, long x, long y)
+  {
+    for (unsigned long w = 0; w < NumberOfWays; ++w)
+      {
+      const Tile * tile = set[w].TilePointer.load(std::memory_order_acquire);
+      if (tile && tile->X == x && tile->Y == y)
+        {
+        // Only write the entry when the clock moved, to avoid bouncing
+        // its cache line between the reading threads
+        const unsigned long now = m_Clock.load(std::memory_order_relaxed);
+        if (set[w].LastUse.load(std::memory_order_relaxed) != now)
+          {
+          set[w].LastUse.store(now, std::memory_order_relaxed);
+          }
+        return tile;
+        }
+      }
+    return ITK_NULLPTR;
+  }
+
+  const Tile * GetTile(long x, long y)
+  {
+    Entry * set =
+      m_Entries[(static_cast<unsigned long>(x) * 73856093UL ^ static_cast<unsigned long>(y) * 19349663UL) & (NumberOfSets-1)];
+
+    const Tile * tile = FindTile(set, x, y);
+    if (tile)
+      {
+      return tile;
+      }
+
+    m_ElevManagerMutex.Lock();
+    // The tile may have been computed while waiting for ossim
+    tile = FindTile(set, x, y);
+    if (tile)
+      {
+      m_ElevManagerMutex.Unlock();
+      return tile;
+      }
+
+    // Replaced tiles are not deleted, so stop computing tiles once the
+    // memory limit is reached
+    if (m_Tiles.size() >= MaximumNumberOfTiles)
+      {
+      m_ElevManagerMutex.Unlock();
+      return ITK_NULLPTR;
+      }
+
+    const unsigned long generation = m_Generation.load(std::memory_order_acquire);
+
+    Tile * newTile = new Tile;
+    newTile->X = x;
+    newTile->Y = y;
+    newTile->HeightAboveMSL.resize((TileSize+1)*(TileSize+1));
+    newTile->HeightAboveEllipsoid.resize((TileSize+1)*(TileSize+1));
+
+    for (long j = 0; j <= TileSize; ++j)
+      {
+      const double lat = (y*TileSize + j) * m_Spacing;
+      for (long i = 0; i <= TileSize; ++i)
+        {
+        const double lon = (x*TileSize + i) * m_Spacing;
+        newTile->HeightAboveMSL[j*(TileSize+1)+i] = ElevManagerHeight(lon, lat, false);
+        newTile->HeightAboveEllipsoid[j*(TileSize+1)+i] = ElevManagerHeight(lon, lat, true);
+        }
+      }
+    tile = newTile;
+
+    // Publish the tile in place of the least recently used one of its
+    // set, unless the cache was cleared during the computation. The
+    // replaced tile is kept in m_Tiles until the cache is cleared.
+    m_Mutex.Lock();
+    m_Tiles.push_back(tile);
+    if (generation == m_Generation.load(std::memory_order_relaxed))
+      {
+      unsigned long victim = 0;
+      for (unsigned long w = 0; w < NumberOfWays; ++w)
+        {
+        if (set[w].TilePointer.load(std::memory_order_relaxed) == ITK_NULLPTR)
+          {
+          victim = w;
+          break;
+          }
+        if (set[w].LastUse.load(std::memory_order_relaxed) < set[victim].LastUse.load(std::memory_order_relaxed))
+          {
+          victim = w;
+          }
+        }
+      set[victim].LastUse.store(++m_Clock, std::memory_order_relaxed);
+      set[victim].TilePointer.store(tile, std::memory_order_release);
+      }
+    m_Mutex.Unlock();
+    m_ElevManagerMutex.Unlock();
+
+    return tile;
+  }
+
+  double m_Spacing;
+
+  Entry m_Entries[NumberOfSets][NumberOfWays];
+
+  /** All the tiles computed since the last Clear(), including the
+   *  replaced ones */
+  std::vector<const Tile *> m_Tiles;
+
+  /** Number of tiles published, used to date the last use of the tiles */
+  std::atomic<unsigned long> m_Clock;
+
+  /** Incremented each time the cache is cleared */
+  std::atomic<unsigned long> m_Generation;
+
+  /** Serializes the updates of the tile table */
+  itk::SimpleFastMutexLock m_Mutex;
+
+  /** Serializes the ossim queries */
+  itk::SimpleFastMutexLock m_ElevManagerMutex;
+};
+
 /** Initialize the singleton */
 DEMHandler::Pointer DEMHandler::m_Singleton = ITK_NULLPTR;
 
@@ -72,13 +376,22 @@ DEMHandler::Pointer DEMHandler::Instance()
 DEMHandler
 ::DEMHandler() :
   m_GeoidFile(""),
-  m_DefaultHeightAboveEllipsoid(0)
+  m_DefaultHeightAboveEllipsoid(0),
+  m_ElevationCache(new ElevationCache)
 {
   assert( ossimElevManager::instance()!=NULL );
 
   ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(m_DefaultHeightAboveEllipsoid);
   // Force geoid fallback
   ossimElevManager::instance()->setUseGeoidIfNullFlag(true);
+
+  m_ElevationCache->SetSpacing(ConfigurationManager::GetDEMCacheSpacing());
+}
+
+DEMHandler
+::~DEMHandler()
+{
+  delete m_ElevationCache;
 }
 
 void
@@ -87,6 +400,8 @@ DEMHandler
 {
   assert( ossimElevManager::instance()!=NULL );
 
+  m_ElevationCache->Clear();
+
   ossimFilename ossimDEMDir( DEMDirectory );
 
   if (!ossimElevManager::instance()->loadElevationPath(ossimDEMDir))
@@ -118,6 +433,8 @@ DEMHandler
 {
   assert( ossimElevManager::instance()!=NULL );
 
+  m_ElevationCache->Clear();
+
   ossimElevManager::instance()->clear();
 }
 
@@ -162,6 +479,7 @@ DEMHandler
       // Ossim does not allow retrieving the geoid file path
       // We therefore must keep it on our side
       m_GeoidFile = geoidFile;
+      m_ElevationCache->Clear();
       otbMsgDevMacro(<< "Geoid successfully opened");
       ossimGeoidManager::instance()->addGeoid(geoidPtr);
       geoidPtr.release();
@@ -199,17 +517,12 @@ double
 DEMHandler
 ::GetHeightAboveMSL(double lon, double lat) const
 {
-  double   height;
-  ossimGpt ossimWorldPoint;
-
-  ossimWorldPoint.lon = lon;
-  ossimWorldPoint.lat = lat;
-
-  assert( ossimElevManager::instance()!=NULL );
-
-  height = ossimElevManager::instance()->getHeightAboveMSL(ossimWorldPoint);
+  if (m_ElevationCache->IsEnabled())
+    {
+    return m_ElevationCache->GetHeight(lon, lat, false);
+    }
 
-  return height;
+  return ElevManagerHeight(lon, lat, false);
 }
 
 double
@@ -223,17 +536,12 @@ double
 DEMHandler
 ::GetHeightAboveEllipsoid(double lon, double lat) const
 {
-  double   height;
-  ossimGpt ossimWorldPoint;
-
-  ossimWorldPoint.lon = lon;
-  ossimWorldPoint.lat = lat;
-
-  assert( ossimElevManager::instance()!=NULL );
-
-  height = ossimElevManager::instance()->getHeightAboveEllipsoid(ossimWorldPoint);
+  if (m_ElevationCache->IsEnabled())
+    {
+    return m_ElevationCache->GetHeight(lon, lat, true);
+    }
 
-  return height;
+  return ElevManagerHeight(lon, lat, true);
 }
 
 double
@@ -243,6 +551,30 @@ DEMHandler
   return GetHeightAboveEllipsoid(geoPoint[0], geoPoint[1]);
 }
 
+void
+DEMHandler
+::GetHeightAboveMSL(const std::vector<PointType>& geoPoints, std::vector<double>& heights) const
+{
+  heights.resize(geoPoints.size());
+
+  for (unsigned int i = 0; i < geoPoints.size(); ++i)
+    {
+    heights[i] = GetHeightAboveMSL(geoPoints[i][0], geoPoints[i][1]);
+    }
+}
+
+void
+DEMHandler
+::GetHeightAboveEllipsoid(const std::vector<PointType>& geoPoints, std::vector<double>& heights) const
+{
+  heights.resize(geoPoints.size());
+
+  for (unsigned int i = 0; i < geoPoints.size(); ++i)
+    {
+    heights[i] = GetHeightAboveEllipsoid(geoPoints[i][0], geoPoints[i][1]);
+    }
+}
+
 void
 DEMHandler
 ::SetDefaultHeightAboveEllipsoid(double h)
@@ -251,6 +583,8 @@ DEMHandler
   // ellipsoid We therefore must keep it on our side
   m_DefaultHeightAboveEllipsoid = h;
 
+  m_ElevationCache->Clear();
+
   assert( ossimElevManager::instance()!=NULL );
 
   ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(h);
@@ -287,6 +621,27 @@ std::string DEMHandler::GetDEMDirectory(unsigned int idx) const
   return demDir;
 }
 
+void
+DEMHandler
+::SetElevationCacheSpacing(double spacing)
+{
+  m_ElevationCache->SetSpacing(spacing);
+}
+
+double
+DEMHandler
+::GetElevationCacheSpacing() const
+{
+  return m_ElevationCache->GetSpacing();
+}
+
+void
+DEMHandler
+::ClearElevationCache()
+{
+  m_ElevationCache->Clear();
+}
+
 std::string DEMHandler::GetGeoidFile() const
 {
   // Ossim does not allow retrieving the geoid file path
@@ -300,6 +655,7 @@ DEMHandler
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "DEMHandler" << std::endl;
+  os << indent << "Elevation cache spacing: " << m_ElevationCache->GetSpacing() << std::endl;
 }
 
 } // namespace otb
@@ -59,6 +59,7 @@ char const* VectorDataKeywordlistDelimiterKey = "VectorDataKeywordlistDelimiter"
 char const* ResolutionFactor = "ResolutionFactor";
 char const* SubDatasetIndex = "SubDatasetIndex";
 char const* CacheSizeInBytes = "CacheSizeInBytes";
+char const* NumberOfReadThreads = "NumberOfReadThreads";
 
 char const* TileHintX = "TileHintX";
 char const* TileHintY = "TileHintY";
@@ -91,6 +92,7 @@ const MetaDataKey::KeyTypeDef Types[] =
   MetaDataKey::KeyTypeDef(MetaDataKey::ResolutionFactor,                  MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::SubDatasetIndex,                   MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::CacheSizeInBytes,                  MetaDataKey::TENTIER),
+  MetaDataKey::KeyTypeDef(MetaDataKey::NumberOfReadThreads,               MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::TileHintX,                         MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::TileHintY,                         MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::NoDataValueAvailable,              MetaDataKey::TVECTOR),
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbRPCModelEvaluator.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "vnl/vnl_math.h"
+#include "otbMath.h"
+
+namespace otb
+{
+
+namespace
+{
+/** Position of the RPC00A terms in the RPC00B ordering */
+const unsigned int RPC00AToRPC00B[RPCModelEvaluator::NumberOfTerms] =
+  {0, 1, 2, 3, 4, 5, 6, 10, 7, 8, 9, 11, 14, 17, 12, 15, 18, 13, 16, 19};
+
+/** Fill the RPC00B terms at the normalized point (P: latitude,
+ *  L: longitude, H: height) */
+inline void ComputeTerms(double P, double L, double H, double * t)
+{
+  const double LP = L * P;
+  const double LL = L * L;
+  const double PP = P * P;
+  const double HH = H * H;
+
+  t[0]  = 1.;
+  t[1]  = L;
+  t[2]  = P;
+  t[3]  = H;
+  t[4]  = LP;
+  t[5]  = L * H;
+  t[6]  = P * H;
+  t[7]  = LL;
+  t[8]  = PP;
+  t[9]  = HH;
+  t[10] = LP * H;
+  t[11] = LL * L;
+  t[12] = L * PP;
+  t[13] = L * HH;
+  t[14] = LL * P;
+  t[15] = PP * P;
+  t[16] = P * HH;
+  t[17] = LL * H;
+  t[18] = PP * H;
+  t[19] = HH * H;
+}
+
+/** Fill the derivatives of the RPC00B terms with respect to P and L */
+inline void ComputeTermsDerivatives(double P, double L, double H, double * dP, double * dL)
+{
+  std::fill(dP, dP + RPCModelEvaluator::NumberOfTerms, 0.);
+  std::fill(dL, dL + RPCModelEvaluator::NumberOfTerms, 0.);
+
+  dP[2]  = 1.;
+  dP[4]  = L;
+  dP[6]  = H;
+  dP[8]  = 2. * P;
+  dP[10] = L * H;
+  dP[12] = 2. * L * P;
+  dP[14] = L * L;
+  dP[15] = 3. * P * P;
+  dP[16] = H * H;
+  dP[18] = 2. * P * H;
+
+  dL[1]  = 1.;
+  dL[4]  = P;
+  dL[5]  = H;
+  dL[7]  = 2. * L;
+  dL[10] = P * H;
+  dL[11] = 3. * L * L;
+  dL[12] = P * P;
+  dL[13] = H * H;
+  dL[14] = 2. * L * P;
+  dL[17] = 2. * L * H;
+}
+
+inline double Dot(const double * c, const double * t)
+{
+  double sum = 0.;
+  for (unsigned int k = 0; k < RPCModelEvaluator::NumberOfTerms; ++k)
+    {
+    sum += c[k] * t[k];
+    }
+  return sum;
+}
+}
+
+RPCModelEvaluator::ParametersType
+::ParametersType()
+  : Type('B'),
+    LineOffset(0.), SampleOffset(0.), LatOffset(0.), LonOffset(0.), HeightOffset(0.),
+    LineScale(1.), SampleScale(1.), LatScale(1.), LonScale(1.), HeightScale(1.),
+    IntrackOffset(0.), CrtrackOffset(0.), MapRotation(0.)
+{
+  std::fill(LineNumCoef, LineNumCoef + NumberOfTerms, 0.);
+  std::fill(LineDenCoef, LineDenCoef + NumberOfTerms, 0.);
+  std::fill(SampleNumCoef, SampleNumCoef + NumberOfTerms, 0.);
+  std::fill(SampleDenCoef, SampleDenCoef + NumberOfTerms, 0.);
+}
+
+RPCModelEvaluator
+::RPCModelEvaluator()
+  : m_CosMapRotation(1.),
+    m_SinMapRotation(0.),
+    m_ConvergenceThreshold(1e-6),
+    m_MaximumNumberOfIterations(20)
+{
+  this->SetParameters(ParametersType());
+}
+
+void
+RPCModelEvaluator
+::SetParameters(const ParametersType & parameters)
+{
+  m_Parameters = parameters;
+
+  for (unsigned int k = 0; k < NumberOfTerms; ++k)
+    {
+    const unsigned int idx = (parameters.Type == 'A') ? RPC00AToRPC00B[k] : k;
+    m_LineNum[idx]   = parameters.LineNumCoef[k];
+    m_LineDen[idx]   = parameters.LineDenCoef[k];
+    m_SampleNum[idx] = parameters.SampleNumCoef[k];
+    m_SampleDen[idx] = parameters.SampleDenCoef[k];
+    }
+
+  const double rotation = parameters.MapRotation * CONST_PI_180;
+  m_CosMapRotation = std::cos(rotation);
+  m_SinMapRotation = std::sin(rotation);
+}
+
+void
+RPCModelEvaluator
+::GroundToImage(const double * lon, const double * lat, const double * h,
+                std::size_t n, double * line, double * sample) const
+{
+  const ParametersType & p = m_Parameters;
+  const double nanHeight = (p.HeightScale - p.HeightOffset) / p.HeightScale;
+
+  double t[NumberOfTerms];
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+    const double P = (lat[i] - p.LatOffset) / p.LatScale;
+    const double L = (lon[i] - p.LonOffset) / p.LonScale;
+    const double H = vnl_math_isnan(h[i]) ? nanHeight : (h[i] - p.HeightOffset) / p.HeightScale;
+
+    ComputeTerms(P, L, H, t);
+
+    const double U = Dot(m_LineNum, t) / Dot(m_LineDen, t);
+    const double V = Dot(m_SampleNum, t) / Dot(m_SampleDen, t);
+
+    const double Urot = m_CosMapRotation * U - m_SinMapRotation * V;
+    const double Vrot = m_SinMapRotation * U + m_CosMapRotation * V;
+
+    line[i]   = Urot * p.LineScale + p.LineOffset + p.IntrackOffset;
+    sample[i] = Vrot * p.SampleScale + p.SampleOffset + p.CrtrackOffset;
+    }
+}
+
+void
+RPCModelEvaluator
+::EvaluateWithDerivatives(double P, double L, double H,
+                          double & line, double & sample,
+                          double & dLineDP, double & dLineDL,
+                          double & dSampleDP, double & dSampleDL) const
+{
+  const ParametersType & p = m_Parameters;
+
+  double t[NumberOfTerms];
+  double dP[NumberOfTerms];
+  double dL[NumberOfTerms];
+
+  ComputeTerms(P, L, H, t);
+  ComputeTermsDerivatives(P, L, H, dP, dL);
+
+  const double Pu = Dot(m_LineNum, t);
+  const double Qu = Dot(m_LineDen, t);
+  const double Pv = Dot(m_SampleNum, t);
+  const double Qv = Dot(m_SampleDen, t);
+
+  const double U = Pu / Qu;
+  const double V = Pv / Qv;
+
+  // Quotient rule: (P/Q)' = (P' - (P/Q) Q') / Q
+  const double dUdP = (Dot(m_LineNum, dP) - U * Dot(m_LineDen, dP)) / Qu;
+  const double dUdL = (Dot(m_LineNum, dL) - U * Dot(m_LineDen, dL)) / Qu;
+  const double dVdP = (Dot(m_SampleNum, dP) - V * Dot(m_SampleDen, dP)) / Qv;
+  const double dVdL = (Dot(m_SampleNum, dL) - V * Dot(m_SampleDen, dL)) / Qv;
+
+  line   = (m_CosMapRotation * U - m_SinMapRotation * V) * p.LineScale
+           + p.LineOffset + p.IntrackOffset;
+  sample = (m_SinMapRotation * U + m_CosMapRotation * V) * p.SampleScale
+           + p.SampleOffset + p.CrtrackOffset;
+
+  dLineDP   = (m_CosMapRotation * dUdP - m_SinMapRotation * dVdP) * p.LineScale;
+  dLineDL   = (m_CosMapRotation * dUdL - m_SinMapRotation * dVdL) * p.LineScale;
+  dSampleDP = (m_SinMapRotation * dUdP + m_CosMapRotation * dVdP) * p.SampleScale;
+  dSampleDL = (m_SinMapRotation * dUdL + m_CosMapRotation * dVdL) * p.SampleScale;
+}
+
+void
+RPCModelEvaluator
+::ImageToGround(const double * line, const double * sample, const double * h,
+                std::size_t n, double * lon, double * lat) const
+{
+  const ParametersType & p = m_Parameters;
+  const double nanHeight = (p.HeightScale - p.HeightOffset) / p.HeightScale;
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+    const double H = vnl_math_isnan(h[i]) ? nanHeight : (h[i] - p.HeightOffset) / p.HeightScale;
+
+    // Start from the center of the model validity domain
+    double P = 0.;
+    double L = 0.;
+
+    for (unsigned int it = 0; it < m_MaximumNumberOfIterations; ++it)
+      {
+      double l, s, dlDP, dlDL, dsDP, dsDL;
+      this->EvaluateWithDerivatives(P, L, H, l, s, dlDP, dlDL, dsDP, dsDL);
+
+      const double rl = l - line[i];
+      const double rs = s - sample[i];
+
+      if (std::abs(rl) < m_ConvergenceThreshold && std::abs(rs) < m_ConvergenceThreshold)
+        {
+        break;
+        }
+
+      const double det = dlDP * dsDL - dlDL * dsDP;
+      if (det == 0.)
+        {
+        break;
+        }
+
+      P -= (dsDL * rl - dlDL * rs) / det;
+      L -= (dlDP * rs - dsDP * rl) / det;
+      }
+
+    lat[i] = P * p.LatScale + p.LatOffset;
+    lon[i] = L * p.LonScale + p.LonOffset;
+    }
+}
+
+} // end namespace otb
@@ -22,9 +22,11 @@
 #include "otbSensorModelAdapter.h"
 
 #include <cassert>
+#include <cmath>
 
 #include "otbMacro.h"
 #include "otbImageKeywordlist.h"
+#include "otbRPCModelEvaluator.h"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -35,6 +37,7 @@
 #include "ossim/projection/ossimSensorModelFactory.h"
 #include "ossim/projection/ossimSensorModel.h"
 #include "ossim/projection/ossimRpcProjection.h"
+#include "ossim/projection/ossimRpcModel.h"
 #include "ossim/ossimPluginProjectionFactory.h"
 #include "ossim/base/ossimTieGptSet.h"
 
@@ -44,6 +47,7 @@
 #include "ossim/projection/ossimSensorModelFactory.h"
 #include "ossim/projection/ossimSensorModel.h"
 #include "ossim/projection/ossimRpcProjection.h"
+#include "ossim/projection/ossimRpcModel.h"
 #include "ossim/ossimPluginProjectionFactory.h"
 #include "ossim/base/ossimTieGptSet.h"
 
@@ -54,7 +58,7 @@ namespace otb
 {
 
 SensorModelAdapter::SensorModelAdapter():
-  m_SensorModel(ITK_NULLPTR), m_TiePoints(ITK_NULLPTR) // FIXME keeping the original value but...
+  m_SensorModel(ITK_NULLPTR), m_RPCEvaluator(ITK_NULLPTR), m_TiePoints(ITK_NULLPTR) // FIXME keeping the original value but...
 {
   m_DEMHandler = DEMHandler::Instance();
   m_TiePoints = new ossimTieGptSet();
@@ -63,6 +67,7 @@ SensorModelAdapter::SensorModelAdapter():
 SensorModelAdapter::~SensorModelAdapter()
 {
   delete m_SensorModel;
+  delete m_RPCEvaluator;
   delete m_TiePoints;
 }
 
@@ -79,6 +84,8 @@ void SensorModelAdapter::CreateProjection(const ImageKeywordlist& image_kwl)
     {
     m_SensorModel = ossimplugins::ossimPluginProjectionFactory::instance()->createProjection(geom);
     }
+
+  this->UpdateRPCEvaluator();
 }
 
 bool SensorModelAdapter::IsValidSensorModel() const
@@ -166,6 +173,220 @@ void SensorModelAdapter::InverseTransformPoint(double lon, double lat,
   z = ossimGPoint.height();
 }
 
+void SensorModelAdapter::ForwardTransformPoints(const std::vector<double>& x,
+                                                const std::vector<double>& y,
+                                                const std::vector<double>& z,
+                                                std::vector<double>& lon,
+                                                std::vector<double>& lat,
+                                                std::vector<double>& h) const
+{
+  if (this->m_SensorModel == ITK_NULLPTR)
+    {
+    itkExceptionMacro(<< "ForwardTransformPoints(): Invalid sensor model (m_SensorModel pointer is null)");
+    }
+
+  const std::size_t n = x.size();
+  if (y.size() != n || z.size() != n)
+    {
+    itkExceptionMacro(<< "ForwardTransformPoints(): input coordinates arrays have different sizes");
+    }
+
+  lon.resize(n);
+  lat.resize(n);
+  h.resize(n);
+
+  if (n == 0)
+    {
+    return;
+    }
+
+  if (m_RPCEvaluator != ITK_NULLPTR)
+    {
+    std::vector<double> line(n);
+    std::vector<double> sample(n);
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      line[i] = internal::ConvertToOSSIMFrame(y[i]);
+      sample[i] = internal::ConvertToOSSIMFrame(x[i]);
+      }
+
+    m_RPCEvaluator->ImageToGround(&line[0], &sample[0], &z[0], n, &lon[0], &lat[0]);
+    h = z;
+    }
+  else
+    {
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      this->ForwardTransformPoint(x[i], y[i], z[i], lon[i], lat[i], h[i]);
+      }
+    }
+}
+
+void SensorModelAdapter::InverseTransformPoints(const std::vector<double>& lon,
+                                                const std::vector<double>& lat,
+                                                const std::vector<double>& h,
+                                                std::vector<double>& x,
+                                                std::vector<double>& y,
+                                                std::vector<double>& z) const
+{
+  if (this->m_SensorModel == ITK_NULLPTR)
+    {
+    itkExceptionMacro(<< "InverseTransformPoints(): Invalid sensor model (m_SensorModel pointer is null)");
+    }
+
+  const std::size_t n = lon.size();
+  if (lat.size() != n || h.size() != n)
+    {
+    itkExceptionMacro(<< "InverseTransformPoints(): input coordinates arrays have different sizes");
+    }
+
+  x.resize(n);
+  y.resize(n);
+  z.resize(n);
+
+  if (n == 0)
+    {
+    return;
+    }
+
+  if (m_RPCEvaluator != ITK_NULLPTR)
+    {
+    m_RPCEvaluator->GroundToImage(&lon[0], &lat[0], &h[0], n, &y[0], &x[0]);
+
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      x[i] = internal::ConvertFromOSSIMFrame(x[i]);
+      y[i] = internal::ConvertFromOSSIMFrame(y[i]);
+      }
+    z = h;
+    }
+  else
+    {
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      this->InverseTransformPoint(lon[i], lat[i], h[i], x[i], y[i], z[i]);
+      }
+    }
+}
+
+void SensorModelAdapter::InverseTransformPoints(const std::vector<double>& lon,
+                                                const std::vector<double>& lat,
+                                                std::vector<double>& x,
+                                                std::vector<double>& y,
+                                                std::vector<double>& z) const
+{
+  if (lat.size() != lon.size())
+    {
+    itkExceptionMacro(<< "InverseTransformPoints(): input coordinates arrays have different sizes");
+    }
+
+  // Get elevations from DEMHandler
+  std::vector<DEMHandler::PointType> geoPoints(lon.size());
+  for (std::size_t i = 0; i < lon.size(); ++i)
+    {
+    geoPoints[i][0] = lon[i];
+    geoPoints[i][1] = lat[i];
+    }
+
+  std::vector<double> h;
+  m_DEMHandler->GetHeightAboveEllipsoid(geoPoints, h);
+
+  this->InverseTransformPoints(lon, lat, h, x, y, z);
+}
+
+bool SensorModelAdapter::UsesNativeRPCEvaluator() const
+{
+  return m_RPCEvaluator != ITK_NULLPTR;
+}
+
+void SensorModelAdapter::UpdateRPCEvaluator()
+{
+  delete m_RPCEvaluator;
+  m_RPCEvaluator = ITK_NULLPTR;
+
+  ossimRpcModel * rpcModel = dynamic_cast<ossimRpcModel *>(m_SensorModel);
+  if (rpcModel == ITK_NULLPTR)
+    {
+    return;
+    }
+
+  ossimRpcModel::rpcModelStruct rpcStruct;
+  rpcModel->getRpcParameters(rpcStruct);
+
+  RPCModelEvaluator::ParametersType parameters;
+  parameters.Type = rpcStruct.type;
+  parameters.LineOffset = rpcStruct.lineOffset;
+  parameters.SampleOffset = rpcStruct.sampOffset;
+  parameters.LatOffset = rpcStruct.latOffset;
+  parameters.LonOffset = rpcStruct.lonOffset;
+  parameters.HeightOffset = rpcStruct.hgtOffset;
+  parameters.LineScale = rpcStruct.lineScale;
+  parameters.SampleScale = rpcStruct.sampScale;
+  parameters.LatScale = rpcStruct.latScale;
+  parameters.LonScale = rpcStruct.lonScale;
+  parameters.HeightScale = rpcStruct.hgtScale;
+
+  for (unsigned int k = 0; k < RPCModelEvaluator::NumberOfTerms; ++k)
+    {
+    parameters.LineNumCoef[k] = rpcStruct.lineNumCoef[k];
+    parameters.LineDenCoef[k] = rpcStruct.lineDenCoef[k];
+    parameters.SampleNumCoef[k] = rpcStruct.sampNumCoef[k];
+    parameters.SampleDenCoef[k] = rpcStruct.sampDenCoef[k];
+    }
+
+  // Adjustable parameters of ossimRpcModel: intrack offset (0), crtrack
+  // offset (1) and map rotation (4)
+  if (rpcModel->getNumberOfAdjustableParameters() > 4)
+    {
+    parameters.IntrackOffset = rpcModel->computeParameterOffset(0);
+    parameters.CrtrackOffset = rpcModel->computeParameterOffset(1);
+    parameters.MapRotation = rpcModel->computeParameterOffset(4);
+    }
+
+  RPCModelEvaluator * evaluator = new RPCModelEvaluator;
+  evaluator->SetParameters(parameters);
+
+  // Check the native model against OSSIM on a grid spanning the validity
+  // domain. Derived models (sensor specific plugins) may override the
+  // evaluation, in which case the native evaluator can not be used.
+  const unsigned int gridSize = 5;
+  std::vector<double> lon, lat, h;
+  for (unsigned int k = 0; k < 3; ++k)
+    {
+    for (unsigned int j = 0; j < gridSize; ++j)
+      {
+      for (unsigned int i = 0; i < gridSize; ++i)
+        {
+        lon.push_back(rpcStruct.lonOffset + rpcStruct.lonScale * (1.6 * i / (gridSize - 1) - 0.8));
+        lat.push_back(rpcStruct.latOffset + rpcStruct.latScale * (1.6 * j / (gridSize - 1) - 0.8));
+        h.push_back(rpcStruct.hgtOffset + rpcStruct.hgtScale * (0.5 * k - 0.5));
+        }
+      }
+    }
+
+  std::vector<double> line(lon.size()), sample(lon.size());
+  evaluator->GroundToImage(&lon[0], &lat[0], &h[0], lon.size(), &line[0], &sample[0]);
+
+  const double tolerance = 1e-6;
+  for (std::size_t i = 0; i < lon.size(); ++i)
+    {
+    ossimGpt ossimGPoint(lat[i], lon[i], h[i]);
+    ossimDpt ossimDPoint;
+
+    m_SensorModel->worldToLineSample(ossimGPoint, ossimDPoint);
+
+    if (!(std::abs(ossimDPoint.y - line[i]) <= tolerance && std::abs(ossimDPoint.x - sample[i]) <= tolerance))
+      {
+      otbMsgDevMacro(<< "Native RPC evaluation disabled: "
+                     << ossimDPoint << " (OSSIM) vs " << sample[i] << ", " << line[i]);
+      delete evaluator;
+      return;
+      }
+    }
+
+  m_RPCEvaluator = evaluator;
+}
+
 void SensorModelAdapter::AddTiePoint(double x, double y, double z, double lon, double lat)
 {
   // Create the tie point
@@ -224,6 +445,9 @@ double SensorModelAdapter::Optimize()
       // Call optimize fit
       precision  = simpleRpcModel->optimizeFit(*m_TiePoints);
       }
+
+    // Adjustable parameters have changed
+    this->UpdateRPCEvaluator();
     }
 
   // Return the precision
@@ -243,6 +467,8 @@ bool SensorModelAdapter::ReadGeomFile(const std::string & infile)
     m_SensorModel = ossimplugins::ossimPluginProjectionFactory::instance()->createProjection(geom);
     }
 
+  this->UpdateRPCEvaluator();
+
   // otbMsgDevMacro(<< "ReadGeomFile("<<geom<<") -> " << m_SensorModel);
   return (m_SensorModel != ITK_NULLPTR);
 }
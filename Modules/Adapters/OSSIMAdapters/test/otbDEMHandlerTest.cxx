@@ -22,6 +22,8 @@
 #include "itkMacro.h"
 #include "otbDEMHandler.h"
 
+#include <vector>
+
 int otbDEMHandlerTest(int argc, char * argv[])
 {
   if(argc!=9)
@@ -120,3 +122,65 @@ int otbDEMHandlerTest(int argc, char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbDEMHandlerCacheTest(int argc, char * argv[])
+{
+  if(argc!=8)
+    {
+    std::cerr<<"Usage: "<<argv[0]<<" demdir geoid longitude latitude extent cacheSpacing tolerance"<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string demdir   = argv[1];
+  std::string geoid    = argv[2];
+  double longitude     = atof(argv[3]);
+  double latitude      = atof(argv[4]);
+  double extent        = atof(argv[5]);
+  double spacing       = atof(argv[6]);
+  double tolerance     = atof(argv[7]);
+
+  otb::DEMHandler::Pointer demHandler = otb::DEMHandler::Instance();
+  demHandler->OpenDEMDirectory(demdir);
+  demHandler->OpenGeoidFile(geoid);
+
+  // Points on a grid which is not aligned with the cache posts
+  std::vector<otb::DEMHandler::PointType> points;
+  const unsigned int nbSteps = 37;
+  for(unsigned int j = 0; j < nbSteps; ++j)
+    {
+    for(unsigned int i = 0; i < nbSteps; ++i)
+      {
+      otb::DEMHandler::PointType point;
+      point[0] = longitude + extent * i / nbSteps;
+      point[1] = latitude + extent * j / nbSteps;
+      points.push_back(point);
+      }
+    }
+
+  demHandler->SetElevationCacheSpacing(0.);
+  std::vector<double> refMSL, refEllipsoid;
+  demHandler->GetHeightAboveMSL(points, refMSL);
+  demHandler->GetHeightAboveEllipsoid(points, refEllipsoid);
+
+  demHandler->SetElevationCacheSpacing(spacing);
+  std::vector<double> cachedMSL, cachedEllipsoid;
+  demHandler->GetHeightAboveMSL(points, cachedMSL);
+  demHandler->GetHeightAboveEllipsoid(points, cachedEllipsoid);
+
+  bool fail = false;
+  for(unsigned int i = 0; i < points.size(); ++i)
+    {
+    if(vcl_abs(refMSL[i] - cachedMSL[i]) > tolerance
+       || vcl_abs(refEllipsoid[i] - cachedEllipsoid[i]) > tolerance
+       || vcl_abs(cachedEllipsoid[i] - demHandler->GetHeightAboveEllipsoid(points[i])) > 1e-9)
+      {
+      std::cerr<<"Point "<<points[i]<<": height above MSL "<<refMSL[i]<<" (cached "<<cachedMSL[i]
+               <<"), height above ellipsoid "<<refEllipsoid[i]<<" (cached "<<cachedEllipsoid[i]<<")"<<std::endl;
+      fail = true;
+      }
+    }
+
+  demHandler->SetElevationCacheSpacing(0.);
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
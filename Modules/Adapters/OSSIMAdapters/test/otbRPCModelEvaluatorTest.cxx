@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "otbMath.h"
+#include "otbRPCModelEvaluator.h"
+#include "otbSensorModelAdapter.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace
+{
+typedef otb::RPCModelEvaluator                                 EvaluatorType;
+typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+// Terms of the polynomials as listed in the RPC00A and RPC00B specifications
+void ReferenceTerms(char type, double P, double L, double H, double * t)
+{
+  if (type == 'A')
+    {
+    const double terms[20] = {1, L, P, H, L*P, L*H, P*H, L*P*H, L*L, P*P,
+                              H*H, L*L*L, L*L*P, L*L*H, L*P*P, P*P*P, P*P*H, L*H*H, P*H*H, H*H*H};
+    std::copy(terms, terms + 20, t);
+    }
+  else
+    {
+    const double terms[20] = {1, L, P, H, L*P, L*H, P*H, L*L, P*P, H*H,
+                              P*L*H, L*L*L, L*P*P, L*H*H, L*L*P, P*P*P, P*H*H, L*L*H, P*P*H, H*H*H};
+    std::copy(terms, terms + 20, t);
+    }
+}
+
+double ReferencePolynomial(const double * coef, const double * t)
+{
+  double sum = 0.;
+  for (unsigned int k = 0; k < 20; ++k)
+    {
+    sum += coef[k] * t[k];
+    }
+  return sum;
+}
+
+EvaluatorType::ParametersType CreateParameters(char type, GeneratorType * generator)
+{
+  EvaluatorType::ParametersType p;
+  p.Type = type;
+  p.LineOffset = 5000.5;
+  p.SampleOffset = 6000.25;
+  p.LatOffset = 43.6;
+  p.LonOffset = 1.44;
+  p.HeightOffset = 200.;
+  p.LineScale = 5000.;
+  p.SampleScale = 6000.;
+  p.LatScale = 0.1;
+  p.LonScale = 0.12;
+  p.HeightScale = 500.;
+
+  // Dominant linear terms, small higher order terms
+  for (unsigned int k = 0; k < 20; ++k)
+    {
+    p.LineNumCoef[k] = generator->GetUniformVariate(-1e-3, 1e-3);
+    p.SampleNumCoef[k] = generator->GetUniformVariate(-1e-3, 1e-3);
+    p.LineDenCoef[k] = generator->GetUniformVariate(-1e-4, 1e-4);
+    p.SampleDenCoef[k] = generator->GetUniformVariate(-1e-4, 1e-4);
+    }
+  p.LineNumCoef[1] = 0.05;
+  p.LineNumCoef[2] = -1.;
+  p.LineNumCoef[3] = 0.02;
+  p.SampleNumCoef[1] = 1.;
+  p.SampleNumCoef[2] = 0.03;
+  p.SampleNumCoef[3] = -0.01;
+  p.LineDenCoef[0] = 1.;
+  p.SampleDenCoef[0] = 1.;
+
+  return p;
+}
+
+bool CheckModel(const EvaluatorType::ParametersType & p, GeneratorType * generator)
+{
+  EvaluatorType evaluator;
+  evaluator.SetParameters(p);
+
+  const unsigned int n = 1000;
+  std::vector<double> lon(n), lat(n), h(n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+    lon[i] = p.LonOffset + p.LonScale * generator->GetUniformVariate(-1., 1.);
+    lat[i] = p.LatOffset + p.LatScale * generator->GetUniformVariate(-1., 1.);
+    h[i] = p.HeightOffset + p.HeightScale * generator->GetUniformVariate(-1., 1.);
+    }
+
+  // Batch evaluation against the reference one
+  std::vector<double> line(n), sample(n);
+  evaluator.GroundToImage(&lon[0], &lat[0], &h[0], n, &line[0], &sample[0]);
+
+  const double rotation = p.MapRotation * CONST_PI_180;
+  for (unsigned int i = 0; i < n; ++i)
+    {
+    double t[20];
+    ReferenceTerms(p.Type,
+                   (lat[i] - p.LatOffset) / p.LatScale,
+                   (lon[i] - p.LonOffset) / p.LonScale,
+                   (h[i] - p.HeightOffset) / p.HeightScale, t);
+
+    const double U = ReferencePolynomial(p.LineNumCoef, t) / ReferencePolynomial(p.LineDenCoef, t);
+    const double V = ReferencePolynomial(p.SampleNumCoef, t) / ReferencePolynomial(p.SampleDenCoef, t);
+
+    const double refLine = (std::cos(rotation) * U - std::sin(rotation) * V) * p.LineScale
+                           + p.LineOffset + p.IntrackOffset;
+    const double refSample = (std::sin(rotation) * U + std::cos(rotation) * V) * p.SampleScale
+                             + p.SampleOffset + p.CrtrackOffset;
+
+    if (std::abs(refLine - line[i]) > 1e-8 || std::abs(refSample - sample[i]) > 1e-8)
+      {
+      std::cerr << "Type " << p.Type << ", point " << i << ": batch evaluation (" << line[i] << ", "
+                << sample[i] << ") differs from reference (" << refLine << ", " << refSample << ")" << std::endl;
+      return false;
+      }
+    }
+
+  // Inversion
+  std::vector<double> lon2(n), lat2(n);
+  evaluator.ImageToGround(&line[0], &sample[0], &h[0], n, &lon2[0], &lat2[0]);
+
+  for (unsigned int i = 0; i < n; ++i)
+    {
+    if (std::abs(lon2[i] - lon[i]) > 1e-9 || std::abs(lat2[i] - lat[i]) > 1e-9)
+      {
+      std::cerr << "Type " << p.Type << ", point " << i << ": inversion of (" << line[i] << ", "
+                << sample[i] << ") gives (" << lon2[i] << ", " << lat2[i] << ") instead of ("
+                << lon[i] << ", " << lat[i] << ")" << std::endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+}
+
+int otbRPCModelEvaluatorTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  // This test checks the batch evaluation of both RPC types against a
+  // straightforward implementation, and the Newton inversion
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(121212);
+
+  bool ok = true;
+
+  ok = CheckModel(CreateParameters('A', generator), generator) && ok;
+  ok = CheckModel(CreateParameters('B', generator), generator) && ok;
+
+  // With adjustments
+  EvaluatorType::ParametersType p = CreateParameters('B', generator);
+  p.IntrackOffset = 1.5;
+  p.CrtrackOffset = -2.25;
+  p.MapRotation = 0.3;
+  ok = CheckModel(p, generator) && ok;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbSensorModelAdapterBatchTest(int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " geom_file" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // This test checks the batch transforms of a sensor model against the
+  // per point ones
+  otb::SensorModelAdapter::Pointer model = otb::SensorModelAdapter::New();
+  if (!model->ReadGeomFile(argv[1]))
+    {
+    std::cerr << "Can not read sensor model from " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Native RPC evaluator: " << (model->UsesNativeRPCEvaluator() ? "yes" : "no") << std::endl;
+
+  std::vector<double> x, y, z;
+  for (unsigned int j = 0; j < 20; ++j)
+    {
+    for (unsigned int i = 0; i < 20; ++i)
+      {
+      x.push_back(25. * i + 0.3);
+      y.push_back(25. * j + 0.7);
+      z.push_back(100. + 10. * i);
+      }
+    }
+
+  std::vector<double> lon, lat, h;
+  model->ForwardTransformPoints(x, y, z, lon, lat, h);
+
+  std::vector<double> x2, y2, z2;
+  model->InverseTransformPoints(lon, lat, h, x2, y2, z2);
+
+  bool ok = true;
+  for (unsigned int i = 0; i < x.size(); ++i)
+    {
+    double refX, refY, refZ;
+    model->InverseTransformPoint(lon[i], lat[i], h[i], refX, refY, refZ);
+
+    if (std::abs(refX - x2[i]) > 1e-6 || std::abs(refY - y2[i]) > 1e-6 || refZ != z2[i])
+      {
+      std::cerr << "Inverse transform of point " << i << ": batch (" << x2[i] << ", " << y2[i]
+                << ") vs single (" << refX << ", " << refY << ")" << std::endl;
+      ok = false;
+      }
+
+    // OSSIM stops the forward iterations at 0.1 pixel
+    if (std::abs(x[i] - x2[i]) > 0.1 || std::abs(y[i] - y2[i]) > 0.1)
+      {
+      std::cerr << "Forward transform of point " << i << ": (" << x[i] << ", " << y[i]
+                << ") reprojected to (" << x2[i] << ", " << y2[i] << ")" << std::endl;
+      ok = false;
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
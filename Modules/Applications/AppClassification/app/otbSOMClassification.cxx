@@ -146,6 +146,10 @@ private:
     SetParameterDescription("iv", "Maximum initial neuron weight");
     MandatoryOff("iv");
 
+    AddParameter(ParameterType_Empty, "batch", "Batch learning");
+    SetParameterDescription("batch", "If activated, the map is updated once per iteration from the winners of all the training samples, searched in parallel, instead of after each sample");
+    MandatoryOff("batch");
+
     AddRAMParameter();
     // TODO : replace StreamingLines by RAM param ?
 
@@ -366,6 +370,7 @@ private:
       estimator->SetBetaInit(GetParameterFloat("bi"));
       estimator->SetBetaEnd(GetParameterFloat("bf"));
       estimator->SetMaxWeight(GetParameterFloat("iv"));
+      estimator->SetBatchMode(IsParameterEnabled("batch"));
 
     AddProcess(estimator,"Learning");
     estimator->Update();
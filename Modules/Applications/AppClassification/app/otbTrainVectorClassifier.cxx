@@ -43,6 +43,7 @@ public:
   typedef Superclass::SampleType SampleType;
   typedef Superclass::ListSampleType ListSampleType;
   typedef Superclass::TargetListSampleType TargetListSampleType;
+  typedef Superclass::SampleStoreType SampleStoreType;
 
   // Estimate performance on validation sample
   typedef otb::ConfusionMatrixCalculator<TargetListSampleType, TargetListSampleType> ConfusionMatrixCalculatorType;
@@ -87,20 +88,36 @@ protected:
 
     Superclass::DoExecute();
 
+    TargetListSampleType::Pointer referenceLabels = GetReferenceLabels();
     if (GetClassifierCategory() == Supervised)
       {
       ConfusionMatrixCalculatorType::Pointer confMatCalc = ComputeConfusionMatrix( m_PredictedList,
-                                                                                   m_ClassificationSamplesWithLabel.labeledListSample );
+                                                                                   referenceLabels );
       WriteConfusionMatrix( confMatCalc );
       }
     else
       {
       ContingencyTablePointerType table = ComputeContingencyTable( m_PredictedList,
-                                                                   m_ClassificationSamplesWithLabel.labeledListSample );
+                                                                   referenceLabels );
       WriteContingencyTable( table );
       }
   }
 
+  /** Labels of the classified samples, read from their sample store */
+  TargetListSampleType::Pointer GetReferenceLabels() const
+  {
+    const SampleStoreType::LabelsType & labels = m_ClassificationSamplesWithLabel.sampleStore->GetLabels();
+
+    TargetListSampleType::Pointer referenceLabels = TargetListSampleType::New();
+    TargetListSampleType::MeasurementVectorType label;
+    for( unsigned long id = 0; id < labels.size(); ++id )
+      {
+      label[0] = labels[id];
+      referenceLabels->PushBack( label );
+      }
+    return referenceLabels;
+  }
+
   ContingencyTablePointerType ComputeContingencyTable(const TargetListSampleType::Pointer &predictedListSample,
                                                       const TargetListSampleType::Pointer &performanceLabeledListSample)
   {
@@ -66,6 +66,10 @@ namespace Wrapper
  * an application deriving this base class for regression should initialize
  * the m_RegressionFlag to true in their constructor.
  *
+ * The training samples can also be given as a contiguous sample store
+ * (see m_TrainingSampleStore), used without copy by the models
+ * supporting it, and converted to list samples for the other ones.
+ *
  * \sa TrainImagesClassifier
  * \sa TrainRegression
  *
@@ -103,6 +107,8 @@ public:
   typedef typename ModelType::TargetListSampleType  TargetListSampleType;
   typedef typename ModelType::TargetValueType       TargetValueType;
 
+  typedef typename ModelType::SampleStoreType       SampleStoreType;
+
   itkGetConstReferenceMacro(SupervisedClassifier, std::vector<std::string>);
   itkGetConstReferenceMacro(UnsupervisedClassifier, std::vector<std::string>);
 
@@ -134,6 +140,19 @@ protected:
     typename ListSampleType::Pointer validationListSample,
     std::string modelPath);
 
+  /** Generic method to load a model file and use it to classify the
+   * samples of a store, converted to list samples chunk by chunk */
+  typename TargetListSampleType::Pointer Classify(
+    const SampleStoreType * validationSampleStore,
+    std::string modelPath);
+
+  /** Give the training samples to a model: the training sample store if
+   * it is set and supported by the model, list samples otherwise (built
+   * from the store if it is set) */
+  void SetTrainingSamples(ModelType * model,
+                          typename ListSampleType::Pointer trainingListSample,
+                          typename TargetListSampleType::Pointer trainingLabeledListSample);
+
   /** Init method that creates all the parameters for machine learning models */
   void DoInit() ITK_OVERRIDE;
 
@@ -141,6 +160,10 @@ protected:
    * False by default, child classes may change it in their constructor */
   bool m_RegressionFlag;
 
+  /** Training samples and labels, used instead of the training list
+   * samples given to Train() if set */
+  typename SampleStoreType::ConstPointer m_TrainingSampleStore;
+
 private:
   /** Specific Init and Train methods for each machine learning model */
 
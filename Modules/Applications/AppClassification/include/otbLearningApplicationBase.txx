@@ -21,6 +21,8 @@
 #ifndef otbLearningApplicationBase_txx
 #define otbLearningApplicationBase_txx
 
+#include <algorithm>
+
 #include "otbLearningApplicationBase.h"
 // only need this filter as a dummy process object
 #include "otbRGBAPixelConverter.h"
@@ -162,6 +164,90 @@ LearningApplicationBase<TInputValue,TOutputValue>
   return predictedList;
 }
 
+template <class TInputValue, class TOutputValue>
+typename LearningApplicationBase<TInputValue,TOutputValue>
+::TargetListSampleType::Pointer
+LearningApplicationBase<TInputValue,TOutputValue>
+::Classify(const SampleStoreType * validationSampleStore,
+           std::string modelPath)
+{
+  // Setup fake reporter
+  RGBAPixelConverter<int,int>::Pointer dummyFilter =
+    RGBAPixelConverter<int,int>::New();
+  dummyFilter->SetProgress(0.0f);
+  this->AddProcess(dummyFilter,"Classify...");
+  dummyFilter->InvokeEvent(itk::StartEvent());
+
+  // load a machine learning model from file and predict the input sample list
+  ModelPointerType model = ModelFactoryType::CreateMachineLearningModel(modelPath,
+                                                                        ModelFactoryType::ReadMode);
+
+  if (model.IsNull())
+    {
+    otbAppLogFATAL(<< "Error when loading model " << modelPath);
+    }
+
+  model->Load(modelPath);
+  model->SetRegressionMode(this->m_RegressionFlag);
+
+  typename TargetListSampleType::Pointer predictedList = TargetListSampleType::New();
+
+  // Only a chunk of the samples is copied in a list sample at a time
+  const unsigned long nbSamples = validationSampleStore->Size();
+  const unsigned long chunkSize = 65536;
+  typename ListSampleType::Pointer chunk = ListSampleType::New();
+  chunk->SetMeasurementVectorSize(validationSampleStore->GetNumberOfFeatures());
+
+  for (unsigned long start = 0; start < nbSamples; start += chunkSize)
+    {
+    const unsigned long size = std::min(chunkSize, nbSamples - start);
+    chunk->Clear();
+    validationSampleStore->ExportToListSamples(start, size, chunk.GetPointer(),
+                                               static_cast<TargetListSampleType *>(ITK_NULLPTR));
+
+    typename TargetListSampleType::Pointer predictedChunk = model->PredictBatch(chunk, NULL);
+    for (unsigned long i = 0; i < predictedChunk->Size(); ++i)
+      {
+      predictedList->PushBack(predictedChunk->GetMeasurementVector(i));
+      }
+
+    dummyFilter->UpdateProgress(static_cast<float>(start + size) / nbSamples);
+    }
+
+  // update reporter
+  dummyFilter->UpdateProgress(1.0f);
+  dummyFilter->InvokeEvent(itk::EndEvent());
+
+  return predictedList;
+}
+
+template <class TInputValue, class TOutputValue>
+void
+LearningApplicationBase<TInputValue,TOutputValue>
+::SetTrainingSamples(ModelType * model,
+                     typename ListSampleType::Pointer trainingListSample,
+                     typename TargetListSampleType::Pointer trainingLabeledListSample)
+{
+  if (m_TrainingSampleStore.IsNotNull())
+    {
+    if (model->IsSampleStoreSupported())
+      {
+      model->SetTrainingSampleStore(m_TrainingSampleStore);
+      return;
+      }
+
+    trainingListSample = ListSampleType::New();
+    trainingListSample->SetMeasurementVectorSize(m_TrainingSampleStore->GetNumberOfFeatures());
+    trainingLabeledListSample = TargetListSampleType::New();
+    m_TrainingSampleStore->ExportToListSamples(0, m_TrainingSampleStore->Size(),
+                                               trainingListSample.GetPointer(),
+                                               trainingLabeledListSample.GetPointer());
+    }
+
+  model->SetInputListSample(trainingListSample);
+  model->SetTargetListSample(trainingLabeledListSample);
+}
+
 template <class TInputValue, class TOutputValue>
 void
 LearningApplicationBase<TInputValue,TOutputValue>
@@ -92,8 +92,7 @@ namespace Wrapper
     typedef otb::BoostMachineLearningModel<InputValueType, OutputValueType> BoostType;
     typename BoostType::Pointer boostClassifier = BoostType::New();
     boostClassifier->SetRegressionMode(this->m_RegressionFlag);
-    boostClassifier->SetInputListSample(trainingListSample);
-    boostClassifier->SetTargetListSample(trainingLabeledListSample);
+    this->SetTrainingSamples(boostClassifier, trainingListSample, trainingLabeledListSample);
     boostClassifier->SetBoostType(GetParameterInt("classifier.boost.t"));
     boostClassifier->SetWeakCount(GetParameterInt("classifier.boost.w"));
     boostClassifier->SetWeightTrimRate(GetParameterFloat("classifier.boost.r"));
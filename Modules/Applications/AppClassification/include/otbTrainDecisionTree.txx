@@ -114,8 +114,7 @@ LearningApplicationBase<TInputValue,TOutputValue>
   typedef otb::DecisionTreeMachineLearningModel<InputValueType, OutputValueType> DecisionTreeType;
   typename DecisionTreeType::Pointer classifier = DecisionTreeType::New();
   classifier->SetRegressionMode(this->m_RegressionFlag);
-  classifier->SetInputListSample(trainingListSample);
-  classifier->SetTargetListSample(trainingLabeledListSample);
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
   classifier->SetMaxDepth(GetParameterInt("classifier.dt.max"));
   classifier->SetMinSampleCount(GetParameterInt("classifier.dt.min"));
   classifier->SetRegressionAccuracy(GetParameterFloat("classifier.dt.ra"));
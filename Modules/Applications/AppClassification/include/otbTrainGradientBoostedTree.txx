@@ -100,8 +100,7 @@ LearningApplicationBase<TInputValue,TOutputValue>
   typedef otb::GradientBoostedTreeMachineLearningModel<InputValueType, OutputValueType> GradientBoostedTreeType;
   typename GradientBoostedTreeType::Pointer classifier = GradientBoostedTreeType::New();
   classifier->SetRegressionMode(this->m_RegressionFlag);
-  classifier->SetInputListSample(trainingListSample);
-  classifier->SetTargetListSample(trainingLabeledListSample);
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
   classifier->SetWeakCount(GetParameterInt("classifier.gbt.w"));
   classifier->SetShrinkage(GetParameterFloat("classifier.gbt.s"));
   classifier->SetSubSamplePortion(GetParameterFloat("classifier.gbt.p"));
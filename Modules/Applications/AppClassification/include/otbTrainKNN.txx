@@ -66,8 +66,7 @@ namespace Wrapper
     typedef otb::KNearestNeighborsMachineLearningModel<InputValueType, OutputValueType> KNNType;
     typename KNNType::Pointer knnClassifier = KNNType::New();
     knnClassifier->SetRegressionMode(this->m_RegressionFlag);
-    knnClassifier->SetInputListSample(trainingListSample);
-    knnClassifier->SetTargetListSample(trainingLabeledListSample);
+    this->SetTrainingSamples(knnClassifier, trainingListSample, trainingLabeledListSample);
     knnClassifier->SetK(GetParameterInt("classifier.knn.k"));
     if (this->m_RegressionFlag)
       {
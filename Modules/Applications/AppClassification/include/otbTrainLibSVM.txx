@@ -133,8 +133,7 @@ namespace Wrapper
     typedef otb::LibSVMMachineLearningModel<InputValueType, OutputValueType> LibSVMType;
     typename LibSVMType::Pointer libSVMClassifier = LibSVMType::New();
     libSVMClassifier->SetRegressionMode(this->m_RegressionFlag);
-    libSVMClassifier->SetInputListSample(trainingListSample);
-    libSVMClassifier->SetTargetListSample(trainingLabeledListSample);
+    this->SetTrainingSamples(libSVMClassifier, trainingListSample, trainingLabeledListSample);
     //SVM Option
     //TODO : Add other options ?
     if (IsParameterEnabled("classifier.libsvm.opt"))
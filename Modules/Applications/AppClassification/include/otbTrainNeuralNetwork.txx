@@ -156,6 +156,35 @@ LearningApplicationBase<TInputValue,TOutputValue>
   SetParameterDescription("classifier.ann.iter",
     "Maximum number of iterations used in the Termination criteria.");
 
+  //BatchSize
+  AddParameter(ParameterType_Int, "classifier.ann.batch",
+    "Number of samples of the training batches");
+  SetParameterInt("classifier.ann.batch",0, false);
+  SetMinimumParameterIntValue("classifier.ann.batch", 0);
+  SetParameterDescription("classifier.ann.batch",
+    "If not null, the network is trained by mini-batches: at each epoch, "
+    "the samples are shuffled and the weights are updated batch by batch. "
+    "This bounds the memory used by the training. 0 means that the network "
+    "is trained on all the samples at once (default = 0).");
+
+  //NumberOfEpochs
+  AddParameter(ParameterType_Int, "classifier.ann.epochs",
+    "Number of epochs of the batch training");
+  SetParameterInt("classifier.ann.epochs",10, false);
+  SetMinimumParameterIntValue("classifier.ann.epochs", 1);
+  SetParameterDescription("classifier.ann.epochs",
+    "Number of passes over all the training batches, when training by "
+    "batches (default = 10).");
+
+  //BatchMaxIter
+  AddParameter(ParameterType_Int, "classifier.ann.batchiter",
+    "Maximum number of iterations on each batch");
+  SetParameterInt("classifier.ann.batchiter",5, false);
+  SetMinimumParameterIntValue("classifier.ann.batchiter", 1);
+  SetParameterDescription("classifier.ann.batchiter",
+    "Maximum number of iterations of the training on each batch, used "
+    "instead of classifier.ann.iter when training by batches (default = 5).");
+
 }
 
 template <class TInputValue, class TOutputValue>
@@ -168,8 +197,7 @@ LearningApplicationBase<TInputValue,TOutputValue>
   typedef otb::NeuralNetworkMachineLearningModel<InputValueType, OutputValueType> NeuralNetworkType;
   typename NeuralNetworkType::Pointer classifier = NeuralNetworkType::New();
   classifier->SetRegressionMode(this->m_RegressionFlag);
-  classifier->SetInputListSample(trainingListSample);
-  classifier->SetTargetListSample(trainingLabeledListSample);
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
 
   switch (GetParameterInt("classifier.ann.t"))
     {
@@ -188,7 +216,9 @@ LearningApplicationBase<TInputValue,TOutputValue>
   std::vector<std::string> sizes = GetParameterStringList("classifier.ann.sizes");
 
 
-  unsigned int nbImageBands = trainingListSample->GetMeasurementVectorSize();
+  unsigned int nbImageBands = this->m_TrainingSampleStore.IsNotNull()
+    ? this->m_TrainingSampleStore->GetNumberOfFeatures()
+    : trainingListSample->GetMeasurementVectorSize();
   layerSizes.push_back(nbImageBands);
   for (unsigned int i = 0; i < sizes.size(); i++)
     {
@@ -205,11 +235,19 @@ LearningApplicationBase<TInputValue,TOutputValue>
   else
     {
     std::set<TargetValueType> labelSet;
-    TargetSampleType currentLabel;
-    for (unsigned int itLab = 0; itLab < trainingLabeledListSample->Size(); ++itLab)
+    if (this->m_TrainingSampleStore.IsNotNull())
+      {
+      labelSet.insert(this->m_TrainingSampleStore->GetLabels().begin(),
+                      this->m_TrainingSampleStore->GetLabels().end());
+      }
+    else
       {
-      currentLabel = trainingLabeledListSample->GetMeasurementVector(itLab);
-      labelSet.insert(currentLabel[0]);
+      TargetSampleType currentLabel;
+      for (unsigned int itLab = 0; itLab < trainingLabeledListSample->Size(); ++itLab)
+        {
+        currentLabel = trainingLabeledListSample->GetMeasurementVector(itLab);
+        labelSet.insert(currentLabel[0]);
+        }
       }
     nbClasses = labelSet.size();
     layerSizes.push_back(nbClasses);
@@ -257,6 +295,9 @@ LearningApplicationBase<TInputValue,TOutputValue>
     }
   classifier->SetEpsilon(GetParameterFloat("classifier.ann.eps"));
   classifier->SetMaxIter(GetParameterInt("classifier.ann.iter"));
+  classifier->SetBatchSize(GetParameterInt("classifier.ann.batch"));
+  classifier->SetNumberOfEpochs(GetParameterInt("classifier.ann.epochs"));
+  classifier->SetBatchMaxIter(GetParameterInt("classifier.ann.batchiter"));
   classifier->Train();
   classifier->Save(modelPath);
 }
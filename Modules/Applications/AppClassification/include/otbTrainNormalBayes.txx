@@ -49,8 +49,7 @@ namespace Wrapper
     typedef otb::NormalBayesMachineLearningModel<InputValueType, OutputValueType> NormalBayesType;
     typename NormalBayesType::Pointer classifier = NormalBayesType::New();
     classifier->SetRegressionMode(this->m_RegressionFlag);
-    classifier->SetInputListSample(trainingListSample);
-    classifier->SetTargetListSample(trainingLabeledListSample);
+    this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
     classifier->Train();
     classifier->Save(modelPath);
   }
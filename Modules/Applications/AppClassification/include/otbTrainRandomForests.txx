@@ -114,8 +114,7 @@ LearningApplicationBase<TInputValue,TOutputValue>
   typedef otb::RandomForestsMachineLearningModel<InputValueType, OutputValueType> RandomForestType;
   typename RandomForestType::Pointer classifier = RandomForestType::New();
   classifier->SetRegressionMode(this->m_RegressionFlag);
-  classifier->SetInputListSample(trainingListSample);
-  classifier->SetTargetListSample(trainingLabeledListSample);
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
   classifier->SetMaxDepth(GetParameterInt("classifier.rf.max"));
   classifier->SetMinSampleCount(GetParameterInt("classifier.rf.min"));
   classifier->SetRegressionAccuracy(GetParameterFloat("classifier.rf.ra"));
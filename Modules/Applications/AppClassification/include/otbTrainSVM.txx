@@ -138,8 +138,7 @@ namespace Wrapper
     typedef otb::SVMMachineLearningModel<InputValueType, OutputValueType> SVMType;
     typename SVMType::Pointer SVMClassifier = SVMType::New();
     SVMClassifier->SetRegressionMode(this->m_RegressionFlag);
-    SVMClassifier->SetInputListSample(trainingListSample);
-    SVMClassifier->SetTargetListSample(trainingLabeledListSample);
+    this->SetTrainingSamples(SVMClassifier, trainingListSample, trainingLabeledListSample);
     switch (GetParameterInt("classifier.svm.k"))
       {
       case 0: // LINEAR
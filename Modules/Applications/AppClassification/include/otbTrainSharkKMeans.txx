@@ -49,6 +49,16 @@ void LearningApplicationBase<TInputValue, TOutputValue>::InitSharkKMeansParams()
   SetParameterDescription( "classifier.sharkkm.k",
                            "The number of class used for the kmeans algorithm. Default set to 2 class" );
   SetMinimumParameterIntValue( "classifier.sharkkm.k", 2 );
+
+  //BatchSize
+  AddParameter( ParameterType_Int, "classifier.sharkkm.batch",
+                "Number of samples of the batches of the mini-batch kmeans." );
+  SetParameterInt( "classifier.sharkkm.batch", 0 );
+  SetMinimumParameterIntValue( "classifier.sharkkm.batch", 0 );
+  SetParameterDescription( "classifier.sharkkm.batch",
+                           "If not null, the centroids are updated batch by batch (mini-batch kmeans), "
+                           "the maximum number of iterations being the number of passes over the samples. "
+                           "The samples are then not copied for the training. 0=standard kmeans" );
 }
 
 template<class TInputValue, class TOutputValue>
@@ -62,10 +72,10 @@ void LearningApplicationBase<TInputValue, TOutputValue>::TrainSharkKMeans(
   typedef otb::SharkKMeansMachineLearningModel<InputValueType, OutputValueType> SharkKMeansType;
   typename SharkKMeansType::Pointer classifier = SharkKMeansType::New();
   classifier->SetRegressionMode( this->m_RegressionFlag );
-  classifier->SetInputListSample( trainingListSample );
-  classifier->SetTargetListSample( trainingLabeledListSample );
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
   classifier->SetK( k );
   classifier->SetMaximumNumberOfIterations( nbMaxIter );
+  classifier->SetBatchSize( static_cast<unsigned long>(GetParameterInt( "classifier.sharkkm.batch" )) );
   classifier->Train();
   classifier->Save( modelPath );
 }
@@ -87,8 +87,7 @@ LearningApplicationBase<TInputValue,TOutputValue>
   typedef otb::SharkRandomForestsMachineLearningModel<InputValueType, OutputValueType> SharkRandomForestType;
   typename SharkRandomForestType::Pointer classifier = SharkRandomForestType::New();
   classifier->SetRegressionMode(this->m_RegressionFlag);
-  classifier->SetInputListSample(trainingListSample);
-  classifier->SetTargetListSample(trainingLabeledListSample);
+  this->SetTrainingSamples(classifier, trainingListSample, trainingLabeledListSample);
   classifier->SetNodeSize(GetParameterInt("classifier.sharkrf.nodesize"));
   classifier->SetOobRatio(GetParameterFloat("classifier.sharkrf.oobr"));
   classifier->SetNumberOfTrees(GetParameterInt("classifier.sharkrf.nbtrees"));
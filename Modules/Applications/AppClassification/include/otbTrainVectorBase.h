@@ -32,7 +32,6 @@
 #include "otbStatisticsXMLFileReader.h"
 
 #include "itkListSample.h"
-#include "otbShiftScaleSampleListFilter.h"
 
 #include <algorithm>
 #include <locale>
@@ -63,14 +62,13 @@ public:
   typedef Superclass::SampleType SampleType;
   typedef Superclass::ListSampleType ListSampleType;
   typedef Superclass::TargetListSampleType TargetListSampleType;
+  typedef Superclass::SampleStoreType SampleStoreType;
 
   typedef double ValueType;
   typedef itk::VariableLengthVector <ValueType> MeasurementType;
 
   typedef otb::StatisticsXMLFileReader<SampleType> StatisticsReader;
 
-  typedef otb::Statistics::ShiftScaleSampleListFilter<ListSampleType, ListSampleType> ShiftScaleFilterType;
-
 protected:
 
   /** Class used to store statistics Measurment (mean/stddev) */
@@ -81,16 +79,15 @@ protected:
     MeasurementType stddevMeasurementVector;
   };
 
-  /** Class used to store a list of sample and the corresponding label */
+  /** Class used to store samples and the corresponding labels */
   class SamplesWithLabel
   {
   public:
-    ListSampleType::Pointer listSample;
-    TargetListSampleType::Pointer labeledListSample;
+    /** Samples and labels, the labels being only kept in the store */
+    SampleStoreType::Pointer sampleStore;
     SamplesWithLabel()
     {
-      listSample = ListSampleType::New();
-      labeledListSample = TargetListSampleType::New();
+      sampleStore = SampleStoreType::New();
     }
   };
 
@@ -162,7 +159,7 @@ protected:
    * \param parameterLayer the name of the layer option in the input application parameters
    * \param measurement statics measurement (mean/stddev)
    * \param nbFeatures the number of features.
-   * \return the list of samples and their corresponding labels.
+   * \return the samples, centered and reduced, and their corresponding labels.
    */
   SamplesWithLabel
   ExtractSamplesWithLabel(std::string parameterName, std::string parameterLayer, const ShiftScaleParameters &measurement);
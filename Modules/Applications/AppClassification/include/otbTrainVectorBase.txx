@@ -159,10 +159,12 @@ void TrainVectorBase::DoExecute()
   ShiftScaleParameters measurement = GetStatistics( m_FeaturesInfo.m_NbFeatures );
   ExtractAllSamples( measurement );
 
-  this->Train( m_TrainingSamplesWithLabel.listSample, m_TrainingSamplesWithLabel.labeledListSample, GetParameterString( "io.out" ) );
+  // The models read the training samples and labels from the store
+  this->m_TrainingSampleStore = m_TrainingSamplesWithLabel.sampleStore.GetPointer();
+  this->Train( ListSampleType::Pointer(), TargetListSampleType::Pointer(), GetParameterString( "io.out" ) );
 
   m_PredictedList =
-    this->Classify( m_ClassificationSamplesWithLabel.listSample, GetParameterString( "io.out" ) );
+    this->Classify( m_ClassificationSamplesWithLabel.sampleStore.GetPointer(), GetParameterString( "io.out" ) );
 }
 
 
@@ -175,7 +177,12 @@ void TrainVectorBase::ExtractAllSamples(const ShiftScaleParameters &measurement)
 TrainVectorBase::SamplesWithLabel
 TrainVectorBase::ExtractTrainingSamplesWithLabel(const ShiftScaleParameters &measurement)
 {
-  return ExtractSamplesWithLabel( "io.vd", "layer", measurement);
+  SamplesWithLabel trainingSamplesWithLabel = ExtractSamplesWithLabel( "io.vd", "layer", measurement );
+  if( trainingSamplesWithLabel.sampleStore->Size() == 0 )
+    {
+    otbAppLogFATAL( "No sample found in io.vd" );
+    }
+  return trainingSamplesWithLabel;
 }
 
 TrainVectorBase::SamplesWithLabel
@@ -186,17 +193,15 @@ TrainVectorBase::ExtractClassificationSamplesWithLabel(const ShiftScaleParameter
     SamplesWithLabel tmpSamplesWithLabel;
     SamplesWithLabel validationSamplesWithLabel = ExtractSamplesWithLabel( "valid.vd", "valid.layer", measurement );
     //Test the input validation set size
-    if( validationSamplesWithLabel.labeledListSample->Size() != 0 )
+    if( validationSamplesWithLabel.sampleStore->Size() != 0 )
       {
-      tmpSamplesWithLabel.listSample = validationSamplesWithLabel.listSample;
-      tmpSamplesWithLabel.labeledListSample = validationSamplesWithLabel.labeledListSample;
+      tmpSamplesWithLabel.sampleStore = validationSamplesWithLabel.sampleStore;
       }
     else
       {
       otbAppLogWARNING(
               "The validation set is empty. The performance estimation is done using the input training set in this case." );
-      tmpSamplesWithLabel.listSample = m_TrainingSamplesWithLabel.listSample;
-      tmpSamplesWithLabel.labeledListSample = m_TrainingSamplesWithLabel.labeledListSample;
+      tmpSamplesWithLabel.sampleStore = m_TrainingSamplesWithLabel.sampleStore;
       }
 
     return tmpSamplesWithLabel;
@@ -238,9 +243,9 @@ TrainVectorBase::ExtractSamplesWithLabel(std::string parameterName, std::string
   SamplesWithLabel samplesWithLabel;
   if( HasValue( parameterName ) && IsParameterEnabled( parameterName ) )
     {
-    ListSampleType::Pointer input = ListSampleType::New();
-    TargetListSampleType::Pointer target = TargetListSampleType::New();
-    input->SetMeasurementVectorSize( m_FeaturesInfo.m_NbFeatures );
+    // The samples are read directly in a contiguous store
+    SampleStoreType::Pointer input = SampleStoreType::New();
+    input->SetNumberOfFeatures( m_FeaturesInfo.m_NbFeatures );
 
     std::vector<std::string> fileList = this->GetParameterStringList( parameterName );
     for( unsigned int k = 0; k < fileList.size(); k++ )
@@ -281,18 +286,14 @@ TrainVectorBase::ExtractSamplesWithLabel(std::string parameterName, std::string
 
       while( goesOn )
         {
+        TargetValueType label = 0;
+        if(cFieldIndex>=0 && ogr::Field(feature,cFieldIndex).HasBeenSet())
+          label = feature.ogr().GetFieldAsInteger( cFieldIndex );
+
         // Retrieve all the features for each field in the ogr layer.
-        MeasurementType mv;
-        mv.SetSize( m_FeaturesInfo.m_NbFeatures );
+        InputValueType * mv = input->AddSample( label );
         for( unsigned int idx = 0; idx < m_FeaturesInfo.m_NbFeatures; ++idx )
-          mv[idx] = feature.ogr().GetFieldAsDouble( featureFieldIndex[idx] );
-
-        input->PushBack( mv );
-
-        if(cFieldIndex>=0 && ogr::Field(feature,cFieldIndex).HasBeenSet())
-          target->PushBack( feature.ogr().GetFieldAsInteger( cFieldIndex ) );
-        else
-          target->PushBack( 0 );
+          mv[idx] = static_cast<InputValueType>( feature.ogr().GetFieldAsDouble( featureFieldIndex[idx] ) );
 
         feature = layer.ogr().GetNextFeature();
         goesOn = feature.addr() != 0;
@@ -301,15 +302,25 @@ TrainVectorBase::ExtractSamplesWithLabel(std::string parameterName, std::string
 
 
 
-    ShiftScaleFilterType::Pointer shiftScaleFilter = ShiftScaleFilterType::New();
-    shiftScaleFilter->SetInput( input );
-    shiftScaleFilter->SetShifts( measurement.meanMeasurementVector );
-    shiftScaleFilter->SetScales( measurement.stddevMeasurementVector );
-    shiftScaleFilter->Update();
+    if( measurement.meanMeasurementVector.Size() != m_FeaturesInfo.m_NbFeatures
+        || measurement.stddevMeasurementVector.Size() != m_FeaturesInfo.m_NbFeatures )
+      {
+      otbAppLogFATAL( "Inconsistent statistics: " << m_FeaturesInfo.m_NbFeatures << " features, "
+                      << measurement.meanMeasurementVector.Size() << " means and "
+                      << measurement.stddevMeasurementVector.Size() << " standard deviations" );
+      }
+
+    // Center and reduce the samples in place
+    std::vector<InputValueType> shifts( m_FeaturesInfo.m_NbFeatures );
+    std::vector<InputValueType> scales( m_FeaturesInfo.m_NbFeatures );
+    for( unsigned int idx = 0; idx < m_FeaturesInfo.m_NbFeatures; ++idx )
+      {
+      shifts[idx] = static_cast<InputValueType>( measurement.meanMeasurementVector[idx] );
+      scales[idx] = static_cast<InputValueType>( measurement.stddevMeasurementVector[idx] );
+      }
+    input->ShiftScale( &shifts[0], &scales[0] );
 
-    samplesWithLabel.listSample = shiftScaleFilter->GetOutput();
-    samplesWithLabel.labeledListSample = target;
-    samplesWithLabel.listSample->DisconnectPipeline();
+    samplesWithLabel.sampleStore = input;
     }
 
   return samplesWithLabel;
@@ -29,6 +29,7 @@
 #include "otbImageToSIFTKeyPointSetFilter.h"
 #endif
 #include "otbImageToSURFKeyPointSetFilter.h"
+#include "otbStreamingImageToKeyPointSetFilter.h"
 #include "otbKeyPointSetsMatchingFilter.h"
 #include "otbMultiToMonoChannelExtractROI.h"
 #include "otbKeyPointSetsMatchingFilter.h"
@@ -140,11 +141,30 @@ private:
     MandatoryOff("backmatching");
     DisableParameter("backmatching");
 
+    AddParameter(ParameterType_Int,"maxchecks","Maximum number of checks per search");
+    SetParameterDescription("maxchecks","Keypoints are matched using k-d trees. If set to 0, the search of the nearest neighbors is exact. Otherwise, it is approximate and checks at most this number of keypoints per search, which is much faster on large sets of keypoints.");
+    SetMinimumParameterIntValue("maxchecks",0);
+    SetDefaultParameterInt("maxchecks",0);
+    MandatoryOff("maxchecks");
+
     AddParameter(ParameterType_Choice,"mode","Keypoints search mode");
 
     AddChoice("mode.full","Extract and match all keypoints (no streaming)");
     SetParameterDescription("mode.full","Extract and match all keypoints, loading both images entirely into memory");
 
+    AddChoice("mode.tiles","Extract and match all keypoints, tile by tile");
+    SetParameterDescription("mode.tiles","Extract all keypoints by streaming the images tile by tile, the tiles being processed in parallel, and match them. Keypoints found twice close to the tile borders are discarded. Memory usage is bounded by the available RAM setting, which allows processing very large images.");
+
+    AddParameter(ParameterType_Int,"mode.tiles.tilesize","Size of tiles");
+    SetParameterDescription("mode.tiles.tilesize","Size of the tiles processed in parallel, in pixels");
+    SetDefaultParameterInt("mode.tiles.tilesize",512);
+    SetMinimumParameterIntValue("mode.tiles.tilesize",1);
+
+    AddParameter(ParameterType_Int,"mode.tiles.margin","Margin of tiles");
+    SetParameterDescription("mode.tiles.margin","Padding of the tiles in pixels, so that keypoints close to their borders are detected and described as in the whole image");
+    SetDefaultParameterInt("mode.tiles.margin",64);
+    SetMinimumParameterIntValue("mode.tiles.margin",0);
+
     AddChoice("mode.geobins","Search keypoints in small spatial bins regularly spread across first image");
     SetParameterDescription("mode.geobins","This method allows retrieving a set of tie points regulary spread across image 1. Corresponding bins in image 2 are retrieved using sensor and geographical information if available. The first bin position takes into account the margin parameter. Bins are cropped to the largest image region shrunk by the margin parameter for both in1 and in2 images.");
 
@@ -207,11 +227,64 @@ private:
 
   }
 
+  /** Extract the keypoints of an image tile by tile */
+  template <class TKeyPointFilter>
+  PointSetType::Pointer ExtractByTiles(FloatImageType * image, unsigned int nbThreads = 0)
+  {
+    typedef StreamingImageToKeyPointSetFilter<FloatImageType,TKeyPointFilter> ExtractorType;
+
+    typename ExtractorType::Pointer extractor = ExtractorType::New();
+    extractor->SetInput(image);
+    extractor->GetFilter()->SetTileSize(GetParameterInt("mode.tiles.tilesize"));
+    extractor->GetFilter()->SetMargin(GetParameterInt("mode.tiles.margin"));
+    if(nbThreads > 0)
+      {
+      extractor->GetFilter()->SetNumberOfThreads(nbThreads);
+      }
+    extractor->GetStreamer()->SetAutomaticTiledStreaming();
+
+    AddProcess(extractor->GetStreamer(),"Extracting keypoints");
+    extractor->Update();
+
+    PointSetType::Pointer keyPoints = extractor->GetOutputPointSet();
+    return keyPoints;
+  }
+
   void Match(FloatImageType * im1, FloatImageType * im2, RSTransformType * rsTransform, RSTransformType * rsTransform1ToWGS84,RSTransformType * rsTransform2ToWGS84, std::ofstream & file, OGRMultiLineString * mls = ITK_NULLPTR)
   {
     MatchingFilterType::Pointer matchingFilter = MatchingFilterType::New();
 
-    if(GetParameterString("algorithm")=="sift")
+    if(GetParameterString("mode")=="tiles")
+      {
+      PointSetType::Pointer keyPoints1, keyPoints2;
+
+      if(GetParameterString("algorithm")=="sift")
+        {
+        otbAppLogINFO("Using SIFT points");
+#ifdef OTB_USE_SIFTFAST
+        // siftfast is not thread safe
+        const unsigned int nbThreads = 1;
+#else
+        const unsigned int nbThreads = 0;
+#endif
+        keyPoints1 = ExtractByTiles<SiftFilterType>(im1,nbThreads);
+        keyPoints2 = ExtractByTiles<SiftFilterType>(im2,nbThreads);
+        }
+      else
+        {
+        keyPoints1 = ExtractByTiles<SurfFilterType>(im1);
+        keyPoints2 = ExtractByTiles<SurfFilterType>(im2);
+        matchingFilter->SetDistanceThreshold(GetParameterFloat("threshold"));
+        matchingFilter->SetUseBackMatching(IsParameterEnabled("backmatching"));
+        }
+
+      otbAppLogINFO("Found " << keyPoints1->GetNumberOfPoints()<<" points in image 1.");
+      otbAppLogINFO("Found " << keyPoints2->GetNumberOfPoints()<<" points in image 2.");
+
+      matchingFilter->SetInput1(keyPoints1);
+      matchingFilter->SetInput2(keyPoints2);
+      }
+    else if(GetParameterString("algorithm")=="sift")
       {
       otbAppLogINFO("Using SIFT points");
       SiftFilterType::Pointer sift1 = SiftFilterType::New();
@@ -254,6 +327,11 @@ private:
       matchingFilter->SetUseBackMatching(IsParameterEnabled("backmatching"));
       }
 
+    // The distance is the Euclidean one, so that the indexed search gives
+    // the same matches as the linear scan when it is exact
+    matchingFilter->SetUseIndexedSearch(true);
+    matchingFilter->SetMaximumNumberOfChecks(GetParameterInt("maxchecks"));
+
     try
       {
 
@@ -371,7 +449,7 @@ private:
     rsTransform2ToWGS84->InstantiateTransform();
 
 
-    if(GetParameterString("mode")=="full")
+    if(GetParameterString("mode")=="full" || GetParameterString("mode")=="tiles")
       {
       // Launch detection on whole images
       Match(extractChannel1->GetOutput(),extractChannel2->GetOutput(),rsTransform,rsTransform1ToWGS84,rsTransform2ToWGS84,file,&mls);
@@ -109,6 +109,15 @@ private:
       "etc."
     );
 
+    AddParameter( ParameterType_Empty, "vectorized", "Vectorized evaluation");
+    SetParameterDescription(
+      "vectorized",
+      "Evaluate the expression over whole rows of pixels, which is faster. "
+      "Expressions that can not be vectorized are evaluated pixel by pixel. "
+      "Results differ from the default evaluation by rounding errors only."
+    );
+    MandatoryOff( "vectorized" );
+
     // Doc example parameter settings
     SetDocExampleParameterValue(
       "il",
@@ -242,6 +251,7 @@ private:
       }
 
     m_Filter->SetExpression(GetParameterString("exp"));
+    m_Filter->SetVectorizedEvaluation(IsParameterEnabled("vectorized"));
 
     // Set the output image
     SetParameterOutputImage("out", m_Filter->GetOutput());
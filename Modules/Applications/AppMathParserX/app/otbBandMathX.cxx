@@ -262,6 +262,15 @@ private:
     );
     MandatoryOff( "outcontext" );
 
+    AddParameter( ParameterType_Empty, "vectorized", "Vectorized evaluation" );
+    SetParameterDescription(
+      "vectorized",
+      "Evaluate scalar expressions over whole rows of pixels, which is faster. "
+      "Expressions that can not be vectorized are evaluated pixel by pixel. "
+      "Results differ from the default evaluation by rounding errors only."
+    );
+    MandatoryOff( "vectorized" );
+
     // Doc example parameter settings
     SetDocExampleParameterValue(
       "il",
@@ -417,6 +426,8 @@ private:
       m_Filter->SetExpression(expStr);
       }
 
+    m_Filter->SetVectorizedEvaluation(IsParameterEnabled("vectorized"));
+
     if ( IsParameterEnabled("outcontext") && HasValue("outcontext") )
       m_Filter->ExportContext(GetParameterString("outcontext"));
 
@@ -229,6 +229,23 @@ private:
                             "but increasing this parameter will reduce processing time.");
     MandatoryOff("opt.gridspacing");
 
+    // Displacement Field maximum error
+    AddParameter(ParameterType_Float, "opt.griderror", "Resampling grid maximum error");
+    SetDefaultParameterFloat("opt.griderror", 0.1);
+    SetParameterDescription("opt.griderror",
+                            "If enabled, the deformation grid spacing is estimated (and opt.gridspacing ignored) "
+                            "so that the bilinear interpolation of the deformation grid stays within "
+                            "this error, expressed in input pixels.");
+    DisableParameter("opt.griderror");
+    MandatoryOff("opt.griderror");
+
+    // Line by line interpolation of the deformation grid
+    AddParameter(ParameterType_Empty, "opt.incremental", "Incremental grid interpolation");
+    SetParameterDescription("opt.incremental",
+                            "Interpolate the deformation grid line by line, which is faster. "
+                            "Results differ from the default interpolation by rounding errors only.");
+    MandatoryOff("opt.incremental");
+
     // Doc example parameter settings
     SetDocExampleParameterValue("io.in", "QB_TOULOUSE_MUL_Extract_500_500.tif");
     SetDocExampleParameterValue("io.out","QB_Toulouse_ortho.tif");
@@ -732,6 +749,19 @@ private:
       m_ResampleFilter->SetDisplacementFieldSpacing(gridSpacing);
       }
 
+    if (IsParameterEnabled("opt.griderror"))
+      {
+      if (GetParameterFloat("opt.griderror") <= 0)
+        {
+        otbAppLogFATAL("opt.griderror must be strictly positive");
+        }
+      otbAppLogINFO("Estimating the deformation grid spacing for a maximum error of "
+                    << GetParameterFloat("opt.griderror") << " input pixels");
+      m_ResampleFilter->SetDisplacementFieldMaximumError(GetParameterFloat("opt.griderror"));
+      }
+
+    m_ResampleFilter->SetIncrementalWarping(IsParameterEnabled("opt.incremental"));
+
     // Output Image
     SetParameterOutputImage("io.out", m_ResampleFilter->GetOutput());
     }
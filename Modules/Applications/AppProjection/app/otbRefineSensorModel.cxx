@@ -129,13 +129,14 @@ private:
     ifs.open(GetParameterString("inpoints").c_str());
 
   TiePointsType tiepoints;
+  std::vector<DEMHandler::PointType> geoPoints;
 
   while(!ifs.eof())
     {
     std::string line;
     std::getline(ifs,line);
 
-    double x,y,z,lat,lon;
+    double x,y,lat,lon;
 
     // Avoid commented lines or too short ones
     if (!line.empty() && line[0] != '#')
@@ -154,26 +155,40 @@ private:
       nextpos = line.find_first_of("\t", pos);
       lat = atof(line.substr(pos, nextpos).c_str());
 
-      z = otb::DEMHandler::Instance()->GetHeightAboveEllipsoid(lon,lat);
-
-      otbAppLogINFO("Adding tie point x="<<x<<", y="<<y<<", z="<<z<<", lon="<<lon<<", lat="<<lat);
-
-      sm->AddTiePoint(x,y,z,lon,lat);
-
       PointType p1,p2;
       p1[0]=x;
       p1[1]=y;
-      p1[2]=z;
+      p1[2]=0;
       p2[0]=lon;
       p2[1]=lat;
-      p2[2]=z;
+      p2[2]=0;
 
       tiepoints.push_back(std::make_pair(p1,p2));
 
+      DEMHandler::PointType geoPoint;
+      geoPoint[0]=lon;
+      geoPoint[1]=lat;
+      geoPoints.push_back(geoPoint);
       }
     }
   ifs.close();
 
+  // Get the elevations of all tie points at once
+  std::vector<double> heights;
+  otb::DEMHandler::Instance()->GetHeightAboveEllipsoid(geoPoints,heights);
+
+  for(unsigned int i = 0; i < tiepoints.size(); ++i)
+    {
+    PointType & p1 = tiepoints[i].first;
+    PointType & p2 = tiepoints[i].second;
+    p1[2] = heights[i];
+    p2[2] = heights[i];
+
+    otbAppLogINFO("Adding tie point x="<<p1[0]<<", y="<<p1[1]<<", z="<<p1[2]<<", lon="<<p2[0]<<", lat="<<p2[1]);
+
+    sm->AddTiePoint(p1[0],p1[1],p1[2],p2[0],p2[1]);
+    }
+
   otbAppLogINFO("Optimization in progress ...");
   sm->Optimize();
   otbAppLogINFO("Done.\n");
@@ -22,16 +22,15 @@
 #include "otbMultiChannelExtractROI.h"
 #include "otbExtractROI.h"
 
-#include "otbStreamingStatisticsImageFilter.h"
 #include "otbSystem.h"
 #include "itkUnaryFunctorImageFilter.h"
-#include "itkChangeLabelImageFilter.h"
-
-#include "otbTileImageFilter.h"
+#include "otbRGBAPixelConverter.h"
 
 #include <time.h>
 #include <vcl_algorithm.h>
+#include <algorithm>
 #include <climits>
+#include <vector>
 
 #include "otbWrapperApplication.h"
 #include "otbWrapperApplicationFactory.h"
@@ -43,6 +42,47 @@ namespace otb
 {
 namespace Wrapper
 {
+
+namespace Functor
+{
+/** Relabel pixels through a look-up table indexed by the input label */
+template <class TLabel>
+class LabelLUTFunctor
+{
+public:
+  typedef std::vector<TLabel> LUTType;
+
+  LabelLUTFunctor() : m_LUT(ITK_NULLPTR) {}
+
+  void SetLUT(const LUTType * lut)
+  {
+    m_LUT = lut;
+  }
+
+  bool operator!=(const LabelLUTFunctor & other) const
+  {
+    return m_LUT != other.m_LUT;
+  }
+
+  bool operator==(const LabelLUTFunctor & other) const
+  {
+    return !(*this != other);
+  }
+
+  inline TLabel operator()(const TLabel & label) const
+  {
+    if (m_LUT != ITK_NULLPTR && label < m_LUT->size())
+      {
+      return (*m_LUT)[label];
+      }
+    return label;
+  }
+
+private:
+  const LUTType * m_LUT;
+};
+} // end namespace Functor
+
 class LSMSSmallRegionsMerging : public Application
 {
 public:
@@ -59,20 +99,49 @@ public:
   typedef otb::MultiChannelExtractROI <ImagePixelType,ImagePixelType > MultiChannelExtractROIFilterType;
   typedef otb::ExtractROI<LabelImagePixelType,LabelImagePixelType> ExtractROIFilterType;
 
-  typedef otb::StreamingStatisticsImageFilter<LabelImageType> StatisticsImageFilterType;
-
-  typedef itk::ImageRegionConstIterator<LabelImageType> LabelImageIterator;
   typedef itk::ImageRegionConstIterator<ImageType> ImageIterator;
 
-  typedef itk::ChangeLabelImageFilter<LabelImageType,LabelImageType> ChangeLabelImageFilterType;
-  typedef otb::TileImageFilter<LabelImageType> TileImageFilterType;
+  typedef Functor::LabelLUTFunctor<LabelImagePixelType> LabelLUTFunctorType;
+  typedef itk::UnaryFunctorImageFilter<LabelImageType,LabelImageType,LabelLUTFunctorType> ChangeLabelImageFilterType;
 
   itkNewMacro(Self);
   itkTypeMacro(Merging, otb::Application);
 
 private:
+  typedef std::vector<LabelImagePixelType> LabelVectorType;
+  /** Adjacency between two labels, packed as (smallest label, largest label) */
+  typedef unsigned long long               EdgeType;
+
   ChangeLabelImageFilterType::Pointer m_ChangeLabelFilter;
 
+  /** Number of pixels and sum of the pixel values of each region */
+  std::vector<unsigned int>   m_NbPixels;
+  std::vector<ImagePixelType> m_Sums;
+  unsigned int                m_NumberOfComponents;
+
+  /** Bounding box of each region, as (min x, max x, min y, max y) */
+  std::vector<unsigned long>  m_BoundingBoxes;
+
+  /** Image and tile sizes, which define the regions merged at each pass */
+  unsigned long m_SizeImageX;
+  unsigned long m_SizeImageY;
+  unsigned long m_SizeTilesX;
+  unsigned long m_SizeTilesY;
+
+  /** Region adjacency graph of the input labels, in compressed sparse row
+   *  format: the neighbors of label l are m_Adjacency[m_AdjacencyOffsets[l]]
+   *  to m_Adjacency[m_AdjacencyOffsets[l+1]-1] */
+  std::vector<unsigned long> m_AdjacencyOffsets;
+  LabelVectorType            m_Adjacency;
+
+  /** Union-find forest of the merged regions (the root of a region is its
+   *  smallest label), used as final relabelling LUT */
+  LabelVectorType m_LUT;
+
+  /** Linked lists of the input labels forming each merged region */
+  LabelVectorType m_NextMember;
+  LabelVectorType m_LastMember;
+
   void DoInit() ITK_OVERRIDE
   {
     SetName("LSMSSmallRegionsMerging");
@@ -89,7 +158,10 @@ private:
                           " segments, then all segments of area equal to 2 pixels will be processed,"
                           " until segments of area minsize. For large images one can use the"
                           " tilesizex and tilesizey parameters for tile-wise processing, with the"
-                          " guarantees of identical results.\n\n"
+                          " guarantees of identical results. The input images are read only once,"
+                          " tile by tile, to build the adjacency graph of the segments, and the"
+                          " merging of each tile is done on this graph. Tiles larger than the"
+                          " available RAM (ram parameter) are read in several strips of lines.\n\n"
                           "The output of this application can be passed to the"
                           " LSMSVectorization application [3] to complete the LSMS workflow.");
     SetDocLimitations("This application is part of the Large-Scale Mean-Shift segmentation"
@@ -160,287 +232,421 @@ private:
     //Acquisition of the input image dimensions
     ImageType::Pointer imageIn = GetParameterImage("in");
     imageIn->UpdateOutputInformation();
-    unsigned long sizeImageX = imageIn->GetLargestPossibleRegion().GetSize()[0],
-      sizeImageY = imageIn->GetLargestPossibleRegion().GetSize()[1];
-    unsigned int numberOfComponentsPerPixel = imageIn->GetNumberOfComponentsPerPixel();
+    m_NumberOfComponents = imageIn->GetNumberOfComponentsPerPixel();
 
     LabelImageType::Pointer labelIn = GetParameterUInt32Image("inseg");
+    labelIn->UpdateOutputInformation();
+
+    //Number of lines of a tile read at once, so that the input and label
+    //buffers fit in the available RAM
+    const unsigned long availableRAM = static_cast<unsigned long>(GetParameterInt("ram")) * 1024UL * 1024UL;
+    const unsigned long bytesPerLine = vcl_min(sizeTilesX+1, static_cast<unsigned long>(imageIn->GetLargestPossibleRegion().GetSize()[0]))
+      * (m_NumberOfComponents*sizeof(ImagePixelType) + sizeof(LabelImagePixelType));
+    const unsigned long linesPerRead = vcl_max(1UL, availableRAM / bytesPerLine);
 
-    StatisticsImageFilterType::Pointer stats = StatisticsImageFilterType::New();
-    stats->SetInput(labelIn);
-    stats->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
-    AddProcess(stats->GetStreamer(), "Retrieve region count...");
-    stats->Update();
-    unsigned int regionCount=stats->GetMaximum();
+    //Region statistics and adjacency graph, in a single pass over the tiles
+    otbAppLogINFO(<<"Building region adjacency graph ...");
+    BuildRegionAdjacencyGraph(imageIn, labelIn, sizeTilesX, sizeTilesY, linesPerRead);
+    otbAppLogINFO(<<"Number of labels: "<<m_NbPixels.size()<<", number of adjacencies: "<<m_Adjacency.size()/2);
 
-    std::vector<unsigned int>nbPixels;
-    nbPixels.clear();
-    nbPixels.resize(regionCount+1);
-    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      nbPixels[curLabel] = 0;
+    //Minimal size region suppression, on the graph
+    otbAppLogINFO(<<"Building LUT for small regions merging ...");
+    MergeSmallRegions(minSize);
 
-    ImageType::PixelType defaultValue(numberOfComponentsPerPixel);
-    defaultValue.Fill(0);
+    // The graph is not needed anymore, only the LUT is used by the output
+    std::vector<unsigned int>().swap(m_NbPixels);
+    std::vector<ImagePixelType>().swap(m_Sums);
+    std::vector<unsigned long>().swap(m_BoundingBoxes);
+    std::vector<unsigned long>().swap(m_AdjacencyOffsets);
+    LabelVectorType().swap(m_Adjacency);
+    LabelVectorType().swap(m_NextMember);
+    LabelVectorType().swap(m_LastMember);
 
-    std::vector<ImageType::PixelType>sum(regionCount+1,defaultValue);
+    //Relabelling
+    m_ChangeLabelFilter = ChangeLabelImageFilterType::New();
+    m_ChangeLabelFilter->SetInput(labelIn);
+    m_ChangeLabelFilter->GetFunctor().SetLUT(&m_LUT);
+
+    SetParameterOutputImage("out", m_ChangeLabelFilter->GetOutput());
+
+    clock_t toc = clock();
+
+    otbAppLogINFO(<<"Elapsed time: "<<(double)(toc - tic) / CLOCKS_PER_SEC<<" seconds");
+  }
+
+  /** Read the label and input images tile by tile, accumulate the number of
+   *  pixels and the sum of each region, and collect the pairs of 4-adjacent
+   *  labels. Each tile is read in strips of at most linesPerRead lines, in
+   *  the order of the tile-wise processing. Label strips are read with one
+   *  extra column and row so that adjacencies across strips and tiles are
+   *  found. */
+  void BuildRegionAdjacencyGraph(ImageType * imageIn, LabelImageType * labelIn,
+                                 unsigned long sizeTilesX, unsigned long sizeTilesY,
+                                 unsigned long linesPerRead)
+  {
+    unsigned long sizeImageX = imageIn->GetLargestPossibleRegion().GetSize()[0],
+      sizeImageY = imageIn->GetLargestPossibleRegion().GetSize()[1];
+
+    m_SizeImageX = sizeImageX;
+    m_SizeImageY = sizeImageY;
+    m_SizeTilesX = sizeTilesX;
+    m_SizeTilesY = sizeTilesY;
 
     unsigned int nbTilesX = sizeImageX/sizeTilesX + (sizeImageX%sizeTilesX > 0 ? 1 : 0);
     unsigned int nbTilesY = sizeImageY/sizeTilesY + (sizeImageY%sizeTilesY > 0 ? 1 : 0);
 
     otbAppLogINFO(<<"Number of tiles: "<<nbTilesX<<" x "<<nbTilesY);
 
-    //Sums calculation per label
-    otbAppLogINFO(<<"Sums calculation ...");
+    m_NbPixels.clear();
+    m_Sums.clear();
+    m_BoundingBoxes.clear();
+
+    std::vector<EdgeType> edges, tileEdges;
+
+    // Setup fake reporter
+    RGBAPixelConverter<int,int>::Pointer dummyFilter =
+      RGBAPixelConverter<int,int>::New();
+    dummyFilter->SetProgress(0.0f);
+    this->AddProcess(dummyFilter,"Building region adjacency graph...");
+    dummyFilter->InvokeEvent(itk::StartEvent());
 
     for(unsigned int row = 0; row < nbTilesY; row++)
       for(unsigned int column = 0; column < nbTilesX; column++)
-       {
+        {
         unsigned long startX = column*sizeTilesX;
-        unsigned long startY = row*sizeTilesY;
+        unsigned long tileStartY = row*sizeTilesY;
         unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
-        unsigned long sizeY = vcl_min(sizeTilesY,sizeImageY-startY);
-
-        //Tiles extraction of the input image
-        MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
-        imageROI->SetInput(imageIn);
-        imageROI->SetStartX(startX);
-        imageROI->SetStartY(startY);
-        imageROI->SetSizeX(sizeX);
-        imageROI->SetSizeY(sizeY);
-        imageROI->Update();
-
-        //Tiles extraction of the segmented image
-        ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX);
-        labelImageROI->SetSizeY(sizeY);
-        labelImageROI->Update();
-
-        //Sums calculation for the mean calculation per label
-        LabelImageIterator itLabel( labelImageROI->GetOutput(), labelImageROI->GetOutput()->GetLargestPossibleRegion());
-        ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
-
-        for (itLabel.GoToBegin(), itImage.GoToBegin(); !itLabel.IsAtEnd(); ++itLabel, ++itImage)
-          {
-          nbPixels[itLabel.Value()]++;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-            {
-            sum[itLabel.Value()][comp]+=itImage.Get()[comp];
-            }
-          }
-        }
+        unsigned long tileSizeY = vcl_min(sizeTilesY,sizeImageY-tileStartY);
+        unsigned long labelSizeX = vcl_min(sizeTilesX+1,sizeImageX-startX);
 
-    //LUT creation for the final relabelling
-    std::vector<LabelImagePixelType> LUT;
-    LUT.clear();
-    LUT.resize(regionCount+1);
-    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      {
-      LUT[curLabel] = curLabel;
-      }
+        tileEdges.clear();
 
-    //Minimal size region suppression
-    otbAppLogINFO(<<"Building LUT for small regions merging ...");
-
-    for (unsigned int size=1; size<minSize; size++)
-      {
-      // LUTtmp creation in order to modify the LUT only at the end of the pass
-      std::vector<LabelImagePixelType> LUTtmp;
-      LUTtmp.clear();
-      LUTtmp.resize(regionCount+1);
-      for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-        {
-        LUTtmp[curLabel] = LUT[curLabel];
-        }
-
-      for(unsigned int row = 0; row < nbTilesY; row++)
-        {
-        for(unsigned int column = 0; column < nbTilesX; column++)
+        for(unsigned long startY = tileStartY; startY < tileStartY+tileSizeY; startY += linesPerRead)
           {
-          std::set<int> minLabel, edgeLabel, labelMerged;
-          std::map<int,std::set<int> > adjMap;
-
-          unsigned long startX = column*sizeTilesX, startY = row*sizeTilesY;
-          unsigned long sizeX = vcl_min(sizeTilesX+size+1,sizeImageX-startX),
-            sizeY = vcl_min(sizeTilesY+size+1,sizeImageY-startY);
-
+          unsigned long sizeY = vcl_min(linesPerRead,tileStartY+tileSizeY-startY);
+          unsigned long labelSizeY = vcl_min(sizeY+1,sizeImageY-startY);
+
+          //Tiles extraction of the input image
+          MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
+          imageROI->SetInput(imageIn);
+          imageROI->SetStartX(startX);
+          imageROI->SetStartY(startY);
+          imageROI->SetSizeX(sizeX);
+          imageROI->SetSizeY(sizeY);
+          imageROI->Update();
+
+          //Tiles extraction of the segmented image
           ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
           labelImageROI->SetInput(labelIn);
           labelImageROI->SetStartX(startX);
           labelImageROI->SetStartY(startY);
-          labelImageROI->SetSizeX(sizeX);
-          labelImageROI->SetSizeY(sizeY);
+          labelImageROI->SetSizeX(labelSizeX);
+          labelImageROI->SetSizeY(labelSizeY);
           labelImageROI->Update();
 
-          LabelImageType::IndexType pixelIndex;
+          const LabelImagePixelType * labels = labelImageROI->GetOutput()->GetBufferPointer();
+          ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
+          itImage.GoToBegin();
+
+          for(unsigned long y = 0; y < sizeY; ++y)
+            {
+            const LabelImagePixelType * line = labels + y*labelSizeX;
 
-          //"Adjacency map" creation for the region with nbPixels=="size"
-          for(pixelIndex[0]=0; pixelIndex[0]<static_cast<long>(sizeX); ++pixelIndex[0])
-            for(pixelIndex[1]=0; pixelIndex[1]<static_cast<long>(sizeY); ++pixelIndex[1])
+            for(unsigned long x = 0; x < sizeX; ++x, ++itImage)
               {
-              LabelImagePixelType curLabel = labelImageROI->GetOutput()->GetPixel(pixelIndex);
+              LabelImagePixelType curLabel = line[x];
 
-              if(labelMerged.count(LUT[curLabel]))
+              if(curLabel >= m_NbPixels.size())
                 {
-                edgeLabel.insert(LUT[curLabel]);
-                }
-              if((pixelIndex[0]==0)&&(startX!=0))
-                {
-                edgeLabel.insert(LUT[curLabel]);
-                }
-              if((pixelIndex[1]==0)&&(startY!=0))
-                {
-                edgeLabel.insert(LUT[curLabel]);
+                m_NbPixels.resize(curLabel+1, 0);
+                m_Sums.resize((curLabel+1)*m_NumberOfComponents, 0);
+                for(LabelImagePixelType label = m_BoundingBoxes.size()/4; label <= curLabel; ++label)
+                  {
+                  m_BoundingBoxes.push_back(ULONG_MAX);
+                  m_BoundingBoxes.push_back(0);
+                  m_BoundingBoxes.push_back(ULONG_MAX);
+                  m_BoundingBoxes.push_back(0);
+                  }
                 }
 
-              if(pixelIndex[0]==static_cast<long>(sizeX)-1)
+              unsigned long * box = &m_BoundingBoxes[4*curLabel];
+              box[0] = vcl_min(box[0], startX+x);
+              box[1] = vcl_max(box[1], startX+x);
+              box[2] = vcl_min(box[2], startY+y);
+              box[3] = vcl_max(box[3], startY+y);
+
+              //Sums calculation for the mean calculation per label
+              m_NbPixels[curLabel]++;
+              ImageType::PixelType pixel = itImage.Get();
+              ImagePixelType * sum = &m_Sums[curLabel*m_NumberOfComponents];
+              for(unsigned int comp = 0; comp<m_NumberOfComponents; ++comp)
                 {
-                if(startX!=(nbTilesX-1)*sizeTilesX) edgeLabel.insert(LUT[curLabel]);
+                sum[comp]+=pixel[comp];
                 }
-              else
-                {
-                ++pixelIndex[0];
-                LabelImagePixelType adjLabelX = labelImageROI->GetOutput()->GetPixel(pixelIndex);
-                --pixelIndex[0];
 
-                if(LUT[adjLabelX]!=LUT[curLabel])
-                  {
-                  if((nbPixels[LUT[curLabel]]>0)&&(nbPixels[LUT[curLabel]]==size))
-                    {
-                    adjMap[LUT[curLabel]].insert(LUT[adjLabelX]);
-                    minLabel.insert(LUT[curLabel]);
-                    }
-                  if((nbPixels[LUT[adjLabelX]]>0)&&(nbPixels[LUT[adjLabelX]]==size))
-                    {
-                    adjMap[LUT[adjLabelX]].insert(LUT[curLabel]);
-                    minLabel.insert(LUT[adjLabelX]);
-                    }
-                  }
-                }
-              if(pixelIndex[1]==static_cast<long>(sizeY)-1)
+              if(x+1 < labelSizeX && line[x+1] != curLabel)
                 {
-                if(startY!=(nbTilesY-1)*sizeTilesY) edgeLabel.insert(LUT[curLabel]);
+                tileEdges.push_back(MakeEdge(curLabel, line[x+1]));
                 }
-              else
+              if(y+1 < labelSizeY && line[x+labelSizeX] != curLabel)
                 {
-                ++pixelIndex[1];
-                LabelImagePixelType adjLabelY = labelImageROI->GetOutput()->GetPixel(pixelIndex);
-                --pixelIndex[1];
-                if(LUT[adjLabelY]!=LUT[curLabel])
-                  {
-                  if((nbPixels[LUT[curLabel]]>0)&&(nbPixels[LUT[curLabel]]==size))
-                    {
-                    adjMap[LUT[curLabel]].insert(LUT[adjLabelY]);
-                    minLabel.insert(LUT[curLabel]);
-                    }
-                  if((nbPixels[LUT[adjLabelY]]>0)&&(nbPixels[LUT[adjLabelY]]==size))
-                    {
-                    adjMap[LUT[adjLabelY]].insert(LUT[curLabel]);
-                    minLabel.insert(LUT[adjLabelY]); }
-                  }
+                tileEdges.push_back(MakeEdge(curLabel, line[x+labelSizeX]));
                 }
               }
+            }
+          }
 
-          //Searching the "nearest" region
-          for(std::set<int>::iterator itMinLabel=minLabel.begin(); itMinLabel!=minLabel.end(); ++itMinLabel)
-            {
-            LabelImagePixelType curLabel = *itMinLabel, adjLabel(0);
-            double err = itk::NumericTraits<double>::max();
-            if(edgeLabel.count(curLabel)==0)
-              {
-              if(nbPixels[curLabel]==size)
-                {
-                edgeLabel.insert(curLabel);
-                for(std::set<int>::iterator itAdjLabel=(adjMap[curLabel]).begin();
-                    itAdjLabel!=(adjMap[curLabel]).end(); ++itAdjLabel)
-                  {
-                  double tmpError = 0;
-                  LabelImagePixelType tmpLabel = *itAdjLabel;
-                  if(tmpLabel!=curLabel)
-                    {
-                    for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-                      {
-                      double curComp = static_cast<double>(sum[curLabel][comp])/nbPixels[curLabel];
-                      int tmpComp = static_cast<double>(sum[tmpLabel][comp])/nbPixels[tmpLabel];
-                      tmpError += (curComp-tmpComp)*(curComp-tmpComp);
-                      }
-                    if(tmpError<err)
-                      {
-                      err = tmpError;
-                      adjLabel = tmpLabel;
-                      }
-                    }
-                  }
+        std::sort(tileEdges.begin(), tileEdges.end());
+        edges.insert(edges.end(), tileEdges.begin(), std::unique(tileEdges.begin(), tileEdges.end()));
 
-                //Fusion of the two regions
-                if(adjLabel!=curLabel)
-                  {
-                  unsigned int curLabelLUT = curLabel, adjLabelLUT = adjLabel;
-                  while(LUTtmp[curLabelLUT] != curLabelLUT)
-                    {
-                    curLabelLUT = LUTtmp[curLabelLUT];
-                    }
-                  while(LUTtmp[adjLabelLUT] != adjLabelLUT)
-                    {
-                    adjLabelLUT = LUTtmp[adjLabelLUT];
-                    }
-                  if(curLabelLUT < adjLabelLUT)
-                    {
-                    LUTtmp[adjLabelLUT] = curLabelLUT;
-                    }
-                  else
-                    {
-                    LUTtmp[LUTtmp[curLabelLUT]] = adjLabelLUT; LUTtmp[curLabelLUT] = adjLabelLUT;
-                    }
-                  }
-                }
-              }
-            }
+        dummyFilter->UpdateProgress(static_cast<float>(row*nbTilesX+column+1) / (nbTilesX*nbTilesY));
+        }
+
+    // update reporter
+    dummyFilter->UpdateProgress(1.0f);
+    dummyFilter->InvokeEvent(itk::EndEvent());
 
-          for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    //Compressed sparse row storage of the adjacency
+    const unsigned long nbLabels = m_NbPixels.size();
+    m_AdjacencyOffsets.assign(nbLabels+1, 0);
+    for(std::vector<EdgeType>::const_iterator it = edges.begin(); it != edges.end(); ++it)
+      {
+      ++m_AdjacencyOffsets[FirstLabel(*it)+1];
+      ++m_AdjacencyOffsets[SecondLabel(*it)+1];
+      }
+    for(unsigned long label = 0; label < nbLabels; ++label)
+      {
+      m_AdjacencyOffsets[label+1] += m_AdjacencyOffsets[label];
+      }
+
+    m_Adjacency.resize(2*edges.size());
+    std::vector<unsigned long> position(m_AdjacencyOffsets.begin(), m_AdjacencyOffsets.end()-1);
+    for(std::vector<EdgeType>::const_iterator it = edges.begin(); it != edges.end(); ++it)
+      {
+      m_Adjacency[position[FirstLabel(*it)]++] = SecondLabel(*it);
+      m_Adjacency[position[SecondLabel(*it)]++] = FirstLabel(*it);
+      }
+  }
+
+  /** Merge the regions smaller than minSize by increasing size: each region
+   *  of the current size is merged with the adjacent region of closest mean
+   *  radiometry, using the statistics from the beginning of the pass. As in
+   *  the tile-wise processing, only the regions lying in one of the tiles
+   *  (see IsInsideATile()) are merged. */
+  void MergeSmallRegions(unsigned int minSize)
+  {
+    const LabelImagePixelType nbLabels = m_NbPixels.size();
+
+    m_LUT.resize(nbLabels);
+    m_NextMember.assign(nbLabels, nbLabels);
+    m_LastMember.resize(nbLabels);
+    LabelVectorType candidates;
+    for(LabelImagePixelType label = 0; label < nbLabels; ++label)
+      {
+      m_LUT[label] = label;
+      m_LastMember[label] = label;
+      if((m_NbPixels[label]>0)&&(m_NbPixels[label]<minSize))
+        {
+        candidates.push_back(label);
+        }
+      }
+
+    LabelVectorType neighbors;
+    LabelVectorType mergedLabels;
+    std::vector<std::pair<LabelImagePixelType, LabelImagePixelType> > merges;
+
+    // Setup fake reporter
+    RGBAPixelConverter<int,int>::Pointer dummyFilter =
+      RGBAPixelConverter<int,int>::New();
+    dummyFilter->SetProgress(0.0f);
+    this->AddProcess(dummyFilter,"Small regions merging...");
+    dummyFilter->InvokeEvent(itk::StartEvent());
+
+    for (unsigned int size=1; size<minSize && !candidates.empty(); size++)
+      {
+      dummyFilter->UpdateProgress(static_cast<float>(size-1) / (minSize-1));
+
+      merges.clear();
+
+      for(LabelVectorType::const_iterator itLabel = candidates.begin(); itLabel != candidates.end(); ++itLabel)
+        {
+        LabelImagePixelType curLabel = *itLabel;
+        if((m_LUT[curLabel]!=curLabel)||(m_NbPixels[curLabel]!=size))
+          {
+          continue;
+          }
+        const unsigned long * box = &m_BoundingBoxes[4*curLabel];
+        if(!IsInsideATile(box[0], box[1], size, m_SizeTilesX, m_SizeImageX)
+           ||!IsInsideATile(box[2], box[3], size, m_SizeTilesY, m_SizeImageY))
+          {
+          continue;
+          }
+
+        //Adjacent regions, from the adjacency of all the labels of the region
+        neighbors.clear();
+        for(LabelImagePixelType member = curLabel; member != nbLabels; member = m_NextMember[member])
+          {
+          for(unsigned long k = m_AdjacencyOffsets[member]; k < m_AdjacencyOffsets[member+1]; ++k)
             {
-            LabelImagePixelType can = label;
-            while(LUTtmp[can] != can)
+            LabelImagePixelType adjLabel = Find(m_Adjacency[k]);
+            if(adjLabel!=curLabel)
               {
-              can = LUTtmp[can];
+              neighbors.push_back(adjLabel);
               }
-            LUTtmp[label] = can;
             }
           }
+        if(neighbors.empty())
+          {
+          continue;
+          }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        //Searching the "nearest" region
+        LabelImagePixelType adjLabel(0);
+        double err = itk::NumericTraits<double>::max();
+        const ImagePixelType * curSum = &m_Sums[curLabel*m_NumberOfComponents];
+        for(LabelVectorType::const_iterator itAdjLabel = neighbors.begin(); itAdjLabel != neighbors.end(); ++itAdjLabel)
+          {
+          double tmpError = 0;
+          LabelImagePixelType tmpLabel = *itAdjLabel;
+          const ImagePixelType * tmpSum = &m_Sums[tmpLabel*m_NumberOfComponents];
+          for(unsigned int comp = 0; comp<m_NumberOfComponents; ++comp)
+            {
+            double curComp = static_cast<double>(curSum[comp])/m_NbPixels[curLabel];
+            int tmpComp = static_cast<double>(tmpSum[comp])/m_NbPixels[tmpLabel];
+            tmpError += (curComp-tmpComp)*(curComp-tmpComp);
+            }
+          if(tmpError<err)
+            {
+            err = tmpError;
+            adjLabel = tmpLabel;
+            }
+          }
+        merges.push_back(std::make_pair(curLabel, adjLabel));
+        }
+
+      //Fusion of the regions, the merged region takes the smallest label
+      mergedLabels.clear();
+      for(unsigned int i = 0; i < merges.size(); ++i)
+        {
+        LabelImagePixelType curLabelLUT = Find(merges[i].first), adjLabelLUT = Find(merges[i].second);
+        if(curLabelLUT < adjLabelLUT)
+          {
+          m_LUT[adjLabelLUT] = curLabelLUT;
+          }
+        else if(adjLabelLUT < curLabelLUT)
+          {
+          m_LUT[curLabelLUT] = adjLabelLUT;
+          }
+        mergedLabels.push_back(merges[i].first);
+        mergedLabels.push_back(merges[i].second);
         }
 
-      for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
+      //Statistics update, by increasing label
+      std::sort(mergedLabels.begin(), mergedLabels.end());
+      mergedLabels.erase(std::unique(mergedLabels.begin(), mergedLabels.end()), mergedLabels.end());
+      for(LabelVectorType::const_iterator itLabel = mergedLabels.begin(); itLabel != mergedLabels.end(); ++itLabel)
         {
-        LUT[label]=LUTtmp[label];
-        if((nbPixels[label]!=0)&&(LUT[label]!=label))
+        LabelImagePixelType label = *itLabel, root = Find(label);
+        if(root!=label)
           {
-          nbPixels[LUT[label]]+=nbPixels[label];
-          nbPixels[label]=0;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
+          m_NbPixels[root]+=m_NbPixels[label];
+          m_NbPixels[label]=0;
+          for(unsigned int comp = 0; comp<m_NumberOfComponents; ++comp)
             {
-            sum[LUT[label]][comp]+=sum[label][comp];
+            m_Sums[root*m_NumberOfComponents+comp]+=m_Sums[label*m_NumberOfComponents+comp];
             }
+          unsigned long * rootBox = &m_BoundingBoxes[4*root];
+          const unsigned long * box = &m_BoundingBoxes[4*label];
+          rootBox[0] = vcl_min(rootBox[0], box[0]);
+          rootBox[1] = vcl_max(rootBox[1], box[1]);
+          rootBox[2] = vcl_min(rootBox[2], box[2]);
+          rootBox[3] = vcl_max(rootBox[3], box[3]);
+          m_NextMember[m_LastMember[root]] = label;
+          m_LastMember[root] = m_LastMember[label];
+          }
+        }
+
+      //Only the remaining small regions are candidates for the next passes
+      LabelVectorType::iterator last = candidates.begin();
+      for(LabelVectorType::const_iterator itLabel = candidates.begin(); itLabel != candidates.end(); ++itLabel)
+        {
+        if((m_LUT[*itLabel]==*itLabel)&&(m_NbPixels[*itLabel]<minSize))
+          {
+          *last++ = *itLabel;
           }
         }
+      candidates.erase(last, candidates.end());
       }
-    //Relabelling
-    m_ChangeLabelFilter = ChangeLabelImageFilterType::New();
-    m_ChangeLabelFilter->SetInput(labelIn);
-    for(LabelImagePixelType label = 1; label<regionCount+1; ++label)
+
+    for(LabelImagePixelType label = 0; label < nbLabels; ++label)
       {
-      if(label!=LUT[label])
+      m_LUT[label] = Find(label);
+      }
+
+    // update reporter
+    dummyFilter->UpdateProgress(1.0f);
+    dummyFilter->InvokeEvent(itk::EndEvent());
+  }
+
+  /** Whether a region spanning [minIndex, maxIndex] along one axis lies in
+   *  one of the tiles of this axis, extended by size+1 pixels as in the
+   *  tile-wise processing, without touching the tile borders shared with
+   *  another tile. The regions touching such a border are skipped by the
+   *  tile-wise processing, and only merged from a tile fully containing
+   *  them. */
+  static bool IsInsideATile(unsigned long minIndex, unsigned long maxIndex, unsigned int size,
+                            unsigned long sizeTiles, unsigned long sizeImage)
+  {
+    const unsigned long nbTiles = sizeImage/sizeTiles + (sizeImage%sizeTiles > 0 ? 1 : 0);
+    for(long tile = minIndex/sizeTiles; tile >= 0; --tile)
+      {
+      const unsigned long start = tile*sizeTiles;
+      const unsigned long end = vcl_min(start+sizeTiles+size, sizeImage-1);
+      if(end < maxIndex)
         {
-        m_ChangeLabelFilter->SetChange(label,LUT[label]);
+        // Previous tiles end before this one
+        return false;
+        }
+      if(((tile == 0) || (minIndex > start))
+         && ((static_cast<unsigned long>(tile) == nbTiles-1) || (maxIndex < end)))
+        {
+        return true;
         }
       }
+    return false;
+  }
 
-    SetParameterOutputImage("out", m_ChangeLabelFilter->GetOutput());
+  /** Root of the region containing label, with path halving */
+  LabelImagePixelType Find(LabelImagePixelType label)
+  {
+    while(m_LUT[label] != label)
+      {
+      m_LUT[label] = m_LUT[m_LUT[label]];
+      label = m_LUT[label];
+      }
+    return label;
+  }
 
-    clock_t toc = clock();
+  static EdgeType MakeEdge(LabelImagePixelType label1, LabelImagePixelType label2)
+  {
+    return label1 < label2 ?
+      (static_cast<EdgeType>(label1) << 32) | label2 :
+      (static_cast<EdgeType>(label2) << 32) | label1;
+  }
 
-    otbAppLogINFO(<<"Elapsed time: "<<(double)(toc - tic) / CLOCKS_PER_SEC<<" seconds");
+  static LabelImagePixelType FirstLabel(EdgeType edge)
+  {
+    return static_cast<LabelImagePixelType>(edge >> 32);
+  }
+
+  static LabelImagePixelType SecondLabel(EdgeType edge)
+  {
+    return static_cast<LabelImagePixelType>(edge & 0xFFFFFFFFULL);
   }
 };
 }
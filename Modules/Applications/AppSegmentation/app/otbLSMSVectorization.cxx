@@ -28,6 +28,8 @@
 #include "otbLabelImageToOGRDataSourceFilter.h"
 #include "otbOGRFeatureWrapper.h"
 
+#include "itkMultiThreader.h"
+
 #include <time.h>
 #include <vcl_algorithm.h>
 
@@ -66,6 +68,18 @@ public:
   itkTypeMacro(Vectorization, otb::Application);
 
 private:
+  // Polygonize the tiles of a batch, one per thread
+  static ITK_THREAD_RETURN_TYPE PolygonizeThreaderCallback(void * arg)
+  {
+    itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+    std::vector<LabelImageToOGRDataSourceFilterType::Pointer> * batch =
+      static_cast<std::vector<LabelImageToOGRDataSourceFilterType::Pointer> *>(info->UserData);
+
+    (*batch)[info->ThreadID]->Update();
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
   void DoInit() ITK_OVERRIDE
   {
     SetName("LSMSVectorization");
@@ -80,7 +94,8 @@ private:
                           " each channels from input image (in parameter), segmentation image"
                           " label, number of pixels in the polygon. For large images one can use"
                           " the tilesizex and tilesizey parameters for tile-wise processing, with"
-                          " the guarantees of identical results.");
+                          " the guarantees of identical results. Tiles are polygonized in parallel,"
+                          " by batches of as many tiles as threads.");
     SetDocLimitations("This application is part of the Large-Scale Mean-Shift segmentation workflow (LSMS) and may not be suited for any other purpose.");
     SetDocAuthors("David Youssefi");
 
@@ -208,64 +223,94 @@ private:
     layer.CreateField(field, true);
     }
 
-    //Vectorization per tile
+    // Transactions are committed after each batch of tiles
+    const bool useTransactions = layer.ogr().TestCapability("Transactions");
+    if (useTransactions && layer.ogr().StartTransaction() != OGRERR_NONE)
+      {
+      itkExceptionMacro(<< "Unable to start transaction for OGR layer " << layer.ogr().GetName() << ".");
+      }
+
+    //Vectorization per tile, the tiles of a batch being polygonized in parallel
     otbAppLogINFO(<<"Vectorization ...");
-    for(unsigned int row = 0; row < nbTilesY; row++)
+    const unsigned int batchSize = std::max<itk::ThreadIdType>(1, itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+    const unsigned int nbTiles = nbTilesX * nbTilesY;
+    std::vector<LabelImageToOGRDataSourceFilterType::Pointer> batch;
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+
+    for(unsigned int tile = 0; tile < nbTiles; tile++)
       {
-      for(unsigned int column = 0; column < nbTilesX; column++)
-       {
-        unsigned long startX = column*sizeTilesX;
-        unsigned long startY = row*sizeTilesY;
-        unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
-          unsigned long sizeY = vcl_min(sizeTilesY,sizeImageY-startY);
-
-        //Tiles extraction of the input image
-        MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
-        imageROI->SetInput(imageIn);
-        imageROI->SetStartX(startX);
-        imageROI->SetStartY(startY);
-        imageROI->SetSizeX(sizeX);
-        imageROI->SetSizeY(sizeY);
-        imageROI->Update();
-
-        //Tiles extraction of the segmented image
-        ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX);
-        labelImageROI->SetSizeY(sizeY);
-        labelImageROI->Update();
-
-        //Sums calculation for the mean and the variance calculation per label
-        LabelImageIterator itLabel( labelImageROI->GetOutput(), labelImageROI->GetOutput()->GetLargestPossibleRegion());
-        ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
-        for (itLabel.GoToBegin(), itImage.GoToBegin(); !itImage.IsAtEnd(); ++itLabel, ++itImage)
+      unsigned int row = tile / nbTilesX;
+      unsigned int column = tile % nbTilesX;
+
+      unsigned long startX = column*sizeTilesX;
+      unsigned long startY = row*sizeTilesY;
+      unsigned long sizeX = vcl_min(sizeTilesX,sizeImageX-startX);
+      unsigned long sizeY = vcl_min(sizeTilesY,sizeImageY-startY);
+
+      //Tiles extraction of the input image
+      MultiChannelExtractROIFilterType::Pointer imageROI = MultiChannelExtractROIFilterType::New();
+      imageROI->SetInput(imageIn);
+      imageROI->SetStartX(startX);
+      imageROI->SetStartY(startY);
+      imageROI->SetSizeX(sizeX);
+      imageROI->SetSizeY(sizeY);
+      imageROI->Update();
+
+      //Tiles extraction of the segmented image
+      ExtractROIFilterType::Pointer labelImageROI = ExtractROIFilterType::New();
+      labelImageROI->SetInput(labelIn);
+      labelImageROI->SetStartX(startX);
+      labelImageROI->SetStartY(startY);
+      labelImageROI->SetSizeX(sizeX);
+      labelImageROI->SetSizeY(sizeY);
+      labelImageROI->Update();
+
+      //Sums calculation for the mean and the variance calculation per label
+      LabelImageIterator itLabel( labelImageROI->GetOutput(), labelImageROI->GetOutput()->GetLargestPossibleRegion());
+      ImageIterator itImage( imageROI->GetOutput(), imageROI->GetOutput()->GetLargestPossibleRegion());
+      for (itLabel.GoToBegin(), itImage.GoToBegin(); !itImage.IsAtEnd(); ++itLabel, ++itImage)
+        {
+        nbPixels[itLabel.Value()]++;
+        for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
           {
-          nbPixels[itLabel.Value()]++;
-          for(unsigned int comp = 0; comp<numberOfComponentsPerPixel; ++comp)
-            {
-            sum[itLabel.Value()][comp]+=itImage.Get()[comp];
-            sum2[itLabel.Value()][comp]+=itImage.Get()[comp]*itImage.Get()[comp];
-            }
+          sum[itLabel.Value()][comp]+=itImage.Get()[comp];
+          sum2[itLabel.Value()][comp]+=itImage.Get()[comp]*itImage.Get()[comp];
           }
+        }
+
+      labelImageROI = ExtractROIFilterType::New();
+      labelImageROI->SetInput(labelIn);
+      labelImageROI->SetStartX(startX);
+      labelImageROI->SetStartY(startY);
+      labelImageROI->SetSizeX(sizeX+1);
+      labelImageROI->SetSizeY(sizeY+1);
+      labelImageROI->Update();
+
+      // The tile is detached from the reader so that it can be
+      // polygonized in another thread
+      LabelImageType::Pointer labelTile = labelImageROI->GetOutput();
+      labelTile->DisconnectPipeline();
+
+      //Raster->Vecteur conversion
+      LabelImageToOGRDataSourceFilterType::Pointer labelToOGR = LabelImageToOGRDataSourceFilterType::New();
+      labelToOGR->SetInput(labelTile);
+      labelToOGR->SetInputMask(labelTile);
+      labelToOGR->SetFieldName("label");
+      batch.push_back(labelToOGR);
+
+      if (batch.size() < batchSize && tile + 1 < nbTiles)
+        {
+        continue;
+        }
+
+      threader->SetNumberOfThreads(batch.size());
+      threader->SetSingleMethod(PolygonizeThreaderCallback, &batch);
+      threader->SingleMethodExecute();
 
-        labelImageROI = ExtractROIFilterType::New();
-        labelImageROI->SetInput(labelIn);
-        labelImageROI->SetStartX(startX);
-        labelImageROI->SetStartY(startY);
-        labelImageROI->SetSizeX(sizeX+1);
-        labelImageROI->SetSizeY(sizeY+1);
-        labelImageROI->Update();
-
-        //Raster->Vecteur conversion
-        LabelImageToOGRDataSourceFilterType::Pointer labelToOGR = LabelImageToOGRDataSourceFilterType::New();
-        labelToOGR->SetInput(labelImageROI->GetOutput());
-        labelToOGR->SetInputMask(labelImageROI->GetOutput());
-        labelToOGR->SetFieldName("label");
-        labelToOGR->Update();
-
-        otb::ogr::DataSource::ConstPointer ogrDSTmp = labelToOGR->GetOutput();
+      // Features are copied in tile order, as with a sequential vectorization
+      for(unsigned int k = 0; k < batch.size(); ++k)
+        {
+        otb::ogr::DataSource::ConstPointer ogrDSTmp = batch[k]->GetOutput();
         otb::ogr::Layer layerTmp = ogrDSTmp->GetLayerChecked(0);
 
         otb::ogr::Layer::const_iterator featIt = layerTmp.begin();
@@ -275,7 +320,17 @@ private:
           dstFeature.SetFrom( *featIt, TRUE );
           layer.CreateFeature( dstFeature );
           }
-       }
+        }
+      batch.clear();
+
+      if (useTransactions)
+        {
+        if (layer.ogr().CommitTransaction() != OGRERR_NONE
+            || layer.ogr().StartTransaction() != OGRERR_NONE)
+          {
+          itkExceptionMacro(<< "Unable to commit transaction for OGR layer " << layer.ogr().GetName() << ".");
+          }
+        }
       }
 
     //Sorting by increasing label of the features
@@ -460,6 +460,11 @@ private:
     SetMinimumParameterIntValue("bm.radius",1);
     MandatoryOff("bm.radius");
 
+    AddParameter(ParameterType_Empty,"bm.boxfilter","Use running block sums");
+    SetParameterDescription("bm.boxfilter","Compute the SSD, NCC and Lp metrics with running sums over the blocks, whose cost does not depend on the radius (disabled by default). Results may differ from the direct computation by floating point rounding.");
+    MandatoryOff("bm.boxfilter");
+    DisableParameter("bm.boxfilter");
+
     AddParameter(ParameterType_Float,"bm.minhoffset","Minimum altitude offset (in meters)");
     SetParameterDescription("bm.minhoffset","Minimum altitude below the selected elevation source (in meters)");
     //MandatoryOff("bm.minhoffset");
@@ -553,6 +558,7 @@ private:
     blockMatcherFilter->SetLeftMaskInput(leftMask);
     blockMatcherFilter->SetRightMaskInput(rightMask);
     blockMatcherFilter->SetRadius(this->GetParameterInt("bm.radius"));
+    blockMatcherFilter->SetUseBoxFiltering(IsParameterEnabled("bm.boxfilter"));
     blockMatcherFilter->SetMinimumHorizontalDisparity(minDisp);
     blockMatcherFilter->SetMaximumHorizontalDisparity(maxDisp);
     blockMatcherFilter->SetMinimumVerticalDisparity(0);
@@ -571,6 +577,7 @@ private:
       invBlockMatcherFilter->SetLeftMaskInput(rightMask);
       invBlockMatcherFilter->SetRightMaskInput(leftMask);
       invBlockMatcherFilter->SetRadius(this->GetParameterInt("bm.radius"));
+      invBlockMatcherFilter->SetUseBoxFiltering(IsParameterEnabled("bm.boxfilter"));
       invBlockMatcherFilter->SetMinimumHorizontalDisparity(-maxDisp);
       invBlockMatcherFilter->SetMaximumHorizontalDisparity(-minDisp);
       invBlockMatcherFilter->SetMinimumVerticalDisparity(0);
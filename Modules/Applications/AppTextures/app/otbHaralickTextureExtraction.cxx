@@ -130,6 +130,12 @@ AddParameter(ParameterType_Int,"parameters.nbbin","Histogram number of bin");
 SetParameterDescription("parameters.nbbin", "Histogram number of bin");
 SetDefaultParameterInt("parameters.nbbin", 8);
 
+AddParameter(ParameterType_Empty,"parameters.incremental","Incremental co-occurrence update");
+SetParameterDescription("parameters.incremental", "Slide the co-occurrence histogram along each line "
+  "instead of rebuilding it for every pixel (simple and advanced texture sets only). "
+  "This is much faster for large radii, but results may differ by floating point rounding.");
+MandatoryOff("parameters.incremental");
+
 AddParameter(ParameterType_Choice, "texture", "Texture Set Selection");
 SetParameterDescription("texture", "Choice of The Texture Set");
 
@@ -234,6 +240,7 @@ void DoExecute() ITK_OVERRIDE
     m_HarTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
     m_HarTexFilter->SetSubsampleFactor(stepping);
     m_HarTexFilter->SetSubsampleOffset(stepOffset);
+    m_HarTexFilter->SetIncrementalMode(IsParameterEnabled("parameters.incremental"));
     m_HarTexFilter->UpdateOutputInformation();
     m_HarImageList->PushBack(m_HarTexFilter->GetEnergyOutput());
     m_HarImageList->PushBack(m_HarTexFilter->GetEntropyOutput());
@@ -257,6 +264,7 @@ void DoExecute() ITK_OVERRIDE
     m_AdvTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
     m_AdvTexFilter->SetSubsampleFactor(stepping);
     m_AdvTexFilter->SetSubsampleOffset(stepOffset);
+    m_AdvTexFilter->SetIncrementalMode(IsParameterEnabled("parameters.incremental"));
     m_AdvImageList->PushBack(m_AdvTexFilter->GetMeanOutput());
     m_AdvImageList->PushBack(m_AdvTexFilter->GetVarianceOutput());
     m_AdvImageList->PushBack(m_AdvTexFilter->GetDissimilarityOutput());
@@ -134,6 +134,10 @@ private:
     SetParameterDescription("mode.attribute.field","Name of the attribute field to burn");
     SetParameterString("mode.attribute.field","DN", false);
 
+    AddParameter(ParameterType_Empty,"native","Native rasterization");
+    SetParameterDescription("native","Index the geometries once and rasterize them in parallel with a scanline filling of polygons, instead of calling GDALRasterizeLayers for each stream division. Pixels are burnt if their center is inside a polygon, as GDAL does, but results may differ for pixel centers lying exactly on a boundary.");
+    MandatoryOff("native");
+
     AddRAMParameter();
 
     SetDocExampleParameterValue("in","qb_RoadExtract_classification.shp");
@@ -339,6 +343,8 @@ private:
         m_OGRDataSourceRendering->SetOutputProjectionRef(outputProjectionRef);
         }
 
+      m_OGRDataSourceRendering->SetNativeRasterization(IsParameterEnabled("native"));
+
       otbAppLogINFO("Output projection reference system is: "<<outputProjectionRef);
 
       otbAppLogINFO("Output origin: "<<origin);
@@ -84,6 +84,49 @@ public:
    */
   static RAMValueType GetMaxRAMHint();
 
+  /**
+   * TileCacheSize is the maximum memory used to keep decoded image
+   * blocks shared between image readers, expressed in MegaBytes.
+   *
+   * If environment variable OTB_TILE_CACHE_SIZE is defined and could be
+   * converted to int, return its content as a 64 bits unsigned int.
+   * Else, returns default value, which is 0 (no cache)
+   *
+   */
+  static RAMValueType GetTileCacheSize();
+
+  /**
+   * DEMCacheSpacing is the spacing, in degrees, of the elevation
+   * posts cached by DEMHandler.
+   *
+   * If environment variable OTB_DEM_CACHE_SPACING is defined and could
+   * be converted to double, return its content. Else, returns default
+   * value, which is 0 (no cache)
+   *
+   */
+  static double GetDEMCacheSpacing();
+
+  /**
+   * ProfilingFile is the path of the report written by applications
+   * when pipeline profiling is enabled (see PipelineProfiler).
+   *
+   * If environment variable OTB_PROFILING_FILE is defined,
+   * returns it contents as a string (and profiling is enabled)
+   * Else, returns an empty string (profiling is disabled)
+   */
+  static std::string GetProfilingFile();
+
+  /**
+   * ProfilingFormat is the format of the profiling report: "json"
+   * for a summary per process object, or "chrome" for the Chrome
+   * trace event format.
+   *
+   * If environment variable OTB_PROFILING_FORMAT is defined,
+   * returns it contents as a string
+   * Else, returns default value, which is "json"
+   */
+  static std::string GetProfilingFormat();
+
 private:
   ConfigurationManager(); //purposely not implemented
   ~ConfigurationManager(); //purposely not implemented
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPipelineProfiler_h
+#define otbPipelineProfiler_h
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "itkFastMutexLock.h"
+#include "itkProcessObject.h"
+
+#include "OTBCommonExport.h"
+
+namespace otb
+{
+
+/** \class PipelineProfiler
+ *
+ * \brief Process-wide recording of the time spent in pipeline filters
+ *
+ * Once a process object is watched (see Watch()), the profiler
+ * observes the StartEvent and EndEvent of this process object and of
+ * all the process objects upstream. Each GenerateData() call (which
+ * includes the ThreadedGenerateData() calls of multi-threaded
+ * filters) is recorded with its wall time, the thread calling it and
+ * the stream split being computed (see SetCurrentSplit()). At the end
+ * of each call, the size of the buffered region of the image outputs
+ * is used to track the peak buffered size. Readers and writers report
+ * the number of bytes transferred by their ImageIO.
+ *
+ * The report gives, for each process object, the number of calls, the
+ * total and self times (self time excludes the nested calls, e.g. from
+ * mini-pipelines), the time per stream split and the I/O counters. It
+ * can be written as JSON or in the Chrome trace event format
+ * (chrome://tracing), one complete event per call.
+ *
+ * The profiler is disabled by default. It is enabled when the
+ * environment variable OTB_PROFILING_FILE is set (see
+ * ConfigurationManager::GetProfilingFile()), in which case
+ * applications write the report to this file at the end of
+ * ExecuteAndWriteOutput().
+ *
+ * Watched process objects are kept alive until Clear() is called.
+ *
+ * \ingroup OTBCommon
+ */
+class OTBCommon_EXPORT PipelineProfiler
+{
+public:
+  typedef unsigned long long SizeValueType;
+
+  /** Summary of the calls of a process object */
+  struct ProcessRecord
+  {
+    ProcessRecord();
+
+    std::string   Name;
+    unsigned long NumberOfCalls;
+    /** Wall times in seconds */
+    double        TotalTime;
+    double        SelfTime;
+    SizeValueType BytesRead;
+    SizeValueType BytesWritten;
+    /** Peak number of pixels (times components) buffered in an output */
+    SizeValueType PeakBufferedSize;
+    /** Time spent for each stream split */
+    std::map<int, double> SplitTimes;
+  };
+
+  // GetInstance returns a reference to the unique PipelineProfiler
+  static PipelineProfiler& GetInstance()
+  {
+    static PipelineProfiler theUniqueInstance;
+    return theUniqueInstance;
+  }
+
+  /** Enable/disable the recording. Watch() and the I/O counters do
+   *  nothing when disabled. */
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+
+  /** Observe the process object and all the process objects
+   *  upstream. Process objects connected later upstream are watched
+   *  when the process object starts. */
+  void Watch(itk::ProcessObject * process);
+
+  /** Set the stream split being computed (-1 outside streaming) */
+  void SetCurrentSplit(int split);
+  int GetCurrentSplit() const;
+
+  /** Record the bytes read or written by the ImageIO of a process object */
+  void AddBytesRead(const itk::ProcessObject * process, SizeValueType bytes);
+  void AddBytesWritten(const itk::ProcessObject * process, SizeValueType bytes);
+
+  /** Called on StartEvent and EndEvent of the watched process objects */
+  void StartProcess(itk::ProcessObject * process);
+  void EndProcess(itk::ProcessObject * process);
+
+  /** Get the summary of a process object. Return false if it has not
+   *  been recorded. */
+  bool GetRecord(const itk::ProcessObject * process, ProcessRecord & record) const;
+
+  /** Stop watching the process objects and discard the records */
+  void Clear();
+
+  /** Write the summary of the process objects as JSON */
+  void WriteJSON(std::ostream & os) const;
+
+  /** Write the calls in the Chrome trace event format */
+  void WriteChromeTrace(std::ostream & os) const;
+
+  /** Write the report to a file, in the Chrome trace event format if
+   *  format is "chrome" and as JSON otherwise. Return false if the
+   *  file can not be written. */
+  bool Write(const std::string & filename, const std::string & format) const;
+
+private:
+  // private constructor so that this class is allocated only inside GetInstance
+  PipelineProfiler();
+  ~PipelineProfiler();
+  PipelineProfiler(const PipelineProfiler &); //purposely not implemented
+  void operator =(const PipelineProfiler&); //purposely not implemented
+
+  typedef std::chrono::steady_clock ClockType;
+
+  struct WatchedProcess
+  {
+    itk::ProcessObject::Pointer Process;
+    unsigned long StartTag;
+    unsigned long EndTag;
+    unsigned int  RecordIndex;
+  };
+
+  /** A call in progress */
+  struct OpenCall
+  {
+    const itk::ProcessObject * Process;
+    double Start;
+    double ChildrenTime;
+    int    Split;
+  };
+
+  /** A completed call */
+  struct CallEvent
+  {
+    unsigned int RecordIndex;
+    unsigned int Thread;
+    int          Split;
+    double       Start;
+    double       Duration;
+  };
+
+  typedef std::map<const itk::ProcessObject *, WatchedProcess> WatchedMapType;
+  typedef std::map<std::thread::id, std::vector<OpenCall> >     OpenCallMapType;
+
+  /** Watch the process object and the ones upstream (lock must be held) */
+  void WatchUpstream(itk::ProcessObject * process);
+
+  /** Record of a process object, or null if not watched (lock must be held) */
+  ProcessRecord * FindRecord(const itk::ProcessObject * process);
+
+  /** Seconds since the last Clear() */
+  double GetTime() const;
+
+  /** Small identifier of the calling thread (lock must be held) */
+  unsigned int GetThreadIndex();
+
+  bool m_Enabled;
+  int  m_CurrentSplit;
+
+  ClockType::time_point m_Origin;
+
+  WatchedMapType                     m_Watched;
+  std::vector<ProcessRecord>         m_Records;
+  std::vector<CallEvent>             m_Events;
+  OpenCallMapType                    m_OpenCalls;
+  std::map<std::thread::id, unsigned int> m_Threads;
+
+  itk::Command::Pointer m_Command;
+
+  mutable itk::SimpleFastMutexLock m_Lock;
+};
+
+} // end namespace otb
+
+#endif // otbPipelineProfiler_h
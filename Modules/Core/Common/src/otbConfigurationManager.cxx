@@ -61,4 +61,51 @@ ConfigurationManager::RAMValueType ConfigurationManager::GetMaxRAMHint()
   return value;
 
 }
+
+ConfigurationManager::RAMValueType ConfigurationManager::GetTileCacheSize()
+{
+  std::string svalue;
+
+  RAMValueType value = 0;
+
+  if(itksys::SystemTools::GetEnv("OTB_TILE_CACHE_SIZE",svalue))
+    {
+    value = static_cast<RAMValueType>(strtoul(svalue.c_str(),ITK_NULLPTR,10));
+    }
+
+  return value;
+}
+
+double ConfigurationManager::GetDEMCacheSpacing()
+{
+  std::string svalue;
+
+  double value = 0.;
+
+  if(itksys::SystemTools::GetEnv("OTB_DEM_CACHE_SPACING",svalue))
+    {
+    value = strtod(svalue.c_str(),ITK_NULLPTR);
+    }
+
+  return value;
+}
+
+std::string ConfigurationManager::GetProfilingFile()
+{
+  std::string svalue;
+  itksys::SystemTools::GetEnv("OTB_PROFILING_FILE",svalue);
+  return svalue;
+}
+
+std::string ConfigurationManager::GetProfilingFormat()
+{
+  std::string svalue;
+
+  if(!itksys::SystemTools::GetEnv("OTB_PROFILING_FORMAT",svalue) || svalue.empty())
+    {
+    svalue = "json";
+    }
+
+  return svalue;
+}
 }
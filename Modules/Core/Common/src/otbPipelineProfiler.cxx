@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbPipelineProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "itkCommand.h"
+#include "itkImageBase.h"
+
+#include "otbConfigurationManager.h"
+
+namespace otb
+{
+
+namespace
+{
+/** Forward the start and end events to the profiler */
+class ProfilerCommand : public itk::Command
+{
+public:
+  typedef ProfilerCommand               Self;
+  typedef itk::Command                  Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+
+  itkNewMacro(Self);
+
+  void Execute(itk::Object * caller, const itk::EventObject & event) ITK_OVERRIDE
+  {
+    itk::ProcessObject * process = dynamic_cast<itk::ProcessObject *>(caller);
+
+    if (process == ITK_NULLPTR)
+      {
+      return;
+      }
+
+    if (itk::StartEvent().CheckEvent(&event))
+      {
+      PipelineProfiler::GetInstance().StartProcess(process);
+      }
+    else if (itk::EndEvent().CheckEvent(&event))
+      {
+      PipelineProfiler::GetInstance().EndProcess(process);
+      }
+  }
+
+  void Execute(const itk::Object *, const itk::EventObject &) ITK_OVERRIDE
+  {
+  }
+
+protected:
+  ProfilerCommand() {}
+};
+
+/** Number of values buffered in an image data object, or 0 */
+template <unsigned int VDimension>
+PipelineProfiler::SizeValueType BufferedSize(const itk::DataObject * data)
+{
+  const itk::ImageBase<VDimension> * image = dynamic_cast<const itk::ImageBase<VDimension> *>(data);
+
+  if (image == ITK_NULLPTR)
+    {
+    return 0;
+    }
+
+  return static_cast<PipelineProfiler::SizeValueType>(image->GetBufferedRegion().GetNumberOfPixels())
+    * image->GetNumberOfComponentsPerPixel();
+}
+
+std::string EscapeJSON(const std::string & in)
+{
+  std::string out;
+
+  for (std::string::const_iterator it = in.begin(); it != in.end(); ++it)
+    {
+    if (*it == '"' || *it == '\\')
+      {
+      out += '\\';
+      }
+    out += *it;
+    }
+
+  return out;
+}
+}
+
+PipelineProfiler::ProcessRecord
+::ProcessRecord()
+  : Name(),
+    NumberOfCalls(0),
+    TotalTime(0.),
+    SelfTime(0.),
+    BytesRead(0),
+    BytesWritten(0),
+    PeakBufferedSize(0),
+    SplitTimes()
+{
+}
+
+PipelineProfiler
+::PipelineProfiler()
+  : m_Enabled(!ConfigurationManager::GetProfilingFile().empty()),
+    m_CurrentSplit(-1),
+    m_Origin(ClockType::now()),
+    m_Command(ProfilerCommand::New().GetPointer())
+{
+}
+
+PipelineProfiler
+::~PipelineProfiler()
+{
+}
+
+void
+PipelineProfiler
+::SetEnabled(bool enabled)
+{
+  m_Enabled = enabled;
+}
+
+bool
+PipelineProfiler
+::IsEnabled() const
+{
+  return m_Enabled;
+}
+
+void
+PipelineProfiler
+::Watch(itk::ProcessObject * process)
+{
+  if (!m_Enabled || process == ITK_NULLPTR)
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  this->WatchUpstream(process);
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::WatchUpstream(itk::ProcessObject * process)
+{
+  std::vector<itk::ProcessObject *> toVisit(1, process);
+
+  while (!toVisit.empty())
+    {
+    itk::ProcessObject * current = toVisit.back();
+    toVisit.pop_back();
+
+    if (m_Watched.find(current) == m_Watched.end())
+      {
+      WatchedProcess watched;
+      watched.Process = current;
+      watched.StartTag = current->AddObserver(itk::StartEvent(), m_Command);
+      watched.EndTag = current->AddObserver(itk::EndEvent(), m_Command);
+      watched.RecordIndex = m_Records.size();
+
+      m_Records.push_back(ProcessRecord());
+      m_Records.back().Name = current->GetNameOfClass();
+
+      m_Watched[current] = watched;
+      }
+
+    // Inputs may have been connected since the last visit
+    itk::ProcessObject::DataObjectPointerArray inputs = current->GetInputs();
+
+    for (itk::ProcessObject::DataObjectPointerArray::iterator it = inputs.begin();
+         it != inputs.end(); ++it)
+      {
+      if (it->IsNotNull() && (*it)->GetSource() != ITK_NULLPTR)
+        {
+        itk::ProcessObject * source = (*it)->GetSource();
+
+        if (m_Watched.find(source) == m_Watched.end()
+            && std::find(toVisit.begin(), toVisit.end(), source) == toVisit.end())
+          {
+          toVisit.push_back(source);
+          }
+        }
+      }
+    }
+}
+
+void
+PipelineProfiler
+::SetCurrentSplit(int split)
+{
+  m_Lock.Lock();
+  m_CurrentSplit = split;
+  m_Lock.Unlock();
+}
+
+int
+PipelineProfiler
+::GetCurrentSplit() const
+{
+  m_Lock.Lock();
+  const int split = m_CurrentSplit;
+  m_Lock.Unlock();
+
+  return split;
+}
+
+void
+PipelineProfiler
+::AddBytesRead(const itk::ProcessObject * process, SizeValueType bytes)
+{
+  if (!m_Enabled)
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  ProcessRecord * record = this->FindRecord(process);
+  if (record != ITK_NULLPTR)
+    {
+    record->BytesRead += bytes;
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::AddBytesWritten(const itk::ProcessObject * process, SizeValueType bytes)
+{
+  if (!m_Enabled)
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  ProcessRecord * record = this->FindRecord(process);
+  if (record != ITK_NULLPTR)
+    {
+    record->BytesWritten += bytes;
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StartProcess(itk::ProcessObject * process)
+{
+  const double now = this->GetTime();
+
+  m_Lock.Lock();
+
+  // The pipeline may have changed since the process object was watched
+  this->WatchUpstream(process);
+
+  OpenCall call;
+  call.Process = process;
+  call.Start = now;
+  call.ChildrenTime = 0.;
+  call.Split = m_CurrentSplit;
+
+  m_OpenCalls[std::this_thread::get_id()].push_back(call);
+
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::EndProcess(itk::ProcessObject * process)
+{
+  const double now = this->GetTime();
+
+  // Peak buffered size of the outputs
+  SizeValueType bufferedSize = 0;
+  itk::ProcessObject::DataObjectPointerArray outputs = process->GetOutputs();
+
+  for (itk::ProcessObject::DataObjectPointerArray::const_iterator it = outputs.begin();
+       it != outputs.end(); ++it)
+    {
+    bufferedSize = std::max(bufferedSize, BufferedSize<2>(*it));
+    bufferedSize = std::max(bufferedSize, BufferedSize<3>(*it));
+    }
+
+  m_Lock.Lock();
+
+  std::vector<OpenCall> & stack = m_OpenCalls[std::this_thread::get_id()];
+
+  // Calls interrupted by an exception have no end event: drop them
+  std::vector<OpenCall>::reverse_iterator callIt = stack.rbegin();
+  while (callIt != stack.rend() && callIt->Process != process)
+    {
+    ++callIt;
+    }
+
+  ProcessRecord * record = this->FindRecord(process);
+
+  if (callIt != stack.rend() && record != ITK_NULLPTR)
+    {
+    const OpenCall call = *callIt;
+    stack.erase(callIt.base() - 1, stack.end());
+
+    const double duration = now - call.Start;
+
+    record->NumberOfCalls++;
+    record->TotalTime += duration;
+    record->SelfTime += duration - call.ChildrenTime;
+    record->SplitTimes[call.Split] += duration;
+    record->PeakBufferedSize = std::max(record->PeakBufferedSize, bufferedSize);
+
+    if (!stack.empty())
+      {
+      stack.back().ChildrenTime += duration;
+      }
+
+    CallEvent event;
+    event.RecordIndex = m_Watched[process].RecordIndex;
+    event.Thread = this->GetThreadIndex();
+    event.Split = call.Split;
+    event.Start = call.Start;
+    event.Duration = duration;
+
+    m_Events.push_back(event);
+    }
+
+  m_Lock.Unlock();
+}
+
+bool
+PipelineProfiler
+::GetRecord(const itk::ProcessObject * process, ProcessRecord & record) const
+{
+  m_Lock.Lock();
+
+  WatchedMapType::const_iterator it = m_Watched.find(process);
+  const bool found = it != m_Watched.end();
+
+  if (found)
+    {
+    record = m_Records[it->second.RecordIndex];
+    }
+
+  m_Lock.Unlock();
+
+  return found;
+}
+
+void
+PipelineProfiler
+::Clear()
+{
+  m_Lock.Lock();
+
+  WatchedMapType watched;
+  watched.swap(m_Watched);
+
+  m_Records.clear();
+  m_Events.clear();
+  m_OpenCalls.clear();
+  m_Threads.clear();
+  m_CurrentSplit = -1;
+  m_Origin = ClockType::now();
+
+  m_Lock.Unlock();
+
+  // Removing the observers may release the last references to the
+  // pipeline, so do it outside of the lock
+  for (WatchedMapType::iterator it = watched.begin(); it != watched.end(); ++it)
+    {
+    it->second.Process->RemoveObserver(it->second.StartTag);
+    it->second.Process->RemoveObserver(it->second.EndTag);
+    }
+}
+
+void
+PipelineProfiler
+::WriteJSON(std::ostream & os) const
+{
+  m_Lock.Lock();
+
+  os << std::setprecision(9);
+  os << "{\n  \"processes\": [";
+
+  for (unsigned int i = 0; i < m_Records.size(); ++i)
+    {
+    const ProcessRecord & record = m_Records[i];
+
+    os << (i == 0 ? "\n" : ",\n");
+    os << "    {\n";
+    os << "      \"id\": " << i << ",\n";
+    os << "      \"name\": \"" << EscapeJSON(record.Name) << "\",\n";
+    os << "      \"calls\": " << record.NumberOfCalls << ",\n";
+    os << "      \"total_time\": " << record.TotalTime << ",\n";
+    os << "      \"self_time\": " << record.SelfTime << ",\n";
+    os << "      \"bytes_read\": " << record.BytesRead << ",\n";
+    os << "      \"bytes_written\": " << record.BytesWritten << ",\n";
+    os << "      \"peak_buffered_size\": " << record.PeakBufferedSize << ",\n";
+    os << "      \"splits\": {";
+
+    for (std::map<int, double>::const_iterator it = record.SplitTimes.begin();
+         it != record.SplitTimes.end(); ++it)
+      {
+      os << (it == record.SplitTimes.begin() ? "" : ", ");
+      os << "\"" << it->first << "\": " << it->second;
+      }
+
+    os << "}\n    }";
+    }
+
+  os << "\n  ]\n}\n";
+
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(std::ostream & os) const
+{
+  m_Lock.Lock();
+
+  // Timestamps and durations are in microseconds
+  os << std::fixed << std::setprecision(3);
+  os << "{\"traceEvents\": [";
+
+  for (unsigned int i = 0; i < m_Events.size(); ++i)
+    {
+    const CallEvent & event = m_Events[i];
+    const ProcessRecord & record = m_Records[event.RecordIndex];
+
+    os << (i == 0 ? "\n" : ",\n");
+    os << "{\"name\": \"" << EscapeJSON(record.Name) << "\", \"cat\": \"otb\", \"ph\": \"X\""
+       << ", \"ts\": " << event.Start * 1e6
+       << ", \"dur\": " << event.Duration * 1e6
+       << ", \"pid\": 0, \"tid\": " << event.Thread
+       << ", \"args\": {\"id\": " << event.RecordIndex << ", \"split\": " << event.Split << "}}";
+    }
+
+  os << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+  m_Lock.Unlock();
+}
+
+bool
+PipelineProfiler
+::Write(const std::string & filename, const std::string & format) const
+{
+  std::ofstream ofs(filename.c_str());
+
+  if (!ofs)
+    {
+    return false;
+    }
+
+  if (format == "chrome")
+    {
+    this->WriteChromeTrace(ofs);
+    }
+  else
+    {
+    this->WriteJSON(ofs);
+    }
+
+  return static_cast<bool>(ofs);
+}
+
+PipelineProfiler::ProcessRecord *
+PipelineProfiler
+::FindRecord(const itk::ProcessObject * process)
+{
+  WatchedMapType::const_iterator it = m_Watched.find(process);
+
+  return it == m_Watched.end() ? ITK_NULLPTR : &m_Records[it->second.RecordIndex];
+}
+
+double
+PipelineProfiler
+::GetTime() const
+{
+  return std::chrono::duration<double>(ClockType::now() - m_Origin).count();
+}
+
+unsigned int
+PipelineProfiler
+::GetThreadIndex()
+{
+  const std::thread::id id = std::this_thread::get_id();
+
+  std::map<std::thread::id, unsigned int>::const_iterator it = m_Threads.find(id);
+
+  if (it != m_Threads.end())
+    {
+    return it->second;
+    }
+
+  const unsigned int index = m_Threads.size();
+  m_Threads[id] = index;
+
+  return index;
+}
+
+} // end namespace otb
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbImage.h"
+#include "otbPipelineProfiler.h"
+#include "itkGradientMagnitudeImageFilter.h"
+
+int otbPipelineProfilerTest(int argc, char * argv[])
+{
+  if (argc < 5)
+    {
+    std::cerr << "Usage: " << argv[0] << " input output json chrome" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef unsigned char                                           PixelType;
+  typedef otb::Image<PixelType, 2>                                ImageType;
+  typedef otb::ImageFileReader<ImageType>                         ReaderType;
+  typedef otb::ImageFileWriter<ImageType>                         WriterType;
+  typedef itk::GradientMagnitudeImageFilter<ImageType, ImageType> FilterType;
+  typedef otb::PipelineProfiler                                   ProfilerType;
+
+  const unsigned int nbDivisions = 4;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+
+  FilterType::Pointer gradient = FilterType::New();
+  gradient->SetInput(reader->GetOutput());
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(argv[2]);
+  writer->SetInput(gradient->GetOutput());
+  writer->SetNumberOfDivisionsStrippedStreaming(nbDivisions);
+
+  ProfilerType & profiler = ProfilerType::GetInstance();
+  profiler.SetEnabled(true);
+  profiler.Watch(writer);
+
+  writer->Update();
+
+  bool ok = true;
+
+  ProfilerType::ProcessRecord readerRecord, gradientRecord, writerRecord;
+
+  if (!profiler.GetRecord(reader, readerRecord)
+      || !profiler.GetRecord(gradient, gradientRecord)
+      || !profiler.GetRecord(writer, writerRecord))
+    {
+    std::cerr << "Upstream process objects are not recorded" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const ImageType::RegionType largest = reader->GetOutput()->GetLargestPossibleRegion();
+  const ProfilerType::SizeValueType imageSize = largest.GetNumberOfPixels() * sizeof(PixelType);
+
+  // One call per stream split
+  if (gradientRecord.NumberOfCalls != nbDivisions || gradientRecord.SplitTimes.size() != nbDivisions)
+    {
+    std::cerr << "Gradient: " << gradientRecord.NumberOfCalls << " calls on "
+              << gradientRecord.SplitTimes.size() << " splits instead of " << nbDivisions << std::endl;
+    ok = false;
+    }
+
+  if (writerRecord.NumberOfCalls != 1)
+    {
+    std::cerr << "Writer: " << writerRecord.NumberOfCalls << " calls instead of 1" << std::endl;
+    ok = false;
+    }
+
+  // The gradient needs a one pixel margin, so the reader reads more
+  // than the image size
+  if (readerRecord.BytesRead < imageSize || writerRecord.BytesWritten != imageSize)
+    {
+    std::cerr << "Bytes read: " << readerRecord.BytesRead << ", bytes written: "
+              << writerRecord.BytesWritten << ", image size: " << imageSize << std::endl;
+    ok = false;
+    }
+
+  if (gradientRecord.PeakBufferedSize == 0 || gradientRecord.PeakBufferedSize >= largest.GetNumberOfPixels())
+    {
+    std::cerr << "Gradient peak buffered size " << gradientRecord.PeakBufferedSize
+              << " should be the size of a split" << std::endl;
+    ok = false;
+    }
+
+  if (gradientRecord.SelfTime > gradientRecord.TotalTime)
+    {
+    std::cerr << "Self time is greater than total time" << std::endl;
+    ok = false;
+    }
+
+  if (!profiler.Write(argv[3], "json") || !profiler.Write(argv[4], "chrome"))
+    {
+    std::cerr << "Can not write the reports" << std::endl;
+    ok = false;
+    }
+
+  profiler.Clear();
+
+  if (profiler.GetRecord(gradient, gradientRecord))
+    {
+    std::cerr << "Records should be cleared" << std::endl;
+    ok = false;
+    }
+
+  profiler.SetEnabled(false);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,8 @@
 #include "vnl/vnl_vector.h"
 #include "otbMath.h"
 
+#include <vector>
+
 #include "otbVectorImage.h"
 
 namespace otb
@@ -48,6 +50,13 @@ namespace otb
  * spline) is known to produce the best approximation of the original
  * function.
  *
+ * Evaluation does not allocate memory for usual radii: coefficients
+ * are computed in stack buffers and the neighbours are read directly
+ * from the input buffer. EvaluateAtContinuousIndexRow() evaluates a
+ * whole set of positions at once, which saves the computation of the
+ * coefficients along the second dimension for positions on the same
+ * line.
+ *
  * \ingroup ImageFunctions ImageInterpolators
  *
  * \ingroup OTBInterpolation
@@ -93,6 +102,9 @@ public:
   /** Coeficients container type.*/
   typedef vnl_vector<double> CoefContainerType;
 
+  /** Offset in the input buffer */
+  typedef itk::OffsetValueType OffsetValueType;
+
   /** Set/Get the window radius */
   virtual void SetRadius(unsigned int radius);
   virtual unsigned int GetRadius() const;
@@ -111,12 +123,62 @@ public:
    * calling the method. */
   OutputType EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const ITK_OVERRIDE = 0;
 
+  /** Evaluate the function at nbIndices ContinuousIndex positions
+   *
+   * output[i] receives the same value as
+   * EvaluateAtContinuousIndex(indices[i]). The coefficients along the
+   * second dimension are only computed again when the line changes,
+   * so that resampling filters should pass a whole output line at
+   * once. No bounds checking is done. */
+  virtual void EvaluateAtContinuousIndexRow( const ContinuousIndexType * indices,
+                                             unsigned int nbIndices,
+                                             OutputType * output ) const = 0;
+
 protected:
   BCOInterpolateImageFunctionBase() : m_Radius(2), m_WinSize(5), m_Alpha(-0.5) {};
   ~BCOInterpolateImageFunctionBase() ITK_OVERRIDE {};
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Compute the BCO coefficients. */
   virtual CoefContainerType EvaluateCoef( const ContinuousIndexValueType & indexValue ) const;
+
+  /** \class WindowType
+   * Coefficients and buffer offsets (in pixels, clamped to the
+   * buffered region) of the interpolation window along each
+   * dimension. The storage lives on the stack unless the window is
+   * larger than StackWinSize.
+   *
+   * \ingroup OTBInterpolation
+   */
+  class WindowType
+  {
+  public:
+    explicit WindowType(unsigned int winSize);
+
+    double *          CoefX;
+    double *          CoefY;
+    OffsetValueType * OffsetX;
+    OffsetValueType * OffsetY;
+
+  private:
+    WindowType(const WindowType &); //purposely not implemented
+    void operator=(const WindowType &); //purposely not implemented
+
+    /** Largest window size (radius 8) stored on the stack */
+    static const unsigned int StackWinSize = 17;
+
+    double                       m_CoefStack[2*StackWinSize];
+    OffsetValueType              m_OffsetStack[2*StackWinSize];
+    std::vector<double>          m_CoefHeap;
+    std::vector<OffsetValueType> m_OffsetHeap;
+  };
+
+  /** Compute the m_WinSize BCO coefficients of indexValue in coef */
+  void ComputeCoef( const ContinuousIndexValueType & indexValue, double * coef ) const;
+
+  /** Fill the window for the given position. When updateLine is
+   * false, the coefficients and offsets along the second dimension
+   * are kept. */
+  void ComputeWindow( const ContinuousIndexType & index, WindowType & window, bool updateLine = true ) const;
   
     /** Used radius for the BCO */
   unsigned int           m_Radius;
@@ -159,11 +221,20 @@ public:
 
   OutputType EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const ITK_OVERRIDE;
 
+  void EvaluateAtContinuousIndexRow( const ContinuousIndexType * indices,
+                                     unsigned int nbIndices,
+                                     OutputType * output ) const ITK_OVERRIDE;
+
 protected:
   BCOInterpolateImageFunction() {};
   ~BCOInterpolateImageFunction() ITK_OVERRIDE {};
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
+  typedef typename Superclass::WindowType            WindowType;
+
+  /** Interpolate the input image over the window */
+  void Interpolate( const WindowType & window, OutputType & output ) const;
+
 private:
   BCOInterpolateImageFunction( const Self& ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
@@ -198,11 +269,20 @@ public:
 
   OutputType EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const ITK_OVERRIDE;
 
+  void EvaluateAtContinuousIndexRow( const ContinuousIndexType * indices,
+                                     unsigned int nbIndices,
+                                     OutputType * output ) const ITK_OVERRIDE;
+
 protected:
   BCOInterpolateImageFunction() {};
   ~BCOInterpolateImageFunction() ITK_OVERRIDE {};
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
+  typedef typename Superclass::WindowType            WindowType;
+
+  /** Interpolate the input image over the window */
+  void Interpolate( const WindowType & window, OutputType & output ) const;
+
 private:
   BCOInterpolateImageFunction( const Self& ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
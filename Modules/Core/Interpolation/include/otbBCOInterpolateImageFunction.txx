@@ -80,8 +80,18 @@ BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
 ::EvaluateCoef( const ContinuousIndexValueType & indexValue ) const
 {
   // Init BCO coefficient container
-
   CoefContainerType BCOCoef(m_WinSize, 0.);
+
+  this->ComputeCoef(indexValue, BCOCoef.data_block());
+
+  return BCOCoef;
+}
+
+template<class TInputImage, class TCoordRep>
+void
+BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::ComputeCoef( const ContinuousIndexValueType & indexValue, double * BCOCoef ) const
+{
   double offset, dist, position, step;
 
   offset = indexValue - itk::Math::Floor<IndexValueType>(indexValue+0.5);
@@ -122,8 +132,61 @@ BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
 
   for ( unsigned int i = 0; i < m_WinSize; ++i)
     BCOCoef[i] = BCOCoef[i] / sum;
+}
 
-  return BCOCoef;
+template<class TInputImage, class TCoordRep>
+BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::WindowType::WindowType(unsigned int winSize)
+{
+  if (winSize <= StackWinSize)
+    {
+    CoefX = m_CoefStack;
+    OffsetX = m_OffsetStack;
+    }
+  else
+    {
+    m_CoefHeap.resize(2*winSize);
+    m_OffsetHeap.resize(2*winSize);
+    CoefX = &m_CoefHeap[0];
+    OffsetX = &m_OffsetHeap[0];
+    }
+  CoefY = CoefX + winSize;
+  OffsetY = OffsetX + winSize;
+}
+
+template<class TInputImage, class TCoordRep>
+void
+BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::ComputeWindow( const ContinuousIndexType & index, WindowType & window, bool updateLine ) const
+{
+  const typename InputImageType::OffsetValueType * offsetTable = this->GetInputImage()->GetOffsetTable();
+
+  for (unsigned int dim = 0; dim < (updateLine ? 2u : 1u); ++dim)
+    {
+    double * coef = (dim == 0 ? window.CoefX : window.CoefY);
+    OffsetValueType * offsets = (dim == 0 ? window.OffsetX : window.OffsetY);
+
+    this->ComputeCoef(index[dim], coef);
+
+    // Compute base index = closest index
+    const IndexValueType baseIndex = itk::Math::Floor< IndexValueType >( index[dim]+0.5 );
+
+    for (unsigned int i = 0; i < m_WinSize; ++i)
+      {
+      // get neighbor index, clamped to the buffered region
+      IndexValueType neighIndex = baseIndex + i - m_Radius;
+
+      if( neighIndex > this->m_EndIndex[dim] )
+        {
+        neighIndex = this->m_EndIndex[dim];
+        }
+      if( neighIndex < this->m_StartIndex[dim] )
+        {
+        neighIndex = this->m_StartIndex[dim];
+        }
+      offsets[i] = (neighIndex - this->m_StartIndex[dim]) * offsetTable[dim];
+      }
+    }
 }
 
 template <class TInputImage, class TCoordRep>
@@ -134,60 +197,60 @@ void BCOInterpolateImageFunction<TInputImage, TCoordRep>
 }
 
 template <class TInputImage, class TCoordRep>
-typename BCOInterpolateImageFunction< TInputImage, TCoordRep >
-::OutputType
+void
 BCOInterpolateImageFunction<TInputImage, TCoordRep>
-::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+::Interpolate( const WindowType & window, OutputType & output ) const
 {
+  typedef typename InputImageType::InternalPixelType InternalPixelType;
 
-  unsigned int dim;
-
-  IndexType baseIndex;
-  IndexType neighIndex;
+  const InternalPixelType * buffer = this->GetInputImage()->GetBufferPointer();
 
   RealType value = itk::NumericTraits<RealType>::Zero;
 
-  CoefContainerType BCOCoefX = this->EvaluateCoef(index[0]);
-  CoefContainerType BCOCoefY = this->EvaluateCoef(index[1]);
-
-  // Compute base index = closet index
-  for( dim = 0; dim < ImageDimension; dim++ )
-    {
-    baseIndex[dim] = itk::Math::Floor< IndexValueType >( index[dim]+0.5 );
-    }
-
   for(unsigned int i = 0; i < this->m_WinSize; ++i )
     {
+    const InternalPixelType * column = buffer + window.OffsetX[i];
     RealType lineRes = 0.;
     for(unsigned int j = 0; j < this->m_WinSize; ++j )
       {
-      // get neighbor index
-      neighIndex[0] = baseIndex[0] + i - this->m_Radius;
-      neighIndex[1] = baseIndex[1] + j - this->m_Radius;
-
-      if( neighIndex[0] > this->m_EndIndex[0] )
-        {
-        neighIndex[0] = this->m_EndIndex[0];
-        }
-      if( neighIndex[0] < this->m_StartIndex[0] )
-        {
-        neighIndex[0] = this->m_StartIndex[0];
-        }
-      if( neighIndex[1] > this->m_EndIndex[1] )
-        {
-        neighIndex[1] = this->m_EndIndex[1];
-        }
-      if( neighIndex[1] < this->m_StartIndex[1] )
-        {
-        neighIndex[1] = this->m_StartIndex[1];
-        }
-      lineRes += static_cast<RealType>( this->GetInputImage()->GetPixel( neighIndex ) ) * BCOCoefY[j];
+      lineRes += static_cast<RealType>( column[window.OffsetY[j]] ) * window.CoefY[j];
       }
-    value += lineRes*BCOCoefX[i];
+    value += lineRes*window.CoefX[i];
     }
 
+  output = static_cast<OutputType>( value );
+}
+
+template <class TInputImage, class TCoordRep>
+typename BCOInterpolateImageFunction< TInputImage, TCoordRep >
+::OutputType
+BCOInterpolateImageFunction<TInputImage, TCoordRep>
+::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+{
+  WindowType window(this->m_WinSize);
+  this->ComputeWindow(index, window);
+
+  OutputType output;
+  this->Interpolate(window, output);
+
+  return output;
+}
+
+template <class TInputImage, class TCoordRep>
+void
+BCOInterpolateImageFunction<TInputImage, TCoordRep>
+::EvaluateAtContinuousIndexRow( const ContinuousIndexType * indices,
+                                unsigned int nbIndices,
+                                OutputType * output ) const
+{
+  WindowType window(this->m_WinSize);
 
-  return ( static_cast<OutputType>( value ) );
+  for (unsigned int k = 0; k < nbIndices; ++k)
+    {
+    const bool updateLine = (k == 0 || indices[k][1] != indices[k-1][1]);
+    this->ComputeWindow(indices[k], window, updateLine);
+    this->Interpolate(window, output[k]);
+    }
 }
 
 template < typename TPixel, unsigned int VImageDimension, class TCoordRep >
@@ -198,74 +261,71 @@ void BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TC
 }
 
 template < typename TPixel, unsigned int VImageDimension, class TCoordRep >
-typename BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TCoordRep >
-::OutputType
+void
 BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TCoordRep >
-::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+::Interpolate( const WindowType & window, OutputType & output ) const
 {
   typedef typename itk::NumericTraits<InputPixelType>::ScalarRealType ScalarRealType;
 
+  const unsigned int componentNumber = this->GetInputImage()->GetNumberOfComponentsPerPixel();
+  const TPixel * buffer = this->GetInputImage()->GetBufferPointer();
 
-  unsigned int dim;
-  unsigned int componentNumber = this->GetInputImage()->GetNumberOfComponentsPerPixel();
-
-  IndexType baseIndex;
-  IndexType neighIndex;
-
-
-  std::vector<ScalarRealType> lineRes(componentNumber);
-  OutputType output(componentNumber);
-  output.Fill(itk::NumericTraits<ScalarRealType>::Zero);
-
-  CoefContainerType BCOCoefX = this->EvaluateCoef(index[0]);
-  CoefContainerType BCOCoefY = this->EvaluateCoef(index[1]);
-
-  //Compute base index = closet index
-  for( dim = 0; dim < ImageDimension; dim++ )
+  if (output.GetSize() != componentNumber)
     {
-    baseIndex[dim] = itk::Math::Floor< IndexValueType >( index[dim]+0.5 );
+    output.SetSize(componentNumber);
     }
 
-  for(unsigned int i = 0; i < this->m_WinSize; ++i )
+  // Components are interpolated one after the other, so that no
+  // temporary line buffer is needed
+  for( unsigned int k = 0; k<componentNumber; ++k)
     {
-    std::fill(lineRes.begin(), lineRes.end(), itk::NumericTraits<ScalarRealType>::Zero);
-    for(unsigned int j = 0; j < this->m_WinSize; ++j )
-      {
-      // get neighbor index
-      neighIndex[0] = baseIndex[0] + i - this->m_Radius;
-      neighIndex[1] = baseIndex[1] + j - this->m_Radius;
-      if( neighIndex[0] > this->m_EndIndex[0] )
-        {
-        neighIndex[0] = this->m_EndIndex[0];
-        }
-      if( neighIndex[0] < this->m_StartIndex[0] )
-        {
-        neighIndex[0] = this->m_StartIndex[0];
-        }
-      if( neighIndex[1] > this->m_EndIndex[1] )
-        {
-        neighIndex[1] = this->m_EndIndex[1];
-        }
-      if( neighIndex[1] < this->m_StartIndex[1] )
-        {
-        neighIndex[1] = this->m_StartIndex[1];
-        }
+    output[k] = itk::NumericTraits<ScalarRealType>::Zero;
 
-      const InputPixelType & pixel = this->GetInputImage()->GetPixel( neighIndex );
-      for( unsigned int k = 0; k<componentNumber; ++k)
+    for(unsigned int i = 0; i < this->m_WinSize; ++i )
+      {
+      const TPixel * column = buffer + window.OffsetX[i] * componentNumber + k;
+      ScalarRealType lineRes = itk::NumericTraits<ScalarRealType>::Zero;
+      for(unsigned int j = 0; j < this->m_WinSize; ++j )
         {
-        lineRes[k] += pixel.GetElement(k) * BCOCoefY[j];
+        lineRes += column[window.OffsetY[j] * componentNumber] * window.CoefY[j];
         }
-      }
-    for( unsigned int k = 0; k<componentNumber; ++k)
-      {
-      output[k] += lineRes[k]*BCOCoefX[i];
+      output[k] += lineRes*window.CoefX[i];
       }
     }
+}
+
+template < typename TPixel, unsigned int VImageDimension, class TCoordRep >
+typename BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TCoordRep >
+::OutputType
+BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TCoordRep >
+::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+{
+  WindowType window(this->m_WinSize);
+  this->ComputeWindow(index, window);
+
+  OutputType output(this->GetInputImage()->GetNumberOfComponentsPerPixel());
+  this->Interpolate(window, output);
 
   return ( output );
 }
 
+template < typename TPixel, unsigned int VImageDimension, class TCoordRep >
+void
+BCOInterpolateImageFunction< otb::VectorImage<TPixel, VImageDimension> , TCoordRep >
+::EvaluateAtContinuousIndexRow( const ContinuousIndexType * indices,
+                                unsigned int nbIndices,
+                                OutputType * output ) const
+{
+  WindowType window(this->m_WinSize);
+
+  for (unsigned int k = 0; k < nbIndices; ++k)
+    {
+    const bool updateLine = (k == 0 || indices[k][1] != indices[k-1][1]);
+    this->ComputeWindow(indices[k], window, updateLine);
+    this->Interpolate(window, output[k]);
+    }
+}
+
 } //namespace otb
 
 #endif
@@ -36,6 +36,10 @@ namespace otb
  *
  * The Initialize() method need to be call to create the filter.
  *
+ * When the whole window lies inside the buffered region, the
+ * neighbors are read directly from the image and the boundary
+ * condition is not used.
+ *
  * \ingroup ImageFunctions ImageInterpolators
  *
  * \ingroup OTBInterpolation
@@ -224,19 +224,22 @@ GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoo
     distance[dim] = index[dim] - double(baseIndex[dim]);
     }
 
-  // Position the neighborhood at the index of interest
-  SizeType radius;
-  radius.Fill(this->GetRadius());
-  IteratorType nit = IteratorType(radius, this->GetInputImage(), this->GetInputImage()->GetBufferedRegion());
-  nit.SetLocation(baseIndex);
-
-  const unsigned int twiceRadius = static_cast<const unsigned int>(2 * this->GetRadius());
-  /*  double xWeight[ImageDimension][ twiceRadius]; */
-  std::vector<std::vector<double> > xWeight;
-  xWeight.resize(ImageDimension);
-  for (unsigned int cpt = 0; cpt < xWeight.size(); ++cpt)
+  // The weights are stored on the stack unless the window is large
+  const unsigned int stackWindowSize = 16;
+  double              weightStack[ImageDimension][stackWindowSize];
+  std::vector<double> weightHeap;
+  double *            xWeight[ImageDimension];
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+    xWeight[dim] = weightStack[dim];
+    }
+  if (m_WindowSize > stackWindowSize)
     {
-    xWeight[cpt].resize(twiceRadius);
+    weightHeap.resize(ImageDimension * m_WindowSize);
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+      xWeight[dim] = &weightHeap[dim * m_WindowSize];
+      }
     }
 
   for (unsigned int dim = 0; dim < ImageDimension; ++dim)
@@ -296,6 +299,49 @@ GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoo
   itk::NumericTraits<RealType>::SetLength(xPixelValue, this->GetInputImage()->GetNumberOfComponentsPerPixel());
   xPixelValue=static_cast<RealType>(0.0);
 
+  // The neighbors used lie in [baseIndex - radius + 1, baseIndex + radius]
+  const long radius = static_cast<long>(this->GetRadius());
+  bool isInsideBuffer = true;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+    if (baseIndex[dim] - radius + 1 < this->m_StartIndex[dim]
+        || baseIndex[dim] + radius > this->m_EndIndex[dim])
+      {
+      isInsideBuffer = false;
+      }
+    }
+
+  if (isInsideBuffer)
+    {
+    // Read the neighbors directly: the boundary condition is not needed
+    IndexType neighIndex;
+
+    for (unsigned int j = 0; j < m_OffsetTableSize; ++j)
+      {
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+        neighIndex[dim] = baseIndex[dim] + static_cast<long>(m_WeightOffsetTable[j][dim]) - radius + 1;
+        }
+
+      RealType xVal = this->GetInputImage()->GetPixel(neighIndex);
+
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+        xVal *= xWeight[dim][m_WeightOffsetTable[j][dim]];
+        }
+
+      xPixelValue += xVal;
+      }
+
+    return static_cast<OutputType>(xPixelValue);
+    }
+
+  // Position the neighborhood at the index of interest
+  SizeType radiusSize;
+  radiusSize.Fill(this->GetRadius());
+  IteratorType nit = IteratorType(radiusSize, this->GetInputImage(), this->GetInputImage()->GetBufferedRegion());
+  nit.SetLocation(baseIndex);
+
   for (unsigned int j = 0; j < m_OffsetTableSize; ++j)
     {
     // Get the offset for this neighbor
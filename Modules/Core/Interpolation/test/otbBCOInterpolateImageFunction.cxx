@@ -19,6 +19,7 @@
  */
 
 #include "itkMacro.h"
+#include "itkImageRegionIterator.h"
 
 #include "otbBCOInterpolateImageFunction.h"
 #include "otbImageFileReader.h"
@@ -340,3 +341,90 @@ int otbBCOInterpolateImageFunctionVectorImageTest(int itkNotUsed(argc), char * a
 
   return EXIT_SUCCESS;
 }
+
+template <class TImage>
+int BCOInterpolateImageFunctionRowTest(TImage * image, unsigned int radius)
+{
+  typedef otb::BCOInterpolateImageFunction<TImage, double> InterpolatorType;
+  typedef typename InterpolatorType::ContinuousIndexType   ContinuousIndexType;
+  typedef typename InterpolatorType::OutputType            OutputType;
+
+  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetRadius(radius);
+  interpolator->SetInputImage(image);
+
+  const unsigned int nbIndices = 200;
+  std::vector<ContinuousIndexType> indices(nbIndices);
+  std::vector<OutputType> rowValues(nbIndices);
+
+  // Positions cross the image borders and change line every 50 positions
+  for (unsigned int k = 0; k < nbIndices; ++k)
+    {
+    indices[k][0] = -3.7 + 0.31 * k;
+    indices[k][1] = -2.2 + 13.4 * (k / 50);
+    }
+
+  interpolator->EvaluateAtContinuousIndexRow(&indices[0], nbIndices, &rowValues[0]);
+
+  for (unsigned int k = 0; k < nbIndices; ++k)
+    {
+    OutputType value = interpolator->EvaluateAtContinuousIndex(indices[k]);
+    if (value != rowValues[k])
+      {
+      std::cerr << "Row evaluation at " << indices[k] << " gives " << rowValues[k]
+                << " instead of " << value << " (radius " << radius << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbBCOInterpolateImageFunctionRow(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::Image<double, 2>                ImageType;
+  typedef otb::VectorImage<unsigned short, 2>  VectorImageType;
+
+  ImageType::RegionType region;
+  region.SetIndex(0, 3);
+  region.SetIndex(1, -1);
+  region.SetSize(0, 53);
+  region.SetSize(1, 37);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+
+  srand(0);
+  itk::ImageRegionIterator<ImageType> it(image, region);
+  itk::ImageRegionIterator<VectorImageType> vit(vectorImage, region);
+  VectorImageType::PixelType vectorPixel(3);
+  for (it.GoToBegin(), vit.GoToBegin(); !it.IsAtEnd(); ++it, ++vit)
+    {
+    it.Set(static_cast<double>(rand()) / RAND_MAX);
+    for (unsigned int c = 0; c < 3; ++c)
+      {
+      vectorPixel[c] = rand() % 4096;
+      }
+    vit.Set(vectorPixel);
+    }
+
+  // Radius 12 does not fit in the stack buffers
+  const unsigned int radii[3] = {2, 3, 12};
+
+  for (unsigned int r = 0; r < 3; ++r)
+    {
+    if (BCOInterpolateImageFunctionRowTest<ImageType>(image, radii[r]) == EXIT_FAILURE
+        || BCOInterpolateImageFunctionRowTest<VectorImageType>(vectorImage, radii[r]) == EXIT_FAILURE)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -50,6 +50,7 @@ void RegisterTests()
   REGISTER_TEST(otbBCOInterpolateImageFunctionOverVectorImage);
   REGISTER_TEST(otbBCOInterpolateImageFunctionTest);
   REGISTER_TEST(otbBCOInterpolateImageFunctionVectorImageTest);
+  REGISTER_TEST(otbBCOInterpolateImageFunctionRow);
   REGISTER_TEST(otbProlateInterpolateImageFunction);
   REGISTER_TEST(otbProlateValidationTest);
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbRAMDrivenOverlapAwareStreamingManager_h
+#define otbRAMDrivenOverlapAwareStreamingManager_h
+
+#include "otbStreamingManager.h"
+
+#include <vector>
+
+namespace otb
+{
+
+/** \class RAMDrivenOverlapAwareStreamingManager
+ *  \brief This class computes the divisions needed to stream an image in tiles,
+ *  taking into account the neighbourhood padding requested by the pipeline.
+ *
+ * Filters working on a neighbourhood (convolution, textures, mean shift ...)
+ * request a larger input region than the output split, so the pixels at
+ * the borders of each split are read and computed several times.
+ *
+ * The padding is estimated by propagating the requested region of a small
+ * probe region through the pipeline, and looking at the largest requested
+ * region of the upstream images sharing the output image grid. The tile
+ * shape is then chosen to minimise the total area computed by the pipeline
+ * (output area plus padding), while keeping the padded tile within the
+ * memory budget estimated as in RAMDrivenTiledStreamingManager.
+ *
+ * Splits are returned along a Hilbert curve, so that consecutive splits
+ * are neighbours and can reuse the blocks kept in the reader caches.
+ *
+ * You can use SetAvailableRAMInMB to set the available RAM.
+ *
+ * \sa RAMDrivenTiledStreamingManager
+ * \sa ImageFileWriter
+ * \sa StreamingImageVirtualFileWriter
+ *
+ * \ingroup OTBStreaming
+ */
+template<class TImage>
+class ITK_EXPORT RAMDrivenOverlapAwareStreamingManager : public StreamingManager<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef RAMDrivenOverlapAwareStreamingManager Self;
+  typedef StreamingManager<TImage>              Superclass;
+  typedef itk::SmartPointer<Self>               Pointer;
+  typedef itk::SmartPointer<const Self>         ConstPointer;
+
+  typedef TImage                          ImageType;
+  typedef typename Superclass::RegionType RegionType;
+  typedef typename Superclass::IndexType  IndexType;
+  typedef typename Superclass::SizeType   SizeType;
+
+  /** Creation through object factory macro */
+  itkNewMacro(Self);
+
+  /** Type macro */
+  itkTypeMacro(RAMDrivenOverlapAwareStreamingManager, itk::LightObject);
+
+  /** Dimension of input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkSetMacro(AvailableRAMInMB, unsigned int);
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkGetConstMacro(AvailableRAMInMB, unsigned int);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkSetMacro(Bias, double);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkGetConstMacro(Bias, double);
+
+  /** The padding (on each side of a split) estimated by the last call
+   *  to PrepareStreaming() */
+  itkGetConstReferenceMacro(Padding, SizeType);
+
+  /** Actually computes the stream divisions, according to the specified streaming mode,
+   * eventually using the input parameter to estimate memory consumption */
+  void PrepareStreaming(itk::DataObject * input, const RegionType &region) ITK_OVERRIDE;
+
+  /** Get the ith split, along the Hilbert curve */
+  RegionType GetSplit(unsigned int i) ITK_OVERRIDE;
+
+protected:
+  RAMDrivenOverlapAwareStreamingManager();
+  ~RAMDrivenOverlapAwareStreamingManager() ITK_OVERRIDE;
+
+  /** Estimate the padding requested by the pipeline around a split */
+  virtual SizeType EstimatePadding(itk::DataObject * input, const RegionType &region);
+
+  /** Compute the number of tiles along X and Y minimising the padded
+   *  area, each padded tile having at most maxTileArea pixels */
+  void ComputeTileGrid(const SizeType & size, const SizeType & padding,
+                       double maxTileArea,
+                       unsigned int & nbTilesX, unsigned int & nbTilesY) const;
+
+  /** Position of (x,y) along the Hilbert curve covering a n x n grid
+   * (n being a power of two) */
+  static unsigned long HilbertIndex(unsigned long n, unsigned long x, unsigned long y);
+
+  /** The number of MegaBytes of RAM available */
+  unsigned int m_AvailableRAMInMB;
+
+  /** The multiplier to apply to the memory print estimation */
+  double m_Bias;
+
+  /** The estimated padding */
+  SizeType m_Padding;
+
+  /** The splits, in processing order */
+  std::vector<RegionType> m_Splits;
+
+private:
+  RAMDrivenOverlapAwareStreamingManager(const RAMDrivenOverlapAwareStreamingManager &);
+  void operator =(const RAMDrivenOverlapAwareStreamingManager&);
+};
+
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbRAMDrivenOverlapAwareStreamingManager.txx"
+#endif
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbRAMDrivenOverlapAwareStreamingManager_txx
+#define otbRAMDrivenOverlapAwareStreamingManager_txx
+
+#include "otbRAMDrivenOverlapAwareStreamingManager.h"
+#include "otbMacro.h"
+#include "itkImageBase.h"
+#include "itkProcessObject.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+namespace otb
+{
+
+template <class TImage>
+RAMDrivenOverlapAwareStreamingManager<TImage>::RAMDrivenOverlapAwareStreamingManager()
+  : m_AvailableRAMInMB(0),
+    m_Bias(1.0)
+{
+  m_Padding.Fill(0);
+}
+
+template <class TImage>
+RAMDrivenOverlapAwareStreamingManager<TImage>::~RAMDrivenOverlapAwareStreamingManager()
+{
+}
+
+template <class TImage>
+void
+RAMDrivenOverlapAwareStreamingManager<TImage>::PrepareStreaming( itk::DataObject * input, const RegionType &region )
+{
+  this->m_Region = region;
+  m_Splits.clear();
+
+  unsigned long nbDivisions =
+      this->EstimateOptimalNumberOfDivisions(input, region, m_AvailableRAMInMB, m_Bias);
+  nbDivisions = std::max(nbDivisions, 1UL);
+
+  m_Padding = this->EstimatePadding(input, region);
+  otbMsgDevMacro(<< "Estimated padding : " << m_Padding)
+
+  // Area of a padded tile fitting in the available memory
+  const double maxTileArea = static_cast<double>(region.GetSize()[0])
+    * static_cast<double>(region.GetSize()[1]) / nbDivisions;
+
+  unsigned int nbTilesX = 1;
+  unsigned int nbTilesY = 1;
+  this->ComputeTileGrid(region.GetSize(), m_Padding, maxTileArea, nbTilesX, nbTilesY);
+
+  // Build the tiles and sort them along the Hilbert curve
+  unsigned long gridSize = 1;
+  while (gridSize < std::max(nbTilesX, nbTilesY))
+    {
+    gridSize *= 2;
+    }
+
+  std::vector<RegionType> tiles;
+  std::vector<std::pair<unsigned long, unsigned int> > order;
+  for (unsigned int y = 0; y < nbTilesY; ++y)
+    {
+    for (unsigned int x = 0; x < nbTilesX; ++x)
+      {
+      RegionType tile(region);
+      const unsigned long startX = static_cast<unsigned long>(region.GetSize()[0]) * x / nbTilesX;
+      const unsigned long endX   = static_cast<unsigned long>(region.GetSize()[0]) * (x + 1) / nbTilesX;
+      const unsigned long startY = static_cast<unsigned long>(region.GetSize()[1]) * y / nbTilesY;
+      const unsigned long endY   = static_cast<unsigned long>(region.GetSize()[1]) * (y + 1) / nbTilesY;
+      tile.SetIndex(0, region.GetIndex()[0] + startX);
+      tile.SetIndex(1, region.GetIndex()[1] + startY);
+      tile.SetSize(0, endX - startX);
+      tile.SetSize(1, endY - startY);
+
+      order.push_back(std::make_pair(HilbertIndex(gridSize, x, y),
+                                     static_cast<unsigned int>(tiles.size())));
+      tiles.push_back(tile);
+      }
+    }
+  std::sort(order.begin(), order.end());
+
+  m_Splits.reserve(tiles.size());
+  for (unsigned int i = 0; i < order.size(); ++i)
+    {
+    m_Splits.push_back(tiles[order[i].second]);
+    }
+
+  this->m_ComputedNumberOfSplits = static_cast<unsigned int>(m_Splits.size());
+  otbMsgDevMacro(<< "Number of split : " << this->m_ComputedNumberOfSplits
+                 << " (" << nbTilesX << " x " << nbTilesY << ")")
+}
+
+template <class TImage>
+typename RAMDrivenOverlapAwareStreamingManager<TImage>::RegionType
+RAMDrivenOverlapAwareStreamingManager<TImage>::GetSplit(unsigned int i)
+{
+  if (i >= m_Splits.size())
+    {
+    itkExceptionMacro(<< "Split " << i << " requested, but only "
+                      << m_Splits.size() << " splits were computed.");
+    }
+  return m_Splits[i];
+}
+
+template <class TImage>
+typename RAMDrivenOverlapAwareStreamingManager<TImage>::SizeType
+RAMDrivenOverlapAwareStreamingManager<TImage>::EstimatePadding(itk::DataObject * input, const RegionType &region)
+{
+  typedef itk::ImageBase<ImageDimension> ImageBaseType;
+
+  SizeType padding;
+  padding.Fill(0);
+
+  ImageType* inputImage = dynamic_cast<ImageType*>(input);
+  if (inputImage == ITK_NULLPTR)
+    {
+    return padding;
+    }
+
+  // Propagate a small region around the image center, 100 pixels wide
+  // in each dimension, as for the memory footprint estimation
+  RegionType probeRegion(region);
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    probeRegion.SetIndex(dim, region.GetIndex()[dim] + region.GetSize()[dim]/2 - 50);
+    probeRegion.SetSize(dim, 100);
+    }
+  if (!probeRegion.Crop(region))
+    {
+    return padding;
+    }
+
+  inputImage->SetRequestedRegion(probeRegion);
+  inputImage->PropagateRequestedRegion();
+
+  // Look at the requested regions of the upstream images sharing the
+  // output grid. Other images (resampled inputs for instance) can not
+  // be compared with the output split.
+  std::vector<itk::DataObject*> toVisit(1, input);
+  std::set<itk::DataObject*>    visited;
+  while (!toVisit.empty())
+    {
+    itk::DataObject* current = toVisit.back();
+    toVisit.pop_back();
+
+    itk::ProcessObject* source = current->GetSource();
+    if (source == ITK_NULLPTR)
+      {
+      continue;
+      }
+
+    itk::ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+    for (unsigned int i = 0; i < inputs.size(); ++i)
+      {
+      itk::DataObject* upstream = inputs[i];
+      if (upstream == ITK_NULLPTR || !visited.insert(upstream).second)
+        {
+        continue;
+        }
+      toVisit.push_back(upstream);
+
+      ImageBaseType* upstreamImage = dynamic_cast<ImageBaseType*>(upstream);
+      if (upstreamImage == ITK_NULLPTR
+          || upstreamImage->GetLargestPossibleRegion() != inputImage->GetLargestPossibleRegion()
+          || upstreamImage->GetSpacing() != inputImage->GetSpacing()
+          || upstreamImage->GetOrigin() != inputImage->GetOrigin())
+        {
+        continue;
+        }
+
+      const typename ImageBaseType::RegionType & requested = upstreamImage->GetRequestedRegion();
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+        const long before = probeRegion.GetIndex()[dim] - requested.GetIndex()[dim];
+        const long after  = (requested.GetIndex()[dim] + static_cast<long>(requested.GetSize()[dim]))
+          - (probeRegion.GetIndex()[dim] + static_cast<long>(probeRegion.GetSize()[dim]));
+        const long dimPadding = std::max(std::max(before, after), 0L);
+        padding[dim] = std::max(padding[dim], static_cast<typename SizeType::SizeValueType>(dimPadding));
+        }
+      }
+    }
+
+  return padding;
+}
+
+template <class TImage>
+void
+RAMDrivenOverlapAwareStreamingManager<TImage>::ComputeTileGrid(const SizeType & size, const SizeType & padding,
+                                                               double maxTileArea,
+                                                               unsigned int & nbTilesX, unsigned int & nbTilesY) const
+{
+  const double width   = static_cast<double>(size[0]);
+  const double height  = static_cast<double>(size[1]);
+  const double padX    = 2. * static_cast<double>(padding[0]);
+  const double padY    = 2. * static_cast<double>(padding[1]);
+
+  double bestCost      = std::numeric_limits<double>::max();
+  bool   bestFeasible  = false;
+  nbTilesX = 1;
+  nbTilesY = 1;
+
+  unsigned long previousTileWidth = 0;
+  for (unsigned long nx = 1; nx <= size[0]; ++nx)
+    {
+    const unsigned long tileWidth = (size[0] + nx - 1) / nx;
+    if (tileWidth == previousTileWidth)
+      {
+      // Same tiles with more splits
+      continue;
+      }
+    previousTileWidth = tileWidth;
+
+    // Highest tile fitting in memory with this width
+    double maxTileHeight = maxTileArea / (tileWidth + padX) - padY;
+    const bool feasible = maxTileHeight >= 1.;
+    if (!feasible && bestFeasible)
+      {
+      // Narrower tiles will not fit either
+      break;
+      }
+    maxTileHeight = std::min(height, std::max(1., vcl_floor(maxTileHeight)));
+
+    const unsigned long ny = static_cast<unsigned long>(vcl_ceil(height / maxTileHeight));
+    const double tileHeight = vcl_ceil(height / ny);
+
+    // Total area processed by the pipeline
+    const double cost = static_cast<double>(nx * ny) * (tileWidth + padX) * (tileHeight + padY);
+
+    if ((feasible && !bestFeasible) || (feasible == bestFeasible && cost < bestCost))
+      {
+      bestCost = cost;
+      bestFeasible = feasible;
+      nbTilesX = static_cast<unsigned int>(nx);
+      nbTilesY = static_cast<unsigned int>(ny);
+      }
+    }
+
+  otbMsgDevMacro(<< "Tile grid : " << nbTilesX << " x " << nbTilesY
+                 << ", processed area " << bestCost << " for " << width * height << " pixels")
+}
+
+template <class TImage>
+unsigned long
+RAMDrivenOverlapAwareStreamingManager<TImage>::HilbertIndex(unsigned long n, unsigned long x, unsigned long y)
+{
+  unsigned long d = 0;
+  for (unsigned long s = n / 2; s > 0; s /= 2)
+    {
+    const unsigned long rx = (x & s) > 0;
+    const unsigned long ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+
+    // Rotate the quadrant
+    if (ry == 0)
+      {
+      if (rx == 1)
+        {
+        x = s - 1 - x;
+        y = s - 1 - y;
+        }
+      std::swap(x, y);
+      }
+    }
+  return d;
+}
+
+} // End namespace otb
+
+#endif
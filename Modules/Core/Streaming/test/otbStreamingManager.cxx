@@ -25,6 +25,9 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbRAMDrivenOverlapAwareStreamingManager.h"
+#include "otbImage.h"
+#include "itkMeanImageFilter.h"
 
 #include <fstream>
 
@@ -230,3 +233,76 @@ int otbRAMDrivenAdaptativeStreamingManager(int itkNotUsed(argc), char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbRAMDrivenOverlapAwareStreamingManager(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::Image<float, Dimension>                                    ScalarImageType;
+  typedef itk::MeanImageFilter<ScalarImageType, ScalarImageType>          MeanFilterType;
+  typedef otb::RAMDrivenOverlapAwareStreamingManager<ScalarImageType>     StreamingManagerType;
+
+  ScalarImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 10013);
+  region.SetSize(1, 5727);
+
+  ScalarImageType::Pointer image = ScalarImageType::New();
+  image->SetRegions(region);
+
+  MeanFilterType::RadiusType radius;
+  radius[0] = 7;
+  radius[1] = 3;
+
+  MeanFilterType::Pointer meanFilter = MeanFilterType::New();
+  meanFilter->SetInput(image);
+  meanFilter->SetRadius(radius);
+  meanFilter->UpdateOutputInformation();
+
+  StreamingManagerType::Pointer streamingManager = StreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(1);
+  streamingManager->PrepareStreaming(meanFilter->GetOutput(), region);
+
+  StreamingManagerType::SizeType padding = streamingManager->GetPadding();
+  if (padding[0] != radius[0] || padding[1] != radius[1])
+    {
+    std::cerr << "Wrong padding: expected " << radius << ", got " << padding << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  unsigned int nbSplits = streamingManager->GetNumberOfSplits();
+  if (nbSplits < 2)
+    {
+    std::cerr << "Expected several splits, got " << nbSplits << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Splits must cover the region exactly
+  unsigned long long area = 0;
+  for (unsigned int i = 0; i < nbSplits; ++i)
+    {
+    ScalarImageType::RegionType split = streamingManager->GetSplit(i);
+    if (!region.IsInside(split))
+      {
+      std::cerr << "Split " << i << " is outside of the region: " << split << std::endl;
+      return EXIT_FAILURE;
+      }
+    area += split.GetNumberOfPixels();
+    }
+
+  if (area != region.GetNumberOfPixels())
+    {
+    std::cerr << "Splits cover " << area << " pixels instead of " << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without neighbourhood filter, there is no padding
+  streamingManager->PrepareStreaming(image, region);
+  padding = streamingManager->GetPadding();
+  if (padding[0] != 0 || padding[1] != 0)
+    {
+    std::cerr << "Padding should be null without neighbourhood filter, got " << padding << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -27,6 +27,7 @@ void RegisterTests()
   REGISTER_TEST(otbRAMDrivenStrippedStreamingManager);
   REGISTER_TEST(otbTileDimensionTiledStreamingManager);
   REGISTER_TEST(otbRAMDrivenTiledStreamingManager);
+  REGISTER_TEST(otbRAMDrivenOverlapAwareStreamingManager);
   REGISTER_TEST(otbRAMDrivenAdaptativeStreamingManager);
   REGISTER_TEST(otbPipelineMemoryPrintCalculatorTest);
   REGISTER_TEST(otbPipelineMemoryPrintCalculatorNew);
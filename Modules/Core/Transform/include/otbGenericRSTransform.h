@@ -23,6 +23,8 @@
 
 #include "otbCompositeTransform.h"
 
+#include <vector>
+
 namespace otb
 {
 namespace Projection
@@ -69,6 +71,7 @@ public:
 
   typedef itk::Vector<double, 2> SpacingType;
   typedef itk::Point<double, 2>  OriginType;
+  typedef itk::Size<2>           GridSizeType;
 
   typedef itk::Transform<double, NInputDimensions, NOutputDimensions>         GenericTransformType;
   typedef typename GenericTransformType::Pointer                              GenericTransformPointerType;
@@ -170,6 +173,22 @@ public:
 
   OutputPointType TransformPoint(const InputPointType& point) const ITK_OVERRIDE;
 
+  /** Transform the nodes of a regular grid. Node (i,j) is the point
+   * origin + (i*spacing[0], j*spacing[1]) (other coordinates are
+   * those of origin). outputPoints receives size[0]*size[1] points,
+   * line after line. This is equivalent to calling TransformPoint()
+   * on each node, but the transform is only retrieved once and inverse
+   * sensor models transform the whole grid in a single batch. For RPC
+   * models, this batch uses a native evaluation of the polynomials,
+   * which only matches TransformPoint() within 1e-6 pixel (it is
+   * checked against OSSIM when the model is loaded). It is used by
+   * GridTransformToDisplacementFieldSource to generate displacement
+   * fields. */
+  virtual void TransformGrid(const InputPointType& origin,
+                             const SpacingType& spacing,
+                             const GridSizeType& size,
+                             std::vector<OutputPointType>& outputPoints) const;
+
   virtual void  InstantiateTransform();
   
   // Get inverse methods
@@ -198,6 +217,12 @@ private:
   GenericRSTransform(const Self &);    //purposely not implemented
   void operator =(const Self&);    //purposely not implemented
 
+  /** Apply one of the composed transforms to a set of points, in batch
+   *  if it is a sensor model */
+  static void TransformPoints(const GenericTransformType * transform,
+                              const std::vector<InputPointType>& points,
+                              std::vector<OutputPointType>& outputPoints);
+
   ImageKeywordlist m_InputKeywordList;
   ImageKeywordlist m_OutputKeywordList;
 
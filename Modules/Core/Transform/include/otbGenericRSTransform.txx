@@ -22,11 +22,16 @@
 #define otbGenericRSTransform_txx
 
 #include "otbGenericRSTransform.h"
+
+#include <algorithm>
+
 #include "otbMacro.h"
 #include "otbMetaDataKey.h"
 #include "itkMetaDataObject.h"
 
 #include "otbGeoInformationConversion.h"
+#include "otbForwardSensorModel.h"
+#include "otbInverseSensorModel.h"
 
 #include "ogr_spatialref.h"
 
@@ -280,6 +285,80 @@ GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
   return outputPoint;
 }
 
+template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformGrid(const InputPointType& origin,
+                const SpacingType& spacing,
+                const GridSizeType& size,
+                std::vector<OutputPointType>& outputPoints) const
+{
+  const TransformType * transform = this->GetTransform();
+
+  std::vector<InputPointType> inputPoints(size[0] * size[1], origin);
+  typename std::vector<InputPointType>::iterator inIt = inputPoints.begin();
+
+  for (unsigned int j = 0; j < size[1]; ++j)
+    {
+    for (unsigned int i = 0; i < size[0]; ++i, ++inIt)
+      {
+      // Apply input origin/spacing
+      (*inIt)[0] = (origin[0] + i * spacing[0]) * m_InputSpacing[0] + m_InputOrigin[0];
+      (*inIt)[1] = (origin[1] + j * spacing[1]) * m_InputSpacing[1] + m_InputOrigin[1];
+      }
+    }
+
+  // Transform points
+  std::vector<OutputPointType> geoPoints;
+  TransformPoints(transform->GetFirstTransform(), inputPoints, geoPoints);
+
+  const unsigned int dimension = std::min(NInputDimensions, NOutputDimensions);
+  for (std::size_t k = 0; k < inputPoints.size(); ++k)
+    {
+    for (unsigned int d = 0; d < dimension; ++d)
+      {
+      inputPoints[k][d] = geoPoints[k][d];
+      }
+    }
+
+  TransformPoints(transform->GetSecondTransform(), inputPoints, outputPoints);
+
+  // Apply output origin/spacing
+  for (typename std::vector<OutputPointType>::iterator outIt = outputPoints.begin();
+       outIt != outputPoints.end(); ++outIt)
+    {
+    (*outIt)[0] = ((*outIt)[0] - m_OutputOrigin[0]) / m_OutputSpacing[0];
+    (*outIt)[1] = ((*outIt)[1] - m_OutputOrigin[1]) / m_OutputSpacing[1];
+    }
+}
+
+template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const GenericTransformType * transform,
+                  const std::vector<InputPointType>& points,
+                  std::vector<OutputPointType>& outputPoints)
+{
+  typedef InverseSensorModel<double, NInputDimensions, NOutputDimensions> InverseSensorModelType;
+
+  if (const InverseSensorModelType * inverseSensorModel =
+      dynamic_cast<const InverseSensorModelType *>(transform))
+    {
+    inverseSensorModel->TransformPoints(points, outputPoints);
+    return;
+    }
+
+  // Forward sensor models are not batched: their native batch iterates
+  // to a tighter threshold than OSSIM, and would not give the
+  // TransformPoint() results
+
+  outputPoints.resize(points.size());
+  for (std::size_t k = 0; k < points.size(); ++k)
+    {
+    outputPoints[k] = transform->TransformPoint(points[k]);
+    }
+}
+
 template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 bool
 GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
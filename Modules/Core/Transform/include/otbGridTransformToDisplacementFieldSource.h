@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGridTransformToDisplacementFieldSource_h
+#define otbGridTransformToDisplacementFieldSource_h
+
+#include "itkTransformToDisplacementFieldSource.h"
+#include "otbGenericRSTransform.h"
+
+namespace otb
+{
+
+/** \class GridTransformToDisplacementFieldSource
+ * \brief This class acts like the itk::TransformToDisplacementFieldSource,
+ * but transforms the nodes of the field region by region.
+ *
+ * When the transform is a otb::GenericRSTransform, the nodes of the
+ * region generated by each thread are transformed at once with
+ * GenericRSTransform::TransformGrid(), which batches the inverse sensor
+ * models. For RPC models, the displacements then match the point by
+ * point evaluation within 1e-6 input pixel (see TransformGrid()).
+ *
+ * Other transforms, and fields whose direction is not the identity,
+ * are transformed point by point by itk::TransformToDisplacementFieldSource.
+ *
+ * \sa itk::TransformToDisplacementFieldSource
+ *
+ * \ingroup Threaded
+ *
+ * \ingroup OTBTransform
+ */
+
+template <class TOutputImage, class TTransformPrecisionType = double>
+class ITK_EXPORT GridTransformToDisplacementFieldSource
+  : public itk::TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+{
+public:
+  /** Standard class typedefs. */
+  typedef GridTransformToDisplacementFieldSource                                        Self;
+  typedef itk::TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType> Superclass;
+  typedef itk::SmartPointer<Self>                                                       Pointer;
+  typedef itk::SmartPointer<const Self>                                                 ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro(GridTransformToDisplacementFieldSource, itk::TransformToDisplacementFieldSource);
+
+  /** Typedefs from the superclass */
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::TransformType         TransformType;
+  typedef typename Superclass::PixelType             PixelType;
+  typedef typename Superclass::PixelValueType        PixelValueType;
+  typedef typename Superclass::PointType             PointType;
+
+  /** Transform whose grids are transformed at once */
+  typedef GenericRSTransform<TTransformPrecisionType, 2, 2> GenericRSTransformType;
+
+protected:
+  GridTransformToDisplacementFieldSource() {}
+  ~GridTransformToDisplacementFieldSource() ITK_OVERRIDE {}
+
+  /** Use TransformGrid() when possible, the superclass otherwise */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            itk::ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** Transform the nodes of the region with TransformGrid() */
+  void GridThreadedGenerateData(const GenericRSTransformType * transform,
+                                const OutputImageRegionType& outputRegionForThread,
+                                itk::ThreadIdType threadId);
+
+private:
+  GridTransformToDisplacementFieldSource(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+};
+
+} // namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbGridTransformToDisplacementFieldSource.txx"
+#endif
+
+#endif
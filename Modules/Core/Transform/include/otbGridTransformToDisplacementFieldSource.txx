@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGridTransformToDisplacementFieldSource_txx
+#define otbGridTransformToDisplacementFieldSource_txx
+
+#include "otbGridTransformToDisplacementFieldSource.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+GridTransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  const GenericRSTransformType * transform =
+    dynamic_cast<const GenericRSTransformType *>(this->GetTransform());
+
+  // Grid nodes follow the field axes only when its direction is the identity
+  if (transform != ITK_NULLPTR
+      && OutputImageType::ImageDimension == 2
+      && this->GetOutput()->GetDirection().GetVnlMatrix().is_identity())
+    {
+    this->GridThreadedGenerateData(transform, outputRegionForThread, threadId);
+    return;
+    }
+
+  Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+GridTransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::GridThreadedGenerateData(const GenericRSTransformType * transform,
+                           const OutputImageRegionType& outputRegionForThread,
+                           itk::ThreadIdType threadId)
+{
+  typedef typename GenericRSTransformType::InputPointType  TransformInputPointType;
+  typedef typename GenericRSTransformType::OutputPointType TransformOutputPointType;
+
+  OutputImageType * outputPtr = this->GetOutput();
+
+  // The grid starts at the first node of the region, with the field spacing
+  PointType regionOrigin;
+  outputPtr->TransformIndexToPhysicalPoint(outputRegionForThread.GetIndex(), regionOrigin);
+
+  TransformInputPointType                       gridOrigin;
+  typename GenericRSTransformType::SpacingType  gridSpacing;
+  typename GenericRSTransformType::GridSizeType gridSize;
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    gridOrigin[dim] = regionOrigin[dim];
+    gridSpacing[dim] = outputPtr->GetSpacing()[dim];
+    gridSize[dim] = outputRegionForThread.GetSize()[dim];
+    }
+
+  std::vector<TransformOutputPointType> transformedPoints;
+  transform->TransformGrid(gridOrigin, gridSpacing, gridSize, transformedPoints);
+
+  // Support for progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Nodes are visited line after line, as returned by TransformGrid()
+  typedef itk::ImageRegionIteratorWithIndex<OutputImageType> OutputIteratorType;
+  OutputIteratorType outIt(outputPtr, outputRegionForThread);
+
+  typename std::vector<TransformOutputPointType>::const_iterator pointIt = transformedPoints.begin();
+  PointType outputPoint;
+  PixelType deformation;
+
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt, ++pointIt)
+    {
+    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
+
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      deformation[dim] = static_cast<PixelValueType>((*pointIt)[dim] - outputPoint[dim]);
+      }
+
+    outIt.Set(deformation);
+    progress.CompletedPixel();
+    }
+}
+
+} // namespace otb
+
+#endif
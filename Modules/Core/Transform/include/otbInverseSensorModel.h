@@ -21,6 +21,8 @@
 #ifndef otbInverseSensorModel_h
 #define otbInverseSensorModel_h
 
+#include <vector>
+
 #include "otbSensorModelBase.h"
 
 #include "itkMacro.h"
@@ -75,6 +77,12 @@ public:
 
   // Transform of geographic point in image sensor index
   OutputPointType TransformPoint(const InputPointType& point) const ITK_OVERRIDE;
+
+  /** Batch transform of geographic points in image sensor indices.
+   *  This is faster than calling TransformPoint() on each point for RPC
+   *  models. */
+  virtual void TransformPoints(const std::vector<InputPointType>& points,
+                               std::vector<OutputPointType>& outputPoints) const;
   // Transform of geographic point in image sensor index -- Backward Compatibility
   //  OutputPointType TransformPoint(const InputPointType &point, double height) const;
 
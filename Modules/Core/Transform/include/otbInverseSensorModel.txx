@@ -73,6 +73,50 @@ InverseSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
 }
 
 
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+InverseSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const std::vector<InputPointType>& points,
+                  std::vector<OutputPointType>& outputPoints) const
+{
+  const std::size_t n = points.size();
+
+  std::vector<double> lon(n), lat(n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+    lon[i] = points[i][0];
+    lat[i] = points[i][1];
+    }
+
+  std::vector<double> x, y, z;
+
+  if (InputPointType::PointDimension == 3)
+    {
+    std::vector<double> h(n);
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      h[i] = points[i][2];
+      }
+    this->m_Model->InverseTransformPoints(lon, lat, h, x, y, z);
+    }
+  else
+    {
+    this->m_Model->InverseTransformPoints(lon, lat, x, y, z);
+    }
+
+  outputPoints.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+    outputPoints[i][0] = x[i];
+    outputPoints[i][1] = y[i];
+
+    if (OutputPointType::PointDimension == 3)
+      {
+      outputPoints[i][2] = z[i];
+      }
+    }
+}
+
 template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 void
 InverseSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
@@ -40,6 +40,15 @@ namespace otb
  * If the maximum displacement is wrong, this filter is likely to request data outside of the input image buffered region. In this case, pixels
  * outside the region will be set to Zero according to itk::NumericTraits.
  *
+ * If IncrementalWarping is on (it is off by default), the displacement field is
+ * interpolated line by line: each output line first blends the two
+ * surrounding lines of the field, then the displacement of each pixel is
+ * a single linear interpolation between two samples of that blended
+ * line. This path requires the lines of the output image to map to lines
+ * of the displacement field (which is the case when both share the same
+ * orientation), and falls back to the itk::WarpImageFilter otherwise.
+ * Results differ from the default path by rounding errors only.
+ *
  * \sa itk::WarpImageFilter
  *
  * \ingroup Streamed
@@ -83,6 +92,11 @@ public:
   itkSetMacro(MaximumDisplacement, DisplacementValueType);
   itkGetConstReferenceMacro(MaximumDisplacement, DisplacementValueType);
 
+  /** Interpolate the displacement field line by line */
+  itkSetMacro(IncrementalWarping, bool);
+  itkGetMacro(IncrementalWarping, bool);
+  itkBooleanMacro(IncrementalWarping);
+
 protected:
   /** Constructor */
   StreamingWarpImageFilter();
@@ -104,12 +118,20 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                             itk::ThreadIdType threadId ) ITK_OVERRIDE;
 
+  /** Warp the output region with a line by line interpolation of the
+   * displacement field. Return false (without writing any pixel) if
+   * output lines do not map to lines of the displacement field. */
+  bool IncrementalThreadedGenerateData(const OutputImageRegionType& outputRegionForThread);
+
 private:
   StreamingWarpImageFilter(const Self &); //purposely not implemented
   void operator =(const Self&); //purposely not implemented
 
   // Assessment of the maximum displacement for streaming
   DisplacementValueType m_MaximumDisplacement;
+
+  // Interpolate the displacement field line by line
+  bool m_IncrementalWarping;
 };
 
 } // end namespace otb
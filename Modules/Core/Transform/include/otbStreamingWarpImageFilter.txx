@@ -24,6 +24,7 @@
 
 #include "otbStreamingWarpImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMetaDataObject.h"
 #include "otbMetaDataKey.h"
@@ -37,6 +38,7 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
  {
   // Fill the default maximum displacement
   m_MaximumDisplacement.Fill(1);
+  m_IncrementalWarping = false;
  }
 
 template<class TInputImage, class TOutputImage, class TDisplacementField>
@@ -254,6 +256,11 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
   const OutputImageRegionType& outputRegionForThread,
   itk::ThreadIdType threadId )
   {
+  if (m_IncrementalWarping && this->IncrementalThreadedGenerateData(outputRegionForThread))
+    {
+    return;
+    }
+
   // the superclass itk::WarpImageFilter is doing the actual warping
   Superclass::ThreadedGenerateData(outputRegionForThread,threadId);
 
@@ -290,6 +297,140 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
     }
   }
 
+template<class TInputImage, class TOutputImage, class TDisplacementField>
+bool
+StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
+::IncrementalThreadedGenerateData(const OutputImageRegionType& outputRegionForThread)
+{
+  typedef itk::ContinuousIndex<double, DisplacementFieldType::ImageDimension> FieldContinuousIndexType;
+  typedef typename Superclass::InterpolatorType::ContinuousIndexType         InputContinuousIndexType;
+
+  const InputImageType * inputPtr = this->GetInput();
+  OutputImageType * outputPtr = this->GetOutput();
+  const DisplacementFieldType * fieldPtr = this->GetDisplacementField();
+  const typename Superclass::InterpolatorType * interpolator = this->GetInterpolator();
+
+  if (OutputImageType::ImageDimension != 2 || outputRegionForThread.GetNumberOfPixels() == 0)
+    {
+    return false;
+    }
+
+  // Position and step of the output lines in the displacement field
+  // index space
+  IndexType firstIndex = outputRegionForThread.GetIndex();
+  IndexType nextIndex = firstIndex;
+  nextIndex[0] += 1;
+
+  PointType firstPoint, nextPoint;
+  outputPtr->TransformIndexToPhysicalPoint(firstIndex, firstPoint);
+  outputPtr->TransformIndexToPhysicalPoint(nextIndex, nextPoint);
+
+  FieldContinuousIndexType firstFieldIndex, nextFieldIndex;
+  fieldPtr->TransformPhysicalPointToContinuousIndex(firstPoint, firstFieldIndex);
+  fieldPtr->TransformPhysicalPointToContinuousIndex(nextPoint, nextFieldIndex);
+
+  const double fieldStep = nextFieldIndex[0] - firstFieldIndex[0];
+  if (vcl_abs(nextFieldIndex[1] - firstFieldIndex[1]) > 1e-9)
+    {
+    // Output lines are not field lines
+    return false;
+    }
+
+  const typename PointType::VectorType pointStep = nextPoint - firstPoint;
+
+  // Field samples available for interpolation
+  const DisplacementFieldRegionType fieldLargest = fieldPtr->GetLargestPossibleRegion();
+  const DisplacementFieldRegionType fieldBuffered = fieldPtr->GetBufferedRegion();
+  const DisplacementValueType * fieldBuffer = fieldPtr->GetBufferPointer();
+  const typename DisplacementFieldType::OffsetValueType fieldLineOffset = fieldPtr->GetOffsetTable()[1];
+
+  const long fieldStartX = fieldBuffered.GetIndex(0);
+  const long fieldEndX = fieldStartX + static_cast<long>(fieldBuffered.GetSize(0)) - 1;
+  const long fieldStartY = fieldBuffered.GetIndex(1);
+  const long fieldEndY = fieldStartY + static_cast<long>(fieldBuffered.GetSize(1)) - 1;
+
+  // Line of the displacement field blended at the current output line
+  std::vector<DisplacementValueType> fieldLine(fieldBuffered.GetSize(0));
+
+  const PixelType paddingValue = this->GetEdgePaddingValue();
+
+  itk::ImageScanlineIterator<OutputImageType> outIt(outputPtr, outputRegionForThread);
+  outIt.GoToBegin();
+
+  PointType linePoint;
+  PointType inputPoint;
+  FieldContinuousIndexType lineFieldIndex;
+  InputContinuousIndexType inputIndex;
+
+  while (!outIt.IsAtEnd())
+    {
+    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), linePoint);
+    fieldPtr->TransformPhysicalPointToContinuousIndex(linePoint, lineFieldIndex);
+
+    const double fy = lineFieldIndex[1];
+    const bool lineInsideField = fy >= static_cast<double>(fieldLargest.GetIndex(1))
+      && fy <= static_cast<double>(fieldLargest.GetIndex(1) + fieldLargest.GetSize(1) - 1);
+
+    if (lineInsideField)
+      {
+      // Blend the two field lines surrounding the output line
+      long y0 = static_cast<long>(vcl_floor(fy));
+      y0 = std::max(fieldStartY, std::min(y0, fieldEndY));
+      const long y1 = std::min(y0 + 1, fieldEndY);
+      const double wy = std::min(1., std::max(0., fy - static_cast<double>(y0)));
+
+      const DisplacementValueType * line0 = fieldBuffer + (y0 - fieldStartY) * fieldLineOffset;
+      const DisplacementValueType * line1 = fieldBuffer + (y1 - fieldStartY) * fieldLineOffset;
+
+      for (unsigned int x = 0; x < fieldLine.size(); ++x)
+        {
+        fieldLine[x] = line0[x] * (1. - wy) + line1[x] * wy;
+        }
+      }
+
+    for (unsigned long k = 0; !outIt.IsAtEndOfLine(); ++k, ++outIt)
+      {
+      const double fx = lineFieldIndex[0] + k * fieldStep;
+
+      if (!lineInsideField
+          || fx < static_cast<double>(fieldLargest.GetIndex(0))
+          || fx > static_cast<double>(fieldLargest.GetIndex(0) + fieldLargest.GetSize(0) - 1))
+        {
+        // Outside the displacement grid
+        outIt.Set(paddingValue);
+        continue;
+        }
+
+      long x0 = static_cast<long>(vcl_floor(fx));
+      x0 = std::max(fieldStartX, std::min(x0, fieldEndX));
+      const long x1 = std::min(x0 + 1, fieldEndX);
+      const double wx = std::min(1., std::max(0., fx - static_cast<double>(x0)));
+
+      const DisplacementValueType displacement = fieldLine[x0 - fieldStartX] * (1. - wx)
+        + fieldLine[x1 - fieldStartX] * wx;
+
+      for (unsigned int dim = 0; dim < 2; ++dim)
+        {
+        inputPoint[dim] = linePoint[dim] + k * pointStep[dim] + displacement[dim];
+        }
+
+      inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+
+      if (interpolator->IsInsideBuffer(inputIndex))
+        {
+        outIt.Set(static_cast<PixelType>(interpolator->EvaluateAtContinuousIndex(inputIndex)));
+        }
+      else
+        {
+        outIt.Set(paddingValue);
+        }
+      }
+    outIt.NextLine();
+    }
+
+  return true;
+}
+
 template<class TInputImage, class TOutputImage, class TDisplacementField>
 void
 StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
@@ -297,6 +438,7 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
  {
   Superclass::PrintSelf(os, indent);
   os << indent << "Maximum displacement: " << m_MaximumDisplacement << std::endl;
+  os << indent << "Incremental warping: " << m_IncrementalWarping << std::endl;
  }
 
 } // end namespace otb
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGenericRSTransform.h"
+
+/**
+  * Check that TransformGrid() gives the same points as TransformPoint()
+  * on each node of the grid.
+  */
+
+int otbGenericRSTransformGrid(int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  typedef otb::GenericRSTransform<>          TransformType;
+  typedef TransformType::InputPointType      InputPointType;
+  typedef TransformType::OutputPointType     OutputPointType;
+
+  TransformType::Pointer utm2wgs = TransformType::New();
+  utm2wgs->SetInputProjectionRef("32631");  // UTM 31 N
+  utm2wgs->SetOutputProjectionRef("4326");  // WGS 84
+  utm2wgs->InstantiateTransform();
+
+  InputPointType origin;
+  origin[0] = 374100.;
+  origin[1] = 4829184.;
+
+  TransformType::SpacingType spacing;
+  spacing[0] = 250.;
+  spacing[1] = -125.;
+
+  TransformType::GridSizeType size;
+  size[0] = 17;
+  size[1] = 9;
+
+  std::vector<OutputPointType> gridPoints;
+  utm2wgs->TransformGrid(origin, spacing, size, gridPoints);
+
+  if (gridPoints.size() != size[0] * size[1])
+    {
+    std::cerr << "TransformGrid returned " << gridPoints.size() << " points instead of "
+              << size[0] * size[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (unsigned int j = 0; j < size[1]; ++j)
+    {
+    for (unsigned int i = 0; i < size[0]; ++i)
+      {
+      InputPointType node;
+      node[0] = origin[0] + i * spacing[0];
+      node[1] = origin[1] + j * spacing[1];
+
+      const OutputPointType expected = utm2wgs->TransformPoint(node);
+      const OutputPointType & point = gridPoints[j * size[0] + i];
+
+      if (vcl_abs(point[0] - expected[0]) > 1e-12 || vcl_abs(point[1] - expected[1]) > 1e-12)
+        {
+        std::cerr << "Node (" << i << ", " << j << "): TransformGrid gives " << point
+                  << " while TransformPoint gives " << expected << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -27,9 +27,9 @@
 
 int otbStreamingWarpImageFilter(int argc, char* argv[])
 {
-  if (argc != 5)
+  if (argc != 5 && argc != 6)
     {
-    std::cout << "usage: " << argv[0] << "infname deffname outfname radius" << std::endl;
+    std::cout << "usage: " << argv[0] << "infname deffname outfname radius [incremental]" << std::endl;
     return EXIT_SUCCESS;
     }
 
@@ -38,6 +38,7 @@ int otbStreamingWarpImageFilter(int argc, char* argv[])
   const char * deffname = argv[2];
   const char * outfname = argv[3];
   const double maxdef = atoi(argv[4]);
+  const bool incremental = (argc == 6 && atoi(argv[5]) != 0);
 
   // Images definition
   const unsigned int Dimension = 2;
@@ -75,6 +76,7 @@ int otbStreamingWarpImageFilter(int argc, char* argv[])
   warper->SetInput(reader->GetOutput());
   warper->SetDisplacementField(displacementReader->GetOutput());
   warper->SetOutputOrigin(origin);
+  warper->SetIncrementalWarping(incremental);
 
   // Writing
   writer->SetInput(warper->GetOutput());
@@ -30,6 +30,7 @@ void RegisterTests()
   REGISTER_TEST(otbStreamingWarpImageFilterNew);
   REGISTER_TEST(otbLogPolarTransform);
   REGISTER_TEST(otbGenericRSTransformNew);
+  REGISTER_TEST(otbGenericRSTransformGrid);
   REGISTER_TEST(otbLogPolarTransformNew);
   REGISTER_TEST(otbGeocentricTransform);
   REGISTER_TEST(otbCreateProjectionWithOTB);
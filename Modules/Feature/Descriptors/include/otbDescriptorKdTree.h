@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbDescriptorKdTree_h
+#define otbDescriptorKdTree_h
+
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace otb
+{
+/** \class DescriptorKdTree
+ *  \brief Index of descriptors for the search of their two nearest neighbors.
+ *
+ *  The descriptors are stored contiguously, and indexed by one or
+ *  several k-d trees. Each node splits its descriptors on the mean of
+ *  the component of highest variance. The first tree always uses this
+ *  component, the other ones pick it randomly among the components of
+ *  highest variance (randomized k-d forest).
+ *
+ *  The search of the two nearest neighbors of a descriptor (in the
+ *  Euclidean sense) is either exact, using the first tree only, or
+ *  approximate: the leaves of all the trees are then visited in the
+ *  order of their distance to the query (best bin first), until a
+ *  given number of descriptors has been checked.
+ *
+ *  The exact search returns the same neighbors as a linear scan of the
+ *  descriptors keeping the first one in case of ties, and the same
+ *  distances as itk::Statistics::EuclideanDistanceMetric. Searches can
+ *  be run concurrently once the trees are built.
+ *
+ *  \sa KeyPointSetsMatchingFilter
+ *
+ * \ingroup OTBDescriptors
+ */
+template <class TValue>
+class ITK_EXPORT DescriptorKdTree
+  : public itk::Object
+{
+public:
+  /// standard class typedefs
+  typedef DescriptorKdTree              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /// standard macros
+  itkNewMacro(Self);
+  itkTypeMacro(DescriptorKdTree, itk::Object);
+
+  typedef TValue                        ValueType;
+  typedef std::vector<ValueType>        DescriptorsType;
+
+  /** Result of the search of the two nearest neighbors */
+  struct NeighborsType
+  {
+    /** Positions of the nearest and second nearest descriptors (-1 if not found) */
+    long   Index[2];
+    /** Their squared distances to the query */
+    double SquaredDistance[2];
+  };
+
+  /// Accessors
+  itkSetMacro(NumberOfTrees, unsigned int);
+  itkGetConstMacro(NumberOfTrees, unsigned int);
+  itkSetMacro(LeafSize, unsigned int);
+  itkGetConstMacro(LeafSize, unsigned int);
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Set the descriptors, stored contiguously. Their content is swapped
+   *  with the internal storage. The trees have to be built again. */
+  void SetDescriptors(DescriptorsType & descriptors, unsigned int dimension);
+
+  /** Number of stored descriptors */
+  unsigned long GetNumberOfDescriptors() const;
+
+  /** Dimension of the descriptors */
+  unsigned int GetDimension() const
+  {
+    return m_Dimension;
+  }
+
+  /** Pointer to the components of a stored descriptor */
+  const ValueType * GetDescriptor(unsigned long position) const
+  {
+    return &m_Descriptors[position * m_Dimension];
+  }
+
+  /** Build the trees */
+  void Build();
+
+  /** Search the two nearest neighbors of query. If maxChecks is 0, the
+   *  search is exact. Otherwise, it stops after maxChecks distance
+   *  evaluations. */
+  void Search(const ValueType * query, unsigned int maxChecks, NeighborsType & neighbors) const;
+
+  /** Squared Euclidean distance, computed as in EuclideanDistanceMetric */
+  static double SquaredDistance(const ValueType * a, const ValueType * b, unsigned int dimension);
+
+protected:
+  /// Constructor
+  DescriptorKdTree();
+  /// Destructor
+  ~DescriptorKdTree() ITK_OVERRIDE {}
+  /// PrintSelf method
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+
+private:
+  DescriptorKdTree(const Self &); // purposely not implemented
+  void operator =(const Self&);   // purposely not implemented
+
+  /** Node of a tree. Leaves have no children, and hold the positions
+   *  [Begin, End[ of the tree permutation. */
+  struct NodeType
+  {
+    unsigned int  SplitDimension;
+    ValueType     SplitValue;
+    long          Children[2];
+    unsigned long Begin;
+    unsigned long End;
+  };
+
+  typedef std::vector<NodeType>      NodeVectorType;
+  typedef std::vector<unsigned long> PermutationType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  /** Branch not explored yet by the approximate search */
+  struct BranchType
+  {
+    double       Bound;
+    unsigned int Tree;
+    long         Node;
+
+    bool operator>(const BranchType& other) const
+    {
+      return Bound > other.Bound;
+    }
+  };
+
+  /** Order of the components by decreasing variance */
+  struct VarianceGreater
+  {
+    explicit VarianceGreater(const std::vector<double>& variances) : m_Variances(variances) {}
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+      return m_Variances[a] > m_Variances[b];
+    }
+    const std::vector<double>& m_Variances;
+  };
+
+  /** Order of the descriptors along a component */
+  struct ComponentLess
+  {
+    ComponentLess(const Self * tree, unsigned int component) : m_Tree(tree), m_Component(component) {}
+    bool operator()(unsigned long a, unsigned long b) const
+    {
+      return m_Tree->GetDescriptor(a)[m_Component] < m_Tree->GetDescriptor(b)[m_Component];
+    }
+    const Self * m_Tree;
+    unsigned int m_Component;
+  };
+
+  /** Is the component of a descriptor lower than a value ? */
+  struct LowerThanValue
+  {
+    LowerThanValue(const Self * tree, unsigned int component, ValueType value)
+      : m_Tree(tree), m_Component(component), m_Value(value) {}
+    bool operator()(unsigned long a) const
+    {
+      return m_Tree->GetDescriptor(a)[m_Component] < m_Value;
+    }
+    const Self * m_Tree;
+    unsigned int m_Component;
+    ValueType    m_Value;
+  };
+
+  /** Insert a candidate in the two nearest neighbors */
+  static void InsertNeighbor(long position, double squaredDistance, NeighborsType & neighbors);
+
+  /** Build the subtree of the descriptors [begin, end[ of the tree
+   *  permutation and return its node index */
+  long BuildNode(unsigned int tree, unsigned long begin, unsigned long end);
+
+  /** Exact search in the subtree of node */
+  void SearchExact(long node, const ValueType * query, NeighborsType & neighbors) const;
+
+  /** Check the descriptors of a leaf and update the neighbors, return
+   *  the number of distance evaluations */
+  unsigned long CheckLeaf(unsigned int tree, const NodeType & leaf, const ValueType * query,
+                          NeighborsType & neighbors) const;
+
+  unsigned int    m_NumberOfTrees;
+  unsigned int    m_LeafSize;
+  unsigned int    m_Seed;
+  unsigned int    m_Dimension;
+  DescriptorsType m_Descriptors;
+
+  std::vector<NodeVectorType>  m_Trees;
+  std::vector<PermutationType> m_Permutations;
+
+  /** Per-component variances of the node being built */
+  std::vector<double> m_Variances;
+
+  /** Random choice of the split components, while building */
+  GeneratorType::Pointer m_Generator;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbDescriptorKdTree.txx"
+#endif
+#endif
@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbDescriptorKdTree_txx
+#define otbDescriptorKdTree_txx
+
+#include "otbDescriptorKdTree.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace otb
+{
+
+template <class TValue>
+DescriptorKdTree<TValue>
+::DescriptorKdTree()
+{
+  m_NumberOfTrees = 1;
+  m_LeafSize = 16;
+  m_Seed = 121212;
+  m_Dimension = 0;
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::SetDescriptors(DescriptorsType & descriptors, unsigned int dimension)
+{
+  m_Descriptors.swap(descriptors);
+  m_Dimension = dimension;
+  m_Trees.clear();
+  m_Permutations.clear();
+  this->Modified();
+}
+
+template <class TValue>
+unsigned long
+DescriptorKdTree<TValue>
+::GetNumberOfDescriptors() const
+{
+  return m_Dimension > 0 ? m_Descriptors.size() / m_Dimension : 0;
+}
+
+template <class TValue>
+double
+DescriptorKdTree<TValue>
+::SquaredDistance(const ValueType * a, const ValueType * b, unsigned int dimension)
+{
+  double distance = 0.;
+  for (unsigned int i = 0; i < dimension; ++i)
+    {
+    const double diff = a[i] - b[i];
+    distance += diff * diff;
+    }
+  return distance;
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::Build()
+{
+  const unsigned long nbDescriptors = this->GetNumberOfDescriptors();
+  const unsigned int  nbTrees = std::max(1U, m_NumberOfTrees);
+
+  m_Generator = GeneratorType::New();
+  m_Generator->SetSeed(m_Seed);
+
+  m_Trees.assign(nbTrees, NodeVectorType());
+  m_Permutations.assign(nbTrees, PermutationType());
+
+  for (unsigned int tree = 0; tree < nbTrees && nbDescriptors > 0; ++tree)
+    {
+    m_Permutations[tree].resize(nbDescriptors);
+    for (unsigned long i = 0; i < nbDescriptors; ++i)
+      {
+      m_Permutations[tree][i] = i;
+      }
+    BuildNode(tree, 0, nbDescriptors);
+    }
+
+  m_Generator = ITK_NULLPTR;
+}
+
+template <class TValue>
+long
+DescriptorKdTree<TValue>
+::BuildNode(unsigned int tree, unsigned long begin, unsigned long end)
+{
+  const long nodeIndex = m_Trees[tree].size();
+  NodeType   node;
+  node.SplitDimension = 0;
+  node.SplitValue = ValueType();
+  node.Children[0] = -1;
+  node.Children[1] = -1;
+  node.Begin = begin;
+  node.End = end;
+  m_Trees[tree].push_back(node);
+
+  if (end - begin <= std::max(1U, m_LeafSize))
+    {
+    return nodeIndex;
+    }
+
+  PermutationType& permutation = m_Permutations[tree];
+
+  // Mean and variance of each component, estimated on at most 100
+  // descriptors regularly spread in the node
+  const unsigned long nbSamples = std::min(end - begin, 100UL);
+  const unsigned long step = (end - begin) / nbSamples;
+  std::vector<double> means(m_Dimension, 0.);
+  m_Variances.assign(m_Dimension, 0.);
+  for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+    const ValueType * descriptor = GetDescriptor(permutation[begin + s * step]);
+    for (unsigned int i = 0; i < m_Dimension; ++i)
+      {
+      means[i] += descriptor[i];
+      m_Variances[i] += static_cast<double>(descriptor[i]) * descriptor[i];
+      }
+    }
+
+  std::vector<unsigned int> components(m_Dimension);
+  for (unsigned int i = 0; i < m_Dimension; ++i)
+    {
+    means[i] /= nbSamples;
+    m_Variances[i] = m_Variances[i] / nbSamples - means[i] * means[i];
+    components[i] = i;
+    }
+
+  // Split on the component of highest variance for the first tree, and
+  // on one of the five highest for the others
+  const unsigned int nbCandidates = tree == 0 ? 1 : std::min(5U, m_Dimension);
+  std::partial_sort(components.begin(), components.begin() + nbCandidates, components.end(),
+                    VarianceGreater(m_Variances));
+  const unsigned int splitDimension =
+    components[nbCandidates > 1 ? m_Generator->GetIntegerVariate(nbCandidates - 1) : 0];
+
+  // Split on the mean. Descriptors on the left are strictly lower than
+  // the split value, the ones on the right are greater or equal.
+  ValueType splitValue = static_cast<ValueType>(means[splitDimension]);
+  unsigned long middle = std::partition(permutation.begin() + begin, permutation.begin() + end,
+                                        LowerThanValue(this, splitDimension, splitValue))
+                         - permutation.begin();
+
+  // If all the descriptors fall on the same side, split on the median.
+  // Descriptors on the left are then lower or equal.
+  if (middle == begin || middle == end)
+    {
+    middle = begin + (end - begin) / 2;
+    std::nth_element(permutation.begin() + begin, permutation.begin() + middle,
+                     permutation.begin() + end, ComponentLess(this, splitDimension));
+    splitValue = GetDescriptor(permutation[middle])[splitDimension];
+    }
+
+  const long left = BuildNode(tree, begin, middle);
+  const long right = BuildNode(tree, middle, end);
+
+  NodeType& built = m_Trees[tree][nodeIndex];
+  built.SplitDimension = splitDimension;
+  built.SplitValue = splitValue;
+  built.Children[0] = left;
+  built.Children[1] = right;
+
+  return nodeIndex;
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::InsertNeighbor(long position, double squaredDistance, NeighborsType & neighbors)
+{
+  if (position == neighbors.Index[0] || position == neighbors.Index[1])
+    {
+    // Already found in another tree
+    return;
+    }
+  // Ties are broken by position, so that the result does not depend on
+  // the visit order
+  if (squaredDistance < neighbors.SquaredDistance[0]
+      || (squaredDistance == neighbors.SquaredDistance[0]
+          && (neighbors.Index[0] < 0 || position < neighbors.Index[0])))
+    {
+    neighbors.Index[1] = neighbors.Index[0];
+    neighbors.SquaredDistance[1] = neighbors.SquaredDistance[0];
+    neighbors.Index[0] = position;
+    neighbors.SquaredDistance[0] = squaredDistance;
+    }
+  else if (squaredDistance < neighbors.SquaredDistance[1]
+           || (squaredDistance == neighbors.SquaredDistance[1]
+               && (neighbors.Index[1] < 0 || position < neighbors.Index[1])))
+    {
+    neighbors.Index[1] = position;
+    neighbors.SquaredDistance[1] = squaredDistance;
+    }
+}
+
+template <class TValue>
+unsigned long
+DescriptorKdTree<TValue>
+::CheckLeaf(unsigned int tree, const NodeType & leaf, const ValueType * query,
+            NeighborsType & neighbors) const
+{
+  const PermutationType& permutation = m_Permutations[tree];
+  for (unsigned long p = leaf.Begin; p < leaf.End; ++p)
+    {
+    const long position = permutation[p];
+    InsertNeighbor(position, SquaredDistance(query, GetDescriptor(position), m_Dimension), neighbors);
+    }
+  return leaf.End - leaf.Begin;
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::SearchExact(long nodeIndex, const ValueType * query, NeighborsType & neighbors) const
+{
+  const NodeType& node = m_Trees[0][nodeIndex];
+  if (node.Children[0] < 0)
+    {
+    CheckLeaf(0, node, query, neighbors);
+    return;
+    }
+
+  // The difference is computed as in the distance, so that it is never
+  // larger than the one of the descriptors on the other side
+  const double diff = query[node.SplitDimension] - node.SplitValue;
+  const unsigned int nearSide = diff < 0 ? 0 : 1;
+
+  SearchExact(node.Children[nearSide], query, neighbors);
+
+  // Descriptors at the same distance as the second neighbor are
+  // checked, since they may have a lower position
+  if (diff * diff <= neighbors.SquaredDistance[1])
+    {
+    SearchExact(node.Children[1 - nearSide], query, neighbors);
+    }
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::Search(const ValueType * query, unsigned int maxChecks, NeighborsType & neighbors) const
+{
+  neighbors.Index[0] = -1;
+  neighbors.Index[1] = -1;
+  neighbors.SquaredDistance[0] = std::numeric_limits<double>::max();
+  neighbors.SquaredDistance[1] = std::numeric_limits<double>::max();
+
+  if (m_Trees.empty() || m_Trees[0].empty())
+    {
+    return;
+    }
+
+  if (maxChecks == 0)
+    {
+    SearchExact(0, query, neighbors);
+    return;
+    }
+
+  // Best bin first over all the trees
+  std::priority_queue<BranchType, std::vector<BranchType>, std::greater<BranchType> > branches;
+  for (unsigned int tree = 0; tree < m_Trees.size(); ++tree)
+    {
+    BranchType root;
+    root.Bound = 0.;
+    root.Tree = tree;
+    root.Node = 0;
+    branches.push(root);
+    }
+
+  unsigned long checks = 0;
+  while (!branches.empty())
+    {
+    const BranchType branch = branches.top();
+    branches.pop();
+
+    if ((checks >= maxChecks && neighbors.Index[1] >= 0)
+        || branch.Bound > neighbors.SquaredDistance[1])
+      {
+      break;
+      }
+
+    const NodeVectorType& nodes = m_Trees[branch.Tree];
+    long nodeIndex = branch.Node;
+    while (nodes[nodeIndex].Children[0] >= 0)
+      {
+      const NodeType& node = nodes[nodeIndex];
+      const double diff = query[node.SplitDimension] - node.SplitValue;
+      const unsigned int nearSide = diff < 0 ? 0 : 1;
+
+      if (diff * diff <= neighbors.SquaredDistance[1])
+        {
+        BranchType far;
+        far.Bound = diff * diff;
+        far.Tree = branch.Tree;
+        far.Node = node.Children[1 - nearSide];
+        branches.push(far);
+        }
+      nodeIndex = node.Children[nearSide];
+      }
+
+    checks += CheckLeaf(branch.Tree, nodes[nodeIndex], query, neighbors);
+    }
+}
+
+template <class TValue>
+void
+DescriptorKdTree<TValue>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfTrees: " << m_NumberOfTrees << std::endl;
+  os << indent << "LeafSize: " << m_LeafSize << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "NumberOfDescriptors: " << this->GetNumberOfDescriptors() << std::endl;
+  os << indent << "Dimension: " << m_Dimension << std::endl;
+}
+
+} // end namespace otb
+
+#endif
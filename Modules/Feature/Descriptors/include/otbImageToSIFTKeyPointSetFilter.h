@@ -109,6 +109,8 @@ public:
  *
  * Orientation is expressed in degree in the range [0, 360] with a precision of 10 degrees.
  *
+ * The internal scale space filters run with the number of threads of this filter.
+ *
  * \example Patented/SIFTExample.cxx
  *
  *
@@ -184,6 +186,10 @@ public:
   itkSetMacro(SigmaFactorDescriptor, double);
   itkGetMacro(SigmaFactorDescriptor, double);
 
+  /** Copy the detection parameters of another filter (used to run
+   *  several instances on image tiles) */
+  void CopyParameters(const Self * other);
+
   /** Internal typedefs */
   typedef itk::ExpandImageFilter<TInputImage, TInputImage> ExpandFilterType;
   typedef typename ExpandFilterType::Pointer               ExpandFilterPointerType;
@@ -137,6 +137,7 @@ ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
     // Get the last gaussian for subsample and
     // repeat the process
     m_ShrinkFilter = ShrinkFilterType::New();
+    m_ShrinkFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_ShrinkFilter->SetInput(m_LastGaussian);
     m_ShrinkFilter->SetShrinkFactors(m_ShrinkFactors);
     m_ShrinkFilter->Update();
@@ -167,6 +168,25 @@ ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
 
 }
 
+template <class TInputImage, class TOutputPointSet>
+void
+ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
+::CopyParameters(const Self * other)
+{
+  m_OctavesNumber = other->m_OctavesNumber;
+  m_ScalesNumber = other->m_ScalesNumber;
+  m_ExpandFactors = other->m_ExpandFactors;
+  m_ShrinkFactors = other->m_ShrinkFactors;
+  m_Sigma0 = other->m_Sigma0;
+  m_DoGThreshold = other->m_DoGThreshold;
+  m_EdgeThreshold = other->m_EdgeThreshold;
+  m_GradientMagnitudeThreshold = other->m_GradientMagnitudeThreshold;
+  m_SigmaFactorOrientation = other->m_SigmaFactorOrientation;
+  m_SigmaFactorDescriptor = other->m_SigmaFactorDescriptor;
+  m_ChangeSamplePointsMax = other->m_ChangeSamplePointsMax;
+  this->Modified();
+}
+
 /**
  * Initialize the input image
  */
@@ -175,6 +195,7 @@ void
 ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
 ::InitializeInputImage()
 {
+  m_ExpandFilter->SetNumberOfThreads(this->GetNumberOfThreads());
   m_ExpandFilter->SetInput(this->GetInput());
   m_ExpandFilter->SetExpandFactors(m_ExpandFactors);
   m_ExpandFilter->Update();
@@ -223,10 +244,12 @@ ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
 
     m_XGaussianFilter->SetSigma(xsigman);
     m_XGaussianFilter->SetDirection(0);
+    m_XGaussianFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_XGaussianFilter->SetInput(input);
 
     m_YGaussianFilter->SetSigma(ysigman);
     m_YGaussianFilter->SetDirection(1);
+    m_YGaussianFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_YGaussianFilter->SetInput(m_XGaussianFilter->GetOutput());
 
     m_YGaussianFilter->Update();
@@ -235,8 +258,11 @@ ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
     m_MagnitudeFilter = MagnitudeFilterType::New();
     m_OrientationFilter = OrientationFilterType::New();
 
+    m_GradientFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_GradientFilter->SetInput(m_YGaussianFilter->GetOutput());
+    m_MagnitudeFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_MagnitudeFilter->SetInput(m_GradientFilter->GetOutput());
+    m_OrientationFilter->SetNumberOfThreads(this->GetNumberOfThreads());
     m_OrientationFilter->SetInput(m_GradientFilter->GetOutput());
 
     m_MagnitudeFilter->Update();
@@ -248,6 +274,7 @@ ImageToSIFTKeyPointSetFilter<TInputImage, TOutputPointSet>
     if (lScale > 0)
       {
       m_SubtractFilter = SubtractFilterType::New();
+      m_SubtractFilter->SetNumberOfThreads(this->GetNumberOfThreads());
       m_SubtractFilter->SetInput1(m_YGaussianFilter->GetOutput());
       m_SubtractFilter->SetInput2(previousGaussian);
       m_SubtractFilter->Update();
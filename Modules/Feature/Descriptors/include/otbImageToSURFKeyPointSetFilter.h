@@ -54,6 +54,8 @@ namespace otb
  *
  * Orientation is expressed in degree in the range of [0, 360]
  *
+ * The internal filters run with the number of threads of this filter.
+ *
  *  \sa otb::ImageToDeterminantHessianImage
  *
  * \ingroup OTBDescriptors
@@ -105,6 +107,10 @@ public:
   /** Get the number of KeyPoints detected*/
   itkGetMacro(NumberOfPoints, int);
 
+  /** Copy the detection parameters of another filter (used to run
+   *  several instances on image tiles) */
+  void CopyParameters(const Self * other);
+
   /** Internal filters typedefs */
   typedef itk::ConstNeighborhoodIterator<InputImageType>      NeighborhoodIteratorType;
   typedef typename NeighborhoodIteratorType::NeighborhoodType NeighborhoodType;
@@ -103,6 +103,7 @@ ImageToSURFKeyPointSetFilter<TInputImage, TOutputPointSet>
       {
 
       m_ResampleFilter = ResampleFilterType::New();
+      m_ResampleFilter->SetNumberOfThreads(this->GetNumberOfThreads());
       m_ResampleFilter->SetInput(this->GetInput());
 
       SizeType size = this->GetInput()->GetLargestPossibleRegion().GetSize();
@@ -142,6 +143,7 @@ ImageToSURFKeyPointSetFilter<TInputImage, TOutputPointSet>
 
       /** Hessian Determinant Image */
       m_DetHessianFilter = ImageToDetHessianImageType::New();
+      m_DetHessianFilter->SetNumberOfThreads(this->GetNumberOfThreads());
 
       if (i == 0) m_DetHessianFilter->SetInput(this->GetInput());
       else m_DetHessianFilter->SetInput(m_determinantImage);
@@ -326,6 +328,17 @@ ImageToSURFKeyPointSetFilter<TInputImage, TOutputPointSet>
 
 } /** End of GenerateData()*/
 
+template <class TInputImage, class TOutputPointSet>
+void
+ImageToSURFKeyPointSetFilter<TInputImage, TOutputPointSet>
+::CopyParameters(const Self * other)
+{
+  m_OctavesNumber = other->m_OctavesNumber;
+  m_ScalesNumber = other->m_ScalesNumber;
+  m_DoHThreshold = other->m_DoHThreshold;
+  this->Modified();
+}
+
 template <class TInputImage, class TOutputPointSet>
 int
 ImageToSURFKeyPointSetFilter<TInputImage, TOutputPointSet>
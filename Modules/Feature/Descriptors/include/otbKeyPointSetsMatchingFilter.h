@@ -23,7 +23,10 @@
 
 #include "otbObjectListSource.h"
 #include "otbLandmark.h"
+#include "otbDescriptorKdTree.h"
 #include "itkEuclideanDistanceMetric.h"
+#include "itkMeasurementVectorTraits.h"
+#include "itkMultiThreader.h"
 
 namespace otb
 {
@@ -41,9 +44,17 @@ namespace otb
  *   Matches are stored in a landmark object containing both matched points and point data. The landmark data will hold the distance value
  *   between the data.
  *
+ *   By default, the nearest neighbors are searched by scanning the other pointset. If the indexed search is activated, the point data
+ *   are copied in contiguous arrays indexed by k-d trees (see DescriptorKdTree), and the searches are run by the threads of the filter.
+ *   This requires the distance to be the Euclidean one. If MaximumNumberOfChecks is 0 (the default), the search is exact and the
+ *   matches are the same as with the linear scan. Otherwise, NumberOfTrees randomized k-d trees are searched, checking at most
+ *   MaximumNumberOfChecks point data per search, which is much faster for high dimensional descriptors such as SIFT or SURF ones,
+ *   at the cost of some missed neighbors.
+ *
  *   \sa Landmark
  *   \sa PointSet
  *   \sa EuclideanDistanceMetric
+ *   \sa DescriptorKdTree
  *
  * \ingroup OTBDescriptors
  */
@@ -77,6 +88,10 @@ public:
   typedef ObjectList<LandmarkType>           LandmarkListType;
   typedef typename LandmarkListType::Pointer LandmarkListPointerType;
   typedef std::pair<unsigned int, double>    NeighborSearchResultType;
+  typedef typename itk::Statistics::MeasurementVectorTraitsTypes<
+      PointDataType>::ValueType                DataValueType;
+  typedef DescriptorKdTree<DataValueType>    KdTreeType;
+  typedef typename KdTreeType::Pointer       KdTreePointerType;
 
   /// standard macros
   itkNewMacro(Self);
@@ -88,6 +103,13 @@ public:
   itkGetMacro(UseBackMatching, bool);
   itkSetMacro(DistanceThreshold, double);
   itkGetMacro(DistanceThreshold, double);
+  itkBooleanMacro(UseIndexedSearch);
+  itkSetMacro(UseIndexedSearch, bool);
+  itkGetMacro(UseIndexedSearch, bool);
+  itkSetMacro(MaximumNumberOfChecks, unsigned int);
+  itkGetMacro(MaximumNumberOfChecks, unsigned int);
+  itkSetMacro(NumberOfTrees, unsigned int);
+  itkGetMacro(NumberOfTrees, unsigned int);
 
   /// Set the first pointset
   void SetInput1(const PointSetType * pointset);
@@ -115,6 +137,21 @@ protected:
    */
   NeighborSearchResultType NearestNeighbor(const PointDataType& data1, const PointSetType * pointset);
 
+  /** Match the pointsets with the indexed search */
+  void GenerateDataIndexed();
+
+  /** Copy the point data of a pointset in a k-d tree and build it */
+  KdTreePointerType BuildKdTree(const PointSetType * pointset, std::vector<unsigned int>& identifiers);
+
+  /**
+   * Find the nearest neighbor of query in the k-d tree.
+   * \return a pair of (position in the tree, distance ratio).
+   */
+  NeighborSearchResultType IndexedNearestNeighbor(const DataValueType * query, const KdTreeType * tree) const;
+
+  /** Match the points of the first pointset in [startIndex, stopIndex[ */
+  void ThreadedMatch(unsigned long startIndex, unsigned long stopIndex);
+
 private:
   KeyPointSetsMatchingFilter(const Self &); // purposely not implemented
   void operator =(const Self&);             // purposely not implemented
@@ -127,6 +164,34 @@ private:
 
   // Distance calculator
   DistancePointerType m_DistanceCalculator;
+
+  // Search the neighbors with k-d trees
+  bool m_UseIndexedSearch;
+
+  // Maximum number of point data checked per indexed search (0 for an exact search)
+  unsigned int m_MaximumNumberOfChecks;
+
+  // Number of k-d trees used by the approximate search
+  unsigned int m_NumberOfTrees;
+
+  // k-d trees of the pointsets and identifiers of their point data
+  KdTreePointerType         m_KdTree1;
+  KdTreePointerType         m_KdTree2;
+  std::vector<unsigned int> m_Identifiers1;
+  std::vector<unsigned int> m_Identifiers2;
+
+  // Forward search results and validity of the matches, per point of the first pointset
+  std::vector<NeighborSearchResultType> m_SearchResults;
+  std::vector<char>                     m_MatchFound;
+
+  /** Static function used as a "callback" by the MultiThreader */
+  static ITK_THREAD_RETURN_TYPE MatchThreaderCallback(void *arg);
+
+  /** Internal structure used for passing the filter to the threading library */
+  struct ThreadStruct
+  {
+    Self * Filter;
+  };
 };
 
 } // end namespace otb
@@ -23,6 +23,9 @@
 
 #include "otbKeyPointSetsMatchingFilter.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace otb
 {
 
@@ -33,6 +36,9 @@ KeyPointSetsMatchingFilter<TPointSet, TDistance>
   this->SetNumberOfRequiredInputs(2);
   m_UseBackMatching   = false;
   m_DistanceThreshold = 0.6;
+  m_UseIndexedSearch = false;
+  m_MaximumNumberOfChecks = 0;
+  m_NumberOfTrees = 4;
   // Object used to measure distance
   m_DistanceCalculator = DistanceType::New();
 }
@@ -88,6 +94,12 @@ KeyPointSetsMatchingFilter<TPointSet, TDistance>
     itkExceptionMacro(<< "Empty input pointset !");
     }
 
+  if (m_UseIndexedSearch)
+    {
+    this->GenerateDataIndexed();
+    return;
+    }
+
   // Get the output pointer
   LandmarkListPointerType landmarks = this->GetOutput();
 
@@ -223,12 +235,198 @@ KeyPointSetsMatchingFilter<TPointSet, TDistance>
 
 }
 
+template <class TPointSet, class TDistance>
+void
+KeyPointSetsMatchingFilter<TPointSet, TDistance>
+::GenerateDataIndexed()
+{
+  const PointSetType * ps1 =  this->GetInput1();
+  const PointSetType * ps2 =  this->GetInput2();
+
+  // Index the point data. The first pointset is only searched for back
+  // matching, but its point data are always used as queries.
+  m_KdTree1 = this->BuildKdTree(ps1, m_Identifiers1);
+  m_KdTree2 = this->BuildKdTree(ps2, m_Identifiers2);
+
+  if (m_KdTree1->GetDimension() != m_KdTree2->GetDimension())
+    {
+    itkExceptionMacro(<< "Point data of the input pointsets have different sizes !");
+    }
+
+  // Search the matches with the filter threads
+  const unsigned long nbPoints = m_Identifiers1.size();
+  m_SearchResults.assign(nbPoints, NeighborSearchResultType(0, 1.));
+  m_MatchFound.assign(nbPoints, 0);
+
+  ThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+  this->GetMultiThreader()->SetSingleMethod(this->MatchThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Add the landmarks in the order of the first pointset
+  LandmarkListPointerType landmarks = this->GetOutput();
+
+  for (unsigned long i = 0; i < nbPoints; ++i)
+    {
+    if (!m_MatchFound[i])
+      {
+      continue;
+      }
+    const unsigned int identifier1 = m_Identifiers1[i];
+    const unsigned int identifier2 = m_Identifiers2[m_SearchResults[i].first];
+
+    LandmarkPointerType landmark = LandmarkType::New();
+    landmark->SetPoint1(ps1->GetPoints()->GetElement(identifier1));
+    landmark->SetPointData1(ps1->GetPointData()->GetElement(identifier1));
+    landmark->SetPoint2(ps2->GetPoints()->GetElement(identifier2));
+    landmark->SetPointData2(ps2->GetPointData()->GetElement(identifier2));
+    landmark->SetLandmarkData(m_SearchResults[i].second);
+
+    landmarks->PushBack(landmark);
+    }
+
+  // Release the search structures
+  m_KdTree1 = ITK_NULLPTR;
+  m_KdTree2 = ITK_NULLPTR;
+  m_Identifiers1.clear();
+  m_Identifiers2.clear();
+  m_SearchResults.clear();
+  m_MatchFound.clear();
+}
+
+template <class TPointSet, class TDistance>
+typename KeyPointSetsMatchingFilter<TPointSet, TDistance>::KdTreePointerType
+KeyPointSetsMatchingFilter<TPointSet, TDistance>
+::BuildKdTree(const PointSetType * pointset, std::vector<unsigned int>& identifiers)
+{
+  identifiers.clear();
+  identifiers.reserve(pointset->GetNumberOfPoints());
+
+  typename KdTreeType::DescriptorsType descriptors;
+  unsigned int dimension = 0;
+
+  // Only the point data with a point are matched, as in the linear scan
+  PointsIteratorType    pIt  = pointset->GetPoints()->Begin();
+  PointDataIteratorType pdIt = pointset->GetPointData()->Begin();
+
+  while (pdIt != pointset->GetPointData()->End()
+         && pIt != pointset->GetPoints()->End())
+    {
+    const PointDataType& data = pdIt.Value();
+    const unsigned int   length = itk::Statistics::MeasurementVectorTraits::GetLength(data);
+    if (identifiers.empty())
+      {
+      dimension = length;
+      descriptors.reserve(static_cast<size_t>(dimension) * pointset->GetNumberOfPoints());
+      }
+    else if (length != dimension)
+      {
+      itkExceptionMacro(<< "Point data of different sizes in the same pointset !");
+      }
+    for (unsigned int i = 0; i < dimension; ++i)
+      {
+      descriptors.push_back(data[i]);
+      }
+    identifiers.push_back(pdIt.Index());
+    ++pdIt;
+    ++pIt;
+    }
+
+  KdTreePointerType tree = KdTreeType::New();
+  tree->SetNumberOfTrees(m_MaximumNumberOfChecks > 0 ? m_NumberOfTrees : 1);
+  tree->SetDescriptors(descriptors, dimension);
+  tree->Build();
+  return tree;
+}
+
+template <class TPointSet, class TDistance>
+typename KeyPointSetsMatchingFilter<TPointSet, TDistance>::NeighborSearchResultType
+KeyPointSetsMatchingFilter<TPointSet, TDistance>
+::IndexedNearestNeighbor(const DataValueType * query, const KdTreeType * tree) const
+{
+  typename KdTreeType::NeighborsType neighbors;
+  tree->Search(query, m_MaximumNumberOfChecks, neighbors);
+
+  // Same ratio as in NearestNeighbor()
+  NeighborSearchResultType result;
+  result.first = std::max(0L, neighbors.Index[0]);
+  if (neighbors.Index[1] < 0 || neighbors.SquaredDistance[1] == 0)
+    {
+    result.second = 1;
+    }
+  else
+    {
+    result.second = std::sqrt(neighbors.SquaredDistance[0]) / std::sqrt(neighbors.SquaredDistance[1]);
+    }
+  return result;
+}
+
+template <class TPointSet, class TDistance>
+void
+KeyPointSetsMatchingFilter<TPointSet, TDistance>
+::ThreadedMatch(unsigned long startIndex, unsigned long stopIndex)
+{
+  for (unsigned long i = startIndex; i < stopIndex; ++i)
+    {
+    NeighborSearchResultType searchResult1 =
+      this->IndexedNearestNeighbor(m_KdTree1->GetDescriptor(i), m_KdTree2);
+    m_SearchResults[i] = searchResult1;
+
+    // Check if the neighbor distance is lower than the threshold
+    if (searchResult1.second < m_DistanceThreshold)
+      {
+      if (m_UseBackMatching)
+        {
+        // Test if back search finds the same match
+        NeighborSearchResultType searchResult2 =
+          this->IndexedNearestNeighbor(m_KdTree2->GetDescriptor(searchResult1.first), m_KdTree1);
+        m_MatchFound[i] = (searchResult2.first == i);
+        }
+      else
+        {
+        m_MatchFound[i] = 1;
+        }
+      }
+    }
+}
+
+template <class TPointSet, class TDistance>
+ITK_THREAD_RETURN_TYPE
+KeyPointSetsMatchingFilter<TPointSet, TDistance>
+::MatchThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  ThreadStruct *          str = static_cast<ThreadStruct *>(info->UserData);
+
+  // Contiguous ranges of points
+  const unsigned long nbPoints = str->Filter->m_Identifiers1.size();
+  const unsigned long chunkSize = (nbPoints + threadCount - 1) / threadCount;
+  const unsigned long start = std::min(nbPoints, threadId * chunkSize);
+  const unsigned long stop = std::min(nbPoints, start + chunkSize);
+
+  if (start < stop)
+    {
+    str->Filter->ThreadedMatch(start, stop);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 template <class TPointSet, class TDistance>
 void
 KeyPointSetsMatchingFilter<TPointSet, TDistance>
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "UseBackMatching: " << m_UseBackMatching << std::endl;
+  os << indent << "DistanceThreshold: " << m_DistanceThreshold << std::endl;
+  os << indent << "UseIndexedSearch: " << m_UseIndexedSearch << std::endl;
+  os << indent << "MaximumNumberOfChecks: " << m_MaximumNumberOfChecks << std::endl;
+  os << indent << "NumberOfTrees: " << m_NumberOfTrees << std::endl;
 }
 
 } // end namespace otb
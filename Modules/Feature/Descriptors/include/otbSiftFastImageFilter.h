@@ -83,6 +83,15 @@ public:
   itkSetMacro(ScalesNumber, unsigned int);
   itkGetMacro(ScalesNumber, unsigned int);
 
+  /** Copy the detection parameters of another filter (used to run
+   *  several instances on image tiles). Note that the siftfast library
+   *  is not thread safe, so that instances can not run concurrently. */
+  void CopyParameters(const Self * other)
+  {
+    m_ScalesNumber = other->m_ScalesNumber;
+    this->Modified();
+  }
+
   //Set/Get the Orientation of all KeyPoints
   OrientationVectorType GetOrientationVector()
   {
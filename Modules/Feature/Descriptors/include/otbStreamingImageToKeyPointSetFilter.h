@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingImageToKeyPointSetFilter_h
+#define otbStreamingImageToKeyPointSetFilter_h
+
+#include <map>
+#include <vector>
+
+#include "itkContinuousIndex.h"
+#include "itkMultiThreader.h"
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+
+namespace otb
+{
+
+/** \class PersistentImageToKeyPointSetFilter
+ *  \brief Extract key points from an image tile by tile, in a persistent way.
+ *
+ *  Each streamed piece of the image is split into tiles of TileSize
+ *  pixels, aligned on a grid starting at the origin of the largest
+ *  region. The tiles are processed by the threads of the filter: each
+ *  one is padded by Margin pixels, copied in its own image and given
+ *  to a single-threaded instance of TKeyPointFilter
+ *  (ImageToSIFTKeyPointSetFilter or ImageToSURFKeyPointSetFilter for
+ *  instance), which takes its parameters from the filter returned by
+ *  GetKeyPointFilter() (see the CopyParameters() method of these
+ *  filters). The margin should be
+ *  large enough for the key points of a tile to be detected and
+ *  described as in the whole image, and should be a multiple of the
+ *  octave subsampling factor so that the octaves of the tiles are
+ *  sampled as the ones of the whole image.
+ *
+ *  A tile keeps the key points located in its region, extended by
+ *  SeamTolerance pixels. Key points close to the tile borders may thus
+ *  be found by two tiles. The key points of the tile regions are always
+ *  kept, and added to the output pointset in the order of the tiles. A
+ *  key point found in the extension of a tile only is discarded if
+ *  another tile found one closer than SeamTolerance pixels; otherwise it
+ *  is added once, when the streaming ends. The result does not depend
+ *  on the number of threads.
+ *
+ *  Only the padded piece of the image being streamed is kept in memory,
+ *  with the scale space of the tiles being processed.
+ *
+ * \sa PersistentImageFilter
+ * \sa StreamingImageToKeyPointSetFilter
+ *
+ * \ingroup OTBDescriptors
+ */
+template <class TInputImage, class TKeyPointFilter>
+class ITK_EXPORT PersistentImageToKeyPointSetFilter :
+  public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentImageToKeyPointSetFilter              Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentImageToKeyPointSetFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                           InputImageType;
+  typedef typename InputImageType::Pointer      InputImagePointer;
+  typedef typename InputImageType::RegionType   RegionType;
+  typedef typename InputImageType::SizeType     SizeType;
+  typedef typename InputImageType::IndexType    IndexType;
+  typedef typename InputImageType::PointType    PointType;
+
+  /** Key point filter related typedefs */
+  typedef TKeyPointFilter                              KeyPointFilterType;
+  typedef typename KeyPointFilterType::Pointer         KeyPointFilterPointerType;
+  typedef typename KeyPointFilterType::OutputPointSetType OutputPointSetType;
+  typedef typename OutputPointSetType::Pointer         OutputPointSetPointerType;
+  typedef typename OutputPointSetType::PointType       OutputPointType;
+  typedef typename OutputPointSetType::PixelType       OutputPixelType;
+
+  typedef itk::ContinuousIndex<double, InputImageType::ImageDimension> ContinuousIndexType;
+
+  /** Set/Get the size of the tiles (0 to process each streamed piece as a single tile) */
+  itkSetMacro(TileSize, unsigned int);
+  itkGetConstMacro(TileSize, unsigned int);
+
+  /** Set/Get the padding of the tiles, in pixels */
+  itkSetMacro(Margin, unsigned int);
+  itkGetConstMacro(Margin, unsigned int);
+
+  /** Set/Get the distance in pixels under which key points found by
+   *  neighboring tiles are duplicates */
+  itkSetMacro(SeamTolerance, double);
+  itkGetConstMacro(SeamTolerance, double);
+
+  /** Filter holding the parameters of the key point extraction */
+  itkGetObjectMacro(KeyPointFilter, KeyPointFilterType);
+
+  /** The key points of the whole image */
+  itkGetObjectMacro(OutputPointSet, OutputPointSetType);
+
+  void Reset(void) ITK_OVERRIDE;
+  void Synthetize(void) ITK_OVERRIDE;
+
+protected:
+  PersistentImageToKeyPointSetFilter();
+  ~PersistentImageToKeyPointSetFilter() ITK_OVERRIDE {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+
+  /** Pad the requested region by the margin */
+  void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** The output image is not meant to be used */
+  void AllocateOutputs() ITK_OVERRIDE;
+
+  void GenerateData() ITK_OVERRIDE;
+
+  /** Extract the key points of a tile */
+  virtual void ProcessTile(unsigned int tile);
+
+private:
+  PersistentImageToKeyPointSetFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  /** A key point found in a tile */
+  struct KeyPointType
+  {
+    OutputPointType     Point;
+    OutputPixelType     Data;
+    ContinuousIndexType Index;
+    /** In the region of its tile, not only in the extension */
+    bool                InTile;
+    /** Closer than SeamTolerance to the border of its tile */
+    bool                NearSeam;
+  };
+
+  /** A key point kept close to a tile border */
+  struct SeamKeyPointType
+  {
+    ContinuousIndexType Index;
+    unsigned long       Tile;
+  };
+
+  /** A key point found in the extension of a tile only */
+  struct PendingKeyPointType
+  {
+    KeyPointType  KeyPoint;
+    unsigned long Tile;
+  };
+
+  typedef std::vector<KeyPointType>                          KeyPointVectorType;
+  typedef std::vector<PendingKeyPointType>                   PendingKeyPointVectorType;
+  typedef std::pair<long, long>                              CellType;
+  typedef std::map<CellType, std::vector<SeamKeyPointType> > SeamGridType;
+
+  /** Cell of the seam grid containing a key point */
+  CellType GetSeamCell(const ContinuousIndexType& index) const;
+
+  /** Add a key point to the output pointset */
+  void AddKeyPoint(const KeyPointType& keyPoint);
+
+  /** Add a kept key point to the seam grid */
+  void AddSeamKeyPoint(const ContinuousIndexType& index, unsigned long tile);
+
+  /** Was a key point found by another tile ? */
+  bool IsDuplicate(const ContinuousIndexType& index, unsigned long tile) const;
+
+  /** Static function used as a "callback" by the MultiThreader */
+  static ITK_THREAD_RETURN_TYPE TileThreaderCallback(void *arg);
+
+  /** Internal structure used for passing the filter to the threading library */
+  struct ThreadStruct
+  {
+    Self * Filter;
+  };
+
+  unsigned int m_TileSize;
+  unsigned int m_Margin;
+  double       m_SeamTolerance;
+
+  KeyPointFilterPointerType m_KeyPointFilter;
+  OutputPointSetPointerType m_OutputPointSet;
+
+  /** Tiles of the streamed piece and their key points */
+  std::vector<RegionType>         m_Tiles;
+  std::vector<KeyPointVectorType> m_TileKeyPoints;
+
+  /** Number of tiles processed since the last Reset() */
+  unsigned long m_NumberOfProcessedTiles;
+
+  /** Key points kept close to tile borders */
+  SeamGridType m_SeamGrid;
+
+  /** Key points found in the extension of a tile only, waiting for the
+   *  end of the streaming */
+  PendingKeyPointVectorType m_PendingKeyPoints;
+}; // end of class PersistentImageToKeyPointSetFilter
+
+/** \class StreamingImageToKeyPointSetFilter
+ *  \brief Extract key points from a large image, tile by tile.
+ *
+ *  This class streams the whole input image through the
+ *  PersistentImageToKeyPointSetFilter. The streaming of the image can
+ *  be configured with GetStreamer(), the extraction of the tiles with
+ *  GetFilter(), and the key point parameters with GetKeyPointFilter().
+ *
+ *  \code
+ *  typedef otb::ImageToSIFTKeyPointSetFilter<ImageType, PointSetType> SiftFilterType;
+ *  typedef otb::StreamingImageToKeyPointSetFilter<ImageType, SiftFilterType> ExtractorType;
+ *  ExtractorType::Pointer extractor = ExtractorType::New();
+ *  extractor->SetInput(reader->GetOutput());
+ *  extractor->GetKeyPointFilter()->SetOctavesNumber(3);
+ *  extractor->GetStreamer()->SetAutomaticTiledStreaming();
+ *  extractor->Update();
+ *  PointSetType * keyPoints = extractor->GetOutputPointSet();
+ *  \endcode
+ *
+ * \sa PersistentFilterStreamingDecorator
+ * \sa PersistentImageToKeyPointSetFilter
+ *
+ * \ingroup OTBDescriptors
+ */
+template <class TInputImage, class TKeyPointFilter>
+class ITK_EXPORT StreamingImageToKeyPointSetFilter :
+  public PersistentFilterStreamingDecorator<PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter> >
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingImageToKeyPointSetFilter Self;
+  typedef PersistentFilterStreamingDecorator
+  <PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter> > Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingImageToKeyPointSetFilter, PersistentFilterStreamingDecorator);
+
+  typedef typename Superclass::FilterType            PersistentFilterType;
+  typedef typename PersistentFilterType::KeyPointFilterType KeyPointFilterType;
+  typedef typename PersistentFilterType::OutputPointSetType OutputPointSetType;
+  typedef TInputImage                                InputImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType * input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType * GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  /** Filter holding the parameters of the key point extraction */
+  KeyPointFilterType * GetKeyPointFilter()
+  {
+    return this->GetFilter()->GetKeyPointFilter();
+  }
+
+  /** The key points of the whole image */
+  OutputPointSetType * GetOutputPointSet()
+  {
+    return this->GetFilter()->GetOutputPointSet();
+  }
+
+protected:
+  /** Constructor */
+  StreamingImageToKeyPointSetFilter() {}
+  /** Destructor */
+  ~StreamingImageToKeyPointSetFilter() ITK_OVERRIDE {}
+
+private:
+  StreamingImageToKeyPointSetFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingImageToKeyPointSetFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingImageToKeyPointSetFilter_txx
+#define otbStreamingImageToKeyPointSetFilter_txx
+
+#include "otbStreamingImageToKeyPointSetFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TKeyPointFilter>
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::PersistentImageToKeyPointSetFilter()
+{
+  m_TileSize = 512;
+  m_Margin = 64;
+  m_SeamTolerance = 1.;
+  m_KeyPointFilter = KeyPointFilterType::New();
+  m_OutputPointSet = OutputPointSetType::New();
+  m_NumberOfProcessedTiles = 0;
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::Reset()
+{
+  m_OutputPointSet->Initialize();
+  m_NumberOfProcessedTiles = 0;
+  m_SeamGrid.clear();
+  m_PendingKeyPoints.clear();
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::Synthetize()
+{
+  // The key points found in the extension of a tile only are kept when
+  // the tile holding them did not find them, and only once
+  for (typename PendingKeyPointVectorType::const_iterator it = m_PendingKeyPoints.begin();
+       it != m_PendingKeyPoints.end(); ++it)
+    {
+    if (this->IsDuplicate(it->KeyPoint.Index, it->Tile))
+      {
+      continue;
+      }
+    this->AddSeamKeyPoint(it->KeyPoint.Index, it->Tile);
+    this->AddKeyPoint(it->KeyPoint);
+    }
+
+  m_PendingKeyPoints.clear();
+  m_SeamGrid.clear();
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType * input = const_cast<InputImageType *>(this->GetInput());
+  if (!input)
+    {
+    return;
+    }
+
+  RegionType region = this->GetOutput()->GetRequestedRegion();
+  region.PadByRadius(m_Margin);
+  region.Crop(input->GetLargestPossibleRegion());
+  input->SetRequestedRegion(region);
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::AllocateOutputs()
+{
+  // Nothing that needs to be allocated for the outputs : the output is not meant to be used
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::GenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  const RegionType       streamRegion = this->GetOutput()->GetRequestedRegion();
+  const IndexType        origin = input->GetLargestPossibleRegion().GetIndex();
+
+  // Split the streamed piece on the tile grid
+  IndexType firstTile, lastTile;
+  for (unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+    {
+    const long start = streamRegion.GetIndex()[dim] - origin[dim];
+    const long end = start + static_cast<long>(streamRegion.GetSize()[dim]) - 1;
+    firstTile[dim] = m_TileSize > 0 ? start / m_TileSize : 0;
+    lastTile[dim] = m_TileSize > 0 ? end / m_TileSize : 0;
+    }
+
+  m_Tiles.clear();
+  for (long ty = firstTile[1]; ty <= lastTile[1]; ++ty)
+    {
+    for (long tx = firstTile[0]; tx <= lastTile[0]; ++tx)
+      {
+      RegionType tile = streamRegion;
+      if (m_TileSize > 0)
+        {
+        IndexType index;
+        SizeType  size;
+        index[0] = origin[0] + tx * m_TileSize;
+        index[1] = origin[1] + ty * m_TileSize;
+        size.Fill(m_TileSize);
+        tile.SetIndex(index);
+        tile.SetSize(size);
+        tile.Crop(streamRegion);
+        }
+      m_Tiles.push_back(tile);
+      }
+    }
+
+  // Extract the key points of the tiles with the filter threads
+  m_TileKeyPoints.assign(m_Tiles.size(), KeyPointVectorType());
+
+  ThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+  this->GetMultiThreader()->SetSingleMethod(this->TileThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Add the key points of the tile regions in the order of the tiles.
+  // The ones found in the extension of a tile only wait until the end of
+  // the streaming, as the tile holding them may not be processed yet.
+  for (unsigned int tile = 0; tile < m_Tiles.size(); ++tile)
+    {
+    const unsigned long tileId = m_NumberOfProcessedTiles + tile;
+    const KeyPointVectorType& keyPoints = m_TileKeyPoints[tile];
+
+    for (typename KeyPointVectorType::const_iterator it = keyPoints.begin(); it != keyPoints.end(); ++it)
+      {
+      if (!it->InTile)
+        {
+        if (!this->IsDuplicate(it->Index, tileId))
+          {
+          PendingKeyPointType pending;
+          pending.KeyPoint = *it;
+          pending.Tile = tileId;
+          m_PendingKeyPoints.push_back(pending);
+          }
+        continue;
+        }
+
+      if (it->NearSeam)
+        {
+        this->AddSeamKeyPoint(it->Index, tileId);
+        }
+      this->AddKeyPoint(*it);
+      }
+    }
+
+  m_NumberOfProcessedTiles += m_Tiles.size();
+  m_Tiles.clear();
+  m_TileKeyPoints.clear();
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::ProcessTile(unsigned int tile)
+{
+  const InputImageType * input = this->GetInput();
+  const RegionType&      core = m_Tiles[tile];
+
+  RegionType padded = core;
+  padded.PadByRadius(m_Margin);
+  padded.Crop(input->GetLargestPossibleRegion());
+
+  // Copy the padded tile in its own image, starting at index 0
+  RegionType tileRegion;
+  tileRegion.SetSize(padded.GetSize());
+
+  PointType tileOrigin;
+  input->TransformIndexToPhysicalPoint(padded.GetIndex(), tileOrigin);
+
+  InputImagePointer tileImage = InputImageType::New();
+  tileImage->CopyInformation(input);
+  tileImage->SetRegions(tileRegion);
+  tileImage->SetOrigin(tileOrigin);
+  tileImage->Allocate();
+
+  itk::ImageRegionConstIterator<InputImageType> inIt(input, padded);
+  itk::ImageRegionIterator<InputImageType>      outIt(tileImage, tileRegion);
+  for (inIt.GoToBegin(), outIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++outIt)
+    {
+    outIt.Set(inIt.Get());
+    }
+
+  // The tiles are already processed in parallel
+  KeyPointFilterPointerType keyPointFilter = KeyPointFilterType::New();
+  keyPointFilter->CopyParameters(m_KeyPointFilter);
+  keyPointFilter->SetNumberOfThreads(1);
+  keyPointFilter->SetInput(tileImage);
+  keyPointFilter->Update();
+
+  // Keep the key points of the tile region, extended by the tolerance.
+  // Pixel i covers the continuous indices [i-0.5, i+0.5[.
+  const OutputPointSetType * keyPoints = keyPointFilter->GetOutput();
+  KeyPointVectorType&        kept = m_TileKeyPoints[tile];
+
+  typename OutputPointSetType::PointsContainer::ConstIterator pIt = keyPoints->GetPoints()->Begin();
+  typename OutputPointSetType::PointDataContainer::ConstIterator pdIt = keyPoints->GetPointData()->Begin();
+
+  while (pIt != keyPoints->GetPoints()->End()
+         && pdIt != keyPoints->GetPointData()->End())
+    {
+    KeyPointType keyPoint;
+    keyPoint.Point = pIt.Value();
+    keyPoint.Data = pdIt.Value();
+    keyPoint.InTile = true;
+    keyPoint.NearSeam = false;
+
+    PointType point;
+    for (unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+      {
+      point[dim] = keyPoint.Point[dim];
+      }
+    input->TransformPhysicalPointToContinuousIndex(point, keyPoint.Index);
+
+    bool inside = true;
+    for (unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+      {
+      const double start = core.GetIndex()[dim] - 0.5;
+      const double end = start + core.GetSize()[dim];
+      const double position = keyPoint.Index[dim];
+
+      inside = inside && position >= start - m_SeamTolerance && position < end + m_SeamTolerance;
+      keyPoint.InTile = keyPoint.InTile && position >= start && position < end;
+      keyPoint.NearSeam = keyPoint.NearSeam
+                          || position < start + m_SeamTolerance || position >= end - m_SeamTolerance;
+      }
+
+    if (inside)
+      {
+      kept.push_back(keyPoint);
+      }
+    ++pIt;
+    ++pdIt;
+    }
+}
+
+template <class TInputImage, class TKeyPointFilter>
+typename PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>::CellType
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::GetSeamCell(const ContinuousIndexType& index) const
+{
+  return CellType(static_cast<long>(std::floor(index[0] / m_SeamTolerance)),
+                  static_cast<long>(std::floor(index[1] / m_SeamTolerance)));
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::AddKeyPoint(const KeyPointType& keyPoint)
+{
+  const unsigned long id = m_OutputPointSet->GetNumberOfPoints();
+  m_OutputPointSet->SetPoint(id, keyPoint.Point);
+  m_OutputPointSet->SetPointData(id, keyPoint.Data);
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::AddSeamKeyPoint(const ContinuousIndexType& index, unsigned long tile)
+{
+  SeamKeyPointType seamKeyPoint;
+  seamKeyPoint.Index = index;
+  seamKeyPoint.Tile = tile;
+  m_SeamGrid[this->GetSeamCell(index)].push_back(seamKeyPoint);
+}
+
+template <class TInputImage, class TKeyPointFilter>
+bool
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::IsDuplicate(const ContinuousIndexType& index, unsigned long tile) const
+{
+  // Cells are as large as the tolerance, so that the neighboring cells
+  // hold all the candidates
+  const CellType cell = this->GetSeamCell(index);
+  const double   squaredTolerance = m_SeamTolerance * m_SeamTolerance;
+
+  for (long dy = -1; dy <= 1; ++dy)
+    {
+    for (long dx = -1; dx <= 1; ++dx)
+      {
+      typename SeamGridType::const_iterator cellIt = m_SeamGrid.find(CellType(cell.first + dx, cell.second + dy));
+      if (cellIt == m_SeamGrid.end())
+        {
+        continue;
+        }
+      for (typename std::vector<SeamKeyPointType>::const_iterator it = cellIt->second.begin();
+           it != cellIt->second.end(); ++it)
+        {
+        const double ddx = it->Index[0] - index[0];
+        const double ddy = it->Index[1] - index[1];
+        if (it->Tile != tile && ddx * ddx + ddy * ddy <= squaredTolerance)
+          {
+          return true;
+          }
+        }
+      }
+    }
+  return false;
+}
+
+template <class TInputImage, class TKeyPointFilter>
+ITK_THREAD_RETURN_TYPE
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::TileThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  ThreadStruct *          str = static_cast<ThreadStruct *>(info->UserData);
+
+  // Interleaved tiles, for a better balance between the threads
+  for (unsigned int tile = threadId; tile < str->Filter->m_Tiles.size(); tile += threadCount)
+    {
+    str->Filter->ProcessTile(tile);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TKeyPointFilter>
+void
+PersistentImageToKeyPointSetFilter<TInputImage, TKeyPointFilter>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+  os << indent << "Margin: " << m_Margin << std::endl;
+  os << indent << "SeamTolerance: " << m_SeamTolerance << std::endl;
+  os << indent << "Number of key points: " << m_OutputPointSet->GetNumberOfPoints() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
@@ -30,6 +30,7 @@ otb_module(OTBDescriptors
     OTBImageBase
     OTBObjectList
     OTBPointSet
+    OTBStreaming
     OTBTransform
 
   OPTIONAL_DEPENDS
@@ -32,6 +32,8 @@ void RegisterTests()
   REGISTER_TEST(otbLandmarkNew);
   REGISTER_TEST(otbImageToSIFTKeyPointSetFilterNew);
   REGISTER_TEST(otbKeyPointSetsMatchingFilter);
+  REGISTER_TEST(otbKeyPointSetsMatchingFilterIndexed);
+  REGISTER_TEST(otbStreamingImageToKeyPointSetFilter);
   REGISTER_TEST(otbImageToSIFTKeyPointSetFilterOutputDescriptorAscii);
   REGISTER_TEST(otbImageToSIFTKeyPointSetFilterOutputAscii);
   REGISTER_TEST(otbFourierMellinImageFilter);
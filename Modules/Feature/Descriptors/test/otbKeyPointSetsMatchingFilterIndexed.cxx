@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbKeyPointSetsMatchingFilter.h"
+
+#include "itkVariableLengthVector.h"
+#include "itkPointSet.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <iostream>
+
+namespace
+{
+typedef itk::VariableLengthVector<float>              PointDataType;
+typedef itk::PointSet<PointDataType, 2>               PointSetType;
+typedef PointSetType::PointType                       PointType;
+typedef otb::KeyPointSetsMatchingFilter<PointSetType> MatchingFilterType;
+typedef MatchingFilterType::LandmarkListType          LandmarkListType;
+typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+LandmarkListType::Pointer Match(PointSetType * ps1, PointSetType * ps2, bool backMatching,
+                                bool indexed, unsigned int maxChecks)
+{
+  MatchingFilterType::Pointer filter = MatchingFilterType::New();
+  filter->SetInput1(ps1);
+  filter->SetInput2(ps2);
+  filter->SetDistanceThreshold(0.8);
+  filter->SetUseBackMatching(backMatching);
+  filter->SetUseIndexedSearch(indexed);
+  filter->SetMaximumNumberOfChecks(maxChecks);
+  filter->Update();
+
+  LandmarkListType::Pointer landmarks = filter->GetOutput();
+  return landmarks;
+}
+
+bool SamePoints(const LandmarkListType::ObjectType * l1, const LandmarkListType::ObjectType * l2)
+{
+  return l1->GetPoint1() == l2->GetPoint1() && l1->GetPoint2() == l2->GetPoint2();
+}
+}
+
+int otbKeyPointSetsMatchingFilterIndexed(int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  // This test checks that the exact indexed search gives the same
+  // matches as the linear scan, and that the approximate one finds most
+  // of them
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(121212);
+
+  const unsigned int nbPoints = 3000;
+  const unsigned int dimension = 16;
+
+  // The second pointset holds noisy copies of the point data of the
+  // first one, in another order, and unrelated point data
+  PointSetType::Pointer ps1 = PointSetType::New();
+  PointSetType::Pointer ps2 = PointSetType::New();
+
+  for (unsigned int i = 0; i < nbPoints; ++i)
+    {
+    PointType point;
+    point[0] = i;
+    point[1] = 0;
+
+    PointDataType data(dimension);
+    for (unsigned int k = 0; k < dimension; ++k)
+      {
+      // Some quantized components create ties
+      data[k] = k % 4 == 0 ? generator->GetIntegerVariate(3) : generator->GetUniformVariate(0., 1.);
+      }
+    ps1->SetPoint(i, point);
+    ps1->SetPointData(i, data);
+
+    const unsigned int j = (i * 7) % nbPoints;
+    point[1] = 1;
+    if (i % 3 != 0)
+      {
+      for (unsigned int k = 0; k < dimension; ++k)
+        {
+        data[k] += generator->GetNormalVariate(0., 0.0025);
+        }
+      }
+    else
+      {
+      for (unsigned int k = 0; k < dimension; ++k)
+        {
+        data[k] = generator->GetUniformVariate(0., 3.);
+        }
+      }
+    ps2->SetPoint(j, point);
+    ps2->SetPointData(j, data);
+    }
+
+  bool ok = true;
+
+  for (unsigned int backMatching = 0; backMatching < 2; ++backMatching)
+    {
+    LandmarkListType::Pointer reference = Match(ps1, ps2, backMatching, false, 0);
+    LandmarkListType::Pointer exact = Match(ps1, ps2, backMatching, true, 0);
+    LandmarkListType::Pointer approximate = Match(ps1, ps2, backMatching, true, 256);
+
+    std::cout << "Back matching " << backMatching << ": " << reference->Size() << " matches, "
+              << exact->Size() << " with the exact indexed search, "
+              << approximate->Size() << " with the approximate one" << std::endl;
+
+    if (reference->Size() != exact->Size())
+      {
+      std::cerr << "The exact indexed search does not find the same number of matches" << std::endl;
+      ok = false;
+      continue;
+      }
+
+    for (unsigned int i = 0; i < reference->Size(); ++i)
+      {
+      if (!SamePoints(reference->GetNthElement(i), exact->GetNthElement(i))
+          || reference->GetNthElement(i)->GetLandmarkData() != exact->GetNthElement(i)->GetLandmarkData())
+        {
+        std::cerr << "Match " << i << " differs: " << reference->GetNthElement(i)->GetPoint1() << " -> "
+                  << reference->GetNthElement(i)->GetPoint2() << " (" << reference->GetNthElement(i)->GetLandmarkData()
+                  << ") vs " << exact->GetNthElement(i)->GetPoint1() << " -> " << exact->GetNthElement(i)->GetPoint2()
+                  << " (" << exact->GetNthElement(i)->GetLandmarkData() << ")" << std::endl;
+        ok = false;
+        break;
+        }
+      }
+
+    // Matches of the approximate search found by the linear scan (the
+    // distance ratio may differ if the second neighbor was missed)
+    unsigned int found = 0;
+    unsigned int r = 0;
+    for (unsigned int i = 0; i < approximate->Size(); ++i)
+      {
+      while (r < reference->Size()
+             && reference->GetNthElement(r)->GetPoint1()[0] < approximate->GetNthElement(i)->GetPoint1()[0])
+        {
+        ++r;
+        }
+      if (r < reference->Size() && SamePoints(reference->GetNthElement(r), approximate->GetNthElement(i)))
+        {
+        ++found;
+        }
+      }
+
+    if (found < 0.9 * reference->Size())
+      {
+      std::cerr << "The approximate search finds only " << found << " of the " << reference->Size()
+                << " matches" << std::endl;
+      ok = false;
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
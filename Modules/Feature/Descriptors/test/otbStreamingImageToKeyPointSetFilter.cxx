@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <iostream>
+
+#include "otbStreamingImageToKeyPointSetFilter.h"
+#include "otbImageToSURFKeyPointSetFilter.h"
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "itkVariableLengthVector.h"
+#include "itkPointSet.h"
+
+namespace
+{
+typedef float                                                      RealType;
+typedef otb::Image<RealType, 2>                                    ImageType;
+typedef itk::VariableLengthVector<RealType>                        RealVectorType;
+typedef otb::ImageFileReader<ImageType>                            ReaderType;
+typedef itk::PointSet<RealVectorType, 2>                           PointSetType;
+typedef otb::ImageToSURFKeyPointSetFilter<ImageType, PointSetType> SurfFilterType;
+typedef otb::StreamingImageToKeyPointSetFilter<ImageType, SurfFilterType> StreamingFilterType;
+typedef PointSetType::PointsContainer::ConstIterator               PointsIteratorType;
+
+// Number of points of ps1 closer than tolerance to a point of ps2
+unsigned int CountFound(const PointSetType * ps1, const PointSetType * ps2, double tolerance)
+{
+  unsigned int found = 0;
+  for (PointsIteratorType it1 = ps1->GetPoints()->Begin(); it1 != ps1->GetPoints()->End(); ++it1)
+    {
+    for (PointsIteratorType it2 = ps2->GetPoints()->Begin(); it2 != ps2->GetPoints()->End(); ++it2)
+      {
+      if (it1.Value().EuclideanDistanceTo(it2.Value()) <= tolerance)
+        {
+        ++found;
+        break;
+        }
+      }
+    }
+  return found;
+}
+
+PointSetType::Pointer ExtractTiled(ImageType * image, unsigned int tileSize, unsigned int margin,
+                                   unsigned int nbDivisions, unsigned int nbThreads)
+{
+  StreamingFilterType::Pointer filter = StreamingFilterType::New();
+  filter->SetInput(image);
+  filter->GetKeyPointFilter()->SetOctavesNumber(1);
+  filter->GetKeyPointFilter()->SetScalesNumber(3);
+  filter->GetFilter()->SetTileSize(tileSize);
+  filter->GetFilter()->SetMargin(margin);
+  filter->GetFilter()->SetNumberOfThreads(nbThreads);
+  filter->GetStreamer()->SetNumberOfDivisionsStrippedStreaming(nbDivisions);
+  filter->Update();
+
+  PointSetType::Pointer keyPoints = filter->GetOutputPointSet();
+  return keyPoints;
+}
+}
+
+int otbStreamingImageToKeyPointSetFilter(int argc, char * argv[])
+{
+  if (argc < 4)
+    {
+    std::cout << "Usage: " << argv[0] << " imageName tileSize margin" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // This test checks that the key points extracted tile by tile are
+  // the ones of the whole image, away from the tile borders at least,
+  // and that they do not depend on the number of threads
+  const unsigned int tileSize = atoi(argv[2]);
+  const unsigned int margin = atoi(argv[3]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->Update();
+
+  SurfFilterType::Pointer reference = SurfFilterType::New();
+  reference->SetInput(reader->GetOutput());
+  reference->SetOctavesNumber(1);
+  reference->SetScalesNumber(3);
+  reference->Update();
+
+  const double tolerance = reader->GetOutput()->GetSpacing()[0];
+
+  PointSetType::Pointer single = ExtractTiled(reader->GetOutput(), tileSize, margin, 3, 1);
+  PointSetType::Pointer multi = ExtractTiled(reader->GetOutput(), tileSize, margin, 3, 4);
+
+  const unsigned int nbReference = reference->GetOutput()->GetNumberOfPoints();
+  const unsigned int nbTiled = single->GetNumberOfPoints();
+  const unsigned int found = CountFound(reference->GetOutput(), single, tolerance);
+  const unsigned int extra = nbTiled - CountFound(single, reference->GetOutput(), tolerance);
+
+  std::cout << nbReference << " key points in the whole image, " << nbTiled << " extracted by tiles, "
+            << found << " found, " << extra << " extra" << std::endl;
+
+  bool ok = true;
+
+  if (found < 0.9 * nbReference || extra > 0.1 * nbReference)
+    {
+    std::cerr << "Key points extracted by tiles differ from the whole image ones" << std::endl;
+    ok = false;
+    }
+
+  if (multi->GetNumberOfPoints() != single->GetNumberOfPoints())
+    {
+    std::cerr << "The number of key points depends on the number of threads" << std::endl;
+    ok = false;
+    }
+  else
+    {
+    for (unsigned int i = 0; i < nbTiled; ++i)
+      {
+      if (single->GetPoints()->GetElement(i) != multi->GetPoints()->GetElement(i)
+          || single->GetPointData()->GetElement(i) != multi->GetPointData()->GetElement(i))
+        {
+        std::cerr << "Key point " << i << " depends on the number of threads" << std::endl;
+        ok = false;
+        break;
+        }
+      }
+    }
+
+  // Key points found twice at tile borders must have been discarded
+  for (PointsIteratorType it1 = single->GetPoints()->Begin(); it1 != single->GetPoints()->End(); ++it1)
+    {
+    PointsIteratorType it2 = it1;
+    for (++it2; it2 != single->GetPoints()->End(); ++it2)
+      {
+      if (it1.Value().EuclideanDistanceTo(it2.Value()) < 1e-6 * tolerance
+          && single->GetPointData()->GetElement(it1.Index()) == single->GetPointData()->GetElement(it2.Index()))
+        {
+        std::cerr << "Key points " << it1.Index() << " and " << it2.Index() << " are duplicates" << std::endl;
+        ok = false;
+        }
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
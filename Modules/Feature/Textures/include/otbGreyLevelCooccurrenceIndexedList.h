@@ -129,6 +129,16 @@ public:
   //m_InputImageMaximum. If so add to m_Vector via AddPairToVector method */
   void AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
 
+  /** Remove a pixel pair previously added with AddPixelPair(). Used to
+    * update the list of a sliding window instead of rebuilding it. */
+  void RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
+
+  /** Check if both pixel values fall between m_InputImageMinimum and
+    * m_InputImageMaximum and compute the index of the pair. Returns false if
+    * the pair would not be counted in the list. */
+  bool GetPixelPairIndex(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2,
+                         IndexType & index) const;
+
   /* Get the frequency value from Vector with index =[j,i] */
   RelativeFrequencyType GetFrequency(IndexValueType i, IndexValueType j);
 
@@ -146,6 +156,11 @@ protected:
     * co-occurrence pair is added again with index values swapped */
   void AddPairToVector(IndexType index);
 
+  /** decrement the frequency of the co-occurrence pair with given index. Pairs
+    * whose frequency drops to zero are removed from the vector, the last pair
+    * being moved in the free slot */
+  void RemovePairFromVector(IndexType index);
+
   void SetBinMin(const unsigned int dimension, const InstanceIdentifier nbin,
                  PixelValueType min);
 
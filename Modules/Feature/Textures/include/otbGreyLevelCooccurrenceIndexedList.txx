@@ -207,32 +207,45 @@ GetIndex(const PixelPairType & pixelPair, IndexType & index) const
 }
 
 template <class TPixel >
-void
+bool
 GreyLevelCooccurrenceIndexedList<TPixel>::
-AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2)
+GetPixelPairIndex(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2,
+                  IndexType & index) const
 {
-
   if ( pixelvalue1 < m_InputImageMinimum
        || pixelvalue1 > m_InputImageMaximum )
     {
-    return; // don't put a pixel in the co-occurrence list if pixelvalue1
-            // is out-of-bounds.
+    return false; // don't put a pixel in the co-occurrence list if pixelvalue1
+                  // is out-of-bounds.
     }
 
   if ( pixelvalue2 < m_InputImageMinimum
        || pixelvalue2 > m_InputImageMaximum )
     {
-    return; // don't put a pixel in the co-occurrence list if the pixelvalue2
-           // is out-of-bounds.
+    return false; // don't put a pixel in the co-occurrence list if the pixelvalue2
+                  // is out-of-bounds.
     }
 
-  IndexType index;
   PixelPairType ppair( PixelPairSize);
   ppair[0] = pixelvalue1;
   ppair[1] = pixelvalue2;
 
   //Get Index of the given pixel pair;
   this->GetIndex(ppair, index);
+  return true;
+}
+
+template <class TPixel >
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2)
+{
+  IndexType index;
+  if ( !this->GetPixelPairIndex(pixelvalue1, pixelvalue2, index) )
+    {
+    return;
+    }
+
   //Add the index and set/update the frequency of the pixel pair. if m_Symmetry
   //is true the index is swapped and added to vector again.
   this->AddPairToVector(index);
@@ -246,6 +259,28 @@ AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue
     }
 }
 
+template <class TPixel >
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2)
+{
+  IndexType index;
+  if ( !this->GetPixelPairIndex(pixelvalue1, pixelvalue2, index) )
+    {
+    return;
+    }
+
+  this->RemovePairFromVector(index);
+  if(m_Symmetry)
+    {
+    IndexValueType temp;
+    temp = index[0];
+    index[0] = index[1];
+    index[1] = temp;
+    this->RemovePairFromVector(index);
+    }
+}
+
 template <class TPixel>
 typename GreyLevelCooccurrenceIndexedList<TPixel>::RelativeFrequencyType
 GreyLevelCooccurrenceIndexedList<TPixel>::
@@ -309,6 +344,31 @@ GreyLevelCooccurrenceIndexedList<TPixel>
   m_TotalFrequency = m_TotalFrequency + 1;
 }
 
+template <class TPixel>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>
+::RemovePairFromVector(IndexType index)
+{
+  InstanceIdentifier instanceId = 0;
+  instanceId = index[1] * m_Size[0] + index[0];
+  int vindex = m_LookupArray[instanceId];
+  if( vindex < 0)
+    {
+    return; // this pair was never added
+    }
+
+  if( --m_Vector[vindex].second == 0 )
+    {
+    // Move the last pair in the free slot to keep the vector compact
+    const CooccurrencePairType last = m_Vector.back();
+    m_LookupArray[last.first[1] * m_Size[0] + last.first[0]] = vindex;
+    m_Vector[vindex] = last;
+    m_Vector.pop_back();
+    m_LookupArray[instanceId] = -1;
+    }
+  m_TotalFrequency = m_TotalFrequency - 1;
+}
+
 template <class TPixel>
 void
 GreyLevelCooccurrenceIndexedList<TPixel>
@@ -179,6 +179,15 @@ public:
   /** Get the sub-sampling offset */
   itkGetMacro(SubsampleOffset, OffsetType);
 
+  /** Set/Get the incremental mode. When enabled, the co-occurrence list is
+   *  updated as the window slides along a row, by removing the pixel pairs
+   *  of the leaving columns and adding those of the entering ones, instead
+   *  of being rebuilt for each output pixel. Results only differ by floating
+   *  point rounding. Off by default. */
+  itkSetMacro(IncrementalMode, bool);
+  itkGetConstMacro(IncrementalMode, bool);
+  itkBooleanMacro(IncrementalMode);
+
   /** Get the mean output image */
   OutputImageType * GetMeanOutput();
 
@@ -230,6 +239,11 @@ private:
   /** Convenient method to compute union of 2 regions */
   static OutputRegionType RegionUnion(const OutputRegionType& region1, const OutputRegionType& region2);
 
+  /** Add (or remove) the pixel pairs of column x of the window to the
+   *  co-occurrence list */
+  void UpdateWindowColumn(CooccurrenceIndexedListType * glcList, const InputRegionType & window,
+                          typename InputRegionType::IndexValueType x, bool add) const;
+
   /** Radius of the window on which to compute textures */
   SizeType m_Radius;
 
@@ -253,6 +267,9 @@ private:
 
   /** Sub-sampling offset */
   OffsetType m_SubsampleOffset;
+
+  /** Incremental computation of the co-occurrence list */
+  bool m_IncrementalMode;
 };
 } // End namespace otb
 
@@ -42,6 +42,7 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
 , m_InputImageMaximum(255)
 , m_SubsampleFactor()
 , m_SubsampleOffset()
+, m_IncrementalMode(false)
 {
   // There are 10 outputs corresponding to the 9 textures indices
   this->SetNumberOfRequiredOutputs(10);
@@ -363,6 +364,10 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
   // Set-up progress reporting
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+  // Co-occurrence list, and the window it holds in incremental mode
+  CooccurrenceIndexedListPointerType GLCIList;
+  InputRegionType window;
+
   // Iterate on outputs to compute textures
   while (!varianceIt.IsAtEnd()
          && !meanIt.IsAtEnd()
@@ -398,24 +403,61 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
     inputRegion.SetSize(inputSize);
     inputRegion.Crop(inputPtr->GetRequestedRegion());
 
-    CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
-    GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+    if (m_IncrementalMode)
+      {
+      const typename InputRegionType::IndexValueType x0 = inputRegion.GetIndex(0);
+      const typename InputRegionType::IndexValueType x1 = x0 + inputRegion.GetSize(0) - 1;
+      const typename InputRegionType::IndexValueType windowX0 = window.GetIndex(0);
+      const typename InputRegionType::IndexValueType windowX1 = windowX0 + window.GetSize(0) - 1;
+
+      if (GLCIList.IsNotNull()
+          && window.GetIndex(1) == inputRegion.GetIndex(1)
+          && window.GetSize(1) == inputRegion.GetSize(1)
+          && x0 >= windowX0 && x0 <= windowX1 + 1)
+        {
+        // Slide the window of the previous pixel along the row
+        for (typename InputRegionType::IndexValueType x = windowX0; x < x0; ++x)
+          {
+          this->UpdateWindowColumn(GLCIList, window, x, false);
+          }
+        for (typename InputRegionType::IndexValueType x = windowX1 + 1; x <= x1; ++x)
+          {
+          this->UpdateWindowColumn(GLCIList, inputRegion, x, true);
+          }
+        }
+      else
+        {
+        // New row (or no overlap) : rebuild the list
+        GLCIList = CooccurrenceIndexedListType::New();
+        GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+        for (typename InputRegionType::IndexValueType x = x0; x <= x1; ++x)
+          {
+          this->UpdateWindowColumn(GLCIList, inputRegion, x, true);
+          }
+        }
+      window = inputRegion;
+      }
+    else
+      {
+      GLCIList = CooccurrenceIndexedListType::New();
+      GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
 
-    typedef itk::ConstNeighborhoodIterator< InputImageType > NeighborhoodIteratorType;
-    NeighborhoodIteratorType neighborIt;
-    neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
-    for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
-    {
-    const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-    bool pixelInBounds;
-    const InputPixelType pixelIntensity =  neighborIt.GetPixel(m_Offset, pixelInBounds);
-    if ( !pixelInBounds )
+      typedef itk::ConstNeighborhoodIterator< InputImageType > NeighborhoodIteratorType;
+      NeighborhoodIteratorType neighborIt;
+      neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
+      for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
       {
-      continue; // don't put a pixel in the co-occurrence list if the value is
-               // out of bounds
+      const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
+      bool pixelInBounds;
+      const InputPixelType pixelIntensity =  neighborIt.GetPixel(m_Offset, pixelInBounds);
+      if ( !pixelInBounds )
+        {
+        continue; // don't put a pixel in the co-occurrence list if the value is
+                 // out of bounds
+        }
+      GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
+      }
       }
-    GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
-    }
 
     PixelValueType m_Mean                    = itk::NumericTraits< PixelValueType >::Zero;
     PixelValueType m_Variance                = itk::NumericTraits< PixelValueType >::Zero;
@@ -575,6 +617,39 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
 
 }
 
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
+::UpdateWindowColumn(CooccurrenceIndexedListType * glcList, const InputRegionType & window,
+                     typename InputRegionType::IndexValueType x, bool add) const
+{
+  const InputImageType * inputPtr = this->GetInput();
+  const InputRegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+
+  typename InputImageType::IndexType index;
+  index[0] = x;
+  const typename InputRegionType::IndexValueType y0 = window.GetIndex(1);
+  const typename InputRegionType::IndexValueType y1 = y0 + window.GetSize(1);
+
+  for (index[1] = y0; index[1] < y1; ++index[1])
+    {
+    const typename InputImageType::IndexType pairIndex = index + m_Offset;
+    if (!bufferedRegion.IsInside(pairIndex))
+      {
+      continue; // don't put a pixel in the co-occurrence list if the value is
+                // out of bounds
+      }
+    if (add)
+      {
+      glcList->AddPixelPair(inputPtr->GetPixel(index), inputPtr->GetPixel(pairIndex));
+      }
+    else
+      {
+      glcList->RemovePixelPair(inputPtr->GetPixel(index), inputPtr->GetPixel(pairIndex));
+      }
+    }
+}
+
 } // End namespace otb
 
 #endif
@@ -181,6 +181,16 @@ public:
   /** Get the sub-sampling offset */
   itkGetMacro(SubsampleOffset, OffsetType);
 
+  /** Set/Get the incremental mode. When enabled, the co-occurrence histogram
+   *  and the sums from which the textures are derived are updated as the
+   *  window slides along a row, by removing the pixel pairs of the leaving
+   *  columns and adding those of the entering ones. This costs O(radius)
+   *  instead of O(radius^2) operations per output pixel. Results only
+   *  differ by floating point rounding. Off by default. */
+  itkSetMacro(IncrementalMode, bool);
+  itkGetConstMacro(IncrementalMode, bool);
+  itkBooleanMacro(IncrementalMode);
+
   /** Get the energy output image */
   OutputImageType * GetEnergyOutput();
 
@@ -226,6 +236,46 @@ private:
   /** Convenient method to compute union of 2 regions */
   static OutputRegionType RegionUnion(const OutputRegionType& region1, const OutputRegionType& region2);
 
+  /** Dense co-occurrence histogram of a sliding window, with the running
+   *  sums needed to compute the textures in incremental mode */
+  struct SlidingCooccurrenceType
+  {
+    /** Allocate the histogram. Cells counts up to maxSmallCount are
+     *  tracked to apply the entropy tolerance. */
+    void Initialize(unsigned int nbBins, unsigned long maxCount, unsigned long maxSmallCount);
+
+    /** Empty the histogram */
+    void Clear();
+
+    /** Add (or remove) one occurrence of the pair (i,j) */
+    void Update(unsigned int i, unsigned int j, bool add);
+
+    unsigned int               NumberOfBins;
+    std::vector<unsigned long> Counts;
+    /** Counts summed by first index, by |i-j| and by i+j */
+    std::vector<unsigned long> MarginalCounts;
+    std::vector<unsigned long> DifferenceCounts;
+    std::vector<unsigned long> SumCounts;
+    /** Number of cells by count, for the counts up to the entropy tolerance */
+    std::vector<unsigned long> SmallCounts;
+    /** Table of c.log(c) */
+    std::vector<double>        CLogC;
+    double Total;
+    double SumOfSquares;
+    double SumOfCLogC;
+    double SumOfJ;
+    double SumOfIJ;
+  };
+
+  /** Textures extraction in incremental mode */
+  void IncrementalThreadedGenerateData(const OutputRegionType& outputRegion, itk::ThreadIdType threadId);
+
+  /** Add (or remove) the pixel pairs of column x of the window to the
+   *  histogram */
+  void UpdateWindowColumn(SlidingCooccurrenceType & histogram, CooccurrenceIndexedListType * binning,
+                          const InputRegionType & window, typename InputRegionType::IndexValueType x,
+                          bool add) const;
+
   /** Radius of the window on which to compute textures */
   SizeType m_Radius;
 
@@ -252,6 +302,9 @@ private:
 
   /** Sub-sampling offset */
   OffsetType m_SubsampleOffset;
+
+  /** Incremental computation of the textures */
+  bool m_IncrementalMode;
 };
 } // End namespace otb
 
@@ -28,6 +28,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "itkNumericTraits.h"
+#include <algorithm>
 #include <vector>
 #include <cmath>
 
@@ -44,6 +45,7 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>
 , m_InputImageMaximum(255)
 , m_SubsampleFactor()
 , m_SubsampleOffset()
+, m_IncrementalMode(false)
 {
   // There are 8 outputs corresponding to the 8 textures indices
   this->SetNumberOfRequiredOutputs(8);
@@ -292,6 +294,12 @@ void
 ScalarImageToTexturesFilter<TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputRegionType& outputRegionForThread, itk::ThreadIdType threadId)
 {
+  if (m_IncrementalMode)
+    {
+    this->IncrementalThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
   // Retrieve the input and output pointers
   InputImagePointerType  inputPtr             =      const_cast<InputImageType *>(this->GetInput());
   OutputImagePointerType energyPtr            =      this->GetEnergyOutput();
@@ -504,6 +512,330 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>
     }
 }
 
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToTexturesFilter<TInputImage, TOutputImage>
+::IncrementalThreadedGenerateData(const OutputRegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  // Retrieve the input pointer and build output iterators
+  InputImagePointerType inputPtr = const_cast<InputImageType *>(this->GetInput());
+
+  typedef itk::ImageRegionIterator<OutputImageType> OutputIteratorType;
+  std::vector<OutputIteratorType> outputIts;
+  for (unsigned int i = 0; i < 8; ++i)
+    {
+    outputIts.push_back(OutputIteratorType(this->GetOutput(i), outputRegionForThread));
+    outputIts[i].GoToBegin();
+    }
+
+  const double log2 = vcl_log(2.0);
+  const unsigned int nbBins = m_NumberOfBinsPerAxis;
+
+  const InputRegionType inputLargest = inputPtr->GetLargestPossibleRegion();
+  const InputRegionType inputRequested = inputPtr->GetRequestedRegion();
+
+  // Only used to bin the pixel pairs
+  CooccurrenceIndexedListPointerType binning = CooccurrenceIndexedListType::New();
+  binning->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+
+  // Cells whose frequency is below the tolerance are not taken into account
+  // in the entropy, their counts are tracked up to this value
+  const unsigned long maxCount =
+    (binning->GetSymmetry() ? 2 : 1) * (2 * m_Radius[0] + 1) * (2 * m_Radius[1] + 1);
+  const unsigned long maxSmallCount =
+    static_cast<unsigned long>(GetPixelValueTolerance() * maxCount);
+
+  SlidingCooccurrenceType histogram;
+  histogram.Initialize(nbBins, maxCount, maxSmallCount);
+
+  // Set-up progress reporting
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  typedef typename InputRegionType::IndexValueType IndexValueType;
+
+  const IndexValueType outX0 = outputRegionForThread.GetIndex(0);
+  const IndexValueType outX1 = outX0 + outputRegionForThread.GetSize(0);
+  const IndexValueType outY0 = outputRegionForThread.GetIndex(1);
+  const IndexValueType outY1 = outY0 + outputRegionForThread.GetSize(1);
+
+  for (IndexValueType outY = outY0; outY < outY1; ++outY)
+    {
+    InputRegionType window;
+    bool windowIsEmpty = true;
+
+    for (IndexValueType outX = outX0; outX < outX1; ++outX)
+      {
+      // Window on which co-occurence is estimated, centered on the
+      // output pixel converted to the full grid
+      typename InputRegionType::IndexType inputIndex;
+      typename InputRegionType::SizeType inputSize;
+      inputIndex[0] = outX * m_SubsampleFactor[0] + m_SubsampleOffset[0] + inputLargest.GetIndex(0) - m_Radius[0];
+      inputIndex[1] = outY * m_SubsampleFactor[1] + m_SubsampleOffset[1] + inputLargest.GetIndex(1) - m_Radius[1];
+      inputSize[0] = 2 * m_Radius[0] + 1;
+      inputSize[1] = 2 * m_Radius[1] + 1;
+
+      InputRegionType inputRegion;
+      inputRegion.SetIndex(inputIndex);
+      inputRegion.SetSize(inputSize);
+      inputRegion.Crop(inputRequested);
+
+      const IndexValueType x0 = inputRegion.GetIndex(0);
+      const IndexValueType x1 = x0 + inputRegion.GetSize(0) - 1;
+      const IndexValueType windowX0 = window.GetIndex(0);
+      const IndexValueType windowX1 = windowX0 + window.GetSize(0) - 1;
+
+      if (!windowIsEmpty && x0 >= windowX0 && x0 <= windowX1 + 1)
+        {
+        // Remove the leaving columns and add the entering ones
+        for (IndexValueType x = windowX0; x < x0; ++x)
+          {
+          this->UpdateWindowColumn(histogram, binning, window, x, false);
+          }
+        for (IndexValueType x = windowX1 + 1; x <= x1; ++x)
+          {
+          this->UpdateWindowColumn(histogram, binning, inputRegion, x, true);
+          }
+        }
+      else
+        {
+        histogram.Clear();
+        for (IndexValueType x = x0; x <= x1; ++x)
+          {
+          this->UpdateWindowColumn(histogram, binning, inputRegion, x, true);
+          }
+        }
+      window = inputRegion;
+      windowIsEmpty = false;
+
+      //Initialize texture variables;
+      PixelValueType energy      = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType entropy     = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType correlation = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType inverseDifferenceMoment      = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType inertia             = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType clusterShade        = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType clusterProminence   = itk::NumericTraits< PixelValueType >::Zero;
+      PixelValueType haralickCorrelation = itk::NumericTraits< PixelValueType >::Zero;
+
+      const double totalFrequency = histogram.Total;
+
+      if (totalFrequency > 0)
+        {
+        // Mean, variance and marginal sums of the first index
+        double sumOfI = 0.;
+        for (unsigned int i = 0; i < nbBins; ++i)
+          {
+          sumOfI += static_cast<double>(i) * histogram.MarginalCounts[i];
+          }
+        const double pixelMean = sumOfI / totalFrequency;
+
+        double pixelVariance = 0.;
+        double marginalMean = histogram.MarginalCounts[0] / totalFrequency;
+        double marginalDevSquared = 0.;
+        for (unsigned int i = 0; i < nbBins; ++i)
+          {
+          const double frequency = histogram.MarginalCounts[i] / totalFrequency;
+          pixelVariance += ( i - pixelMean ) * ( i - pixelMean ) * frequency;
+          if (i > 0)
+            {
+            // Knuth's recurrence, as in ThreadedGenerateData()
+            const double M_k_minus_1 = marginalMean;
+            const double M_k = M_k_minus_1 + ( frequency - M_k_minus_1 ) / ( i + 1 );
+            marginalDevSquared += ( frequency - M_k_minus_1 ) * ( frequency - M_k );
+            marginalMean = M_k;
+            }
+          }
+        marginalDevSquared = marginalDevSquared / nbBins;
+
+        double pixelVarianceSquared = pixelVariance * pixelVariance;
+        if(pixelVarianceSquared < GetPixelValueTolerance())
+          {
+          pixelVarianceSquared = 1.;
+          }
+
+        energy = histogram.SumOfSquares / ( totalFrequency * totalFrequency );
+
+        // Entropy of all cells, minus the cells below the tolerance
+        double entropySum = ( totalFrequency * vcl_log(totalFrequency) - histogram.SumOfCLogC ) / totalFrequency;
+        for (unsigned long c = 1; c <= maxSmallCount; ++c)
+          {
+          const double frequency = c / totalFrequency;
+          if ( frequency > GetPixelValueTolerance() )
+            {
+            break;
+            }
+          entropySum += histogram.SmallCounts[c] * frequency * vcl_log(frequency);
+          }
+        entropy = entropySum / log2;
+
+        correlation = ( ( histogram.SumOfIJ - pixelMean * histogram.SumOfJ - pixelMean * sumOfI )
+                        / totalFrequency + pixelMean * pixelMean ) / pixelVarianceSquared;
+
+        for (unsigned int d = 0; d < nbBins; ++d)
+          {
+          const double frequency = histogram.DifferenceCounts[d] / totalFrequency;
+          inverseDifferenceMoment += frequency / ( 1.0 + d * d );
+          inertia += static_cast<double>(d * d) * frequency;
+          }
+
+        for (unsigned int k = 0; k < 2 * nbBins - 1; ++k)
+          {
+          const double frequency = histogram.SumCounts[k] / totalFrequency;
+          const double centered = k - 2. * pixelMean;
+          clusterShade += centered * centered * centered * frequency;
+          clusterProminence += centered * centered * centered * centered * frequency;
+          }
+
+        haralickCorrelation = (fabs(marginalDevSquared) > 1E-8) ?
+          ( histogram.SumOfIJ / totalFrequency - marginalMean * marginalMean ) / marginalDevSquared : 0;
+        }
+
+      // Fill outputs
+      outputIts[0].Set(energy);
+      outputIts[1].Set(entropy);
+      outputIts[2].Set(correlation);
+      outputIts[3].Set(inverseDifferenceMoment);
+      outputIts[4].Set(inertia);
+      outputIts[5].Set(clusterShade);
+      outputIts[6].Set(clusterProminence);
+      outputIts[7].Set(haralickCorrelation);
+
+      // Update progress
+      progress.CompletedPixel();
+
+      // Increment iterators
+      for (unsigned int i = 0; i < 8; ++i)
+        {
+        ++outputIts[i];
+        }
+      }
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToTexturesFilter<TInputImage, TOutputImage>
+::UpdateWindowColumn(SlidingCooccurrenceType & histogram, CooccurrenceIndexedListType * binning,
+                     const InputRegionType & window, typename InputRegionType::IndexValueType x,
+                     bool add) const
+{
+  const InputImageType * inputPtr = this->GetInput();
+  const InputRegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  const bool symmetry = binning->GetSymmetry();
+
+  typename InputImageType::IndexType index;
+  index[0] = x;
+  const typename InputRegionType::IndexValueType y0 = window.GetIndex(1);
+  const typename InputRegionType::IndexValueType y1 = y0 + window.GetSize(1);
+
+  CooccurrenceIndexType binIndex;
+  for (index[1] = y0; index[1] < y1; ++index[1])
+    {
+    const typename InputImageType::IndexType pairIndex = index + m_Offset;
+    if (!bufferedRegion.IsInside(pairIndex))
+      {
+      continue; // don't put a pixel in the co-occurrence list if the value is
+                // out of bounds
+      }
+    if (!binning->GetPixelPairIndex(inputPtr->GetPixel(index), inputPtr->GetPixel(pairIndex), binIndex))
+      {
+      continue;
+      }
+    histogram.Update(binIndex[0], binIndex[1], add);
+    if (symmetry)
+      {
+      histogram.Update(binIndex[1], binIndex[0], add);
+      }
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToTexturesFilter<TInputImage, TOutputImage>::SlidingCooccurrenceType
+::Initialize(unsigned int nbBins, unsigned long maxCount, unsigned long maxSmallCount)
+{
+  NumberOfBins = nbBins;
+  Counts.resize(nbBins * nbBins);
+  MarginalCounts.resize(nbBins);
+  DifferenceCounts.resize(nbBins);
+  SumCounts.resize(2 * nbBins - 1);
+  SmallCounts.resize(maxSmallCount + 1);
+
+  CLogC.resize(maxCount + 1);
+  CLogC[0] = 0.;
+  for (unsigned long c = 1; c <= maxCount; ++c)
+    {
+    CLogC[c] = c * vcl_log(static_cast<double>(c));
+    }
+
+  this->Clear();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToTexturesFilter<TInputImage, TOutputImage>::SlidingCooccurrenceType
+::Clear()
+{
+  std::fill(Counts.begin(), Counts.end(), 0);
+  std::fill(MarginalCounts.begin(), MarginalCounts.end(), 0);
+  std::fill(DifferenceCounts.begin(), DifferenceCounts.end(), 0);
+  std::fill(SumCounts.begin(), SumCounts.end(), 0);
+  std::fill(SmallCounts.begin(), SmallCounts.end(), 0);
+  Total = 0.;
+  SumOfSquares = 0.;
+  SumOfCLogC = 0.;
+  SumOfJ = 0.;
+  SumOfIJ = 0.;
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ScalarImageToTexturesFilter<TInputImage, TOutputImage>::SlidingCooccurrenceType
+::Update(unsigned int i, unsigned int j, bool add)
+{
+  unsigned long & count = Counts[i * NumberOfBins + j];
+  const unsigned long before = count;
+  const double delta = add ? 1. : -1.;
+
+  if (add)
+    {
+    ++count;
+    }
+  else
+    {
+    --count;
+    }
+
+  if (before > 0 && before < SmallCounts.size())
+    {
+    --SmallCounts[before];
+    }
+  if (count > 0 && count < SmallCounts.size())
+    {
+    ++SmallCounts[count];
+    }
+
+  Total += delta;
+  SumOfSquares += static_cast<double>(count) * count - static_cast<double>(before) * before;
+  SumOfCLogC += CLogC[count] - CLogC[before];
+  SumOfJ += delta * j;
+  SumOfIJ += delta * i * j;
+
+  const unsigned int difference = (i > j) ? i - j : j - i;
+  if (add)
+    {
+    ++MarginalCounts[i];
+    ++DifferenceCounts[difference];
+    ++SumCounts[i + j];
+    }
+  else
+    {
+    --MarginalCounts[i];
+    --DifferenceCounts[difference];
+    --SumCounts[i + j];
+    }
+}
+
 } // End namespace otb
 
 #endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+
+#include "otbScalarImageToTexturesFilter.h"
+#include "otbScalarImageToAdvancedTexturesFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <algorithm>
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef float                            PixelType;
+typedef otb::Image<PixelType, Dimension> ImageType;
+
+// Random image, with some pixels outside of [0, 255] to check that the
+// incremental update skips the same pairs as the full computation
+ImageType::Pointer BuildRandomImage()
+{
+  ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 53);
+  region.SetSize(1, 37);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(12345);
+
+  itk::ImageRegionIterator<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    it.Set(static_cast<PixelType>(generator->GetUniformVariate(-10., 265.)));
+    }
+  return image;
+}
+
+// Compare the outputs of two filters, up to a relative tolerance
+template <class TFilter>
+bool CompareOutputs(TFilter * filter, TFilter * incrementalFilter)
+{
+  bool ok = true;
+  for (unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i)
+    {
+    ImageType * output = static_cast<ImageType *>(filter->GetOutput(i));
+    ImageType * incrementalOutput = static_cast<ImageType *>(incrementalFilter->GetOutput(i));
+
+    itk::ImageRegionIterator<ImageType> it(output, output->GetLargestPossibleRegion());
+    itk::ImageRegionIterator<ImageType> incIt(incrementalOutput, output->GetLargestPossibleRegion());
+    for (it.GoToBegin(), incIt.GoToBegin(); !it.IsAtEnd(); ++it, ++incIt)
+      {
+      const double ref = it.Get();
+      const double value = incIt.Get();
+      if (vcl_abs(ref - value) > 1e-4 * std::max(1., vcl_abs(ref)))
+        {
+        std::cerr << "Output " << i << " differs at " << it.GetIndex() << ": expected " << ref
+                  << ", got " << value << " in incremental mode" << std::endl;
+        ok = false;
+        break;
+        }
+      }
+    }
+  return ok;
+}
+
+template <class TFilter>
+int TestIncrementalMode()
+{
+  ImageType::Pointer image = BuildRandomImage();
+
+  typename TFilter::SizeType radius;
+  radius[0] = 3;
+  radius[1] = 2;
+
+  typename TFilter::OffsetType offset;
+  offset[0] = 2;
+  offset[1] = -1;
+
+  typename TFilter::SizeType subsampleFactor;
+  typename TFilter::OffsetType subsampleOffset;
+
+  // Check the dense grid, and a subsampled grid with a step larger than the window
+  const unsigned int steps[2] = {1, 9};
+  for (unsigned int s = 0; s < 2; ++s)
+    {
+    subsampleFactor.Fill(steps[s]);
+    subsampleOffset.Fill((steps[s] - 1) / 2);
+
+    typename TFilter::Pointer filter = TFilter::New();
+    typename TFilter::Pointer incrementalFilter = TFilter::New();
+    TFilter * filters[2] = {filter, incrementalFilter};
+    for (unsigned int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInput(image);
+      filters[f]->SetRadius(radius);
+      filters[f]->SetOffset(offset);
+      filters[f]->SetNumberOfBinsPerAxis(8);
+      filters[f]->SetInputImageMinimum(0);
+      filters[f]->SetInputImageMaximum(255);
+      filters[f]->SetSubsampleFactor(subsampleFactor);
+      filters[f]->SetSubsampleOffset(subsampleOffset);
+      }
+    incrementalFilter->IncrementalModeOn();
+
+    filter->Update();
+    incrementalFilter->Update();
+
+    if (!CompareOutputs<TFilter>(filter, incrementalFilter))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int otbScalarImageToTexturesFilterIncremental(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  return TestIncrementalMode<otb::ScalarImageToTexturesFilter<ImageType, ImageType> >();
+}
+
+int otbScalarImageToAdvancedTexturesFilterIncremental(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  return TestIncrementalMode<otb::ScalarImageToAdvancedTexturesFilter<ImageType, ImageType> >();
+}
@@ -36,4 +36,6 @@ void RegisterTests()
   REGISTER_TEST(otbGreyLevelCooccurrenceIndexedListNew);
   REGISTER_TEST(otbScalarImageToAdvancedTexturesFilter);
   REGISTER_TEST(otbScalarImageToPanTexTextureFilter);
+  REGISTER_TEST(otbScalarImageToTexturesFilterIncremental);
+  REGISTER_TEST(otbScalarImageToAdvancedTexturesFilterIncremental);
 }
@@ -51,6 +51,10 @@ namespace otb
  *  If CheckOutputBounds flag is set to true (default value), the
  *  interpolated value will be checked for output pixel type range
  *  prior to casting.
+ *
+ *  When the interpolator is a BCOInterpolateImageFunction, each
+ *  output line is interpolated at once with
+ *  EvaluateAtContinuousIndexRow().
  *   
  * \ingroup OTBImageManipulation
  * \ingroup Streamed
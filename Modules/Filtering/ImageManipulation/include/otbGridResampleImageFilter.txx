@@ -24,6 +24,7 @@
 #include "otbGridResampleImageFilter.h"
 
 #include "otbStreamingTraits.h"
+#include "otbBCOInterpolateImageFunction.h"
 
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
@@ -343,7 +344,24 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
   // TODO: assert outputPtr->GetSpacing() != 0 here
   assert(outputPtr->GetSpacing()[0]!=0&&"Null spacing will cause division by zero.");
   const double delta = outputPtr->GetSpacing()[0]/inputPtr->GetSpacing()[0];
-  
+
+  // Interpolators able to evaluate a whole line at once
+  typedef BCOInterpolateImageFunctionBase<InputImageType,
+                                          TInterpolatorPrecision> RowInterpolatorType;
+  typedef typename RowInterpolatorType::ContinuousIndexType      RowContinuousIndexType;
+
+  const RowInterpolatorType * rowInterpolator =
+    dynamic_cast<const RowInterpolatorType *>(m_Interpolator.GetPointer());
+
+  const unsigned int lineSize = regionToCompute.GetSize()[0];
+  std::vector<RowContinuousIndexType> lineIndices;
+  std::vector<InterpolatorOutputType> lineValues;
+  if (rowInterpolator)
+    {
+    lineIndices.resize(lineSize);
+    lineValues.resize(lineSize);
+    }
+
   // Iterate through the output region
   outIt.GoToBegin();
   
@@ -353,6 +371,27 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
     outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(),outPoint);
     inputPtr->TransformPhysicalPointToContinuousIndex(outPoint,inCIndex);
 
+    if (rowInterpolator)
+      {
+      // Interpolate the whole line
+      for (unsigned int k = 0; k < lineSize; ++k)
+        {
+        for (unsigned int dim = 0; dim < InputImageDimension; ++dim)
+          {
+          lineIndices[k][dim] = inCIndex[dim];
+          }
+        inCIndex[0]+=delta;
+        }
+      rowInterpolator->EvaluateAtContinuousIndexRow(&lineIndices[0], lineSize, &lineValues[0]);
+
+      for (unsigned int k = 0; !outIt.IsAtEndOfLine(); ++k)
+        {
+        this->CastPixelWithBoundsChecking(lineValues[k],minOutputValue,maxOutputValue,outputValue);
+        outIt.Set(outputValue);
+        ++outIt;
+        }
+      }
+
     while(!outIt.IsAtEndOfLine())
       {
       // Interpolate
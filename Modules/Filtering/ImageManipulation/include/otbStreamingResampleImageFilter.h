@@ -23,7 +23,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "otbStreamingWarpImageFilter.h"
-#include "itkTransformToDisplacementFieldSource.h"
+#include "otbGridTransformToDisplacementFieldSource.h"
 #include "itkLinearInterpolateImageFunction.h"
 #include "otbImage.h"
 #include "itkVector.h"
@@ -47,6 +47,11 @@ namespace otb
  * the  interpolator (SetInterpolator()) and the origin (SetOrigin())
  * can be set using the method between brackets.
  *
+ * The displacement grid is built by an
+ * otb::GridTransformToDisplacementFieldSource, which transforms each
+ * requested region of the grid at once when the transform is a
+ * otb::GenericRSTransform.
+ *
  *
  *
  * \ingroup Projection
@@ -88,7 +93,7 @@ public:
                                    DisplacementFieldType>        WarpImageFilterType;
 
   /** Internal filters typedefs*/
-  typedef itk::TransformToDisplacementFieldSource<DisplacementFieldType,
+  typedef GridTransformToDisplacementFieldSource<DisplacementFieldType,
                                                  double>        DisplacementFieldGeneratorType;
   typedef typename DisplacementFieldGeneratorType::TransformType TransformType;
   typedef typename DisplacementFieldGeneratorType::SizeType      SizeType;
@@ -165,6 +170,11 @@ public:
                                         EdgePaddingValue,
                                         typename OutputImageType::PixelType);
 
+  /** Interpolate the displacement field line by line
+   *  (see StreamingWarpImageFilter) */
+  otbSetObjectMemberMacro(WarpFilter, IncrementalWarping, bool);
+  otbGetObjectMemberMacro(WarpFilter, IncrementalWarping, bool);
+
   /** Import output parameters from a given image */
   void SetOutputParametersFromImage(const ImageBaseType * image);
 
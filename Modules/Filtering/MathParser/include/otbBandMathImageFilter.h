@@ -28,6 +28,7 @@
 #include "itkArray.h"
 
 #include "otbParser.h"
+#include "otbVectorizedParser.h"
 
 namespace otb
 {
@@ -69,8 +70,16 @@ namespace otb
  * This functionality assumes that all the band involved have the same
  * spacing and origin.
  *
+ * With VectorizedEvaluationOn(), an expression only using the operators
+ * and functions supported by VectorizedParser is compiled once and
+ * evaluated over whole rows of pixels, which is much faster than the
+ * per-pixel evaluation of muParser. The results may then differ from
+ * the muParser ones by rounding errors. Other expressions are always
+ * evaluated pixel by pixel. The vectorized evaluation is off by default.
+ *
  *
  * \sa Parser
+ * \sa VectorizedParser
  *
  * \ingroup Streamed
  * \ingroup Threaded
@@ -104,6 +113,7 @@ public:
   typedef typename ImageType::PointType           OrigineType;
   typedef typename ImageType::SpacingType         SpacingType;
   typedef Parser                                  ParserType;
+  typedef VectorizedParser                        VectorizedParserType;
   typedef itk::ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
 
   /** Set the nth filter input with or without a specified associated variable name */
@@ -126,6 +136,12 @@ public:
   /** Return a pointer on the nth filter input */
   ImageType * GetNthInput(DataObjectPointerArraySizeType idx);
 
+  /** Evaluate the expression over whole rows when it is supported by
+   *  VectorizedParser (default is Off) */
+  itkSetMacro(VectorizedEvaluation, bool);
+  itkGetConstMacro(VectorizedEvaluation, bool);
+  itkBooleanMacro(VectorizedEvaluation);
+
 protected :
   BandMathImageFilter();
   ~BandMathImageFilter() ITK_OVERRIDE;
@@ -139,8 +155,17 @@ private :
   BandMathImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  /** Evaluate the compiled expression row by row */
+  void VectorizedThreadedGenerateData(const ImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+  /** Cast the value to the pixel type, counting underflows and overflows */
+  PixelType CastValue(double value, itk::ThreadIdType threadId);
+
   std::string                           m_Expression;
   std::vector<ParserType::Pointer>      m_VParser;
+  std::vector<VectorizedParserType::Pointer> m_VVectorizedParser;
+  std::vector< std::vector< std::vector<double> > > m_ARow;
+  bool                                  m_VectorizedEvaluation;
   std::vector< std::vector<double> >    m_AImage;
   std::vector< std::string >            m_VVarName;
   unsigned int                          m_NbVar;
@@ -24,6 +24,7 @@
 #include "otbBandMathImageFilter.h"
 
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 #include "otbMacro.h"
@@ -45,6 +46,8 @@ BandMathImageFilter<TImage>
   this->SetNumberOfRequiredInputs( 1 );
   this->InPlaceOff();
 
+  m_VectorizedEvaluation = false;
+
   m_UnderflowCount = 0;
   m_OverflowCount = 0;
   m_ThreadUnderflow.SetSize(1);
@@ -65,6 +68,7 @@ void BandMathImageFilter<TImage>
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Expression: "      << m_Expression                  << std::endl;
+  os << indent << "VectorizedEvaluation: " << m_VectorizedEvaluation << std::endl;
   os << indent << "Computed values follow:"                            << std::endl;
   os << indent << "UnderflowCount: "  << m_UnderflowCount              << std::endl;
   os << indent << "OverflowCount: "   << m_OverflowCount               << std::endl;
@@ -215,6 +219,36 @@ void BandMathImageFilter<TImage>
       m_VParser[i]->DefineVar(m_VVarName[j], &(m_AImage[i][j]));
       }
     }
+
+  // Compile the expression for the row by row evaluation, with one row
+  // buffer per variable (plus one for the results) for each thread
+  m_VVectorizedParser.clear();
+  m_ARow.clear();
+  if (m_VectorizedEvaluation)
+    {
+    const unsigned int rowSize = this->GetOutput()->GetRequestedRegion().GetSize(0);
+
+    m_VVectorizedParser.resize(nbThreads);
+    m_ARow.resize(nbThreads);
+    for(i = 0; i < nbThreads; ++i)
+      {
+      m_ARow[i].resize(m_NbVar+1, std::vector<double>(rowSize));
+      m_VVectorizedParser[i] = VectorizedParserType::New();
+      m_VVectorizedParser[i]->SetExpr(m_Expression);
+      for(j=0; j < m_NbVar; ++j)
+        {
+        m_VVectorizedParser[i]->DefineVar(m_VVarName[j], &(m_ARow[i][j][0]));
+        }
+
+      if (!m_VVectorizedParser[i]->Compile())
+        {
+        otbMsgDevMacro(<< "Expression " << m_Expression << " can not be vectorized, using per-pixel evaluation");
+        m_VVectorizedParser.clear();
+        m_ARow.clear();
+        break;
+        }
+      }
+    }
 }
 
 template< typename TImage >
@@ -244,11 +278,39 @@ void BandMathImageFilter<TImage>
         << "Type May Be Incompatible !");
 }
 
+template< typename TImage >
+typename BandMathImageFilter<TImage>::PixelType
+BandMathImageFilter<TImage>
+::CastValue(double value, itk::ThreadIdType threadId)
+{
+  // Case value is equal to -inf or inferior to the minimum value
+  // allowed by the pixelType cast
+  if (value < double(itk::NumericTraits<PixelType>::NonpositiveMin()))
+    {
+    m_ThreadUnderflow[threadId]++;
+    return itk::NumericTraits<PixelType>::NonpositiveMin();
+    }
+  // Case value is equal to inf or superior to the maximum value
+  // allowed by the pixelType cast
+  else if (value > double(itk::NumericTraits<PixelType>::max()))
+    {
+    m_ThreadOverflow[threadId]++;
+    return itk::NumericTraits<PixelType>::max();
+    }
+  return static_cast<PixelType>(value);
+}
+
 template< typename TImage >
 void BandMathImageFilter<TImage>
 ::ThreadedGenerateData(const ImageRegionType& outputRegionForThread,
            itk::ThreadIdType threadId)
 {
+  if (!m_VVectorizedParser.empty())
+    {
+    this->VectorizedThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
   double value;
   unsigned int j;
   unsigned int nbInputImages = this->GetNumberOfInputs();
@@ -270,8 +332,6 @@ void BandMathImageFilter<TImage>
 
   std::vector<double>      & threadImage     = m_AImage[threadId];
   ParserType::Pointer const& threadParser    = m_VParser[threadId];
-  long                     & threadUnderflow = m_ThreadUnderflow[threadId];
-  long                     & threadOverflow  = m_ThreadOverflow[threadId];
   ImageRegionConstIteratorType & firstImageRegion = Vit.front(); // alias for better perfs
   while(!firstImageRegion.IsAtEnd())
      {
@@ -301,24 +361,7 @@ void BandMathImageFilter<TImage>
       itkExceptionMacro(<< err);
       }
 
-    // Case value is equal to -inf or inferior to the minimum value
-    // allowed by the pixelType cast
-    if (value < double(itk::NumericTraits<PixelType>::NonpositiveMin()))
-      {
-      ot.Set(itk::NumericTraits<PixelType>::NonpositiveMin());
-      threadUnderflow++;
-      }
-    // Case value is equal to inf or superior to the maximum value
-    // allowed by the pixelType cast
-    else if (value > double(itk::NumericTraits<PixelType>::max()))
-      {
-      ot.Set(itk::NumericTraits<PixelType>::max());
-      threadOverflow++;
-      }
-    else
-      {
-      ot.Set(static_cast<PixelType>(value));
-      }
+    ot.Set(this->CastValue(value, threadId));
 
     for(j=0; j < nbInputImages; ++j)
       {
@@ -332,6 +375,75 @@ void BandMathImageFilter<TImage>
     }
 }
 
+template< typename TImage >
+void BandMathImageFilter<TImage>
+::VectorizedThreadedGenerateData(const ImageRegionType& outputRegionForThread,
+           itk::ThreadIdType threadId)
+{
+  unsigned int j;
+  unsigned int nbInputImages = this->GetNumberOfInputs();
+  const unsigned int rowSize = outputRegionForThread.GetSize(0);
+
+  typedef itk::ImageScanlineConstIterator<TImage> ImageScanlineConstIteratorType;
+
+  assert(nbInputImages);
+  std::vector< ImageScanlineConstIteratorType > Vit(nbInputImages);
+
+  for(j=0; j < nbInputImages; ++j)
+    {
+    Vit[j] = ImageScanlineConstIteratorType (this->GetNthInput(j), outputRegionForThread);
+    }
+
+  itk::ImageScanlineIterator<TImage> ot (this->GetOutput(), outputRegionForThread);
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  std::vector< std::vector<double> > & threadRows   = m_ARow[threadId];
+  VectorizedParserType::Pointer const& threadParser = m_VVectorizedParser[threadId];
+  double * results = &(threadRows[m_NbVar][0]);
+  double * idxX    = &(threadRows[nbInputImages][0]);
+  double * idxY    = &(threadRows[nbInputImages+1][0]);
+  double * idxPhyX = &(threadRows[nbInputImages+2][0]);
+  double * idxPhyY = &(threadRows[nbInputImages+3][0]);
+
+  while(!ot.IsAtEnd())
+    {
+    const IndexType lineIndex = ot.GetIndex();
+
+    for(j=0; j < nbInputImages; ++j)
+      {
+      double * row = &(threadRows[j][0]);
+      for(unsigned int i = 0; !Vit[j].IsAtEndOfLine(); ++i, ++Vit[j])
+        {
+        row[i] = static_cast<double>(Vit[j].Get());
+        }
+      Vit[j].NextLine();
+      }
+
+    // Image Indexes
+    const double physicalY = static_cast<double>(m_Origin[1])
+      + static_cast<double>(lineIndex[1]) * static_cast<double>(m_Spacing[1]);
+    for(unsigned int i = 0; i < rowSize; ++i)
+      {
+      idxX[i]    = static_cast<double>(lineIndex[0] + i);
+      idxY[i]    = static_cast<double>(lineIndex[1]);
+      idxPhyX[i] = static_cast<double>(m_Origin[0])
+        + static_cast<double>(lineIndex[0] + i) * static_cast<double>(m_Spacing[0]);
+      idxPhyY[i] = physicalY;
+      }
+
+    threadParser->Eval(results, rowSize);
+
+    for(unsigned int i = 0; i < rowSize; ++i, ++ot)
+      {
+      ot.Set(this->CastValue(results[i], threadId));
+      progress.CompletedPixel();
+      }
+    ot.NextLine();
+    }
+}
+
 }// end namespace otb
 
 #endif
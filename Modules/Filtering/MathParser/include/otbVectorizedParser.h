@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbVectorizedParser_h
+#define otbVectorizedParser_h
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+
+namespace otb
+{
+
+class VectorizedParserImpl;
+
+
+/** \class VectorizedParser
+ * \brief Evaluation of a mathematical expression over arrays of values.
+ *
+ * The expression is compiled once into a sequence of operations, each of
+ * them being applied to a whole block of values (for instance a row of
+ * pixels) in a tight loop. This removes the per-value interpretation cost
+ * of Parser and ParserX for simple expressions (NDVI-like band ratios,
+ * thresholds ...).
+ *
+ * Only a subset of the syntax of Parser (or ParserX, see SetSyntax()) is
+ * supported: numbers, constants, scalar variables, arithmetic,
+ * comparison and logical operators, the ternary operator and the most
+ * common functions. Compile() returns false for any other expression,
+ * in which case the caller is expected to fall back to the per-value
+ * evaluation. Constructs whose precedence differs between muParser
+ * versions (chained powers, signed powers, chained comparisons) are also
+ * rejected, so that both evaluations give the same results (up to the
+ * rounding errors of the muParser bytecode optimizations).
+ *
+ * \sa Parser
+ * \sa BandMathImageFilter
+ *
+ * \ingroup OTBMathParser
+ */
+class ITK_EXPORT VectorizedParser : public itk::LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef VectorizedParser                         Self;
+  typedef itk::LightObject                         Superclass;
+  typedef itk::SmartPointer<Self>                  Pointer;
+  typedef itk::SmartPointer<const Self>            ConstPointer;
+
+  /** New macro for creation of through a Smart Pointer */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro(VectorizedParser, itk::LightObject);
+
+  /** Convenient type definitions */
+  typedef double                                   ValueType;
+
+  /** Syntax of the expressions, which defines the available functions
+   *  and constants */
+  typedef enum
+  {
+    MuParserSyntax,
+    MuParserXSyntax
+  } SyntaxType;
+
+  /** Set/Get the syntax (default is MuParserSyntax) */
+  void SetSyntax(SyntaxType syntax);
+  SyntaxType GetSyntax() const;
+
+  /** Set the expression to be parsed */
+  void SetExpr(const std::string & Expression);
+
+  /** Return the expression to be parsed */
+  const std::string& GetExpr() const;
+
+  /** Define a variable, whose values are read from buffer. The buffer
+   *  must hold at least as many values as the results of Eval(). A
+   *  variable can be redefined with another buffer without compiling
+   *  the expression again. */
+  void DefineVar(const std::string &sName, const ValueType *buffer);
+
+  /** Define a constant */
+  void DefineConst(const std::string &sName, ValueType value);
+
+  /** Clear all the defined variables and constants */
+  void ClearVar();
+
+  /** Compile the expression. Return false if the expression is not
+   *  supported (or is invalid). */
+  bool Compile();
+
+  /** Return true if the expression has been successfully compiled */
+  bool IsCompiled() const;
+
+  /** Evaluate the compiled expression for size values */
+  void Eval(ValueType * results, unsigned int size);
+
+protected:
+  VectorizedParser();
+  ~VectorizedParser() ITK_OVERRIDE;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+
+private:
+  VectorizedParser(const Self &);   //purposely not implemented
+  void operator =(const Self &);    //purposely not implemented
+
+  typedef itk::SmartPointer<VectorizedParserImpl> VectorizedParserImplPtr;
+  VectorizedParserImplPtr m_InternalParser;
+}; // end class
+
+}//end namespace otb
+
+#endif
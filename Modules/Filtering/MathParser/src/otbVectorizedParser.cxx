@@ -0,0 +1,1084 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbMath.h"
+#include "otbVectorizedParser.h"
+
+#include "otb_muparser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace otb
+{
+
+namespace
+{
+
+/** Thrown when the expression can not be compiled */
+struct UnsupportedExpression {};
+
+typedef VectorizedParser::ValueType ValueType;
+
+//----------  Element-wise operations  ----------//BEGIN
+struct AddOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return a + b; } };
+struct SubOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return a - b; } };
+struct MulOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return a * b; } };
+struct DivOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return a / b; } };
+struct PowOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return std::pow(a, b); } };
+struct LtOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a < b; } };
+struct GtOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a > b; } };
+struct LeOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a <= b; } };
+struct GeOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a >= b; } };
+struct EqOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a == b; } };
+struct NeOperation    { static inline ValueType Apply(ValueType a, ValueType b) { return a != b; } };
+struct LAndOperation  { static inline ValueType Apply(ValueType a, ValueType b) { return a && b; } };
+struct LOrOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return a || b; } };
+// Same definition as the "and" and "or" operators of Parser
+struct WordAndOperation { static inline ValueType Apply(ValueType a, ValueType b)
+  { return static_cast<int>(a) && static_cast<int>(b); } };
+struct WordOrOperation  { static inline ValueType Apply(ValueType a, ValueType b)
+  { return static_cast<int>(a) || static_cast<int>(b); } };
+// Same definitions as std::min and std::max, used by muParser
+struct MinOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return (b < a) ? b : a; } };
+struct MaxOperation   { static inline ValueType Apply(ValueType a, ValueType b) { return (a < b) ? b : a; } };
+struct Atan2Operation { static inline ValueType Apply(ValueType a, ValueType b) { return vcl_atan2(a, b); } };
+struct NdviOperation  { static inline ValueType Apply(ValueType r, ValueType niri)
+  {
+  if ( vcl_abs(r + niri) < 1E-6 )
+    {
+    return 0.;
+    }
+  return (niri-r)/(niri+r);
+  } };
+
+ValueType Sin(ValueType v)   { return vcl_sin(v); }
+ValueType Cos(ValueType v)   { return vcl_cos(v); }
+ValueType Tan(ValueType v)   { return vcl_tan(v); }
+ValueType ASin(ValueType v)  { return vcl_asin(v); }
+ValueType ACos(ValueType v)  { return vcl_acos(v); }
+ValueType ATan(ValueType v)  { return vcl_atan(v); }
+ValueType Sinh(ValueType v)  { return vcl_sinh(v); }
+ValueType Cosh(ValueType v)  { return vcl_cosh(v); }
+ValueType Tanh(ValueType v)  { return vcl_tanh(v); }
+ValueType Ln(ValueType v)    { return vcl_log(v); }
+ValueType Log10(ValueType v) { return vcl_log10(v); }
+ValueType Exp(ValueType v)   { return vcl_exp(v); }
+ValueType Sqrt(ValueType v)  { return vcl_sqrt(v); }
+ValueType Abs(ValueType v)   { return vcl_abs(v); }
+// Same definitions as muParser
+ValueType Sign(ValueType v)  { return (v < 0) ? -1 : (v > 0) ? 1 : 0; }
+ValueType Rint(ValueType v)  { return vcl_floor(v + 0.5); }
+//----------  Element-wise operations  ----------//END
+
+template <class TOperation>
+inline void ApplyBinary(const ValueType * a, bool aIsConst,
+                        const ValueType * b, bool bIsConst,
+                        ValueType * r, unsigned int n)
+{
+  if (aIsConst)
+    {
+    const ValueType av = *a;
+    for (unsigned int i = 0; i < n; ++i)
+      {
+      r[i] = TOperation::Apply(av, b[i]);
+      }
+    }
+  else if (bIsConst)
+    {
+    const ValueType bv = *b;
+    for (unsigned int i = 0; i < n; ++i)
+      {
+      r[i] = TOperation::Apply(a[i], bv);
+      }
+    }
+  else
+    {
+    for (unsigned int i = 0; i < n; ++i)
+      {
+      r[i] = TOperation::Apply(a[i], b[i]);
+      }
+    }
+}
+
+} // end anonymous namespace
+
+
+class ITK_EXPORT VectorizedParserImpl : public itk::LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef VectorizedParserImpl                     Self;
+  typedef itk::LightObject                         Superclass;
+  typedef itk::SmartPointer<Self>                  Pointer;
+  typedef itk::SmartPointer<const Self>            ConstPointer;
+
+  /** New macro for creation of through a Smart Pointer */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro(VectorizedParserImpl, itk::LightObject);
+
+  typedef VectorizedParser::ValueType              ValueType;
+  typedef VectorizedParser::SyntaxType             SyntaxType;
+
+  /** Number of values processed by each operation at once, small
+   *  enough for the temporaries to stay in cache */
+  static const unsigned int BlockSize = 256;
+
+  void SetSyntax(SyntaxType syntax)
+  {
+    m_Syntax = syntax;
+    m_Compiled = false;
+  }
+
+  SyntaxType GetSyntax() const
+  {
+    return m_Syntax;
+  }
+
+  void SetExpr(const std::string & Expression)
+  {
+    m_Expression = Expression;
+    m_Compiled = false;
+  }
+
+  const std::string& GetExpr() const
+  {
+    return m_Expression;
+  }
+
+  void DefineVar(const std::string &sName, const ValueType *buffer)
+  {
+    std::map<std::string, unsigned int>::const_iterator it = m_VarIndex.find(sName);
+    if (it != m_VarIndex.end())
+      {
+      m_VarBuffers[it->second] = buffer;
+      }
+    else
+      {
+      m_VarIndex[sName] = m_VarBuffers.size();
+      m_VarBuffers.push_back(buffer);
+      m_Compiled = false;
+      }
+  }
+
+  void DefineConst(const std::string &sName, ValueType value)
+  {
+    m_Constants[sName] = value;
+    m_Compiled = false;
+  }
+
+  void ClearVar()
+  {
+    m_VarIndex.clear();
+    m_VarBuffers.clear();
+    m_Constants.clear();
+    m_Compiled = false;
+  }
+
+  bool Compile()
+  {
+    m_Compiled = false;
+    m_Tokens.clear();
+    m_Nodes.clear();
+    m_Program.clear();
+    m_FreeSlots.clear();
+    m_NumberOfSlots = 0;
+
+    try
+      {
+      Tokenize();
+      m_Position = 0;
+      unsigned int root = ParseTernary();
+      if (Peek().type != TokenEnd)
+        {
+        throw UnsupportedExpression();
+        }
+      m_Result = Generate(root);
+      }
+    catch (UnsupportedExpression &)
+      {
+      m_Program.clear();
+      return false;
+      }
+
+    m_Slots.resize(m_NumberOfSlots * BlockSize);
+    m_Compiled = true;
+    return true;
+  }
+
+  bool IsCompiled() const
+  {
+    return m_Compiled;
+  }
+
+  void Eval(ValueType * results, unsigned int size)
+  {
+    if (!m_Compiled)
+      {
+      itkExceptionMacro(<< "Expression " << m_Expression << " has not been compiled");
+      }
+
+    const ValueType * args[3];
+    for (unsigned int offset = 0; offset < size; offset += BlockSize)
+      {
+      const unsigned int n = (size - offset < BlockSize) ? size - offset : BlockSize;
+
+      for (std::vector<InstructionType>::const_iterator it = m_Program.begin(); it != m_Program.end(); ++it)
+        {
+        bool isConst[3] = {false, false, false};
+        for (unsigned int k = 0; k < it->nbArgs; ++k)
+          {
+          args[k] = GetOperandPointer(it->args[k], offset, isConst[k]);
+          }
+        Execute(it->op, args, isConst, &m_Slots[it->result * BlockSize], n, it->function);
+        }
+
+      bool isConst = false;
+      const ValueType * result = GetOperandPointer(m_Result, offset, isConst);
+      if (isConst)
+        {
+        std::fill(results + offset, results + offset + n, *result);
+        }
+      else
+        {
+        std::copy(result, result + n, results + offset);
+        }
+      }
+  }
+
+  unsigned int GetNumberOfInstructions() const
+  {
+    return m_Program.size();
+  }
+
+protected:
+  VectorizedParserImpl()
+    : m_Syntax(VectorizedParser::MuParserSyntax),
+      m_Compiled(false),
+      m_Position(0),
+      m_NumberOfSlots(0)
+  {
+  }
+
+  ~VectorizedParserImpl() ITK_OVERRIDE
+  {
+  }
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Expression: " << m_Expression << std::endl;
+    os << indent << "Compiled: " << m_Compiled << std::endl;
+    os << indent << "Number of instructions: " << m_Program.size() << std::endl;
+  }
+
+private:
+  VectorizedParserImpl(const Self &);   //purposely not implemented
+  void operator =(const Self &);        //purposely not implemented
+
+  typedef enum
+  {
+    OpConst, OpVar,
+    OpAdd, OpSub, OpMul, OpDiv, OpPow, OpNeg,
+    OpLt, OpGt, OpLe, OpGe, OpEq, OpNe,
+    OpLAnd, OpLOr, OpWordAnd, OpWordOr, OpIf,
+    OpMin, OpMax, OpAtan2, OpNdvi,
+    OpFunction
+  } OperationType;
+
+  typedef ValueType (*FunctionType)(ValueType);
+
+  typedef enum
+  {
+    TokenNumber, TokenName, TokenOperator,
+    TokenOpen, TokenClose, TokenComma, TokenEnd
+  } TokenKindType;
+
+  struct TokenType
+  {
+    TokenKindType type;
+    std::string   text;
+    ValueType     value;
+  };
+
+  /** Node of the expression tree */
+  struct NodeType
+  {
+    OperationType             op;
+    ValueType                 value;
+    unsigned int              var;
+    FunctionType              function;
+    std::vector<unsigned int> args;
+  };
+
+  typedef enum { OperandSlot, OperandVar, OperandConst } OperandKindType;
+
+  struct OperandType
+  {
+    OperandKindType kind;
+    unsigned int    index;
+    ValueType       value;
+  };
+
+  /** One operation of the compiled program, writing in a temporary slot */
+  struct InstructionType
+  {
+    OperationType op;
+    FunctionType  function;
+    unsigned int  nbArgs;
+    OperandType   args[3];
+    unsigned int  result;
+  };
+
+  //----------  Tokenizer  ----------//BEGIN
+  void Tokenize()
+  {
+    static const char * operators[] = {"&&", "||", "<=", ">=", "==", "!=",
+                                       "<", ">", "+", "-", "*", "/", "^", "?", ":", ITK_NULLPTR};
+
+    bool hasWordOperator = false;
+    bool hasTernary = false;
+
+    std::string::size_type pos = 0;
+    const std::string & expr = m_Expression;
+    while (pos < expr.size())
+      {
+      const char c = expr[pos];
+      TokenType token;
+      token.value = 0.;
+
+      if (std::isspace(static_cast<unsigned char>(c)))
+        {
+        ++pos;
+        continue;
+        }
+
+      if (std::isdigit(static_cast<unsigned char>(c))
+          || (c == '.' && pos + 1 < expr.size() && std::isdigit(static_cast<unsigned char>(expr[pos+1]))))
+        {
+        std::string::size_type end = pos;
+        while (end < expr.size() && std::isdigit(static_cast<unsigned char>(expr[end]))) ++end;
+        if (end < expr.size() && expr[end] == '.')
+          {
+          ++end;
+          while (end < expr.size() && std::isdigit(static_cast<unsigned char>(expr[end]))) ++end;
+          }
+        if (end < expr.size() && (expr[end] == 'e' || expr[end] == 'E'))
+          {
+          ++end;
+          if (end < expr.size() && (expr[end] == '+' || expr[end] == '-')) ++end;
+          if (end >= expr.size() || !std::isdigit(static_cast<unsigned char>(expr[end])))
+            {
+            throw UnsupportedExpression();
+            }
+          while (end < expr.size() && std::isdigit(static_cast<unsigned char>(expr[end]))) ++end;
+          }
+        if (end < expr.size() && (std::isalpha(static_cast<unsigned char>(expr[end])) || expr[end] == '_'))
+          {
+          throw UnsupportedExpression();
+          }
+
+        std::istringstream iss(expr.substr(pos, end - pos));
+        iss.imbue(std::locale::classic());
+        iss >> token.value;
+        if (iss.fail())
+          {
+          throw UnsupportedExpression();
+          }
+        token.type = TokenNumber;
+        pos = end;
+        }
+      else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+        {
+        std::string::size_type end = pos;
+        while (end < expr.size() && (std::isalnum(static_cast<unsigned char>(expr[end])) || expr[end] == '_')) ++end;
+        token.text = expr.substr(pos, end - pos);
+        token.type = TokenName;
+        if (m_Syntax == VectorizedParser::MuParserSyntax && (token.text == "and" || token.text == "or"))
+          {
+#ifdef OTB_MUPARSER_HAS_CXX_LOGICAL_OPERATORS
+          token.type = TokenOperator;
+          hasWordOperator = true;
+#else
+          throw UnsupportedExpression();
+#endif
+          }
+        pos = end;
+        }
+      else if (c == '(' || c == ')' || c == ',')
+        {
+        token.type = (c == '(') ? TokenOpen : (c == ')') ? TokenClose : TokenComma;
+        token.text = std::string(1, c);
+        ++pos;
+        }
+      else
+        {
+        unsigned int i = 0;
+        for (; operators[i] != ITK_NULLPTR; ++i)
+          {
+          if (expr.compare(pos, std::string(operators[i]).size(), operators[i]) == 0)
+            {
+            break;
+            }
+          }
+        if (operators[i] == ITK_NULLPTR)
+          {
+          throw UnsupportedExpression();
+          }
+        token.type = TokenOperator;
+        token.text = operators[i];
+        pos += token.text.size();
+
+#ifndef OTB_MUPARSER_HAS_CXX_LOGICAL_OPERATORS
+        // Before muParser 2.0.0, logical and ternary operators have another syntax
+        if (m_Syntax == VectorizedParser::MuParserSyntax
+            && (token.text == "&&" || token.text == "||" || token.text == "?" || token.text == ":"))
+          {
+          throw UnsupportedExpression();
+          }
+#endif
+        if (token.text == "?")
+          {
+          hasTernary = true;
+          }
+        }
+
+      m_Tokens.push_back(token);
+      }
+
+    // "and" and "or" have the same precedence as the ternary operator
+    if (hasWordOperator && hasTernary)
+      {
+      throw UnsupportedExpression();
+      }
+
+    TokenType end;
+    end.type = TokenEnd;
+    end.value = 0.;
+    m_Tokens.push_back(end);
+  }
+
+  const TokenType & Peek() const
+  {
+    return m_Tokens[m_Position];
+  }
+
+  bool PeekOperator(const char * op) const
+  {
+    return Peek().type == TokenOperator && Peek().text == op;
+  }
+
+  void Expect(TokenKindType type, const char * text = ITK_NULLPTR)
+  {
+    if (Peek().type != type || (text != ITK_NULLPTR && Peek().text != text))
+      {
+      throw UnsupportedExpression();
+      }
+    ++m_Position;
+  }
+  //----------  Tokenizer  ----------//END
+
+  //----------  Parser  ----------//BEGIN
+  unsigned int AddNode(OperationType op, unsigned int a, unsigned int b)
+  {
+    NodeType node;
+    node.op = op;
+    node.value = 0.;
+    node.var = 0;
+    node.function = ITK_NULLPTR;
+    node.args.push_back(a);
+    node.args.push_back(b);
+    m_Nodes.push_back(node);
+    return m_Nodes.size() - 1;
+  }
+
+  unsigned int AddConstNode(ValueType value)
+  {
+    NodeType node;
+    node.op = OpConst;
+    node.value = value;
+    node.var = 0;
+    node.function = ITK_NULLPTR;
+    m_Nodes.push_back(node);
+    return m_Nodes.size() - 1;
+  }
+
+  unsigned int ParseTernary()
+  {
+    unsigned int condition = ParseWordLogic();
+    if (PeekOperator("?"))
+      {
+      ++m_Position;
+      unsigned int a = ParseTernary();
+      Expect(TokenOperator, ":");
+      unsigned int b = ParseTernary();
+
+      unsigned int node = AddNode(OpIf, condition, a);
+      m_Nodes[node].args.push_back(b);
+      return node;
+      }
+    return condition;
+  }
+
+  unsigned int ParseWordLogic()
+  {
+    unsigned int left = ParseLOr();
+    while (PeekOperator("and") || PeekOperator("or"))
+      {
+      OperationType op = PeekOperator("and") ? OpWordAnd : OpWordOr;
+      ++m_Position;
+      left = AddNode(op, left, ParseLOr());
+      }
+    return left;
+  }
+
+  unsigned int ParseLOr()
+  {
+    unsigned int left = ParseLAnd();
+    while (PeekOperator("||"))
+      {
+      ++m_Position;
+      left = AddNode(OpLOr, left, ParseLAnd());
+      }
+    return left;
+  }
+
+  unsigned int ParseLAnd()
+  {
+    unsigned int left = ParseComparison();
+    while (PeekOperator("&&"))
+      {
+      ++m_Position;
+      left = AddNode(OpLAnd, left, ParseComparison());
+      }
+    return left;
+  }
+
+  bool PeekComparison(OperationType & op) const
+  {
+    if (Peek().type != TokenOperator) return false;
+    const std::string & text = Peek().text;
+    if (text == "<")       op = OpLt;
+    else if (text == ">")  op = OpGt;
+    else if (text == "<=") op = OpLe;
+    else if (text == ">=") op = OpGe;
+    else if (text == "==") op = OpEq;
+    else if (text == "!=") op = OpNe;
+    else return false;
+    return true;
+  }
+
+  unsigned int ParseComparison()
+  {
+    unsigned int left = ParseAdditive();
+    OperationType op;
+    if (PeekComparison(op))
+      {
+      ++m_Position;
+      left = AddNode(op, left, ParseAdditive());
+      // The relative precedence of comparison operators differs
+      // between muParser and muParserX
+      if (PeekComparison(op))
+        {
+        throw UnsupportedExpression();
+        }
+      }
+    return left;
+  }
+
+  unsigned int ParseAdditive()
+  {
+    unsigned int left = ParseMultiplicative();
+    while (PeekOperator("+") || PeekOperator("-"))
+      {
+      OperationType op = PeekOperator("+") ? OpAdd : OpSub;
+      ++m_Position;
+      left = AddNode(op, left, ParseMultiplicative());
+      }
+    return left;
+  }
+
+  unsigned int ParseMultiplicative()
+  {
+    unsigned int left = ParseUnary();
+    while (PeekOperator("*") || PeekOperator("/"))
+      {
+      OperationType op = PeekOperator("*") ? OpMul : OpDiv;
+      ++m_Position;
+      left = AddNode(op, left, ParseUnary());
+      }
+    return left;
+  }
+
+  unsigned int ParseUnary()
+  {
+    if (PeekOperator("-") || PeekOperator("+"))
+      {
+      const bool negate = PeekOperator("-");
+      ++m_Position;
+      unsigned int operand;
+      if (PeekOperator("-") || PeekOperator("+"))
+        {
+        operand = ParseUnary();
+        }
+      else
+        {
+        // Whether "-a^b" means -(a^b) or (-a)^b depends on the parser
+        bool hasPower = false;
+        operand = ParsePower(hasPower);
+        if (hasPower)
+          {
+          throw UnsupportedExpression();
+          }
+        }
+      if (!negate)
+        {
+        return operand;
+        }
+      unsigned int node = AddNode(OpNeg, operand, 0);
+      m_Nodes[node].args.resize(1);
+      return node;
+      }
+
+    bool hasPower = false;
+    return ParsePower(hasPower);
+  }
+
+  unsigned int ParsePower(bool & hasPower)
+  {
+    unsigned int base = ParsePrimary();
+    if (PeekOperator("^"))
+      {
+      ++m_Position;
+      unsigned int exponent;
+      if (PeekOperator("-") || PeekOperator("+"))
+        {
+        exponent = ParseUnary();
+        }
+      else
+        {
+        exponent = ParsePrimary();
+        }
+      // The associativity of chained powers depends on the parser version
+      if (PeekOperator("^"))
+        {
+        throw UnsupportedExpression();
+        }
+      hasPower = true;
+      return AddNode(OpPow, base, exponent);
+      }
+    return base;
+  }
+
+  unsigned int ParsePrimary()
+  {
+    const TokenType token = Peek();
+    switch (token.type)
+      {
+      case TokenNumber:
+        ++m_Position;
+        return AddConstNode(token.value);
+
+      case TokenOpen:
+        {
+        ++m_Position;
+        unsigned int node = ParseTernary();
+        Expect(TokenClose);
+        return node;
+        }
+
+      case TokenName:
+        ++m_Position;
+        if (Peek().type == TokenOpen)
+          {
+          ++m_Position;
+          std::vector<unsigned int> args;
+          args.push_back(ParseTernary());
+          while (Peek().type == TokenComma)
+            {
+            ++m_Position;
+            args.push_back(ParseTernary());
+            }
+          Expect(TokenClose);
+          return AddFunctionNode(token.text, args);
+          }
+        return AddNameNode(token.text);
+
+      default:
+        throw UnsupportedExpression();
+      }
+  }
+
+  unsigned int AddNameNode(const std::string & name)
+  {
+    std::map<std::string, unsigned int>::const_iterator varIt = m_VarIndex.find(name);
+    if (varIt != m_VarIndex.end())
+      {
+      NodeType node;
+      node.op = OpVar;
+      node.value = 0.;
+      node.var = varIt->second;
+      node.function = ITK_NULLPTR;
+      m_Nodes.push_back(node);
+      return m_Nodes.size() - 1;
+      }
+
+    std::map<std::string, ValueType>::const_iterator constIt = m_Constants.find(name);
+    if (constIt != m_Constants.end())
+      {
+      return AddConstNode(constIt->second);
+      }
+
+    // Constants defined by Parser and ParserX
+    if (name == "log2e")  return AddConstNode(CONST_LOG2E);
+    if (name == "log10e") return AddConstNode(CONST_LOG10E);
+    if (name == "ln2")    return AddConstNode(CONST_LN2);
+    if (name == "ln10")   return AddConstNode(CONST_LN10);
+    if (name == "euler")  return AddConstNode(CONST_EULER);
+    if (name == "e")      return AddConstNode(CONST_E);
+    if (name == "pi")     return AddConstNode(CONST_PI);
+    if (m_Syntax == VectorizedParser::MuParserSyntax)
+      {
+      if (name == "_e")   return AddConstNode(CONST_E);
+      if (name == "_pi")  return AddConstNode(CONST_PI);
+      }
+
+    throw UnsupportedExpression();
+  }
+
+  unsigned int AddFunctionNode(const std::string & name, const std::vector<unsigned int> & args)
+  {
+    // Functions available with both syntaxes
+    static const struct { const char * name; FunctionType function; } functions[] =
+      {
+        {"sin", Sin}, {"cos", Cos}, {"tan", Tan},
+        {"asin", ASin}, {"acos", ACos}, {"atan", ATan},
+        {"sinh", Sinh}, {"cosh", Cosh}, {"tanh", Tanh},
+        {"exp", Exp}, {"sqrt", Sqrt}, {"abs", Abs},
+        {ITK_NULLPTR, ITK_NULLPTR}
+      };
+    // Functions of Parser only
+    static const struct { const char * name; FunctionType function; } muParserFunctions[] =
+      {
+        {"ln", Ln}, {"log10", Log10}, {"sign", Sign}, {"rint", Rint},
+        {ITK_NULLPTR, ITK_NULLPTR}
+      };
+
+    FunctionType function = ITK_NULLPTR;
+    for (unsigned int i = 0; functions[i].name != ITK_NULLPTR && function == ITK_NULLPTR; ++i)
+      {
+      if (name == functions[i].name) function = functions[i].function;
+      }
+    const bool muParser = (m_Syntax == VectorizedParser::MuParserSyntax);
+    for (unsigned int i = 0; muParser && muParserFunctions[i].name != ITK_NULLPTR && function == ITK_NULLPTR; ++i)
+      {
+      if (name == muParserFunctions[i].name) function = muParserFunctions[i].function;
+      }
+
+    if (function != ITK_NULLPTR)
+      {
+      if (args.size() != 1)
+        {
+        throw UnsupportedExpression();
+        }
+      NodeType node;
+      node.op = OpFunction;
+      node.value = 0.;
+      node.var = 0;
+      node.function = function;
+      node.args = args;
+      m_Nodes.push_back(node);
+      return m_Nodes.size() - 1;
+      }
+
+    if (name == "ndvi" || (muParser && (name == "NDVI" || name == "atan2")))
+      {
+      if (args.size() != 2)
+        {
+        throw UnsupportedExpression();
+        }
+      return AddNode(name == "atan2" ? OpAtan2 : OpNdvi, args[0], args[1]);
+      }
+
+    // Functions with a variable number of arguments, computed in the
+    // same order as muParser
+    if (muParser && (name == "min" || name == "max" || name == "sum" || name == "avg"))
+      {
+      const OperationType op = (name == "min") ? OpMin : (name == "max") ? OpMax : OpAdd;
+      unsigned int node = args[0];
+      for (unsigned int i = 1; i < args.size(); ++i)
+        {
+        node = AddNode(op, node, args[i]);
+        }
+      if (name == "avg")
+        {
+        node = AddNode(OpDiv, node, AddConstNode(static_cast<ValueType>(args.size())));
+        }
+      return node;
+      }
+
+    throw UnsupportedExpression();
+  }
+  //----------  Parser  ----------//END
+
+  //----------  Code generation  ----------//BEGIN
+  unsigned int AcquireSlot()
+  {
+    if (m_FreeSlots.empty())
+      {
+      return m_NumberOfSlots++;
+      }
+    unsigned int slot = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+    return slot;
+  }
+
+  OperandType Generate(unsigned int nodeIndex)
+  {
+    const NodeType node = m_Nodes[nodeIndex];
+
+    OperandType result;
+    result.index = 0;
+    result.value = 0.;
+
+    if (node.op == OpConst)
+      {
+      result.kind = OperandConst;
+      result.value = node.value;
+      return result;
+      }
+    if (node.op == OpVar)
+      {
+      result.kind = OperandVar;
+      result.index = node.var;
+      return result;
+      }
+
+    InstructionType instruction;
+    instruction.op = node.op;
+    instruction.function = node.function;
+    instruction.nbArgs = node.args.size();
+
+    bool allConst = true;
+    for (unsigned int k = 0; k < instruction.nbArgs; ++k)
+      {
+      instruction.args[k] = Generate(node.args[k]);
+      allConst = allConst && instruction.args[k].kind == OperandConst;
+      }
+
+    if (allConst)
+      {
+      // Fold the operation at compile time
+      const ValueType * args[3];
+      bool isConst[3] = {false, false, false};
+      for (unsigned int k = 0; k < instruction.nbArgs; ++k)
+        {
+        args[k] = &instruction.args[k].value;
+        }
+      result.kind = OperandConst;
+      Execute(instruction.op, args, isConst, &result.value, 1, instruction.function);
+      return result;
+      }
+
+    // The result may be written over one of the arguments, since
+    // operations are element-wise
+    for (unsigned int k = 0; k < instruction.nbArgs; ++k)
+      {
+      if (instruction.args[k].kind == OperandSlot)
+        {
+        m_FreeSlots.push_back(instruction.args[k].index);
+        }
+      }
+    instruction.result = AcquireSlot();
+    m_Program.push_back(instruction);
+
+    result.kind = OperandSlot;
+    result.index = instruction.result;
+    return result;
+  }
+  //----------  Code generation  ----------//END
+
+  //----------  Evaluation  ----------//BEGIN
+  const ValueType * GetOperandPointer(const OperandType & operand, unsigned int offset, bool & isConst) const
+  {
+    switch (operand.kind)
+      {
+      case OperandConst:
+        isConst = true;
+        return &operand.value;
+      case OperandVar:
+        isConst = false;
+        return m_VarBuffers[operand.index] + offset;
+      default:
+        isConst = false;
+        return &m_Slots[operand.index * BlockSize];
+      }
+  }
+
+  void Execute(OperationType op, const ValueType * const * a, const bool * isConst,
+               ValueType * r, unsigned int n, FunctionType function) const
+  {
+    switch (op)
+      {
+      case OpAdd:     ApplyBinary<AddOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpSub:     ApplyBinary<SubOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpMul:     ApplyBinary<MulOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpDiv:     ApplyBinary<DivOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpPow:     ApplyBinary<PowOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpLt:      ApplyBinary<LtOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpGt:      ApplyBinary<GtOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpLe:      ApplyBinary<LeOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpGe:      ApplyBinary<GeOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpEq:      ApplyBinary<EqOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpNe:      ApplyBinary<NeOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpLAnd:    ApplyBinary<LAndOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpLOr:     ApplyBinary<LOrOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpWordAnd: ApplyBinary<WordAndOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpWordOr:  ApplyBinary<WordOrOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpMin:     ApplyBinary<MinOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpMax:     ApplyBinary<MaxOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpAtan2:   ApplyBinary<Atan2Operation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+      case OpNdvi:    ApplyBinary<NdviOperation>(a[0], isConst[0], a[1], isConst[1], r, n); break;
+
+      case OpNeg:
+        for (unsigned int i = 0; i < n; ++i)
+          {
+          r[i] = -a[0][i];
+          }
+        break;
+
+      case OpFunction:
+        for (unsigned int i = 0; i < n; ++i)
+          {
+          r[i] = function(a[0][i]);
+          }
+        break;
+
+      case OpIf:
+        {
+        // Constant arguments are read with a null stride
+        const unsigned int s0 = isConst[0] ? 0 : 1;
+        const unsigned int s1 = isConst[1] ? 0 : 1;
+        const unsigned int s2 = isConst[2] ? 0 : 1;
+        for (unsigned int i = 0; i < n; ++i)
+          {
+          r[i] = (a[0][i*s0] != 0) ? a[1][i*s1] : a[2][i*s2];
+          }
+        }
+        break;
+
+      default:
+        itkExceptionMacro(<< "Unknown operation " << op);
+      }
+  }
+  //----------  Evaluation  ----------//END
+
+  SyntaxType                          m_Syntax;
+  std::string                         m_Expression;
+  bool                                m_Compiled;
+
+  std::map<std::string, unsigned int> m_VarIndex;
+  std::vector<const ValueType*>       m_VarBuffers;
+  std::map<std::string, ValueType>    m_Constants;
+
+  std::vector<TokenType>              m_Tokens;
+  unsigned int                        m_Position;
+  std::vector<NodeType>               m_Nodes;
+
+  std::vector<InstructionType>        m_Program;
+  OperandType                         m_Result;
+  std::vector<unsigned int>           m_FreeSlots;
+  unsigned int                        m_NumberOfSlots;
+  std::vector<ValueType>              m_Slots;
+}; // end class
+
+void VectorizedParser::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  m_InternalParser->Print(os, indent.GetNextIndent());
+}
+
+VectorizedParser::VectorizedParser()
+: m_InternalParser( VectorizedParserImpl::New() )
+{
+}
+
+VectorizedParser::~VectorizedParser()
+{
+}
+
+void VectorizedParser::SetSyntax(SyntaxType syntax)
+{
+  m_InternalParser->SetSyntax(syntax);
+}
+
+VectorizedParser::SyntaxType VectorizedParser::GetSyntax() const
+{
+  return m_InternalParser->GetSyntax();
+}
+
+void VectorizedParser::SetExpr(const std::string & Expression)
+{
+  m_InternalParser->SetExpr(Expression);
+}
+
+const std::string& VectorizedParser::GetExpr() const
+{
+  return m_InternalParser->GetExpr();
+}
+
+void VectorizedParser::DefineVar(const std::string &sName, const ValueType *buffer)
+{
+  m_InternalParser->DefineVar(sName, buffer);
+}
+
+void VectorizedParser::DefineConst(const std::string &sName, ValueType value)
+{
+  m_InternalParser->DefineConst(sName, value);
+}
+
+void VectorizedParser::ClearVar()
+{
+  m_InternalParser->ClearVar();
+}
+
+bool VectorizedParser::Compile()
+{
+  return m_InternalParser->Compile();
+}
+
+bool VectorizedParser::IsCompiled() const
+{
+  return m_InternalParser->IsCompiled();
+}
+
+void VectorizedParser::Eval(ValueType * results, unsigned int size)
+{
+  m_InternalParser->Eval(results, size);
+}
+
+}//end namespace otb
@@ -23,6 +23,7 @@
 #include "itkMacro.h"
 #include <iostream>
 #include <complex>  //only for the isnan() test line 148
+#include <algorithm>
 
 #include "otbMath.h"
 #include "otbImage.h"
@@ -285,3 +286,91 @@ int otbBandMathImageFilterWithIdx( int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+
+int otbBandMathImageFilterVectorized( int itkNotUsed(argc), char* argv[])
+{
+  const char * expression = argv[1];
+
+  typedef double                                            PixelType;
+  typedef otb::Image<PixelType, 2>                          ImageType;
+  typedef otb::BandMathImageFilter<ImageType>               FilterType;
+
+  const unsigned int N = 100;
+
+  ImageType::SizeType size;
+  size.Fill(N);
+  ImageType::IndexType index;
+  index.Fill(0);
+  ImageType::RegionType region;
+  region.SetSize(size);
+  region.SetIndex(index);
+
+  ImageType::Pointer image1 = ImageType::New();
+  ImageType::Pointer image2 = ImageType::New();
+  ImageType::Pointer image3 = ImageType::New();
+
+  image1->SetRegions( region );
+  image1->Allocate();
+  image2->SetRegions( region );
+  image2->Allocate();
+  image3->SetRegions( region );
+  image3->Allocate();
+
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> IteratorType;
+  IteratorType it1(image1, region);
+  IteratorType it2(image2, region);
+  IteratorType it3(image3, region);
+
+  for (it1.GoToBegin(), it2.GoToBegin(), it3.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2, ++it3)
+    {
+    ImageType::IndexType i1 = it1.GetIndex();
+
+    it1.Set( i1[0] + i1[1] -50 );
+    it2.Set( i1[0] * i1[1] );
+    it3.Set( i1[0] + i1[1] * i1[1] );
+    }
+
+  // Same expression, evaluated pixel by pixel and row by row
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetNthInput(0, image1);
+  filter->SetNthInput(1, image2);
+  filter->SetNthInput(2, image3, "canal3");
+  filter->SetExpression(expression);
+  filter->VectorizedEvaluationOff();
+  filter->Update();
+
+  FilterType::Pointer vectorizedFilter = FilterType::New();
+  vectorizedFilter->SetNthInput(0, image1);
+  vectorizedFilter->SetNthInput(1, image2);
+  vectorizedFilter->SetNthInput(2, image3, "canal3");
+  vectorizedFilter->SetExpression(expression);
+  vectorizedFilter->VectorizedEvaluationOn();
+  vectorizedFilter->Update();
+
+  std::cout << "Parsed Expression :   " << filter->GetExpression() << std::endl;
+
+  IteratorType it(filter->GetOutput(), region);
+  IteratorType itv(vectorizedFilter->GetOutput(), region);
+
+  for (it.GoToBegin(), itv.GoToBegin(); !it.IsAtEnd(); ++it, ++itv)
+    {
+    PixelType expected = it.Get();
+    PixelType result = itv.Get();
+
+    if (vnl_math_isnan(expected) && vnl_math_isnan(result))
+      continue;
+
+    if ( !(vcl_abs(result - expected) <= 1E-9 * std::max(PixelType(1), vcl_abs(expected))) )
+      {
+      std::cout
+         << "Vectorized evaluation differs at " << it.GetIndex() << " -> TEST FAILLED" << std::endl
+         << "Result =  "          << result
+         << "     Expected =  "   << expected << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "[PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
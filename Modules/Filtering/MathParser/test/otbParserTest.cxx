@@ -20,6 +20,11 @@
 
 #include "otbMath.h"
 #include "otbParser.h"
+#include "otbVectorizedParser.h"
+#include "vnl/vnl_math.h"
+
+#include <algorithm>
+#include <vector>
 
 typedef otb::Parser ParserType;
 
@@ -115,6 +120,82 @@ void otbParserTest_LogicalOperator(void)
   otbParserTest_ThrowIfNotEqual(static_cast<int>(parser->Eval()), 1, "LogicalOperator or");
 }
 
+void otbParserTest_Vectorized(void)
+{
+  const unsigned int size = 1000;
+  std::vector<double> b1(size), b2(size), results(size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    b1[i] = 0.5 * i - 100.;
+    b2[i] = i % 7;
+    }
+
+  // Expressions evaluated row by row must give the same results as
+  // the per-value evaluation (up to rounding errors)
+  const char * supported[] = {
+    "(b2-b1)/(b2+b1)",
+    "ndvi(b1, b2) * 2 + 1E-3",
+    "b1 > 0 ? b1 * 2 : -b2",
+    "min(b1, b2, 3) + max(b1, 4) + avg(1, 2, b2) + sum(b1, b2)",
+    "2^-b2 + b2^2",
+    "cos(2 * pi * b1) / (2 * pi * b2 + 1E-3) * sin(pi * b2)",
+    "sqrt(abs(b1)) + exp(b2 / 10) + ln10",
+    "(b1 >= 0 && b2 != 3) || b2 == 0",
+    "b1 and b2 or 0",
+    "rint(b1 * 0.3) * sign(b1) + atan2(b1, b2)",
+    "(b1 < 0 ? 1 : 2) * (3 + 4)",
+    ITK_NULLPTR
+  };
+
+  double v1, v2;
+  ParserType::Pointer parser = ParserType::New();
+  parser->DefineVar("b1", &v1);
+  parser->DefineVar("b2", &v2);
+
+  otb::VectorizedParser::Pointer vectorizedParser = otb::VectorizedParser::New();
+  vectorizedParser->DefineVar("b1", &b1[0]);
+  vectorizedParser->DefineVar("b2", &b2[0]);
+
+  for (unsigned int e = 0; supported[e] != ITK_NULLPTR; ++e)
+    {
+    parser->SetExpr(supported[e]);
+    vectorizedParser->SetExpr(supported[e]);
+    otbParserTest_ThrowIfNotEqual(static_cast<int>(vectorizedParser->Compile()), 1, std::string("Vectorized compile ") + supported[e]);
+
+    vectorizedParser->Eval(&results[0], size);
+    for (unsigned int i = 0; i < size; ++i)
+      {
+      v1 = b1[i];
+      v2 = b2[i];
+      const double ref = parser->Eval();
+      if (vcl_abs(results[i] - ref) > 1E-12 * std::max(1., vcl_abs(ref))
+          && !(vnl_math_isnan(ref) && vnl_math_isnan(results[i])))
+        {
+        itkGenericExceptionMacro( << supported[e] << ": got " << results[i] << " while waiting for " << ref
+                                  << " (b1 = " << v1 << ", b2 = " << v2 << ")" );
+        }
+      }
+    }
+
+  // Expressions which must be left to the per-value evaluation
+  const char * unsupported[] = {
+    "-b1^2",
+    "b1^2^3",
+    "b1 < b2 < 3",
+    "log(b1)",
+    "b3 + 1",
+    "b1 +",
+    "b1 and b2 ? 1 : 0",
+    ITK_NULLPTR
+  };
+
+  for (unsigned int e = 0; unsupported[e] != ITK_NULLPTR; ++e)
+    {
+    vectorizedParser->SetExpr(unsupported[e]);
+    otbParserTest_ThrowIfNotEqual(static_cast<int>(vectorizedParser->Compile()), 0, std::string("Vectorized compile ") + unsupported[e]);
+    }
+}
+
 int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
 {
   otbParserTest_Numerical();
@@ -124,5 +205,6 @@ int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
   otbParserTest_UserDefinedVars();
   otbParserTest_Mixed();
   otbParserTest_LogicalOperator();
+  otbParserTest_Vectorized();
   return EXIT_SUCCESS;
 }
@@ -29,6 +29,7 @@
 
 #include "otbStreamingStatisticsVectorImageFilter.h"
 #include "otbParserX.h"
+#include "otbVectorizedParser.h"
 
 #include <vector>
 
@@ -52,7 +53,16 @@ namespace otb
  * If the jth input image is multidimensional, then the variable imj represents a vector whose components are related to its bands.
  * In order to access the kth band, the variable observes the following pattern : imjbk.
  *
+ * With VectorizedEvaluationOn(), when all the expressions are scalar and
+ * only use the operators and functions supported by VectorizedParser
+ * (with the muParserX syntax), they are compiled once and evaluated over
+ * whole rows of pixels. The results may then differ from the muParserX
+ * ones by rounding errors. Other expressions (using vectors,
+ * neighborhoods, or other functions) are always evaluated pixel by
+ * pixel. The vectorized evaluation is off by default.
+ *
  * \sa Parser
+ * \sa VectorizedParser
  *
  * \ingroup Streamed
  * \ingroup Threaded
@@ -89,6 +99,7 @@ public:
   typedef typename ImageType::PointType              OrigineType;
   typedef typename ImageType::SpacingType            SpacingType;
   typedef ParserX                                     ParserType;
+  typedef VectorizedParser                            VectorizedParserType;
   typedef typename ParserType::ValueType             ValueType;
   typedef itk::ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
 
@@ -129,6 +140,12 @@ public:
   /** Return the variable and constant names */
   std::vector<std::string> GetVarNames() const;
 
+  /** Evaluate the expressions over whole rows when they are supported by
+   *  VectorizedParser (default is Off) */
+  itkSetMacro(VectorizedEvaluation, bool);
+  itkGetConstMacro(VectorizedEvaluation, bool);
+  itkBooleanMacro(VectorizedEvaluation);
+
 
 protected :
   BandMathXImageFilter();
@@ -165,9 +182,13 @@ private :
   void PrepareParsers();
   void PrepareParsersGlobStats();
   void OutputsDimensions();
+  void PrepareVectorizedParsers();
+  void VectorizedThreadedGenerateData(const ImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
 
   std::vector<std::string>                  m_Expression;
   std::vector< std::vector<ParserType::Pointer> > m_VParser;
+  std::vector< std::vector<VectorizedParserType::Pointer> > m_VVectorizedParser;
+  std::vector< std::vector< std::vector<double> > > m_ARow; // row buffers, for each thread and variable
   std::vector< std::vector<adhocStruct> >   m_AImage;
   std::vector< adhocStruct >                m_VVarName;
   std::vector< adhocStruct >                m_VAllowedVarNameAuto;
@@ -189,6 +210,7 @@ private :
   itk::Array<long>                      m_ThreadOverflow;
 
   bool                                  m_ManyExpressions;
+  bool                                  m_VectorizedEvaluation;
 
 };
 
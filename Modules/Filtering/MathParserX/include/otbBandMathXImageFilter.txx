@@ -70,6 +70,7 @@ BandMathXImageFilter<TImage>
   
   m_ManyExpressions = true;
 
+  m_VectorizedEvaluation = false;
 }
 
 /** Destructor */
@@ -104,6 +105,7 @@ void BandMathXImageFilter<TImage>
   os << indent << "Expressions: " << std::endl;
   for (unsigned int i=0; i<m_Expression.size(); i++)
     os << indent << m_Expression[i] << std::endl;
+  os << indent << "VectorizedEvaluation: " << m_VectorizedEvaluation << std::endl;
   os << indent << "Computed values follow:"                            << std::endl;
   os << indent << "UnderflowCount: "  << m_UnderflowCount              << std::endl;
   os << indent << "OverflowCount: "   << m_OverflowCount               << std::endl;
@@ -1003,6 +1005,70 @@ void BandMathXImageFilter<TImage>
   m_ThreadOverflow.SetSize(nbThreads);
   m_ThreadOverflow.Fill(0);
 
+  PrepareVectorizedParsers();
+}
+
+template< typename TImage >
+void BandMathXImageFilter<TImage>
+::PrepareVectorizedParsers()
+{
+  m_VVectorizedParser.clear();
+  m_ARow.clear();
+
+  if (!m_VectorizedEvaluation || m_AImage.empty())
+    return;
+
+  // Only scalar expressions of scalar variables can be vectorized
+  for(unsigned int i=0; i<m_outputsDimensions.size(); ++i)
+    if (m_outputsDimensions[i] != 1)
+      return;
+
+  for(unsigned int j=0; j<m_AImage[0].size(); ++j)
+    {
+    const adhocStruct & var = m_AImage[0][j];
+    if ( (var.type == 4) || (var.type == 6) ) // vector, neighborhood
+      return;
+    if ( (var.type != 0) && (var.type != 1) && (var.type != 5)
+         && (var.value.GetType() != 'f') && (var.value.GetType() != 'i') ) // matrix constant
+      return;
+    }
+
+  const unsigned int rowSize = this->GetOutput()->GetRequestedRegion().GetSize(0);
+  const unsigned int nbThreads = m_AImage.size();
+  const unsigned int nbExpr = m_Expression.size();
+
+  m_VVectorizedParser.resize(nbThreads);
+  m_ARow.resize(nbThreads);
+  for(unsigned int t=0; t<nbThreads; ++t)
+    {
+    // Row buffers of the variables, plus one for the results
+    m_ARow[t].resize(m_AImage[t].size()+1, std::vector<double>(rowSize));
+
+    for(unsigned int k=0; k<nbExpr; ++k)
+      {
+      VectorizedParserType::Pointer parser = VectorizedParserType::New();
+      parser->SetSyntax(VectorizedParserType::MuParserXSyntax);
+      parser->SetExpr(m_Expression[k]);
+
+      for(unsigned int j=0; j<m_AImage[t].size(); ++j)
+        {
+        const adhocStruct & var = m_AImage[t][j];
+        if ( (var.type == 0) || (var.type == 1) || (var.type == 5) ) // idxX, idxY, pixel
+          parser->DefineVar(var.name, &(m_ARow[t][j][0]));
+        else // spacing, user defined constant, global statistic
+          parser->DefineConst(var.name, var.value.GetFloat());
+        }
+
+      if (!parser->Compile())
+        {
+        otbMsgDevMacro(<< "Expression " << m_Expression[k] << " can not be vectorized, using per-pixel evaluation");
+        m_VVectorizedParser.clear();
+        m_ARow.clear();
+        return;
+        }
+      m_VVectorizedParser[t].push_back(parser);
+      }
+    }
 }
 
 
@@ -1044,6 +1110,11 @@ void BandMathXImageFilter<TImage>
 ::ThreadedGenerateData(const ImageRegionType& outputRegionForThread,
            itk::ThreadIdType threadId)
 {
+  if (!m_VVectorizedParser.empty())
+    {
+    this->VectorizedThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
 
   ValueType value;
   unsigned int nbInputImages = this->GetNumberOfInputs();
@@ -1245,6 +1316,104 @@ void BandMathXImageFilter<TImage>
 
 }
 
+template< typename TImage >
+void BandMathXImageFilter<TImage>
+::VectorizedThreadedGenerateData(const ImageRegionType& outputRegionForThread,
+           itk::ThreadIdType threadId)
+{
+  unsigned int nbInputImages = this->GetNumberOfInputs();
+  const unsigned int rowSize = outputRegionForThread.GetSize(0);
+
+  typedef itk::ImageScanlineConstIterator<TImage> ImageScanlineConstIteratorType;
+  typedef itk::ImageScanlineIterator<TImage> ImageScanlineIteratorType;
+  std::vector< ImageScanlineConstIteratorType > Vit(nbInputImages);
+  for(unsigned int j=0; j < nbInputImages; ++j)
+    Vit[j] = ImageScanlineConstIteratorType (this->GetNthInput(j), outputRegionForThread);
+
+  std::vector< ImageScanlineIteratorType > VoutIt(m_Expression.size());
+  for(unsigned int j=0; j < VoutIt.size(); ++j)
+    VoutIt[j] = ImageScanlineIteratorType (this->GetOutput(j), outputRegionForThread);
+
+  // Support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  std::vector< std::vector<double> > & threadRows = m_ARow[threadId];
+  const std::vector<adhocStruct> & threadVars = m_AImage[threadId];
+  double * results = &(threadRows.back()[0]);
+
+  // Pixel variables (row buffer, band) of each input image
+  std::vector< std::vector< std::pair<double*, int> > > bandVars(nbInputImages);
+  for(unsigned int j=0; j < threadVars.size(); ++j)
+    if (threadVars[j].type == 5)
+      bandVars[threadVars[j].info[0]].push_back(std::make_pair(&(threadRows[j][0]), threadVars[j].info[1]));
+
+  PixelType outputPixel(1);
+
+  while(!VoutIt[0].IsAtEnd())
+    {
+    const IndexType lineIndex = VoutIt[0].GetIndex();
+
+    //----------------- Variable affectations -----------------//
+    for(unsigned int j=0; j < nbInputImages; ++j)
+      {
+      if (!bandVars[j].empty())
+        {
+        for(unsigned int i=0; !Vit[j].IsAtEndOfLine(); ++i, ++Vit[j])
+          {
+          const PixelType & pixel = Vit[j].Get();
+          for(unsigned int v=0; v < bandVars[j].size(); ++v)
+            bandVars[j][v].first[i] = pixel[bandVars[j][v].second];
+          }
+        }
+      Vit[j].NextLine();
+      }
+
+    for(unsigned int j=0; j < threadVars.size(); ++j)
+      {
+      double * row = &(threadRows[j][0]);
+      if (threadVars[j].type == 0) //idxX
+        for(unsigned int i=0; i < rowSize; ++i)
+          row[i] = static_cast<double>(lineIndex[0] + i);
+      else if (threadVars[j].type == 1) //idxY
+        std::fill(row, row + rowSize, static_cast<double>(lineIndex[1]));
+      }
+
+    //----------------- Evaluations -----------------//
+    for(unsigned int IDExpression=0; IDExpression<m_Expression.size(); ++IDExpression)
+      {
+      m_VVectorizedParser[threadId][IDExpression]->Eval(results, rowSize);
+
+      ImageScanlineIteratorType & outIt = VoutIt[IDExpression];
+      for(unsigned int i=0; i < rowSize; ++i, ++outIt)
+        {
+        // Case value is equal to -inf or inferior to the minimum value
+        // allowed by the PixelValueType cast
+        if (results[i] < double(itk::NumericTraits<PixelValueType>::NonpositiveMin()))
+          {
+          outputPixel[0] = itk::NumericTraits<PixelValueType>::NonpositiveMin();
+          m_ThreadUnderflow[threadId]++;
+          }
+        // Case value is equal to inf or superior to the maximum value
+        // allowed by the PixelValueType cast
+        else if (results[i] > double(itk::NumericTraits<PixelValueType>::max()))
+          {
+          outputPixel[0] = itk::NumericTraits<PixelValueType>::max();
+          m_ThreadOverflow[threadId]++;
+          }
+        else
+          {
+          outputPixel[0] = static_cast<PixelValueType>(results[i]);
+          }
+        outIt.Set(outputPixel);
+        }
+      outIt.NextLine();
+      }
+
+    for(unsigned int i=0; i < rowSize; ++i)
+      progress.CompletedPixel();
+    }
+}
+
 }// end namespace otb
 
 #endif
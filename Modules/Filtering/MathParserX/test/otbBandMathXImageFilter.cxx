@@ -23,6 +23,7 @@
 #include "itkMacro.h"
 #include <iostream>
 #include <complex>  //only for the isnan() test line 148
+#include <algorithm>
 
 #include "otbMath.h"
 #include "otbVectorImage.h"
@@ -562,3 +563,99 @@ int otbBandMathXImageFilterWithIdx( int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+
+int otbBandMathXImageFilterVectorized( int argc, char* argv[])
+{
+  typedef otb::VectorImage<double, 2>              ImageType;
+  typedef ImageType::PixelType                      PixelType;
+  typedef otb::BandMathXImageFilter<ImageType>      FilterType;
+
+  const unsigned int N = 100, D1=3, D2=1;
+
+  ImageType::SizeType size;
+  size.Fill(N);
+  ImageType::IndexType index;
+  index.Fill(0);
+  ImageType::RegionType region;
+  region.SetSize(size);
+  region.SetIndex(index);
+
+  ImageType::Pointer image1 = ImageType::New();
+  ImageType::Pointer image2 = ImageType::New();
+
+  image1->SetRegions( region );
+  image1->SetNumberOfComponentsPerPixel(D1);
+  image1->Allocate();
+
+  image2->SetRegions( region );
+  image2->SetNumberOfComponentsPerPixel(D2);
+  image2->Allocate();
+
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> IteratorType;
+  IteratorType it1(image1, region);
+  IteratorType it2(image2, region);
+
+  PixelType val1(D1), val2(D2);
+
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+    {
+    ImageType::IndexType i1 = it1.GetIndex();
+
+    val1[0] = i1[0] + i1[1] -50;
+    val1[1] = i1[0] * i1[1] -50;
+    val1[2] = i1[0] / (i1[1]+1)+5;
+    val2[0] = i1[0] * i1[1];
+
+    it1.Set(val1);
+    it2.Set(val2);
+    }
+
+  // Each argument is an expression, i.e. an output of the filter. The
+  // same expressions are evaluated pixel by pixel and row by row.
+  FilterType::Pointer filter = FilterType::New();
+  FilterType::Pointer vectorizedFilter = FilterType::New();
+
+  filter->SetNthInput(0, image1);
+  filter->SetNthInput(1, image2);
+  vectorizedFilter->SetNthInput(0, image1);
+  vectorizedFilter->SetNthInput(1, image2);
+
+  for (int i = 1; i < argc; ++i)
+    {
+    filter->SetExpression(argv[i]);
+    vectorizedFilter->SetExpression(argv[i]);
+    }
+
+  filter->VectorizedEvaluationOff();
+  filter->Update();
+  vectorizedFilter->VectorizedEvaluationOn();
+  vectorizedFilter->Update();
+
+  for (int i = 0; i < argc - 1; ++i)
+    {
+    std::cout << "Parsed Expression :   " << filter->GetExpression(i) << std::endl;
+
+    IteratorType it(filter->GetOutput(i), region);
+    IteratorType itv(vectorizedFilter->GetOutput(i), region);
+
+    for (it.GoToBegin(), itv.GoToBegin(); !it.IsAtEnd(); ++it, ++itv)
+      {
+      double expected = it.Get()[0];
+      double result = itv.Get()[0];
+
+      if (vnl_math_isnan(expected) && vnl_math_isnan(result))
+        continue;
+
+      if ( !(vcl_abs(result - expected) <= 1E-9 * std::max(1.0, vcl_abs(expected))) )
+        {
+        itkGenericExceptionMacro( << std::endl
+           << "Vectorized evaluation of output " << i << " differs at " << it.GetIndex() << " -> TEST FAILLED" << std::endl
+           << "Result =  "        << result
+           << "     Expected =  " << expected << std::endl);
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -45,6 +45,18 @@ namespace otb
  *  image parameters Size/Origin/Spacing so the hole image can be
  *  reprojected without setting any output parameter.
  *
+ *  If DisplacementFieldMaximumError is positive, the displacement
+ *  field spacing is estimated instead of using
+ *  DisplacementFieldSpacing: it is the largest power of two multiple
+ *  of the output spacing (up to 64) for which the bilinear
+ *  interpolation of the transform over sample cells of the output
+ *  grid stays within this error, in input pixels.
+ *
+ *  The displacement field itself is generated with
+ *  GenericRSTransform::TransformGrid() (see
+ *  GridTransformToDisplacementFieldSource), so the error check and
+ *  the field use the same evaluation of the transform.
+ *
  * \ingroup Projection
  *
  *
@@ -109,6 +121,16 @@ public:
                                         DisplacementFieldSpacing,
                                         SpacingType);
 
+  /** Maximum interpolation error of the displacement field, in input
+   *  pixels (0 to use DisplacementFieldSpacing, which is the default) */
+  itkSetMacro(DisplacementFieldMaximumError, double);
+  itkGetMacro(DisplacementFieldMaximumError, double);
+
+  /** Interpolate the displacement field line by line
+   *  (see StreamingWarpImageFilter) */
+  otbSetObjectMemberMacro(Resampler, IncrementalWarping, bool);
+  otbGetObjectMemberMacro(Resampler, IncrementalWarping, bool);
+
   /** The resampled image parameters */
   /** Output Origin */
   void SetOutputOrigin(const OriginType & origin)
@@ -291,11 +313,22 @@ private:
   void EstimateOutputRpcModel();
   void EstimateInputRpcModel();
 
+  // Method to estimate the displacement field spacing from
+  // m_DisplacementFieldMaximumError
+  void EstimateDisplacementFieldSpacing();
+
+  // Maximum interpolation error of the grid of step outputs pixels,
+  // over sample cells of the output image
+  double EvaluateDisplacementFieldError(unsigned int step) const;
+
   // boolean that allow the estimation of the input rpc model
   bool                               m_EstimateInputRpcModel;
   bool                               m_EstimateOutputRpcModel;
   bool                               m_RpcEstimationUpdated;
 
+  // Maximum interpolation error of the displacement field (0: disabled)
+  double                             m_DisplacementFieldMaximumError;
+
   // Filters pointers
   ResamplerPointerType               m_Resampler;
   InputRpcModelEstimatorPointerType  m_InputRpcEstimator;
@@ -29,6 +29,7 @@
 #include "itkProgressAccumulator.h"
 
 #include "itkPoint.h"
+#include "vnl/vnl_math.h"
 
 #include "ogr_spatialref.h"
 #include "cpl_conv.h"
@@ -47,6 +48,7 @@ GenericRSResampleImageFilter<TInputImage, TOutputImage>
   m_EstimateInputRpcModel  = false;
   m_EstimateOutputRpcModel = false;
   m_RpcEstimationUpdated   = false;
+  m_DisplacementFieldMaximumError = 0.;
 
   // internal filters instantiation
   m_Resampler         = ResamplerType::New();
@@ -98,6 +100,12 @@ GenericRSResampleImageFilter<TInputImage, TOutputImage>
   // Instantiate the RS transform
   this->UpdateTransform();
 
+  // Choose the displacement field spacing if needed
+  if (m_DisplacementFieldMaximumError > 0.)
+    {
+    this->EstimateDisplacementFieldSpacing();
+    }
+
   m_Resampler->SetInput(this->GetInput());
   m_Resampler->SetTransform(m_Transform);
   m_Resampler->SetDisplacementFieldSpacing(this->GetDisplacementFieldSpacing());
@@ -116,6 +124,112 @@ GenericRSResampleImageFilter<TInputImage, TOutputImage>
     }
 }
 
+/**
+ * Method to estimate the displacement field spacing from the maximum
+ * interpolation error
+ */
+template <class TInputImage, class TOutputImage>
+void
+GenericRSResampleImageFilter<TInputImage, TOutputImage>
+::EstimateDisplacementFieldSpacing()
+{
+  const unsigned int maximumStep = 64;
+  const SizeType & outputSize = this->GetOutputSize();
+
+  // Start with the coarsest grid fitting in the output image
+  unsigned int step = maximumStep;
+  while (step > 1 && (step > outputSize[0] || step > outputSize[1]))
+    {
+    step /= 2;
+    }
+
+  // Refine until the interpolation error is small enough
+  while (step > 1 && this->EvaluateDisplacementFieldError(step) > m_DisplacementFieldMaximumError)
+    {
+    step /= 2;
+    }
+
+  SpacingType fieldSpacing = this->GetOutputSpacing();
+  fieldSpacing[0] *= step;
+  fieldSpacing[1] *= step;
+
+  otbMsgDevMacro(<< "Estimated displacement field spacing: " << fieldSpacing
+                 << " (" << step << " output pixels)");
+
+  m_Resampler->SetDisplacementFieldSpacing(fieldSpacing);
+}
+
+template <class TInputImage, class TOutputImage>
+double
+GenericRSResampleImageFilter<TInputImage, TOutputImage>
+::EvaluateDisplacementFieldError(unsigned int step) const
+{
+  typedef typename GenericRSTransformType::InputPointType  TransformInputPointType;
+  typedef typename GenericRSTransformType::OutputPointType TransformOutputPointType;
+
+  // Number of sample cells along each dimension
+  const unsigned int nbCells = 8;
+
+  const SpacingType & outputSpacing = this->GetOutputSpacing();
+  const OriginType & outputOrigin = this->GetOutputOrigin();
+  const IndexType & outputIndex = this->GetOutputStartIndex();
+  const SizeType & outputSize = this->GetOutputSize();
+  const typename InputImageType::SpacingType & inputSpacing = this->GetInput()->GetSpacing();
+
+  // Each cell is sampled on a 3x3 grid: corners are used for the
+  // interpolation, other nodes to measure the error
+  typename GenericRSTransformType::SpacingType nodeSpacing;
+  nodeSpacing[0] = 0.5 * step * outputSpacing[0];
+  nodeSpacing[1] = 0.5 * step * outputSpacing[1];
+
+  typename GenericRSTransformType::GridSizeType nodes;
+  nodes.Fill(3);
+
+  std::vector<TransformOutputPointType> points;
+  double maximumError = 0.;
+
+  for (unsigned int cy = 0; cy < nbCells; ++cy)
+    {
+    for (unsigned int cx = 0; cx < nbCells; ++cx)
+      {
+      // Cells are spread over the output image
+      TransformInputPointType cellOrigin;
+      cellOrigin[0] = outputOrigin[0] + outputSpacing[0]
+        * (outputIndex[0] + (outputSize[0] - step) * (cx + 0.5) / nbCells);
+      cellOrigin[1] = outputOrigin[1] + outputSpacing[1]
+        * (outputIndex[1] + (outputSize[1] - step) * (cy + 0.5) / nbCells);
+
+      m_Transform->TransformGrid(cellOrigin, nodeSpacing, nodes, points);
+
+      bool validCell = true;
+      for (unsigned int n = 0; n < points.size(); ++n)
+        {
+        validCell = validCell && vnl_math_isfinite(points[n][0]) && vnl_math_isfinite(points[n][1]);
+        }
+      if (!validCell)
+        {
+        continue;
+        }
+
+      for (unsigned int n = 0; n < points.size(); ++n)
+        {
+        const double u = 0.5 * (n % 3);
+        const double v = 0.5 * (n / 3);
+
+        for (unsigned int dim = 0; dim < 2; ++dim)
+          {
+          const double interpolated = (1. - v) * ((1. - u) * points[0][dim] + u * points[2][dim])
+            + v * ((1. - u) * points[6][dim] + u * points[8][dim]);
+          const double error = vcl_abs(interpolated - points[n][dim]) / vcl_abs(inputSpacing[dim]);
+          maximumError = std::max(maximumError, error);
+          }
+        }
+      }
+    }
+
+  return maximumError;
+}
+
 /**
  * Method to estimate the rpc model of the output using a temporary image
  */
@@ -378,6 +492,7 @@ GenericRSResampleImageFilter<TInputImage, TOutputImage>
   os << indent << "OutputSpacing: " << m_Resampler->GetOutputSpacing() << std::endl;
   os << indent << "OutputStartIndex: " << m_Resampler->GetOutputStartIndex() << std::endl;
   os << indent << "OutputSize: " << m_Resampler->GetOutputSize() << std::endl;
+  os << indent << "DisplacementFieldMaximumError: " << m_DisplacementFieldMaximumError << std::endl;
   os << indent << "GenericRSTransform: " << std::endl;
   m_Transform->Print(os, indent.GetNextIndent());
 }
@@ -29,6 +29,10 @@
 // Extract ROI
 #include "otbMultiChannelExtractROI.h"
 
+// Per-point displacement field
+#include "itkTransformToDisplacementFieldSource.h"
+#include "otbStreamingWarpImageFilter.h"
+
 // Images definition
 const unsigned int Dimension = 2;
 typedef double                                      PixelType;
@@ -206,3 +210,110 @@ int otbGenericRSResampleImageFilterFromMap(int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbGenericRSResampleImageFilterMaximumError(int itkNotUsed(argc), char* argv[])
+{
+  typedef ImageResamplerType::ResamplerType::DisplacementFieldType DisplacementFieldType;
+  typedef itk::TransformToDisplacementFieldSource<DisplacementFieldType,
+                                                  double>          DisplacementFieldSourceType;
+  typedef otb::StreamingWarpImageFilter<ImageType, ImageType,
+                                        DisplacementFieldType>     WarpFilterType;
+  typedef ImageResamplerType::GenericRSTransformType               TransformType;
+
+  const char * infname         = argv[1];
+  unsigned int isize           = atoi(argv[2]);
+  double       maxError        = atof(argv[3]);
+  const char * outGridFname    = argv[4];
+  const char * outPerPointFname = argv[5];
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+  reader->UpdateOutputInformation();
+
+  SizeType size;
+  size.Fill(isize);
+
+  OriginType origin;
+  origin[0] = 367340;
+  origin[1] = 4.83467e+06;
+
+  SpacingType spacing;
+  spacing[0] = 0.6;
+  spacing[1] = -0.6;
+
+  OGRSpatialReference oSRS;
+  oSRS.SetProjCS("UTM");
+  oSRS.SetUTM(31, true);
+  char * utmRef = ITK_NULLPTR;
+  oSRS.exportToWkt(&utmRef);
+
+  ImageType::PixelType defaultValue;
+  itk::NumericTraits<ImageType::PixelType>::SetLength(defaultValue, reader->GetOutput()->GetNumberOfComponentsPerPixel());
+
+  // Grid path: the field spacing is estimated from the maximum error
+  // and the field is generated with GenericRSTransform::TransformGrid()
+  ImageResamplerType::Pointer resampler = ImageResamplerType::New();
+  resampler->SetInput(reader->GetOutput());
+  resampler->SetDisplacementFieldMaximumError(maxError);
+  resampler->SetOutputOrigin(origin);
+  resampler->SetOutputSize(size);
+  resampler->SetOutputSpacing(spacing);
+  resampler->SetOutputProjectionRef(utmRef);
+  resampler->SetEdgePaddingValue(defaultValue);
+  resampler->UpdateOutputInformation();
+
+  const SpacingType fieldSpacing = resampler->GetDisplacementFieldSpacing();
+  std::cout << "Estimated displacement field spacing: " << fieldSpacing << std::endl;
+
+  WriterType::Pointer gridWriter = WriterType::New();
+  gridWriter->SetNumberOfDivisionsTiledStreaming(4);
+  gridWriter->SetFileName(outGridFname);
+  gridWriter->SetInput(resampler->GetOutput());
+  gridWriter->Update();
+
+  // Per-point path: same transform and field spacing, but the field is
+  // generated point by point by itk::TransformToDisplacementFieldSource
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetInputProjectionRef(utmRef);
+  transform->SetOutputDictionary(reader->GetOutput()->GetMetaDataDictionary());
+  transform->SetOutputProjectionRef(reader->GetOutput()->GetProjectionRef());
+  transform->SetOutputKeywordList(reader->GetOutput()->GetImageKeywordlist());
+  transform->InstantiateTransform();
+
+  DisplacementFieldSourceType::SizeType fieldSize;
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+    {
+    fieldSize[dim] = static_cast<unsigned int>(
+      vcl_ceil(size[dim] * vcl_abs(spacing[dim] / fieldSpacing[dim]))) + 1;
+    }
+  DisplacementFieldSourceType::IndexType fieldIndex;
+  fieldIndex.Fill(0);
+
+  DisplacementFieldSourceType::Pointer fieldSource = DisplacementFieldSourceType::New();
+  fieldSource->SetTransform(transform);
+  fieldSource->SetOutputOrigin(origin);
+  fieldSource->SetOutputSpacing(fieldSpacing);
+  fieldSource->SetOutputSize(fieldSize);
+  fieldSource->SetOutputIndex(fieldIndex);
+  fieldSource->SetNumberOfThreads(1);
+
+  ImageType::IndexType outIndex;
+  outIndex.Fill(0);
+
+  WarpFilterType::Pointer warper = WarpFilterType::New();
+  warper->SetInput(reader->GetOutput());
+  warper->SetDisplacementField(fieldSource->GetOutput());
+  warper->SetOutputOrigin(origin);
+  warper->SetOutputSpacing(spacing);
+  warper->SetOutputSize(size);
+  warper->SetOutputStartIndex(outIndex);
+  warper->SetEdgePaddingValue(defaultValue);
+
+  WriterType::Pointer perPointWriter = WriterType::New();
+  perPointWriter->SetNumberOfDivisionsTiledStreaming(4);
+  perPointWriter->SetFileName(outPerPointFname);
+  perPointWriter->SetInput(warper->GetOutput());
+  perPointWriter->Update();
+
+  return EXIT_SUCCESS;
+}
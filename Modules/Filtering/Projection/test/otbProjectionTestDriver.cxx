@@ -30,6 +30,7 @@ void RegisterTests()
   REGISTER_TEST(otbGenericRSResampleImageFilterNew);
   REGISTER_TEST(otbGenericRSResampleImageFilter);
   REGISTER_TEST(otbGenericRSResampleImageFilterFromMap);
+  REGISTER_TEST(otbGenericRSResampleImageFilterMaximumError);
   REGISTER_TEST(otbGeometriesProjectionFilter);
   REGISTER_TEST(otbGenericRSTransformGenericTest);
   REGISTER_TEST(otbLeastSquareAffineTransformEstimatorNew);
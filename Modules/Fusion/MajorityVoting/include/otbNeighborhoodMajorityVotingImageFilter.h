@@ -30,6 +30,8 @@
 #include "itkMorphologyImageFilter.h"
 #include "itkBinaryBallStructuringElement.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -58,6 +60,15 @@ namespace otb
  *     the image neighbors where the kernel has elements > 0.
  *   - Replace the original label value with the more representative label value
  *
+ * For integer labels spanning a small range (at most
+ * MaximumNumberOfDenseLabels values), the filter does not call Evaluate()
+ * but maintains a dense histogram of the labels under the structuring
+ * element, updated incrementally as the element slides along the lines:
+ * only the pixels entering and leaving each run of the element are
+ * processed. The output is identical to the one of the generic path,
+ * which is used for other label types and when the boundary condition has
+ * been overridden.
+ *
  * \sa MorphologyImageFilter, GrayscaleFunctionDilateImageFilter, BinaryDilateImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  *
@@ -115,6 +126,12 @@ public:
   /** Type of the pixels in the Kernel. */
   typedef typename TKernel::PixelType            KernelPixelType;
 
+  typedef typename TOutputImage::RegionType      OutputImageRegionType;
+  typedef typename TOutputImage::PixelType       OutputPixelType;
+
+  /** Maximum size of the label range for the dense histogram path */
+  itkStaticConstMacro(MaximumNumberOfDenseLabels, unsigned long, 65536);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(InputConvertibleToOutputCheck,
@@ -173,6 +190,13 @@ protected:
 
   void GenerateOutputInformation() ITK_OVERRIDE;
 
+  /** Check whether the dense histogram path can be used */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Dense histogram path, or generic path of MorphologyImageFilter */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            itk::ThreadIdType threadId) ITK_OVERRIDE;
+
 
   //Type to store the useful information from the label histogram  
   struct HistoSummary
@@ -198,6 +222,10 @@ protected:
                                                          const KernelIteratorType kernelBegin,
                                                          const KernelIteratorType kernelEnd) const;
 
+  //Return the output label of a pixel from its value and the summary of
+  //its neighborhood histogram
+  PixelType SelectLabel(const PixelType centerPixel, const HistoSummary & histoSummary) const;
+
 private:
   NeighborhoodMajorityVotingImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
@@ -215,6 +243,40 @@ private:
   //this threshold with the same label
   unsigned int m_IsolatedThreshold;
 
+  //Horizontal run of positive elements of the structuring element
+  struct KernelRun
+  {
+    typename KernelType::OffsetType offset; //offset of the first element
+    unsigned int length;
+  };
+
+  //Label counts indexed by (label - minimum label), with the list of
+  //labels having a non null count
+  class DenseHistogram
+  {
+  public:
+    DenseHistogram(unsigned long nbLabels, PixelType minLabel, PixelType noDataLabel);
+
+    void AddPixel(const PixelType label);
+    void RemovePixel(const PixelType label);
+    void Clear();
+
+    const HistoSummary Summarize(const PixelType centerPixel) const;
+
+  private:
+    std::vector<unsigned int> m_Counts;
+    std::vector<unsigned long> m_Active;
+    std::vector<unsigned long> m_Position;
+    PixelType m_MinLabel;
+    PixelType m_NoDataLabel;
+  };
+
+  //Dense histogram path settings, computed before threading
+  bool m_UseDenseHistogram;
+  PixelType m_MinimumLabel;
+  unsigned long m_NumberOfLabels;
+  std::vector<KernelRun> m_KernelRuns;
+
 }; // end of class
 
 } // end namespace otb
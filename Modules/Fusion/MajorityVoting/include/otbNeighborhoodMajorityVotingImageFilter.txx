@@ -29,6 +29,11 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMetaDataObject.h"
 #include "otbMetaDataKey.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
 
 namespace otb
 {
@@ -38,11 +43,18 @@ namespace otb
 template<class TInputImage, class TOutputImage, class TKernel>
 NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>::NeighborhoodMajorityVotingImageFilter()
 {
-  this->SetLabelForNoDataPixels(itk::NumericTraits<PixelType>::NonpositiveMin()); //m_LabelForNoDataPixels = 0
+  //m_LabelForNoDataPixels = 0, set directly since the setter only updates
+  //the boundary condition if the value changes
+  m_LabelForNoDataPixels = itk::NumericTraits<PixelType>::NonpositiveMin();
+  m_MajorityVotingBoundaryCondition.SetConstant(m_LabelForNoDataPixels);
+  this->OverrideBoundaryCondition(&m_MajorityVotingBoundaryCondition);
   this->SetLabelForUndecidedPixels(itk::NumericTraits<PixelType>::NonpositiveMin()); //m_LabelForUndecidedPixels = 0
   this->SetKeepOriginalLabelBool(true); //m_KeepOriginalLabelBool = true
   this->SetOnlyIsolatedPixels(false); //process all pixels 
   this->SetIsolatedThreshold(1);
+  m_UseDenseHistogram = false;
+  m_MinimumLabel = itk::NumericTraits<PixelType>::Zero;
+  m_NumberOfLabels = 0;
 }
 
 
@@ -64,32 +76,42 @@ NeighborhoodMajorityVotingImageFilter<TInputImage,
     //Get a histogram of label frequencies where the 2 highest are at the beginning and sorted
     const HistoSummary histoSummary = 
       this->ComputeNeighborhoodHistogramSummary(nit, kernelBegin, kernelEnd);
-    if(m_OnlyIsolatedPixels && 
-       histoSummary.freqCenterLabel > m_IsolatedThreshold)
-      {
-      //If we want to filter only isolated pixels, keep the label if
-      //there are enough pixels with the center label to consider that
-      //it is not isolated
-      return centerPixel;
-      }
-    else
+    return this->SelectLabel(centerPixel, histoSummary);
+    }//END if (centerPixel != m_LabelForNoDataPixels)
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+typename NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage,
+                                               TKernel>::PixelType
+NeighborhoodMajorityVotingImageFilter<TInputImage,
+                                      TOutputImage, TKernel>::SelectLabel(const PixelType centerPixel,
+                                                                          const HistoSummary & histoSummary) const
+{
+  if(m_OnlyIsolatedPixels && 
+     histoSummary.freqCenterLabel > m_IsolatedThreshold)
+    {
+    //If we want to filter only isolated pixels, keep the label if
+    //there are enough pixels with the center label to consider that
+    //it is not isolated
+    return centerPixel;
+    }
+  else
+    {
+    //If the majorityLabel is NOT unique in the neighborhood
+    if(!histoSummary.majorityUnique)
       {
-      //If the majorityLabel is NOT unique in the neighborhood
-      if(!histoSummary.majorityUnique)
+      if (m_KeepOriginalLabelBool == true)
         {
-        if (m_KeepOriginalLabelBool == true)
-          {
-          return centerPixel;
-          }
-        else
-          {
-          return m_LabelForUndecidedPixels;
-          }
+        return centerPixel;
+        }
+      else
+        {
+        return m_LabelForUndecidedPixels;
         }
-      //Extraction of the more representative Label in the neighborhood (majorityLabel)
-      return histoSummary.majorityLabel;
       }
-    }//END if (centerPixel != m_LabelForNoDataPixels)
+    //Extraction of the more representative Label in the neighborhood (majorityLabel)
+    return histoSummary.majorityLabel;
+    }
 }
 
 template<class TInputImage, class TOutputImage, class TKernel>
@@ -140,6 +162,303 @@ NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage,
   return result;
 }
 
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  m_UseDenseHistogram = false;
+  m_KernelRuns.clear();
+
+  // Out of image pixels must be no-data pixels, as with the default
+  // boundary condition
+  if (!itk::NumericTraits<PixelType>::is_integer
+      || this->GetBoundaryCondition() != &m_MajorityVotingBoundaryCondition)
+    {
+    return;
+    }
+
+  // Range of the labels of the input buffer
+  const TInputImage * inputPtr = this->GetInput();
+  itk::ImageRegionConstIterator<TInputImage> it(inputPtr, inputPtr->GetBufferedRegion());
+
+  bool foundLabel = false;
+  PixelType minLabel = itk::NumericTraits<PixelType>::Zero;
+  PixelType maxLabel = itk::NumericTraits<PixelType>::Zero;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    const PixelType label = it.Get();
+    if (label == m_LabelForNoDataPixels)
+      {
+      continue;
+      }
+    if (!foundLabel)
+      {
+      minLabel = label;
+      maxLabel = label;
+      foundLabel = true;
+      }
+    else if (label < minLabel)
+      {
+      minLabel = label;
+      }
+    else if (label > maxLabel)
+      {
+      maxLabel = label;
+      }
+    }
+
+  if (!foundLabel ||
+      static_cast<double>(maxLabel) - static_cast<double>(minLabel) + 1 > MaximumNumberOfDenseLabels)
+    {
+    return;
+    }
+
+  m_MinimumLabel = minLabel;
+  m_NumberOfLabels = static_cast<unsigned long>(static_cast<double>(maxLabel) - static_cast<double>(minLabel) + 1);
+
+  // Split the structuring element in runs along the first dimension
+  const KernelType & kernel = this->GetKernel();
+  long lastPositive = -2;
+  for (unsigned int i = 0; i < kernel.Size(); ++i)
+    {
+    if (!(kernel[i] > itk::NumericTraits<KernelPixelType>::Zero))
+      {
+      continue;
+      }
+
+    const typename KernelType::OffsetType offset = kernel.GetOffset(i);
+
+    bool sameRun = (lastPositive == static_cast<long>(i) - 1);
+    for (unsigned int d = 1; sameRun && d < KernelDimension; ++d)
+      {
+      sameRun = (offset[d] == m_KernelRuns.back().offset[d]);
+      }
+
+    if (sameRun)
+      {
+      ++m_KernelRuns.back().length;
+      }
+    else
+      {
+      KernelRun run;
+      run.offset = offset;
+      run.length = 1;
+      m_KernelRuns.push_back(run);
+      }
+    lastPositive = i;
+    }
+
+  m_UseDenseHistogram = true;
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  if (!m_UseDenseHistogram)
+    {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  const TInputImage * inputPtr = this->GetInput();
+  TOutputImage * outputPtr = this->GetOutput();
+
+  const typename TInputImage::RegionType bufferedRegion = inputPtr->GetBufferedRegion();
+  const long bufferStart = bufferedRegion.GetIndex()[0];
+  const long bufferSize = bufferedRegion.GetSize()[0];
+  const PixelType * buffer = inputPtr->GetBufferPointer();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  DenseHistogram histogram(m_NumberOfLabels, m_MinimumLabel, m_LabelForNoDataPixels);
+
+  const unsigned int nbRuns = m_KernelRuns.size();
+  std::vector<const PixelType *> runRows(nbRuns);
+
+  itk::ImageLinearIteratorWithIndex<TOutputImage> outIt(outputPtr, outputRegionForThread);
+  outIt.SetDirection(0);
+
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); outIt.NextLine())
+    {
+    typename TInputImage::IndexType lineIndex = outIt.GetIndex();
+    const long lineStart = lineIndex[0];
+    lineIndex[0] = bufferStart;
+
+    const PixelType * centerRow = buffer + inputPtr->ComputeOffset(lineIndex);
+
+    // First pixel of the buffer line of each run (null if outside)
+    for (unsigned int r = 0; r < nbRuns; ++r)
+      {
+      typename TInputImage::IndexType rowIndex = lineIndex + m_KernelRuns[r].offset;
+      rowIndex[0] = bufferStart;
+      runRows[r] = bufferedRegion.IsInside(rowIndex) ? buffer + inputPtr->ComputeOffset(rowIndex) : ITK_NULLPTR;
+      }
+
+    // Fill the histogram for the first pixel of the line
+    histogram.Clear();
+    for (unsigned int r = 0; r < nbRuns; ++r)
+      {
+      if (runRows[r] == ITK_NULLPTR)
+        {
+        continue;
+        }
+      const long first = lineStart + m_KernelRuns[r].offset[0] - bufferStart;
+      for (long x = std::max(first, 0L);
+           x < std::min(first + static_cast<long>(m_KernelRuns[r].length), bufferSize); ++x)
+        {
+        histogram.AddPixel(runRows[r][x]);
+        }
+      }
+
+    for (long x = lineStart - bufferStart; !outIt.IsAtEndOfLine(); ++outIt, ++x)
+      {
+      if (x > lineStart - bufferStart)
+        {
+        // Slide the runs by one pixel
+        for (unsigned int r = 0; r < nbRuns; ++r)
+          {
+          if (runRows[r] == ITK_NULLPTR)
+            {
+            continue;
+            }
+          const long leaving = x - 1 + m_KernelRuns[r].offset[0];
+          const long entering = leaving + m_KernelRuns[r].length;
+          if (leaving >= 0 && leaving < bufferSize)
+            {
+            histogram.RemovePixel(runRows[r][leaving]);
+            }
+          if (entering >= 0 && entering < bufferSize)
+            {
+            histogram.AddPixel(runRows[r][entering]);
+            }
+          }
+        }
+
+      const PixelType centerPixel = centerRow[x];
+      if (centerPixel == m_LabelForNoDataPixels)
+        {
+        outIt.Set(static_cast<OutputPixelType>(m_LabelForNoDataPixels));
+        }
+      else
+        {
+        outIt.Set(static_cast<OutputPixelType>(this->SelectLabel(centerPixel, histogram.Summarize(centerPixel))));
+        }
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::DenseHistogram::DenseHistogram(unsigned long nbLabels, PixelType minLabel, PixelType noDataLabel)
+  : m_Counts(nbLabels, 0),
+    m_Position(nbLabels, 0),
+    m_MinLabel(minLabel),
+    m_NoDataLabel(noDataLabel)
+{
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::DenseHistogram::AddPixel(const PixelType label)
+{
+  if (label == m_NoDataLabel)
+    {
+    return;
+    }
+  const unsigned long idx = static_cast<unsigned long>(label - m_MinLabel);
+  if (m_Counts[idx]++ == 0)
+    {
+    m_Position[idx] = m_Active.size();
+    m_Active.push_back(idx);
+    }
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::DenseHistogram::RemovePixel(const PixelType label)
+{
+  if (label == m_NoDataLabel)
+    {
+    return;
+    }
+  const unsigned long idx = static_cast<unsigned long>(label - m_MinLabel);
+  if (--m_Counts[idx] == 0)
+    {
+    // Swap with the last active label
+    const unsigned long last = m_Active.back();
+    m_Active[m_Position[idx]] = last;
+    m_Position[last] = m_Position[idx];
+    m_Active.pop_back();
+    }
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::DenseHistogram::Clear()
+{
+  for (std::vector<unsigned long>::const_iterator it = m_Active.begin(); it != m_Active.end(); ++it)
+    {
+    m_Counts[*it] = 0;
+    }
+  m_Active.clear();
+}
+
+template<class TInputImage, class TOutputImage, class TKernel>
+const typename NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage,
+                                                     TKernel>::HistoSummary
+NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
+::DenseHistogram::Summarize(const PixelType centerPixel) const
+{
+  HistoSummary result;
+  if (m_Active.empty())
+    {
+    result.freqCenterLabel = 0;
+    result.majorityLabel = centerPixel;
+    result.majorityUnique = true;
+    }
+  else if (m_Active.size() == 1)
+    {
+    result.freqCenterLabel = m_Counts[m_Active[0]];
+    result.majorityLabel = static_cast<PixelType>(m_MinLabel + m_Active[0]);
+    result.majorityUnique = true;
+    }
+  else
+    {
+    // 2 highest frequencies
+    unsigned int first = 0;
+    unsigned int second = 0;
+    unsigned long majority = 0;
+    for (std::vector<unsigned long>::const_iterator it = m_Active.begin(); it != m_Active.end(); ++it)
+      {
+      const unsigned int count = m_Counts[*it];
+      if (count > first)
+        {
+        second = first;
+        first = count;
+        majority = *it;
+        }
+      else if (count > second)
+        {
+        second = count;
+        }
+      }
+    result.freqCenterLabel = m_Counts[static_cast<unsigned long>(centerPixel - m_MinLabel)];
+    result.majorityLabel = static_cast<PixelType>(m_MinLabel + majority);
+    result.majorityUnique = (first != second);
+    }
+  return result;
+}
+
 template<class TInputImage, class TOutputImage, class TKernel>
 void
 NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>
@@ -25,4 +25,5 @@ void RegisterTests()
   REGISTER_TEST(otbNeighborhoodMajorityVotingImageFilterNew);
   REGISTER_TEST(otbNeighborhoodMajorityVotingImageFilterTest);
   REGISTER_TEST(otbNeighborhoodMajorityVotingImageFilterIsolatedTest);
+  REGISTER_TEST(otbNeighborhoodMajorityVotingImageFilterReferenceTest);
 }
@@ -29,6 +29,12 @@
 #include "otbNeighborhoodMajorityVotingImageFilter.h"
 
 #include "itkTimeProbe.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <map>
+#include <vector>
+#include <algorithm>
 
 
 int otbNeighborhoodMajorityVotingImageFilterTest(int argc, char* argv[])
@@ -208,3 +214,146 @@ int otbNeighborhoodMajorityVotingImageFilterIsolatedTest(int itkNotUsed(argc), c
     }
   return EXIT_SUCCESS;
 }
+
+namespace
+{
+// Straightforward majority voting on a ball neighborhood, used as reference
+template <class TImage, class TKernel>
+typename TImage::PixelType ReferenceMajorityVoting(const TImage * image,
+                                                   const typename TImage::IndexType & index,
+                                                   const TKernel & kernel,
+                                                   typename TImage::PixelType noData,
+                                                   typename TImage::PixelType undecided,
+                                                   bool keepOriginal,
+                                                   bool onlyIsolated,
+                                                   unsigned int isolatedThreshold)
+{
+  typedef typename TImage::PixelType PixelType;
+
+  const PixelType center = image->GetPixel(index);
+  if (center == noData)
+    {
+    return noData;
+    }
+
+  std::map<PixelType, unsigned int> histo;
+  for (unsigned int i = 0; i < kernel.Size(); ++i)
+    {
+    if (kernel[i] > 0)
+      {
+      const typename TImage::IndexType neighbor = index + kernel.GetOffset(i);
+      const PixelType label = image->GetLargestPossibleRegion().IsInside(neighbor) ? image->GetPixel(neighbor) : noData;
+      if (label != noData)
+        {
+        histo[label] += 1;
+        }
+      }
+    }
+
+  std::vector<unsigned int> counts;
+  PixelType majority = center;
+  unsigned int maxCount = 0;
+  for (typename std::map<PixelType, unsigned int>::const_iterator it = histo.begin(); it != histo.end(); ++it)
+    {
+    counts.push_back(it->second);
+    if (it->second > maxCount)
+      {
+      maxCount = it->second;
+      majority = it->first;
+      }
+    }
+  std::sort(counts.rbegin(), counts.rend());
+
+  const unsigned int freqCenter = (histo.size() == 1) ? histo.begin()->second : histo[center];
+  const bool unique = (counts.size() == 1) || (counts[0] != counts[1]);
+
+  if (onlyIsolated && freqCenter > isolatedThreshold)
+    {
+    return center;
+    }
+  if (!unique)
+    {
+    return keepOriginal ? center : undecided;
+    }
+  return majority;
+}
+
+template <class TPixel>
+bool CheckMajorityVotingAgainstReference(TPixel labelStep, bool keepOriginal, bool onlyIsolated)
+{
+  typedef otb::Image<TPixel, 2>                                 ImageType;
+  typedef otb::NeighborhoodMajorityVotingImageFilter<ImageType> FilterType;
+  typedef typename FilterType::KernelType                       StructuringType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  typename ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 61);
+  region.SetSize(1, 47);
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  // Few labels (including the no-data one) with spatial coherence
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(1234);
+  itk::ImageRegionIterator<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    const typename ImageType::IndexType idx = it.GetIndex();
+    const unsigned int label = (generator->GetIntegerVariate(3) == 0)
+      ? generator->GetIntegerVariate(5) : ((idx[0] / 7 + idx[1] / 5) % 5);
+    it.Set(static_cast<TPixel>(label * labelStep));
+    }
+
+  const TPixel noData = 3 * labelStep;
+  const TPixel undecided = 7;
+
+  typename StructuringType::RadiusType rad;
+  rad[0] = 3;
+  rad[1] = 2;
+  StructuringType seBall;
+  seBall.SetRadius(rad);
+  seBall.CreateStructuringElement();
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetKernel(seBall);
+  filter->SetLabelForNoDataPixels(noData);
+  filter->SetLabelForUndecidedPixels(undecided);
+  filter->SetKeepOriginalLabelBool(keepOriginal);
+  filter->SetOnlyIsolatedPixels(onlyIsolated);
+  filter->SetIsolatedThreshold(4);
+  filter->Update();
+
+  itk::ImageRegionConstIterator<ImageType> outIt(filter->GetOutput(), region);
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+    {
+    const TPixel ref = ReferenceMajorityVoting(image.GetPointer(), outIt.GetIndex(), seBall, noData, undecided,
+                                               keepOriginal, onlyIsolated, 4);
+    if (outIt.Get() != ref)
+      {
+      std::cerr << "Label step " << labelStep << ", keep original " << keepOriginal << ", only isolated "
+                << onlyIsolated << ": pixel " << outIt.GetIndex() << " is " << outIt.Get()
+                << " instead of " << ref << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbNeighborhoodMajorityVotingImageFilterReferenceTest(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  // Small label range (dense histogram) and large label range (generic
+  // path) against a straightforward implementation
+  bool ok = true;
+  ok = CheckMajorityVotingAgainstReference<unsigned char>(1, true, false) && ok;
+  ok = CheckMajorityVotingAgainstReference<unsigned char>(1, false, false) && ok;
+  ok = CheckMajorityVotingAgainstReference<unsigned char>(1, false, true) && ok;
+  ok = CheckMajorityVotingAgainstReference<int>(-40000, false, false) && ok;
+  ok = CheckMajorityVotingAgainstReference<int>(-40000, true, true) && ok;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
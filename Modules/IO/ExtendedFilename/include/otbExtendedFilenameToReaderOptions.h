@@ -35,6 +35,8 @@ namespace otb
  * - &resol : resolution factor for jpeg200 files
  * - &skipcarto : switch to skip the cartographic information
  * - &skipgeom  : switch to skip the geometric information
+ * - &nbthreads : number of threads used to decode the image blocks
+ *               (at least 1, other values are rejected)
  * - &bands : select a band composition different from the input image,
  *           syntax is bands=r1,r2,r3,...,rn  where each ri is a band range
  *           that can be :
@@ -75,6 +77,7 @@ public:
     std::pair< bool, bool         >  skipGeom;
     std::pair< bool, bool         >  skipRpcTag;
     std::pair< bool, std::string  >  bandRange;
+    std::pair< bool, unsigned int >  numberOfReadThreads;
     std::vector<std::string>         optionList;
   };
 
@@ -94,6 +97,8 @@ public:
   bool GetSkipGeom () const;
   bool SkipRpcTagIsSet () const;
   bool GetSkipRpcTag () const;
+  bool NumberOfReadThreadsIsSet () const;
+  unsigned int GetNumberOfReadThreads () const;
   std::string GetBandRange () const;
 
   /** Test if band range extended filename is set */
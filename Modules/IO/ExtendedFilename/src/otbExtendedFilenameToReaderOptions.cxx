@@ -20,6 +20,7 @@
 
 #include "otbExtendedFilenameToReaderOptions.h"
 #include "otb_boost_string_header.h"
+#include "otbStringUtils.h"
 #include "itksys/RegularExpression.hxx"
 
 namespace otb
@@ -52,6 +53,9 @@ ExtendedFilenameToReaderOptions
   m_Options.bandRange.first = false;
   m_Options.bandRange.second = "";
 
+  m_Options.numberOfReadThreads.first  = false;
+  m_Options.numberOfReadThreads.second = 1;
+
   m_Options.optionList.push_back("geom");
   m_Options.optionList.push_back("sdataidx");
   m_Options.optionList.push_back("resol");
@@ -59,6 +63,7 @@ ExtendedFilenameToReaderOptions
   m_Options.optionList.push_back("skipgeom");
   m_Options.optionList.push_back("skiprpctag");
   m_Options.optionList.push_back("bands");
+  m_Options.optionList.push_back("nbthreads");
 }
 
 void
@@ -87,6 +92,27 @@ ExtendedFilenameToReaderOptions
     m_Options.resolutionFactor.second = atoi(map["resol"].c_str());
     }
 
+  if (!map["nbthreads"].empty())
+    {
+    int nbThreads = 0;
+    try
+      {
+      nbThreads = boost::lexical_cast<int>(map["nbthreads"]);
+      }
+    catch(boost::bad_lexical_cast &)
+      {
+      itkGenericExceptionMacro(<< "Invalid value '" << map["nbthreads"]
+                               << "' for option nbthreads: expected an integer");
+      }
+    if (nbThreads < 1)
+      {
+      itkGenericExceptionMacro(<< "Invalid value " << nbThreads
+                               << " for option nbthreads: at least 1 thread is needed");
+      }
+    m_Options.numberOfReadThreads.first  = true;
+    m_Options.numberOfReadThreads.second = static_cast<unsigned int>(nbThreads);
+    }
+
   if (!map["skipcarto"].empty())
     {
     m_Options.skipCarto.first = true;
@@ -245,6 +271,19 @@ ExtendedFilenameToReaderOptions
   return m_Options.skipRpcTag.second;
 }
 
+bool
+ExtendedFilenameToReaderOptions
+::NumberOfReadThreadsIsSet () const
+{
+  return m_Options.numberOfReadThreads.first;
+}
+unsigned int
+ExtendedFilenameToReaderOptions
+::GetNumberOfReadThreads () const
+{
+  return m_Options.numberOfReadThreads.second;
+}
+
 bool
 ExtendedFilenameToReaderOptions
 ::BandRangeIsSet () const
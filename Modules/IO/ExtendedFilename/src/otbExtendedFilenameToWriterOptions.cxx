@@ -42,6 +42,8 @@ ExtendedFilenameToWriterOptions
   m_Options.streamingType.first       = false;
   m_Options.streamingSizeMode.first   = false;
   m_Options.streamingSizeValue.first  = false;
+  m_Options.streamingPipelined.first  = false;
+  m_Options.streamingPipelined.second = false;
 
   m_Options.bandRange.first = false;
   m_Options.bandRange.second = "";
@@ -51,6 +53,7 @@ ExtendedFilenameToWriterOptions
   m_Options.optionList.push_back("streaming:type");
   m_Options.optionList.push_back("streaming:sizemode");
   m_Options.optionList.push_back("streaming:sizevalue");
+  m_Options.optionList.push_back("streaming:pipelined");
   m_Options.optionList.push_back("box");
   m_Options.optionList.push_back("bands");
 }
@@ -113,6 +116,7 @@ ExtendedFilenameToWriterOptions
     if(map["streaming:type"] == "auto"
        || map["streaming:type"] == "tiled"
        || map["streaming:type"] == "stripped"
+       || map["streaming:type"] == "overlap"
        || map["streaming:type"] == "none")
       {
       m_Options.streamingType.first=true;
@@ -120,7 +124,7 @@ ExtendedFilenameToWriterOptions
       }
     else
       {
-      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,tiled,stripped.");
+      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,tiled,stripped,overlap,none.");
       }
     }
 
@@ -145,6 +149,20 @@ ExtendedFilenameToWriterOptions
     m_Options.streamingSizeValue.second = atof(map["streaming:sizevalue"].c_str());
     }
 
+  if (!map["streaming:pipelined"].empty())
+     {
+     m_Options.streamingPipelined.first = true;
+     if (   map["streaming:pipelined"] == "On"
+         || map["streaming:pipelined"] == "on"
+         || map["streaming:pipelined"] == "ON"
+         || map["streaming:pipelined"] == "true"
+         || map["streaming:pipelined"] == "True"
+         || map["streaming:pipelined"] == "1"   )
+       {
+       m_Options.streamingPipelined.second = true;
+       }
+     }
+
   //Manage region size to write in output image
   if(!map["box"].empty())
     {
@@ -295,6 +313,20 @@ ExtendedFilenameToWriterOptions
   return m_Options.streamingSizeValue.second;
 }
 
+bool
+ExtendedFilenameToWriterOptions
+::StreamingPipelinedIsSet() const
+{
+  return m_Options.streamingPipelined.first;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::GetStreamingPipelined() const
+{
+  return m_Options.streamingPipelined.second;
+}
+
 bool
 ExtendedFilenameToWriterOptions
 ::BoxIsSet() const
@@ -23,6 +23,7 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbExtendedFilenameToReaderOptions);
+  REGISTER_TEST(otbExtendedFilenameToReaderOptionsNbThreads);
   REGISTER_TEST(otbExtendedFilenameToWriterOptions);
   REGISTER_TEST(otbImageFileReaderWithExtendedFilename);
   REGISTER_TEST(otbImageFileWriterWithExtendedFilename);
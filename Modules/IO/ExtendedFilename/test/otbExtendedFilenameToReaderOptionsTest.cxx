@@ -87,3 +87,23 @@ int otbExtendedFilenameToReaderOptions(int argc, char* argv[])
   file.close();
   return EXIT_SUCCESS;
 }
+
+int otbExtendedFilenameToReaderOptionsNbThreads(int itkNotUsed(argc), char* argv[])
+{
+  const char * inputExtendedFilename  = argv[1];
+  const unsigned int expectedNbThreads = atoi(argv[2]);
+
+  FilenameHelperType::Pointer helper = FilenameHelperType::New();
+
+  helper->SetExtendedFileName(inputExtendedFilename);
+
+  if (!helper->NumberOfReadThreadsIsSet()
+      || helper->GetNumberOfReadThreads() != expectedNbThreads)
+    {
+    std::cout << "Number of read threads: " << helper->GetNumberOfReadThreads()
+              << ", expected: " << expectedNbThreads << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -24,12 +24,16 @@
 
 /* C++ Libraries */
 #include <string>
+#include <vector>
 
 /* ITK Libraries */
 #include "otbImageIOBase.h"
+#include "itkNumericTraits.h"
 
 #include "OTBIOGDALExport.h"
 
+class GDALDataset;
+
 namespace otb
 {
 class GDALDatasetWrapper;
@@ -61,7 +65,16 @@ class GDALDataTypeWrapper;
  * physical space as GDAL physical space : a given point of
  * image has the same physical location in OTB and in GDAL.
  *
- * The streaming read is implemented.
+ * The streaming read is implemented. The region to read can be split
+ * along the native block grid of the file and decoded by several threads,
+ * each of them using its own GDAL dataset handle (see
+ * SetNumberOfReadThreads()). This speeds up the reading of compressed
+ * files (tiled JPEG or DEFLATE GeoTIFF, JPEG2000 ...).
+ *
+ * When the process-wide GDALTileCache is enabled, decoded blocks are
+ * kept in and read from this cache, so that several readers of the same
+ * file do not decode the same blocks twice. The blocks missing from the
+ * cache are then decoded by the same number of threads.
  *
  * \ingroup IOFilters
  *
@@ -104,6 +117,28 @@ public:
   itkSetMacro(WriteRPCTags,bool);
   itkGetMacro(WriteRPCTags,bool);
 
+  /** Set/Get the number of threads used to read a region (at least 1).
+   *  1 (default) reads the region with a single RasterIO call. This value
+   *  can also be passed through the MetaDataKey::NumberOfReadThreads key
+   *  of the dictionary. */
+  itkSetClampMacro(NumberOfReadThreads, unsigned int, 1, itk::NumericTraits<unsigned int>::max());
+  itkGetMacro(NumberOfReadThreads, unsigned int);
+
+  /** Get the cumulated time (in seconds) spent by GDAL to read pixels
+   *  since the last call to ResetReadStatistics() */
+  itkGetConstMacro(TotalReadTime, double);
+
+  /** Get the number of regions read since the last call to
+   *  ResetReadStatistics() */
+  itkGetConstMacro(NumberOfReads, unsigned long);
+
+  /** Reset the reading time and count */
+  void ResetReadStatistics()
+  {
+    m_TotalReadTime = 0.;
+    m_NumberOfReads = 0;
+  }
+
   
   /** Set/Get the options */
   void SetOptions(const GDALCreationOptionsType& opts)
@@ -226,6 +261,28 @@ private:
 
   std::string FilenameToGdalDriverShortName(const std::string& name) const;
 
+  /** Read the given region (at full resolution) in the buffer, splitting
+   *  it in chunks aligned on the file blocks decoded by several threads.
+   *  Throws if any of the chunk reads failed. */
+  void ParallelRasterIO(int firstColumn, int firstLine, int nbColumns, int nbLines,
+                        unsigned char * buffer, int nbBands,
+                        int pixelOffset, int lineOffset, int bandOffset);
+
+  /** Read the given region (at the current resolution) in the buffer
+   *  block by block, through the process-wide GDALTileCache. The blocks
+   *  missing from the cache are decoded by NumberOfReadThreads threads.
+   *  Return false if the cache is disabled or can not be used for this
+   *  file, in which case nothing is read. */
+  bool CachedRasterIO(int firstColumn, int firstLine, int nbColumns, int nbLines,
+                      unsigned char * buffer, int nbBands,
+                      int pixelOffset, int lineOffset, int bandOffset);
+
+  /** Get dataset handles on the input file for nbThreads reading
+   *  threads, m_Dataset first, opening the missing ones. Return the
+   *  number of handles, which may be lower if the file can not be
+   *  opened again. */
+  unsigned int GetReadDatasets(unsigned int nbThreads, std::vector<GDALDataset*> & datasets);
+
   /** Parse a GML box from a Jpeg2000 file and get the origin */
   bool GetOriginFromGMLBox(std::vector<double> &origin);
   
@@ -281,6 +338,17 @@ private:
    * True if RPC tags should be exported
    */
   bool m_WriteRPCTags;
+
+  /** Number of threads used by Read() */
+  unsigned int m_NumberOfReadThreads;
+
+  /** Additional dataset handles on the input file, one per extra
+   *  reading thread (the first thread uses m_Dataset) */
+  std::vector<GDALDatasetWrapperPointer> m_ReadDatasets;
+
+  /** Reading statistics */
+  double        m_TotalReadTime;
+  unsigned long m_NumberOfReads;
   
 };
 
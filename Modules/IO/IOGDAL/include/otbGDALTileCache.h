@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGDALTileCache_h
+#define otbGDALTileCache_h
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "itkFastMutexLock.h"
+
+#include "OTBIOGDALExport.h"
+
+namespace otb
+{
+
+/** \class GDALTileCache
+ *
+ * \brief Process-wide cache of decoded image blocks
+ *
+ * This class provides an unique, bounded and thread-safe cache of the
+ * native blocks decoded by GDALImageIO. Blocks are identified by the
+ * file name, the overview level, the band and the block index, so that
+ * several readers on the same file (or successive overlapping stream
+ * requests) share the decoding work.
+ *
+ * When the cache is full, the least recently used blocks are
+ * evicted. Its capacity is initialized from
+ * ConfigurationManager::GetTileCacheSize() (environment variable
+ * OTB_TILE_CACHE_SIZE, in MB). A capacity of 0 disables the cache,
+ * which is the default.
+ *
+ * \sa GDALImageIO
+ *
+ * \ingroup OTBIOGDAL
+ */
+class OTBIOGDAL_EXPORT GDALTileCache
+{
+public:
+  typedef std::vector<unsigned char>            BlockType;
+  typedef boost::shared_ptr<const BlockType>    BlockPointerType;
+  typedef unsigned long long                    SizeValueType;
+
+  /** Identifier of a block in a file */
+  struct KeyType
+  {
+    std::string  FileName;
+    unsigned int OverviewLevel;
+    int          Band;
+    int          BlockX;
+    int          BlockY;
+
+    bool operator<(const KeyType & other) const;
+  };
+
+  // GetInstance returns a reference to the unique GDALTileCache
+  static GDALTileCache& GetInstance()
+  {
+    static GDALTileCache theUniqueInstance;
+    return theUniqueInstance;
+  }
+
+  /** Return the block if it is in the cache (and mark it as recently
+   *  used), or a null pointer otherwise */
+  BlockPointerType Get(const KeyType & key);
+
+  /** Insert a block in the cache, evicting the least recently used
+   *  blocks if needed. Blocks larger than the capacity are not kept. */
+  void Insert(const KeyType & key, const BlockPointerType & block);
+
+  /** Remove all blocks of the given file (for instance because it is
+   *  being overwritten) */
+  void Remove(const std::string & fileName);
+
+  /** Remove all blocks */
+  void Clear();
+
+  /** Set/Get the capacity of the cache in bytes. Reducing it evicts
+   *  blocks immediately. */
+  void SetCapacity(SizeValueType capacity);
+  SizeValueType GetCapacity() const;
+
+  /** Return true if the capacity is not 0 */
+  bool IsEnabled() const;
+
+  /** Statistics */
+  SizeValueType GetSize() const;
+  unsigned long GetNumberOfBlocks() const;
+  unsigned long GetNumberOfHits() const;
+  unsigned long GetNumberOfMisses() const;
+  unsigned long GetNumberOfEvictions() const;
+  void ResetStatistics();
+
+private:
+  // private constructor so that this class is allocated only inside GetInstance
+  GDALTileCache();
+  ~GDALTileCache();
+  GDALTileCache(const GDALTileCache &); //purposely not implemented
+  void operator =(const GDALTileCache&); //purposely not implemented
+
+  /** Evict blocks until the size fits in the capacity (lock must be held) */
+  void Shrink();
+
+  typedef std::pair<KeyType, BlockPointerType>        EntryType;
+  typedef std::list<EntryType>                        EntryListType;
+  typedef std::map<KeyType, EntryListType::iterator>  EntryMapType;
+
+  /** Most recently used blocks first */
+  EntryListType m_Entries;
+  EntryMapType  m_Index;
+
+  SizeValueType m_Capacity;
+  SizeValueType m_Size;
+
+  unsigned long m_NumberOfHits;
+  unsigned long m_NumberOfMisses;
+  unsigned long m_NumberOfEvictions;
+
+  mutable itk::SimpleFastMutexLock m_Lock;
+};
+
+} // end namespace otb
+
+#endif // otbGDALTileCache_h
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 
 #include "otbGDALImageIO.h"
 #include "otbMacro.h"
@@ -36,12 +37,14 @@
 #include "itkRGBPixel.h"
 #include "itkRGBAPixel.h"
 #include "itkTimeProbe.h"
+#include "itkMultiThreader.h"
 
 #include "cpl_conv.h"
 #include "ogr_spatialref.h"
 #include "ogr_srs_api.h"
 
 #include "otbGDALDriverManagerWrapper.h"
+#include "otbGDALTileCache.h"
 
 #include "otb_boost_string_header.h"
 
@@ -53,6 +56,133 @@ inline unsigned int uint_ceildivpow2(unsigned int a, unsigned int b) {
   return (a + (1 << b) - 1) >> b;
 }
 
+namespace
+{
+
+/** Part of a region read by one thread, aligned on the file blocks */
+struct ReadChunk
+{
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+/** Data shared by the reading threads */
+struct ParallelReadStruct
+{
+  std::vector<GDALDataset*> Datasets;
+  std::vector<ReadChunk>    Chunks;
+  std::vector<std::string>  Errors;
+  unsigned char *           Buffer;
+  int                       FirstColumn;
+  int                       FirstLine;
+  GDALDataType              PixelType;
+  int                       NbBands;
+  int                       PixelOffset;
+  int                       LineOffset;
+  int                       BandOffset;
+};
+
+ITK_THREAD_RETURN_TYPE ParallelReadThreaderCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  ParallelReadStruct * str = static_cast<ParallelReadStruct *>(info->UserData);
+
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType nbThreads = info->NumberOfThreads;
+  GDALDataset * dataset = str->Datasets[threadId];
+
+  for (size_t i = threadId; i < str->Chunks.size(); i += nbThreads)
+    {
+    const ReadChunk & chunk = str->Chunks[i];
+
+    // The chunk is read in place in the shared buffer
+    unsigned char * p = str->Buffer
+      + static_cast<std::ptrdiff_t>(chunk.y - str->FirstLine) * str->LineOffset
+      + static_cast<std::ptrdiff_t>(chunk.x - str->FirstColumn) * str->PixelOffset;
+
+    CPLErr lCrGdal = dataset->RasterIO(GF_Read,
+                                       chunk.x,
+                                       chunk.y,
+                                       chunk.width,
+                                       chunk.height,
+                                       p,
+                                       chunk.width,
+                                       chunk.height,
+                                       str->PixelType,
+                                       str->NbBands,
+                                       ITK_NULLPTR,
+                                       str->PixelOffset,
+                                       str->LineOffset,
+                                       str->BandOffset);
+    if (lCrGdal == CE_Failure)
+      {
+      // GDAL error messages are thread local
+      str->Errors[threadId] = CPLGetLastErrorMsg();
+      break;
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** Block missing from the tile cache */
+struct MissingBlock
+{
+  int    Band;
+  int    BlockX;
+  int    BlockY;
+  size_t Index;
+};
+
+/** Data shared by the threads decoding the blocks missing from the tile cache */
+struct CachedReadStruct
+{
+  std::vector<GDALDataset*>                       Datasets;
+  std::vector<MissingBlock>                       Missing;
+  std::vector<otb::GDALTileCache::BlockPointerType> * Blocks;
+  std::vector<std::string>                        Errors;
+  unsigned int                                    OverviewLevel;
+  size_t                                          BlockBytes;
+};
+
+ITK_THREAD_RETURN_TYPE CachedReadThreaderCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  CachedReadStruct * str = static_cast<CachedReadStruct *>(info->UserData);
+
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType nbThreads = info->NumberOfThreads;
+  GDALDataset * dataset = str->Datasets[threadId];
+
+  for (size_t i = threadId; i < str->Missing.size(); i += nbThreads)
+    {
+    const MissingBlock & missing = str->Missing[i];
+
+    GDALRasterBand * band = dataset->GetRasterBand(missing.Band);
+    if (band != ITK_NULLPTR && str->OverviewLevel > 0)
+      {
+      band = band->GetOverview(str->OverviewLevel - 1);
+      }
+
+    boost::shared_ptr<otb::GDALTileCache::BlockType> block(new otb::GDALTileCache::BlockType(str->BlockBytes));
+    if (band == ITK_NULLPTR || band->ReadBlock(missing.BlockX, missing.BlockY, &(*block)[0]) == CE_Failure)
+      {
+      // GDAL error messages are thread local
+      str->Errors[threadId] = CPLGetLastErrorMsg();
+      break;
+      }
+
+    // Each block is written by a single thread
+    (*str->Blocks)[missing.Index] = block;
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+} // end of anonymous namespace
+
 namespace otb
 {
 
@@ -164,6 +294,9 @@ GDALImageIO::GDALImageIO()
   m_ResolutionFactor = 0;
   m_BytePerPixel = 0;
   m_WriteRPCTags = false;
+  m_NumberOfReadThreads = 1;
+  m_TotalReadTime = 0.;
+  m_NumberOfReads = 0;
 }
 
 GDALImageIO::~GDALImageIO()
@@ -181,6 +314,7 @@ bool GDALImageIO::CanReadFile(const char* file)
     return false;
     }
   m_Dataset = GDALDriverManagerWrapper::GetInstance().Open(file);
+  m_ReadDatasets.clear();
   return m_Dataset.IsNotNull();
 }
 
@@ -191,6 +325,8 @@ void GDALImageIO::PrintSelf(std::ostream& os, itk::Indent indent) const
   os << indent << "Compression Level : " << m_CompressionLevel << "\n";
   os << indent << "IsComplex (otb side) : " << m_IsComplex << "\n";
   os << indent << "Byte per pixel : " << m_BytePerPixel << "\n";
+  os << indent << "Number of read threads : " << m_NumberOfReadThreads << "\n";
+  os << indent << "Total read time : " << m_TotalReadTime << " s (" << m_NumberOfReads << " reads)\n";
 }
 
 // Read a 3D image (or event more bands)... not implemented yet
@@ -410,22 +546,54 @@ void GDALImageIO::Read(void* buffer)
 
     itk::TimeProbe chrono;
     chrono.Start();
-    CPLErr lCrGdal = m_Dataset->GetDataSet()->RasterIO(GF_Read,
-                                                       lFirstColumn,
-                                                       lFirstLine,
-                                                       lNbColumns,
-                                                       lNbLines,
-                                                       p,
-                                                       lNbColumnsRegion,
-                                                       lNbLinesRegion,
-                                                       m_PxType->pixType,
-                                                       nbBands,
-                                                       // We want to read all bands
-                                                       ITK_NULLPTR,
-                                                       pixelOffset,
-                                                       lineOffset,
-                                                       bandOffset);
+    CPLErr lCrGdal = CE_None;
+    if (this->CachedRasterIO(lFirstColumnRegion,
+                             lFirstLineRegion,
+                             lNbColumnsRegion,
+                             lNbLinesRegion,
+                             p,
+                             nbBands,
+                             pixelOffset,
+                             lineOffset,
+                             bandOffset))
+      {
+      otbMsgDevMacro(<< "Region read through the tile cache");
+      }
+    // The parallel read is only done at full resolution, so that the
+    // result does not depend on the way the region is split
+    else if (m_NumberOfReadThreads != 1 && m_ResolutionFactor == 0)
+      {
+      this->ParallelRasterIO(lFirstColumn,
+                             lFirstLine,
+                             lNbColumns,
+                             lNbLines,
+                             p,
+                             nbBands,
+                             pixelOffset,
+                             lineOffset,
+                             bandOffset);
+      }
+    else
+      {
+      lCrGdal = m_Dataset->GetDataSet()->RasterIO(GF_Read,
+                                                  lFirstColumn,
+                                                  lFirstLine,
+                                                  lNbColumns,
+                                                  lNbLines,
+                                                  p,
+                                                  lNbColumnsRegion,
+                                                  lNbLinesRegion,
+                                                  m_PxType->pixType,
+                                                  nbBands,
+                                                  // We want to read all bands
+                                                  ITK_NULLPTR,
+                                                  pixelOffset,
+                                                  lineOffset,
+                                                  bandOffset);
+      }
     chrono.Stop();
+    m_TotalReadTime += chrono.GetTotal();
+    ++m_NumberOfReads;
     otbMsgDevMacro(<< "RasterIO Read took " << chrono.GetTotal() << " sec")
 
     // Check if gdal call succeed
@@ -439,6 +607,301 @@ void GDALImageIO::Read(void* buffer)
     }
 }
 
+void GDALImageIO::ParallelRasterIO(int firstColumn, int firstLine, int nbColumns, int nbLines,
+                                   unsigned char * buffer, int nbBands,
+                                   int pixelOffset, int lineOffset, int bandOffset)
+{
+  GDALDataset* dataset = m_Dataset->GetDataSet();
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(m_NumberOfReadThreads);
+  unsigned int nbThreads = threader->GetNumberOfThreads();
+
+  // Get the block grid intersecting the region
+  int blockSizeX = 0;
+  int blockSizeY = 0;
+  dataset->GetRasterBand(1)->GetBlockSize(&blockSizeX, &blockSizeY);
+  if (blockSizeX <= 0 || blockSizeY <= 0)
+    {
+    blockSizeX = nbColumns;
+    blockSizeY = 1;
+    }
+
+  const int firstBlockRow = firstLine / blockSizeY;
+  const int lastBlockRow  = (firstLine + nbLines - 1) / blockSizeY;
+  const int firstBlockCol = firstColumn / blockSizeX;
+  const int lastBlockCol  = (firstColumn + nbColumns - 1) / blockSizeX;
+  const int nbBlockRows   = lastBlockRow - firstBlockRow + 1;
+  const int nbBlockCols   = lastBlockCol - firstBlockCol + 1;
+
+  // Group block rows (stripped files often have very small blocks) so
+  // that each thread gets a few chunks, and only split along block
+  // columns when there are not enough block rows to feed all threads
+  const int targetNbChunks = 4 * static_cast<int>(nbThreads);
+  const int blockRowsPerChunk = std::max(1, nbBlockRows / targetNbChunks);
+  const int nbRowChunks = (nbBlockRows + blockRowsPerChunk - 1) / blockRowsPerChunk;
+  int blockColsPerChunk = nbBlockCols;
+  if (nbRowChunks < static_cast<int>(nbThreads))
+    {
+    const int nbColChunks = std::min(nbBlockCols, (targetNbChunks + nbRowChunks - 1) / nbRowChunks);
+    blockColsPerChunk = (nbBlockCols + nbColChunks - 1) / nbColChunks;
+    }
+
+  ParallelReadStruct str;
+  for (int blockRow = firstBlockRow; blockRow <= lastBlockRow; blockRow += blockRowsPerChunk)
+    {
+    const int y0 = std::max(firstLine, blockRow * blockSizeY);
+    const int y1 = std::min(firstLine + nbLines, (blockRow + blockRowsPerChunk) * blockSizeY);
+    for (int blockCol = firstBlockCol; blockCol <= lastBlockCol; blockCol += blockColsPerChunk)
+      {
+      const int x0 = std::max(firstColumn, blockCol * blockSizeX);
+      const int x1 = std::min(firstColumn + nbColumns, (blockCol + blockColsPerChunk) * blockSizeX);
+      ReadChunk chunk;
+      chunk.x = x0;
+      chunk.y = y0;
+      chunk.width = x1 - x0;
+      chunk.height = y1 - y0;
+      str.Chunks.push_back(chunk);
+      }
+    }
+  if (str.Chunks.empty())
+    {
+    return;
+    }
+  nbThreads = this->GetReadDatasets(std::min(nbThreads, static_cast<unsigned int>(str.Chunks.size())),
+                                     str.Datasets);
+  str.Errors.resize(nbThreads);
+  str.Buffer = buffer;
+  str.FirstColumn = firstColumn;
+  str.FirstLine = firstLine;
+  str.PixelType = m_PxType->pixType;
+  str.NbBands = nbBands;
+  str.PixelOffset = pixelOffset;
+  str.LineOffset = lineOffset;
+  str.BandOffset = bandOffset;
+
+  otbMsgDevMacro(<< "Parallel RasterIO : " << str.Chunks.size() << " chunks read by "
+                 << nbThreads << " threads (block size " << blockSizeX << " x " << blockSizeY << ")");
+
+  threader->SetNumberOfThreads(nbThreads);
+  threader->SetSingleMethod(ParallelReadThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for (unsigned int i = 0; i < nbThreads; ++i)
+    {
+    if (!str.Errors[i].empty())
+      {
+      itkExceptionMacro(<< "Error while reading image (GDAL format) '"
+        << m_FileName.c_str() << "' : " << str.Errors[i]);
+      }
+    }
+}
+
+unsigned int GDALImageIO::GetReadDatasets(unsigned int nbThreads, std::vector<GDALDataset*> & datasets)
+{
+  GDALDataset* dataset = m_Dataset->GetDataSet();
+
+  // Each additional thread needs its own handle on the file. They are
+  // kept for the next reads.
+  const std::string datasetName = dataset->GetDescription();
+  while (m_ReadDatasets.size() + 1 < nbThreads)
+    {
+    GDALDatasetWrapperPointer readDataset = GDALDriverManagerWrapper::GetInstance().Open(datasetName);
+    if (readDataset.IsNull())
+      {
+      otbMsgDevMacro(<< "Unable to open another handle on " << datasetName << ", reading with fewer threads");
+      nbThreads = static_cast<unsigned int>(m_ReadDatasets.size()) + 1;
+      break;
+      }
+    m_ReadDatasets.push_back(readDataset);
+    }
+
+  datasets.clear();
+  datasets.push_back(dataset);
+  for (unsigned int i = 0; i + 1 < nbThreads; ++i)
+    {
+    datasets.push_back(m_ReadDatasets[i]->GetDataSet());
+    }
+  return nbThreads;
+}
+
+bool GDALImageIO::CachedRasterIO(int firstColumn, int firstLine, int nbColumns, int nbLines,
+                                 unsigned char * buffer, int nbBands,
+                                 int pixelOffset, int lineOffset, int bandOffset)
+{
+  GDALTileCache & cache = GDALTileCache::GetInstance();
+  if (!cache.IsEnabled())
+    {
+    return false;
+    }
+
+  GDALDataset* dataset = m_Dataset->GetDataSet();
+
+  // Check the bands at the requested overview level. Blocks are copied
+  // as is, so the bands must have the type and block size of the
+  // buffer, and the overview must have the expected size.
+  int blockSizeX = 0;
+  int blockSizeY = 0;
+  for (int b = 1; b <= nbBands; ++b)
+    {
+    GDALRasterBand* band = dataset->GetRasterBand(b);
+    if (m_ResolutionFactor > 0)
+      {
+      if (band->GetOverviewCount() < static_cast<int>(m_ResolutionFactor))
+        {
+        return false;
+        }
+      band = band->GetOverview(m_ResolutionFactor - 1);
+      if (band == ITK_NULLPTR
+          || band->GetXSize() != static_cast<int>(m_Dimensions[0])
+          || band->GetYSize() != static_cast<int>(m_Dimensions[1]))
+        {
+        return false;
+        }
+      }
+    if (band->GetRasterDataType() != m_PxType->pixType)
+      {
+      return false;
+      }
+
+    int bandBlockSizeX = 0;
+    int bandBlockSizeY = 0;
+    band->GetBlockSize(&bandBlockSizeX, &bandBlockSizeY);
+    if (b == 1)
+      {
+      blockSizeX = bandBlockSizeX;
+      blockSizeY = bandBlockSizeY;
+      }
+    if (bandBlockSizeX <= 0 || bandBlockSizeY <= 0
+        || bandBlockSizeX != blockSizeX || bandBlockSizeY != blockSizeY)
+      {
+      return false;
+      }
+    }
+
+  const int elementSize = GDALGetDataTypeSize(m_PxType->pixType) / 8;
+  const size_t blockBytes = static_cast<size_t>(blockSizeX) * blockSizeY * elementSize;
+
+  const int firstBlockRow = firstLine / blockSizeY;
+  const int lastBlockRow  = (firstLine + nbLines - 1) / blockSizeY;
+  const int firstBlockCol = firstColumn / blockSizeX;
+  const int lastBlockCol  = (firstColumn + nbColumns - 1) / blockSizeX;
+
+  GDALTileCache::KeyType key;
+  key.FileName = dataset->GetDescription();
+  key.OverviewLevel = m_ResolutionFactor;
+
+  // Get the blocks of the region from the cache, and list the missing ones
+  std::vector<GDALTileCache::BlockPointerType> blocks;
+  CachedReadStruct str;
+  for (int b = 0; b < nbBands; ++b)
+    {
+    key.Band = b + 1;
+    for (int blockRow = firstBlockRow; blockRow <= lastBlockRow; ++blockRow)
+      {
+      for (int blockCol = firstBlockCol; blockCol <= lastBlockCol; ++blockCol)
+        {
+        key.BlockX = blockCol;
+        key.BlockY = blockRow;
+        blocks.push_back(cache.Get(key));
+        if (!blocks.back())
+          {
+          MissingBlock missing;
+          missing.Band = key.Band;
+          missing.BlockX = blockCol;
+          missing.BlockY = blockRow;
+          missing.Index = blocks.size() - 1;
+          str.Missing.push_back(missing);
+          }
+        }
+      }
+    }
+
+  // Decode the missing blocks with the read threads, each of them using
+  // its own dataset handle, and insert them in the cache
+  if (!str.Missing.empty())
+    {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(m_NumberOfReadThreads);
+    unsigned int nbThreads = std::min(static_cast<unsigned int>(threader->GetNumberOfThreads()),
+                                      static_cast<unsigned int>(str.Missing.size()));
+    nbThreads = this->GetReadDatasets(nbThreads, str.Datasets);
+
+    str.Blocks = &blocks;
+    str.Errors.resize(nbThreads);
+    str.OverviewLevel = m_ResolutionFactor;
+    str.BlockBytes = blockBytes;
+
+    otbMsgDevMacro(<< "Cached RasterIO : " << str.Missing.size() << " of " << blocks.size()
+                   << " blocks decoded by " << nbThreads << " threads");
+
+    threader->SetNumberOfThreads(nbThreads);
+    threader->SetSingleMethod(CachedReadThreaderCallback, &str);
+    threader->SingleMethodExecute();
+
+    for (unsigned int i = 0; i < nbThreads; ++i)
+      {
+      if (!str.Errors[i].empty())
+        {
+        itkExceptionMacro(<< "Error while reading image (GDAL format) '"
+          << m_FileName.c_str() << "' : " << str.Errors[i]);
+        }
+      }
+
+    for (std::vector<MissingBlock>::const_iterator it = str.Missing.begin(); it != str.Missing.end(); ++it)
+      {
+      key.Band = it->Band;
+      key.BlockX = it->BlockX;
+      key.BlockY = it->BlockY;
+      cache.Insert(key, blocks[it->Index]);
+      }
+    }
+
+  // Copy the parts of the blocks inside the region
+  std::vector<GDALTileCache::BlockPointerType>::const_iterator blockIt = blocks.begin();
+  for (int b = 0; b < nbBands; ++b)
+    {
+    for (int blockRow = firstBlockRow; blockRow <= lastBlockRow; ++blockRow)
+      {
+      for (int blockCol = firstBlockCol; blockCol <= lastBlockCol; ++blockCol, ++blockIt)
+        {
+        const GDALTileCache::BlockPointerType & block = *blockIt;
+
+        // Copy the part of the block inside the region
+        const int x0 = std::max(firstColumn, blockCol * blockSizeX);
+        const int x1 = std::min(firstColumn + nbColumns, (blockCol + 1) * blockSizeX);
+        const int y0 = std::max(firstLine, blockRow * blockSizeY);
+        const int y1 = std::min(firstLine + nbLines, (blockRow + 1) * blockSizeY);
+
+        for (int y = y0; y < y1; ++y)
+          {
+          const unsigned char * in = &(*block)[0]
+            + (static_cast<std::ptrdiff_t>(y - blockRow * blockSizeY) * blockSizeX
+               + (x0 - blockCol * blockSizeX)) * elementSize;
+          unsigned char * out = buffer
+            + static_cast<std::ptrdiff_t>(y - firstLine) * lineOffset
+            + static_cast<std::ptrdiff_t>(x0 - firstColumn) * pixelOffset
+            + static_cast<std::ptrdiff_t>(b) * bandOffset;
+
+          if (pixelOffset == elementSize)
+            {
+            memcpy(out, in, static_cast<size_t>(x1 - x0) * elementSize);
+            }
+          else
+            {
+            for (int x = x0; x < x1; ++x, in += elementSize, out += pixelOffset)
+              {
+              memcpy(out, in, elementSize);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  return true;
+}
+
 bool GDALImageIO::GetSubDatasetInfo(std::vector<std::string> &names, std::vector<std::string> &desc)
 {
   // Note: we assume that the subdatasets are in order : SUBDATASET_ID_NAME, SUBDATASET_ID_DESC, SUBDATASET_ID+1_NAME, SUBDATASET_ID+1_DESC
@@ -589,6 +1052,14 @@ void GDALImageIO::InternalReadImageInformation()
                                     MetaDataKey::SubDatasetIndex,
                                     m_DatasetNumber);
 
+  unsigned int nbReadThreads = m_NumberOfReadThreads;
+  itk::ExposeMetaData<unsigned int>(this->GetMetaDataDictionary(),
+                                    MetaDataKey::NumberOfReadThreads,
+                                    nbReadThreads);
+  this->SetNumberOfReadThreads(nbReadThreads);
+
+  m_ReadDatasets.clear();
+
   // Detecting if we are in the case of an image with subdatasets
   // example: hdf Modis data
   // in this situation, we are going to change the filename to the
@@ -1434,6 +1905,8 @@ void GDALImageIO::Write(const void* buffer)
       itkExceptionMacro(<< "Unable to instantiate driver " << gdalDriverShortName << " to write " << m_FileName);
       }
 
+    GDALTileCache::GetInstance().Remove(realFileName);
+
     GDALCreationOptionsType creationOptions = m_CreationOptions;
     GDALDataset* hOutputDS = driver->CreateCopy( realFileName.c_str(), m_Dataset->GetDataSet(), FALSE,
                                                  otb::ogr::StringListConverter(creationOptions).to_ogr(),
@@ -1633,6 +2106,9 @@ void GDALImageIO::InternalWriteImageInformation(const void* buffer)
         }
       }
 */
+    // Blocks of a previous version of the file must not be read again
+    GDALTileCache::GetInstance().Remove(GetGdalWriteImageFileName(driverShortName, m_FileName));
+
     m_Dataset = GDALDriverManagerWrapper::GetInstance().Create(
                      driverShortName,
                      GetGdalWriteImageFileName(driverShortName, m_FileName),
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALTileCache.h"
+
+#include "itkMutexLockHolder.h"
+#include "otbConfigurationManager.h"
+
+namespace otb
+{
+
+typedef itk::MutexLockHolder<itk::SimpleFastMutexLock> LockHolderType;
+
+bool
+GDALTileCache::KeyType::operator<(const KeyType & other) const
+{
+  if (FileName != other.FileName)
+    {
+    return FileName < other.FileName;
+    }
+  if (OverviewLevel != other.OverviewLevel)
+    {
+    return OverviewLevel < other.OverviewLevel;
+    }
+  if (Band != other.Band)
+    {
+    return Band < other.Band;
+    }
+  if (BlockY != other.BlockY)
+    {
+    return BlockY < other.BlockY;
+    }
+  return BlockX < other.BlockX;
+}
+
+GDALTileCache::GDALTileCache()
+  : m_Capacity(0),
+    m_Size(0),
+    m_NumberOfHits(0),
+    m_NumberOfMisses(0),
+    m_NumberOfEvictions(0)
+{
+  m_Capacity = static_cast<SizeValueType>(ConfigurationManager::GetTileCacheSize()) * 1024 * 1024;
+}
+
+GDALTileCache::~GDALTileCache()
+{
+}
+
+GDALTileCache::BlockPointerType
+GDALTileCache::Get(const KeyType & key)
+{
+  LockHolderType lock(m_Lock);
+
+  EntryMapType::iterator it = m_Index.find(key);
+  if (it == m_Index.end())
+    {
+    ++m_NumberOfMisses;
+    return BlockPointerType();
+    }
+
+  ++m_NumberOfHits;
+  // Move the entry to the front of the LRU list
+  m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+  return it->second->second;
+}
+
+void
+GDALTileCache::Insert(const KeyType & key, const BlockPointerType & block)
+{
+  if (!block)
+    {
+    return;
+    }
+
+  LockHolderType lock(m_Lock);
+
+  const SizeValueType blockSize = block->size();
+  if (blockSize > m_Capacity)
+    {
+    return;
+    }
+
+  EntryMapType::iterator it = m_Index.find(key);
+  if (it != m_Index.end())
+    {
+    // Another reader decoded the same block in the meantime
+    m_Size -= it->second->second->size();
+    m_Entries.erase(it->second);
+    m_Index.erase(it);
+    }
+
+  m_Entries.push_front(EntryType(key, block));
+  m_Index[key] = m_Entries.begin();
+  m_Size += blockSize;
+
+  this->Shrink();
+}
+
+void
+GDALTileCache::Remove(const std::string & fileName)
+{
+  LockHolderType lock(m_Lock);
+
+  EntryListType::iterator it = m_Entries.begin();
+  while (it != m_Entries.end())
+    {
+    if (it->first.FileName == fileName)
+      {
+      m_Size -= it->second->size();
+      m_Index.erase(it->first);
+      it = m_Entries.erase(it);
+      }
+    else
+      {
+      ++it;
+      }
+    }
+}
+
+void
+GDALTileCache::Clear()
+{
+  LockHolderType lock(m_Lock);
+
+  m_Entries.clear();
+  m_Index.clear();
+  m_Size = 0;
+}
+
+void
+GDALTileCache::SetCapacity(SizeValueType capacity)
+{
+  LockHolderType lock(m_Lock);
+
+  m_Capacity = capacity;
+  this->Shrink();
+}
+
+GDALTileCache::SizeValueType
+GDALTileCache::GetCapacity() const
+{
+  LockHolderType lock(m_Lock);
+  return m_Capacity;
+}
+
+bool
+GDALTileCache::IsEnabled() const
+{
+  return this->GetCapacity() > 0;
+}
+
+GDALTileCache::SizeValueType
+GDALTileCache::GetSize() const
+{
+  LockHolderType lock(m_Lock);
+  return m_Size;
+}
+
+unsigned long
+GDALTileCache::GetNumberOfBlocks() const
+{
+  LockHolderType lock(m_Lock);
+  return static_cast<unsigned long>(m_Index.size());
+}
+
+unsigned long
+GDALTileCache::GetNumberOfHits() const
+{
+  LockHolderType lock(m_Lock);
+  return m_NumberOfHits;
+}
+
+unsigned long
+GDALTileCache::GetNumberOfMisses() const
+{
+  LockHolderType lock(m_Lock);
+  return m_NumberOfMisses;
+}
+
+unsigned long
+GDALTileCache::GetNumberOfEvictions() const
+{
+  LockHolderType lock(m_Lock);
+  return m_NumberOfEvictions;
+}
+
+void
+GDALTileCache::ResetStatistics()
+{
+  LockHolderType lock(m_Lock);
+
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+  m_NumberOfEvictions = 0;
+}
+
+void
+GDALTileCache::Shrink()
+{
+  while (m_Size > m_Capacity && !m_Entries.empty())
+    {
+    const EntryType & last = m_Entries.back();
+    m_Size -= last.second->size();
+    m_Index.erase(last.first);
+    m_Entries.pop_back();
+    ++m_NumberOfEvictions;
+    }
+}
+
+} // end namespace otb
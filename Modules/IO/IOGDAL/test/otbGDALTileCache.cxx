@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include <iostream>
+
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbGDALTileCache.h"
+
+int otbGDALTileCache(int itkNotUsed(argc), char* argv[])
+{
+  const char * inputFilename  = argv[1];
+  const char * outputFilename = argv[2];
+
+  typedef otb::VectorImage<unsigned char, 2>  ImageType;
+  typedef otb::ImageFileReader<ImageType>     ReaderType;
+  typedef otb::ImageFileWriter<ImageType>     WriterType;
+
+  otb::GDALTileCache & cache = otb::GDALTileCache::GetInstance();
+  cache.SetCapacity(64 * 1024 * 1024);
+  cache.Clear();
+  cache.ResetStatistics();
+
+  // The first reader fills the cache
+  ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName(inputFilename);
+  reader1->Update();
+
+  const unsigned long misses = cache.GetNumberOfMisses();
+  std::cout << "First read: " << cache.GetNumberOfBlocks() << " blocks ("
+            << cache.GetSize() << " bytes), " << misses << " misses" << std::endl;
+
+  if (misses == 0 || cache.GetNumberOfHits() != 0)
+    {
+    std::cerr << "The first read should only miss the cache" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The second reader only uses cached blocks
+  ReaderType::Pointer reader2 = ReaderType::New();
+  reader2->SetFileName(inputFilename);
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(outputFilename);
+  writer->SetInput(reader2->GetOutput());
+  writer->Update();
+
+  std::cout << "Second read: " << cache.GetNumberOfHits() << " hits, "
+            << cache.GetNumberOfMisses() << " misses" << std::endl;
+
+  if (cache.GetNumberOfMisses() != misses || cache.GetNumberOfHits() == 0)
+    {
+    std::cerr << "The second read should only hit the cache" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Shrinking the cache evicts blocks
+  cache.SetCapacity(0);
+  if (cache.GetNumberOfBlocks() != 0 || cache.GetSize() != 0)
+    {
+    std::cerr << "The cache should be empty" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -39,6 +39,7 @@
 #include "otbMetaDataKey.h"
 
 #include "otbMacro.h"
+#include "otbPipelineProfiler.h"
 
 
 namespace otb
@@ -179,6 +180,11 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
 
   this->m_ImageIO->SetIORegion(ioRegion);
 
+  PipelineProfiler::GetInstance().AddBytesRead(
+    this,
+    static_cast<PipelineProfiler::SizeValueType>(ioRegion.GetNumberOfPixels())
+    * this->m_ImageIO->GetComponentSize() * this->m_ImageIO->GetNumberOfComponents());
+
   typedef otb::DefaultConvertPixelTraits<typename TOutputImage::IOPixelType> ConvertIOPixelTraits;
   typedef otb::DefaultConvertPixelTraits<typename TOutputImage::PixelType>   ConvertOutputPixelTraits;
 
@@ -310,6 +316,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
     itk::EncapsulateMetaData<unsigned int>(dict, MetaDataKey::ResolutionFactor, m_AdditionalNumber);
     }
 
+  // Pass the number of threads used to decode the file
+  if (m_FilenameHelper->NumberOfReadThreadsIsSet())
+    {
+    itk::EncapsulateMetaData<unsigned int>(dict, MetaDataKey::NumberOfReadThreads, m_FilenameHelper->GetNumberOfReadThreads());
+    }
+
   // Got to allocate space for the image. Determine the characteristics of
   // the image.
   //
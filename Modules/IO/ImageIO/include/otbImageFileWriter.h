@@ -46,6 +46,15 @@ namespace otb
  * ImageFileWriter will write directly the streaming buffer in the image file, so
  * that the output image never needs to be completely allocated
  *
+ * When PipelinedStreaming is enabled (or through the
+ * &streaming:pipelined=on extended filename option), each computed
+ * stream split is copied into one of two internal buffers and handed
+ * to a dedicated writing thread, so that the upstream pipeline already
+ * computes the next split while the previous one is being encoded and
+ * written by the ImageIO. This costs up to two additional stream
+ * buffers of memory, which are not accounted for by the streaming
+ * manager.
+ *
  * ImageFileWriter supports extended filenames, which allow controlling
  * some properties of the output file. See
  * http://wiki.orfeo-toolbox.org/index.php/ExtendedFileName for more
@@ -159,6 +168,15 @@ public:
    *   is set from the CMake configuration option */
   void SetAutomaticAdaptativeStreaming(unsigned int availableRAM = 0, double bias = 1.0);
 
+  /**  Set the streaming mode to 'overlap' and configure the number of MB
+   *   available. The actual number of divisions is computed automatically
+   *   by estimating the memory consumption of the pipeline.
+   *   The tile shape accounts for the neighbourhood padding requested
+   *   by the pipeline, and tiles are processed along a Hilbert curve.
+   *   Setting the availableRAM parameter to 0 means that the available RAM
+   *   is set from the CMake configuration option */
+  void SetAutomaticOverlapAwareStreaming(unsigned int availableRAM = 0, double bias = 1.0);
+
   /** Set the only input of the writer */
   using Superclass::SetInput;
   virtual void SetInput(const InputImageType *input);
@@ -195,6 +213,13 @@ public:
   itkGetConstReferenceMacro(UseInputMetaDataDictionary, bool);
   itkBooleanMacro(UseInputMetaDataDictionary);
 
+  /** Set the pipelined streaming mode On or Off. In pipelined mode, the
+   *  writing of a stream split is done in a separate thread while the
+   *  next split is being computed. */
+  itkSetMacro(PipelinedStreaming, bool);
+  itkGetConstReferenceMacro(PipelinedStreaming, bool);
+  itkBooleanMacro(PipelinedStreaming);
+
   itkSetObjectMacro(ImageIO, otb::ImageIOBase);
   itkGetObjectMacro(ImageIO, otb::ImageIOBase);
   itkGetConstObjectMacro(ImageIO, otb::ImageIOBase);
@@ -207,6 +232,17 @@ protected:
   /** Does the real work. */
   void GenerateData(void) ITK_OVERRIDE;
 
+  /** Write the buffer of the given image to the current IORegion of
+   *  the ImageIO. This is called from the writing thread when
+   *  pipelined streaming is enabled. */
+  virtual void WriteImageBuffer(const InputImageType * input);
+
+  /** Copy the current stream region of the input into the given
+   *  buffer, (re)allocating it if needed. */
+  void CopyStreamBuffer(const InputImageType * input,
+                        const InputImageRegionType & streamRegion,
+                        InputImagePointer & buffer) const;
+
 private:
   ImageFileWriter(const ImageFileWriter &); //purposely not implemented
   void operator =(const ImageFileWriter&); //purposely not implemented
@@ -247,6 +283,7 @@ private:
   bool               m_UserSpecifiedIORegion; // track whether the region is user specified
   bool m_FactorySpecifiedImageIO; //track whether the factory mechanism set the ImageIO
   bool m_UseCompression;
+  bool m_PipelinedStreaming;
   bool m_UseInputMetaDataDictionary; // whether to use the
                                      // MetaDataDictionary from the
                                      // input or not.
@@ -36,6 +36,7 @@
 #include "otbMetaDataKey.h"
 
 #include "otbConfigure.h"
+#include "otbPipelineProfiler.h"
 
 #include "otbNumberOfDivisionsStrippedStreamingManager.h"
 #include "otbNumberOfDivisionsTiledStreamingManager.h"
@@ -44,11 +45,14 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbRAMDrivenOverlapAwareStreamingManager.h"
 
 #include "otb_boost_tokenizer_header.h"
 
 #include "otbStringUtils.h"
 
+#include <future>
+
 namespace otb
 {
 
@@ -65,6 +69,7 @@ ImageFileWriter<TInputImage>
     m_UserSpecifiedIORegion(false),
     m_FactorySpecifiedImageIO(false),
     m_UseCompression(false),
+    m_PipelinedStreaming(false),
     m_UseInputMetaDataDictionary(false),
     m_WriteGeomFile(false),
     m_FilenameHelper(),
@@ -176,6 +181,18 @@ ImageFileWriter<TInputImage>
   m_StreamingManager = streamingManager;
 }
 
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::SetAutomaticOverlapAwareStreaming(unsigned int availableRAM, double bias)
+{
+  typedef RAMDrivenOverlapAwareStreamingManager<TInputImage> RAMDrivenOverlapAwareStreamingManagerType;
+  typename RAMDrivenOverlapAwareStreamingManagerType::Pointer streamingManager = RAMDrivenOverlapAwareStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  m_StreamingManager = streamingManager;
+}
+
 #ifndef ITK_LEGACY_REMOVE
 
 #endif // ITK_LEGACY_REMOVE
@@ -213,6 +230,15 @@ ImageFileWriter<TInputImage>
     os << indent << "Compression: Off\n";
     }
 
+  if (m_PipelinedStreaming)
+    {
+    os << indent << "PipelinedStreaming: On\n";
+    }
+  else
+    {
+    os << indent << "PipelinedStreaming: Off\n";
+    }
+
   if (m_UseInputMetaDataDictionary)
     {
     os << indent << "UseInputMetaDataDictionary: On\n";
@@ -375,6 +401,14 @@ ImageFileWriter<TInputImage>
         this->SetNumberOfLinesStrippedStreaming(static_cast<unsigned int>(sizevalue));
         }
 
+      }
+    else if(type == "overlap")
+      {
+      if(sizemode != "auto")
+        {
+        itkWarningMacro(<<"In overlap streaming type, the sizemode option will be ignored.");
+        }
+      this->SetAutomaticOverlapAwareStreaming(sizevalue);
       }
     else if (type == "none")
       {
@@ -393,6 +427,11 @@ ImageFileWriter<TInputImage>
       }
     }
 
+  if(m_FilenameHelper->StreamingPipelinedIsSet())
+    {
+    this->SetPipelinedStreaming(m_FilenameHelper->GetStreamingPipelined());
+    }
+
   this->SetAbortGenerateData(0);
   this->SetProgress(0.0);
 
@@ -611,12 +650,32 @@ ImageFileWriter<TInputImage>
     itkWarningMacro(<< "Could not get the source process object. Progress report might be buggy");
     }
 
+  // Stream splits are reported to the profiler
+  PipelineProfiler & profiler = PipelineProfiler::GetInstance();
+
+  // Pipelined streaming only makes sense if there is something to overlap
+  const bool pipelined = m_PipelinedStreaming && m_NumberOfDivisions > 1;
+
+  // In pipelined mode, split N is written from one of these buffers
+  // by an asynchronous task while split N+1 is computed. Since the
+  // writing of split N-1 is always completed before the writing of
+  // split N starts, two buffers are enough. Note that the future is
+  // declared after the buffers: if an exception is thrown, its
+  // destructor waits for the pending write before they are released.
+  InputImagePointer streamBuffers[2];
+  std::future<void> pendingWrite;
+
   for (m_CurrentDivision = 0;
        m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
        m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
     {
     streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
 
+    if (profiler.IsEnabled())
+      {
+      profiler.SetCurrentSplit(m_CurrentDivision);
+      }
+
     inputPtr->SetRequestedRegion(streamRegion);
     inputPtr->PropagateRequestedRegion();
     inputPtr->UpdateOutputData();
@@ -630,11 +689,49 @@ ImageFileWriter<TInputImage>
       //Set the ioRegion index using the shifted index ( (0,0 without box parameter))
       ioRegion.SetIndex(i, streamRegion.GetIndex(i) - m_ShiftOutputIndex[i]);
       }
+
+    if (!pipelined)
+      {
+      this->SetIORegion(ioRegion);
+      m_ImageIO->SetIORegion(m_IORegion);
+
+      // Start writing stream region in the image file
+      this->GenerateData();
+      continue;
+      }
+
+    // Detach the computed split from the pipeline buffer, which will
+    // be overwritten by the next split
+    InputImagePointer & buffer = streamBuffers[m_CurrentDivision % 2];
+    this->CopyStreamBuffer(inputPtr, streamRegion, buffer);
+
+    // Wait for the previous split to be written: the ImageIO is not
+    // reentrant, and its IORegion must not change during a write
+    if (pendingWrite.valid())
+      {
+      pendingWrite.get();
+      }
+
     this->SetIORegion(ioRegion);
     m_ImageIO->SetIORegion(m_IORegion);
 
-    // Start writing stream region in the image file
-    this->GenerateData();
+    // Start writing stream region in the image file, while the
+    // pipeline goes on with the next split
+    pendingWrite = std::async(std::launch::async,
+                              &Self::WriteImageBuffer,
+                              this,
+                              static_cast<const InputImageType *>(buffer.GetPointer()));
+    }
+
+  // Flush the last split (and rethrow any writing error)
+  if (pendingWrite.valid())
+    {
+    pendingWrite.get();
+    }
+
+  if (profiler.IsEnabled())
+    {
+    profiler.SetCurrentSplit(-1);
     }
 
   /**
@@ -684,7 +781,46 @@ void
 ImageFileWriter<TInputImage>
 ::GenerateData(void)
 {
-  const InputImageType * input = this->GetInput();
+  this->WriteImageBuffer(this->GetInput());
+}
+
+template<class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::CopyStreamBuffer(const InputImageType * input,
+                   const InputImageRegionType & streamRegion,
+                   InputImagePointer & buffer) const
+{
+  if (buffer.IsNull())
+    {
+    buffer = InputImageType::New();
+    }
+
+  buffer->CopyInformation(input);
+  if (buffer->GetBufferedRegion() != streamRegion)
+    {
+    buffer->SetBufferedRegion(streamRegion);
+    buffer->Allocate();
+    }
+  buffer->SetRequestedRegion(streamRegion);
+
+  typedef itk::ImageRegionConstIterator<TInputImage> ConstIteratorType;
+  typedef itk::ImageRegionIterator<TInputImage>      IteratorType;
+
+  ConstIteratorType in(input, streamRegion);
+  IteratorType out(buffer, streamRegion);
+
+  for (in.GoToBegin(), out.GoToBegin(); !in.IsAtEnd(); ++in, ++out)
+    {
+    out.Set(in.Get());
+    }
+}
+
+template<class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::WriteImageBuffer(const InputImageType * input)
+{
   InputImagePointer cacheImage;
 
   // Make sure that the image is the right type and no more than
@@ -803,6 +939,11 @@ ImageFileWriter<TInputImage>
 
   m_ImageIO->Write(dataPtr);
 
+  PipelineProfiler::GetInstance().AddBytesWritten(
+    this,
+    static_cast<PipelineProfiler::SizeValueType>(m_ImageIO->GetIORegion().GetNumberOfPixels())
+    * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+
   if (m_WriteGeomFile  || m_FilenameHelper->GetWriteGEOMFile())
     {
     ImageKeywordlist otb_kwl;
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbDenseSampleStore_h
+#define otbDenseSampleStore_h
+
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace otb
+{
+
+/** \class DenseSampleStore
+ * \brief Contiguous storage of training samples and their labels.
+ *
+ * The features of the samples are stored in a single row-major matrix
+ * of TInputValue, one row per sample, and the labels in a vector of
+ * TTargetValue. Compared to an itk::Statistics::ListSample of
+ * VariableLengthVector, there is no allocation per sample, and models
+ * can use the matrix without copying it (see
+ * MachineLearningModel::SetTrainingSampleStore()).
+ *
+ * Readers fill the store with PushBack(), or with AddSample() which
+ * returns the row of the new sample.
+ *
+ * \sa MachineLearningModel
+ *
+ * \ingroup OTBLearningBase
+ */
+template <class TInputValue, class TTargetValue>
+class ITK_EXPORT DenseSampleStore
+  : public itk::Object
+{
+public:
+  /**\name Standard ITK typedefs */
+  //@{
+  typedef DenseSampleStore              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+  //@}
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DenseSampleStore, itk::Object);
+
+  typedef TInputValue                  InputValueType;
+  typedef TTargetValue                 TargetValueType;
+  typedef std::vector<InputValueType>  DataType;
+  typedef std::vector<TargetValueType> LabelsType;
+
+  /** Set the number of features of the samples. This clears the store. */
+  void SetNumberOfFeatures(unsigned int nbFeatures);
+  itkGetConstMacro(NumberOfFeatures, unsigned int);
+
+  /** Number of samples */
+  unsigned long Size() const
+  {
+    return m_Labels.size();
+  }
+
+  /** Reserve the memory of nbSamples samples */
+  void Reserve(unsigned long nbSamples);
+
+  /** Remove all the samples */
+  void Clear();
+
+  /** Add a sample, copying its NumberOfFeatures features */
+  void PushBack(const InputValueType * sample, TargetValueType label);
+
+  /** Add a sample whose features are set to zero, and return its row */
+  InputValueType * AddSample(TargetValueType label);
+
+  /** Features of a sample */
+  const InputValueType * GetSample(unsigned long id) const
+  {
+    return &m_Data[id * m_NumberOfFeatures];
+  }
+  InputValueType * GetSample(unsigned long id)
+  {
+    return &m_Data[id * m_NumberOfFeatures];
+  }
+
+  /** Label of a sample */
+  TargetValueType GetLabel(unsigned long id) const
+  {
+    return m_Labels[id];
+  }
+  void SetLabel(unsigned long id, TargetValueType label)
+  {
+    m_Labels[id] = label;
+  }
+
+  /** Row-major matrix of the features, of Size() rows */
+  const DataType & GetData() const
+  {
+    return m_Data;
+  }
+
+  /** Labels of the samples */
+  const LabelsType & GetLabels() const
+  {
+    return m_Labels;
+  }
+
+  /** Center and reduce the features in place: each feature becomes
+   *  (value - shift) / scale, or 0 if the scale is null, as with the
+   *  ShiftScaleSampleListFilter */
+  void ShiftScale(const InputValueType * shifts, const InputValueType * scales);
+
+  /** Append the samples [start, start+size[ to a ListSample of
+   *  measurement vectors, and their labels to a ListSample of labels if
+   *  it is not null */
+  template <class TListSample, class TTargetListSample>
+  void ExportToListSamples(unsigned long start, unsigned long size,
+                           TListSample * samples, TTargetListSample * labels) const;
+
+protected:
+  DenseSampleStore();
+  ~DenseSampleStore() ITK_OVERRIDE {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+
+private:
+  DenseSampleStore(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  unsigned int m_NumberOfFeatures;
+  DataType     m_Data;
+  LabelsType   m_Labels;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbDenseSampleStore.txx"
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbDenseSampleStore_txx
+#define otbDenseSampleStore_txx
+
+#include "otbDenseSampleStore.h"
+#include "itkMacro.h"
+#include "itkNumericTraits.h"
+
+namespace otb
+{
+
+template <class TInputValue, class TTargetValue>
+DenseSampleStore<TInputValue, TTargetValue>
+::DenseSampleStore() :
+  m_NumberOfFeatures(0)
+{}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::SetNumberOfFeatures(unsigned int nbFeatures)
+{
+  this->Clear();
+  m_NumberOfFeatures = nbFeatures;
+  this->Modified();
+}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::Reserve(unsigned long nbSamples)
+{
+  m_Data.reserve(nbSamples * m_NumberOfFeatures);
+  m_Labels.reserve(nbSamples);
+}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::Clear()
+{
+  m_Data.clear();
+  m_Labels.clear();
+  this->Modified();
+}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::PushBack(const InputValueType * sample, TargetValueType label)
+{
+  m_Data.insert(m_Data.end(), sample, sample + m_NumberOfFeatures);
+  m_Labels.push_back(label);
+}
+
+template <class TInputValue, class TTargetValue>
+typename DenseSampleStore<TInputValue, TTargetValue>
+::InputValueType *
+DenseSampleStore<TInputValue, TTargetValue>
+::AddSample(TargetValueType label)
+{
+  m_Data.resize(m_Data.size() + m_NumberOfFeatures, InputValueType());
+  m_Labels.push_back(label);
+  return this->GetSample(m_Labels.size() - 1);
+}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::ShiftScale(const InputValueType * shifts, const InputValueType * scales)
+{
+  // Compute the 1/(sigma) vector
+  DataType invertedScales(m_NumberOfFeatures);
+  for (unsigned int idx = 0; idx < m_NumberOfFeatures; ++idx)
+    {
+    if (scales[idx] - 1e-10 < 0.)
+      invertedScales[idx] = 0.;
+    else
+      invertedScales[idx] = 1 / scales[idx];
+    }
+
+  for (unsigned long id = 0; id < this->Size(); ++id)
+    {
+    InputValueType * sample = this->GetSample(id);
+    for (unsigned int idx = 0; idx < m_NumberOfFeatures; ++idx)
+      {
+      sample[idx] = static_cast<InputValueType>((sample[idx] - shifts[idx]) * invertedScales[idx]);
+      }
+    }
+  this->Modified();
+}
+
+template <class TInputValue, class TTargetValue>
+template <class TListSample, class TTargetListSample>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::ExportToListSamples(unsigned long start, unsigned long size,
+                      TListSample * samples, TTargetListSample * labels) const
+{
+  if (start + size > this->Size())
+    {
+    itkExceptionMacro(<< "Requested range [" << start << ", " << start + size
+                      << "[ is out of bound for the sample store (range [0, " << this->Size() << "[)");
+    }
+
+  samples->SetMeasurementVectorSize(m_NumberOfFeatures);
+
+  typename TListSample::MeasurementVectorType sample;
+  itk::NumericTraits<typename TListSample::MeasurementVectorType>::SetLength(sample, m_NumberOfFeatures);
+
+  for (unsigned long id = start; id < start + size; ++id)
+    {
+    const InputValueType * row = this->GetSample(id);
+    for (unsigned int idx = 0; idx < m_NumberOfFeatures; ++idx)
+      {
+      sample[idx] = row[idx];
+      }
+    samples->PushBack(sample);
+
+    if (labels != ITK_NULLPTR)
+      {
+      typename TTargetListSample::MeasurementVectorType label;
+      label[0] = m_Labels[id];
+      labels->PushBack(label);
+      }
+    }
+}
+
+template <class TInputValue, class TTargetValue>
+void
+DenseSampleStore<TInputValue, TTargetValue>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfFeatures: " << m_NumberOfFeatures << std::endl;
+  os << indent << "Size: " << this->Size() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
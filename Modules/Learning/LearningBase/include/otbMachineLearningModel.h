@@ -24,6 +24,7 @@
 #include "itkObject.h"
 #include "itkListSample.h"
 #include "otbMachineLearningModelTraits.h"
+#include "otbDenseSampleStore.h"
 
 namespace otb
 {
@@ -44,6 +45,11 @@ namespace otb
  * computes its corresponding model with Train() and exports it with
  * the help of the Save() method.
  *
+ * The training samples are given either as list samples, or as a
+ * DenseSampleStore for the classifiers supporting it (see
+ * IsSampleStoreSupported()), which read the features from the store
+ * without copying them in list samples.
+ *
  * It is also possible to classify any input sample composed of several
  * features (or any number of bands in the case of a pixel extracted
  * from a multi-band image) with the help of the Predict() method which
@@ -94,6 +100,9 @@ public:
   typedef itk::Statistics::ListSample<TargetSampleType>      TargetListSampleType;
   //@}
 
+  /** Contiguous store of training samples */
+  typedef DenseSampleStore<InputValueType, TargetValueType> SampleStoreType;
+
   /**\name Confidence value typedef */
   typedef typename MLMTargetTraits<TConfidenceValue>::ValueType  ConfidenceValueType;
   typedef typename MLMTargetTraits<TConfidenceValue>::SampleType ConfidenceSampleType;
@@ -165,6 +174,18 @@ public:
   //@}
 
   itkGetObjectMacro(ConfidenceListSample,ConfidenceListSampleType);
+
+  /**\name Training sample store accessors */
+  //@{
+  /** Set the training samples and labels as a contiguous store. If the
+   *  model supports it, Train() uses the store instead of the input and
+   *  target list samples. */
+  itkSetConstObjectMacro(TrainingSampleStore,SampleStoreType);
+  itkGetConstObjectMacro(TrainingSampleStore,SampleStoreType);
+  //@}
+
+  /** Can Train() use a training sample store ? */
+  bool IsSampleStoreSupported() const {return m_IsSampleStoreSupported;}
   
   /**\name Use model in regression mode */
   //@{
@@ -182,6 +203,18 @@ protected:
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
+  /** Is the training sample store used by Train() ? */
+  bool UseTrainingSampleStore() const;
+
+  /** Number of training samples, from the store if it is used */
+  unsigned long GetNumberOfTrainingSamples() const;
+
+  /** Number of features of the training samples, from the store if it is used */
+  unsigned int GetNumberOfTrainingFeatures() const;
+
+  /** Label of a training sample, from the store if it is used */
+  TargetValueType GetTrainingLabel(unsigned long id) const;
+
   /** Input list sample */
   typename InputListSampleType::Pointer m_InputListSample;
 
@@ -189,6 +222,9 @@ protected:
   typename TargetListSampleType::Pointer m_TargetListSample;
 
   typename ConfidenceListSampleType::Pointer m_ConfidenceListSample;
+
+  /** Training sample store */
+  typename SampleStoreType::ConstPointer m_TrainingSampleStore;
   
   /** flag to choose between classification and regression modes */
   bool m_RegressionMode;
@@ -204,6 +240,10 @@ protected:
   /** Is DoPredictBatch multi-threaded ? */
   bool m_IsDoPredictBatchMultiThreaded;
 
+  /** flag that indicates if Train() can use a training sample store,
+   *  child classes should modify it in their constructor if they do */
+  bool m_IsSampleStoreSupported;
+
 private:
   /**  Actual implementation of BatchPredicition
     *  Default implementation will call DoPredict iteratively 
@@ -38,7 +38,8 @@ MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
   m_RegressionMode(false),
   m_IsRegressionSupported(false),
   m_ConfidenceIndex(false),
-  m_IsDoPredictBatchMultiThreaded(false)
+  m_IsDoPredictBatchMultiThreaded(false),
+  m_IsSampleStoreSupported(false)
 {}
 
 
@@ -63,6 +64,51 @@ MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
     }
 }
 
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+bool
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::UseTrainingSampleStore() const
+{
+  return m_IsSampleStoreSupported && m_TrainingSampleStore.IsNotNull();
+}
+
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+unsigned long
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::GetNumberOfTrainingSamples() const
+{
+  if (this->UseTrainingSampleStore())
+    {
+    return m_TrainingSampleStore->Size();
+    }
+  return m_InputListSample.IsNotNull() ? m_InputListSample->Size() : 0;
+}
+
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+unsigned int
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::GetNumberOfTrainingFeatures() const
+{
+  if (this->UseTrainingSampleStore())
+    {
+    return m_TrainingSampleStore->GetNumberOfFeatures();
+    }
+  return m_InputListSample.IsNotNull() ? m_InputListSample->GetMeasurementVectorSize() : 0;
+}
+
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+typename MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::TargetValueType
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::GetTrainingLabel(unsigned long id) const
+{
+  if (this->UseTrainingSampleStore())
+    {
+    return m_TrainingSampleStore->GetLabel(id);
+    }
+  return m_TargetListSample->GetMeasurementVector(id)[0];
+}
+
 template <class TInputValue, class TOutputValue, class TConfidenceValue>
 typename MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
 ::TargetSampleType
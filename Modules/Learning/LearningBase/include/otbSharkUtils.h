@@ -22,6 +22,7 @@
 #define otbSharkUtils_h
 
 #include "itkMacro.h"
+#include "otbDenseSampleStore.h"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -111,6 +112,51 @@ template <class T> void ListSampleRangeToSharkVector(const T * listSample, std::
     } 
 }
 
+/** Converts the samples [start, start+size[ of a DenseSampleStore to Shark vectors */
+template <class TInputValue, class TTargetValue>
+void SampleStoreRangeToSharkVector(const DenseSampleStore<TInputValue, TTargetValue> * store,
+                                   std::vector<shark::RealVector> & output, unsigned long start, unsigned long size)
+{
+  assert(store != ITK_NULLPTR);
+
+  if(start+size>store->Size())
+    {
+    itkGenericExceptionMacro(<<"Requested range ["<<start<<", "<<start+size<<"[ is out of bound for input sample store (range [0, "<<store->Size()<<"[");
+    }
+
+  output.clear();
+  output.reserve(size);
+
+  const unsigned int sampleSize = store->GetNumberOfFeatures();
+
+  for (unsigned long sampleIdx = start; sampleIdx < start+size; ++sampleIdx)
+    {
+    const TInputValue * sample = store->GetSample(sampleIdx);
+    output.emplace_back(sample, sample+sampleSize);
+    }
+}
+
+/** Converts the labels [start, start+size[ of a DenseSampleStore to Shark labels */
+template <class TInputValue, class TTargetValue>
+void SampleStoreRangeToSharkVector(const DenseSampleStore<TInputValue, TTargetValue> * store,
+                                   std::vector<unsigned int> & output, unsigned long start, unsigned long size)
+{
+  assert(store != ITK_NULLPTR);
+
+  if(start+size>store->Size())
+    {
+    itkGenericExceptionMacro(<<"Requested range ["<<start<<", "<<start+size<<"[ is out of bound for input sample store (range [0, "<<store->Size()<<"[");
+    }
+
+  output.clear();
+  output.reserve(size);
+
+  for (unsigned long sampleIdx = start; sampleIdx < start+size; ++sampleIdx)
+    {
+    output.push_back(store->GetLabel(sampleIdx));
+    }
+}
+
 template <class T> void ListSampleToSharkVector(const T * listSample, std::vector<shark::RealVector> & output)
 {
   assert(listSample != ITK_NULLPTR);
@@ -35,6 +35,7 @@ otb_module(OTBLearningBase
     OTBTestKernel
     OTBImageIO
     OTBImageBase
+    OTBStatistics
 
   DESCRIPTION
     "${DOCUMENTATION}"
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbDenseSampleStore.h"
+#include "otbShiftScaleSampleListFilter.h"
+
+#include "itkListSample.h"
+#include "itkVariableLengthVector.h"
+#include "itkFixedArray.h"
+
+#include <iostream>
+
+int otbDenseSampleStore(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::DenseSampleStore<float, int>                               StoreType;
+  typedef itk::VariableLengthVector<float>                                SampleType;
+  typedef itk::Statistics::ListSample<SampleType>                         ListSampleType;
+  typedef itk::FixedArray<int, 1>                                         LabelType;
+  typedef itk::Statistics::ListSample<LabelType>                          LabelListSampleType;
+  typedef itk::VariableLengthVector<double>                               MeasurementType;
+  typedef otb::Statistics::ShiftScaleSampleListFilter<ListSampleType, ListSampleType> ShiftScaleFilterType;
+
+  // This test checks that the samples centered and reduced in a store
+  // are the ones of the ShiftScaleSampleListFilter
+  const unsigned int nbFeatures = 5;
+  const unsigned int nbSamples = 1000;
+
+  StoreType::Pointer store = StoreType::New();
+  store->SetNumberOfFeatures(nbFeatures);
+  store->Reserve(nbSamples);
+
+  ListSampleType::Pointer listSample = ListSampleType::New();
+  listSample->SetMeasurementVectorSize(nbFeatures);
+
+  MeasurementType mv(nbFeatures);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    for (unsigned int j = 0; j < nbFeatures; ++j)
+      {
+      mv[j] = (i * 37 + j * 101) % 997 / 7.3 - 50.;
+      }
+
+    // Half of the samples are pushed, the other ones written in place
+    if (i % 2 == 0)
+      {
+      SampleType sample(mv);
+      store->PushBack(sample.GetDataPointer(), i % 7);
+      }
+    else
+      {
+      float * row = store->AddSample(0);
+      for (unsigned int j = 0; j < nbFeatures; ++j)
+        {
+        row[j] = static_cast<float>(mv[j]);
+        }
+      store->SetLabel(i, i % 7);
+      }
+    listSample->PushBack(mv);
+    }
+
+  // The last feature has a null scale
+  MeasurementType shifts(nbFeatures);
+  MeasurementType scales(nbFeatures);
+  for (unsigned int j = 0; j < nbFeatures; ++j)
+    {
+    shifts[j] = 3.1 * j - 4.;
+    scales[j] = j + 1 < nbFeatures ? 0.7 + 1.3 * j : 0.;
+    }
+
+  ShiftScaleFilterType::Pointer filter = ShiftScaleFilterType::New();
+  filter->SetInput(listSample);
+  filter->SetShifts(shifts);
+  filter->SetScales(scales);
+  filter->Update();
+
+  SampleType floatShifts(shifts);
+  SampleType floatScales(scales);
+  store->ShiftScale(floatShifts.GetDataPointer(), floatScales.GetDataPointer());
+
+  ListSampleType::Pointer exported = ListSampleType::New();
+  LabelListSampleType::Pointer labels = LabelListSampleType::New();
+  store->ExportToListSamples(0, 400, exported.GetPointer(), labels.GetPointer());
+  store->ExportToListSamples(400, nbSamples - 400, exported.GetPointer(), labels.GetPointer());
+
+  if (store->Size() != nbSamples || exported->Size() != nbSamples || labels->Size() != nbSamples)
+    {
+    std::cerr << "Wrong number of samples: " << store->Size() << " in the store, "
+              << exported->Size() << " exported, " << labels->Size() << " labels" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const SampleType & expected = filter->GetOutput()->GetMeasurementVector(i);
+    const SampleType & sample = exported->GetMeasurementVector(i);
+    for (unsigned int j = 0; j < nbFeatures; ++j)
+      {
+      if (sample[j] != expected[j] || store->GetSample(i)[j] != expected[j])
+        {
+        std::cerr << "Sample " << i << ", feature " << j << ": " << sample[j]
+                  << " instead of " << expected[j] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if (labels->GetMeasurementVector(i)[0] != static_cast<int>(i % 7) || store->GetLabel(i) != static_cast<int>(i % 7))
+      {
+      std::cerr << "Sample " << i << ": wrong label" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Out of range export
+  try
+    {
+    store->ExportToListSamples(nbSamples - 1, 2, exported.GetPointer(), labels.GetPointer());
+    std::cerr << "An out of range export should throw" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (itk::ExceptionObject &)
+    {
+    }
+
+  return EXIT_SUCCESS;
+}
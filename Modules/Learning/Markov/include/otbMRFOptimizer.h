@@ -72,11 +72,34 @@ public:
 
   virtual bool Compute(double deltaEnergy) = 0;
 
+  /** Create an optimizer of the same type and with the same parameters,
+   * to be used by another thread of the MarkovRandomFieldFilter.
+   * Optimizers drawing random numbers get their own generator
+   * initialized with seed. Return a null pointer if the optimizer can not
+   * be created. */
+  virtual Pointer CreateThreadCopy(int seed) const
+  {
+    itk::LightObject::Pointer another = this->CreateAnother();
+    Pointer copy = dynamic_cast<Self *>(another.GetPointer());
+    if (copy.IsNotNull())
+      {
+      copy->m_NumberOfParameters = m_NumberOfParameters;
+      copy->m_Parameters = m_Parameters;
+      copy->UseOwnGenerator(seed);
+      }
+    return copy;
+  }
+
 protected:
   MRFOptimizer() :
     m_NumberOfParameters(1),
     m_Parameters(1) {}
   ~MRFOptimizer() ITK_OVERRIDE {}
+
+  /** Use an independent random generator (nothing to do for
+   * deterministic optimizers) */
+  virtual void UseOwnGenerator(int itkNotUsed(seed)) {}
+
   unsigned int   m_NumberOfParameters;
   ParametersType m_Parameters;
 
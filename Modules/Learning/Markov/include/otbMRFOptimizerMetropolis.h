@@ -113,6 +113,12 @@ protected:
     m_Generator->SetSeed();
     }
   ~MRFOptimizerMetropolis() ITK_OVERRIDE {}
+
+  void UseOwnGenerator(int seed) ITK_OVERRIDE
+  {
+    m_Generator = RandomGeneratorType::New();
+    m_Generator->SetSeed(seed);
+  }
   RandomGeneratorType::Pointer m_Generator;
 };
 
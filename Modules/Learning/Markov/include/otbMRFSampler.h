@@ -85,6 +85,26 @@ public:
   virtual int Compute(const InputImageNeighborhoodIterator& itData,
                       const LabelledImageNeighborhoodIterator& itRegul) = 0;
 
+  /** Create a sampler of the same type and with the same settings, to be
+   * used by another thread of the MarkovRandomFieldFilter. The energies
+   * are shared, and samplers drawing random numbers get their own
+   * generator initialized with seed. Return a null pointer if the
+   * sampler can not be created. */
+  virtual Pointer CreateThreadCopy(int seed) const
+  {
+    itk::LightObject::Pointer another = this->CreateAnother();
+    Pointer copy = dynamic_cast<Self *>(another.GetPointer());
+    if (copy.IsNotNull())
+      {
+      copy->SetNumberOfClasses(m_NumberOfClasses);
+      copy->SetLambda(m_Lambda);
+      copy->SetEnergyRegularization(m_EnergyRegularization);
+      copy->SetEnergyFidelity(m_EnergyFidelity);
+      copy->UseOwnGenerator(seed);
+      }
+    return copy;
+  }
+
 protected:
   unsigned int m_NumberOfClasses;
   double       m_EnergyBefore;
@@ -113,6 +133,10 @@ protected:
     };
   ~MRFSampler() ITK_OVERRIDE {}
 
+  /** Use an independent random generator (nothing to do for
+   * deterministic samplers) */
+  virtual void UseOwnGenerator(int itkNotUsed(seed)) {}
+
 };
 
 }
@@ -99,6 +99,12 @@ protected:
     }
   ~MRFSamplerRandom() ITK_OVERRIDE {}
 
+  void UseOwnGenerator(int seed) ITK_OVERRIDE
+  {
+    m_Generator = RandomGeneratorType::New();
+    m_Generator->SetSeed(seed);
+  }
+
 private:
   RandomGeneratorType::Pointer m_Generator;
 };
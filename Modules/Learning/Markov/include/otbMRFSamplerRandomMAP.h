@@ -172,6 +172,12 @@ protected:
     if (m_RepartitionFunction != ITK_NULLPTR) free(m_RepartitionFunction);
     }
 
+  void UseOwnGenerator(int seed) ITK_OVERRIDE
+  {
+    m_Generator = RandomGeneratorType::New();
+    m_Generator->SetSeed(seed);
+  }
+
 private:
   double *                     m_RepartitionFunction;
   double *                     m_Energy;
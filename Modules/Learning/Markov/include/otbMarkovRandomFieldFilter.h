@@ -33,6 +33,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkNeighborhood.h"
 #include "itkSize.h"
+#include "itkMultiThreader.h"
 #include "otbMRFOptimizer.h"
 #include "otbMRFSampler.h"
 
@@ -69,6 +70,17 @@ namespace otb
  *   markovFilter->SetSampler(sampler);
  * \endcode
  *
+ * By default the pixels are visited in raster order by a single thread.
+ * With ParallelOptimizationOn(), each iteration is split into colour
+ * passes: two pixels of the same colour are at least radius+1 apart
+ * along one dimension, so that their neighborhoods do not overlap and
+ * they can be updated concurrently. Each pass is then processed by all
+ * the threads of the filter, each thread using its own copy of the
+ * sampler and of the optimizer (see MRFSampler::CreateThreadCopy() and
+ * MRFOptimizer::CreateThreadCopy()), with independent random generators
+ * seeded from the generator of the filter. The result is reproducible
+ * for a given seed and number of threads, but differs from the
+ * sequential one since the visiting order is not the same.
  *
  * \ingroup Markov
  *
@@ -248,6 +260,12 @@ public:
   itkSetMacro(Lambda, double);
   itkGetMacro(Lambda, double);
 
+  /** Set/Get whether the optimization is multithreaded, with colour
+   * passes over independent pixels. Default is false. */
+  itkSetMacro(ParallelOptimization, bool);
+  itkGetMacro(ParallelOptimization, bool);
+  itkBooleanMacro(ParallelOptimization);
+
   /** Set the neighborhood radius */
   void SetNeighborhoodRadius(const NeighborhoodRadiusType&);
 
@@ -383,7 +401,37 @@ protected:
 
   virtual void MinimizeOnce();
 
+  /** Apply the MRF once on the whole image, one colour pass after the
+   * other, each pass being multithreaded */
+  virtual void ParallelMinimizeOnce();
+
+  /** Update the pixels of the given colour in the region, with the
+   * sampler and optimizer of the thread */
+  virtual void ThreadedMinimizeColor(const LabelledImageRegionType& region,
+                                     unsigned int color,
+                                     itk::ThreadIdType threadId);
+
+  /** Get the colour of a pixel for the parallel optimization */
+  unsigned int GetPixelColor(const LabelledImageIndexType& index) const;
+
+  bool m_ParallelOptimization;
+
+  /** Per-thread samplers, optimizers and counters */
+  std::vector<SamplerPointer>   m_ThreadSamplers;
+  std::vector<OptimizerPointer> m_ThreadOptimizers;
+  std::vector<int>              m_ThreadErrorCounter;
+  std::vector<double>           m_ThreadDeltaEnergy;
+
 private:
+  /** Structure passed to the threads of a colour pass */
+  struct ColorPassStruct
+  {
+    Self *       Filter;
+    unsigned int Color;
+  };
+
+  /** Callback of the threads of a colour pass */
+  static ITK_THREAD_RETURN_TYPE ColorPassThreaderCallback(void * arg);
 
 }; // class MarkovRandomFieldFilter
 
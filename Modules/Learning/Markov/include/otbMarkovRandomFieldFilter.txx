@@ -23,6 +23,8 @@
 #define otbMarkovRandomFieldFilter_txx
 #include "otbMarkovRandomFieldFilter.h"
 
+#include <algorithm>
+
 namespace otb
 {
 template<class TInputImage, class TClassifiedImage>
@@ -40,7 +42,8 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
   m_NumberOfIterations(0),
   m_Lambda(1.0),
   m_ExternalClassificationSet(false),
-  m_StopCondition(MaximumNumberOfIterations)
+  m_StopCondition(MaximumNumberOfIterations),
+  m_ParallelOptimization(false)
 {
   m_Generator = RandomGeneratorType::GetInstance();
   m_Generator->SetSeed();
@@ -116,6 +119,9 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
 
   os << indent << " Lambda: " <<
   m_Lambda << std::endl;
+
+  os << indent << " Parallel optimization: " <<
+  m_ParallelOptimization << std::endl;
 } // end PrintSelf
 
 /**
@@ -347,6 +353,40 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
   m_Sampler->SetEnergyRegularization(m_EnergyRegularization);
   m_Sampler->SetEnergyFidelity(m_EnergyFidelity);
   m_Sampler->SetNumberOfClasses(m_NumberOfClasses);
+
+  m_ThreadSamplers.clear();
+  m_ThreadOptimizers.clear();
+
+  if (m_ParallelOptimization)
+    {
+    // Each thread gets its own sampler and optimizer, with random
+    // generators seeded from the one of the filter. Seeds are drawn
+    // first since creating samplers may reseed the global generator.
+    const itk::ThreadIdType nbThreads = this->GetNumberOfThreads();
+
+    std::vector<int> seeds(2 * nbThreads);
+    for (unsigned int i = 0; i < seeds.size(); ++i)
+      {
+      seeds[i] = static_cast<int>(m_Generator->GetIntegerVariate());
+      }
+
+    for (itk::ThreadIdType i = 0; i < nbThreads; ++i)
+      {
+      SamplerPointer   sampler = m_Sampler->CreateThreadCopy(seeds[2 * i]);
+      OptimizerPointer optimizer = m_Optimizer->CreateThreadCopy(seeds[2 * i + 1]);
+
+      if (sampler.IsNull() || optimizer.IsNull())
+        {
+        itkExceptionMacro(<< "Sampler and optimizer must be created by New() for the parallel optimization");
+        }
+
+      m_ThreadSamplers.push_back(sampler);
+      m_ThreadOptimizers.push_back(optimizer);
+      }
+
+    m_ThreadErrorCounter.assign(nbThreads, 0);
+    m_ThreadDeltaEnergy.assign(nbThreads, 0.0);
+    }
   }
 
 /**
@@ -370,7 +410,14 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
     {
     otbMsgDevMacro(<< "Iteration No." << m_NumberOfIterations);
 
-    this->MinimizeOnce();
+    if (m_ParallelOptimization)
+      {
+      this->ParallelMinimizeOnce();
+      }
+    else
+      {
+      this->MinimizeOnce();
+      }
 
     otbMsgDevMacro(<< "m_ErrorCounter/m_TotalNumberOfPixelsInInputImage: "
                    << m_ErrorCounter / ((double) (m_TotalNumberOfPixelsInInputImage)));
@@ -433,6 +480,134 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
 
 }
 
+/**
+* Get the colour of a pixel: two pixels of the same colour are at least
+* radius+1 apart along one dimension
+*/
+template<class TInputImage, class TClassifiedImage>
+unsigned int
+MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
+::GetPixelColor(const LabelledImageIndexType& index) const
+{
+  const LabelledImageIndexType& start = this->GetOutput()->GetLargestPossibleRegion().GetIndex();
+
+  unsigned int color = 0;
+  unsigned int stride = 1;
+  for (unsigned int i = 0; i < ClassifiedImageDimension; ++i)
+    {
+    const unsigned int period = m_LabelledImageNeighborhoodRadius[i] + 1;
+    color += static_cast<unsigned int>((index[i] - start[i]) % period) * stride;
+    stride *= period;
+    }
+  return color;
+}
+
+/**
+*Apply the MRF image filter on the whole image once, one colour pass after
+*the other
+*/
+template<class TInputImage, class TClassifiedImage>
+void
+MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
+::ParallelMinimizeOnce()
+{
+  unsigned int nbColors = 1;
+  for (unsigned int i = 0; i < ClassifiedImageDimension; ++i)
+    {
+    nbColors *= m_LabelledImageNeighborhoodRadius[i] + 1;
+    }
+
+  std::fill(m_ThreadErrorCounter.begin(), m_ThreadErrorCounter.end(), 0);
+  std::fill(m_ThreadDeltaEnergy.begin(), m_ThreadDeltaEnergy.end(), 0.0);
+
+  ColorPassStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(static_cast<itk::ThreadIdType>(m_ThreadSamplers.size()));
+
+  for (unsigned int color = 0; color < nbColors; ++color)
+    {
+    str.Color = color;
+    this->GetMultiThreader()->SetSingleMethod(this->ColorPassThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  m_ErrorCounter = 0;
+  for (unsigned int i = 0; i < m_ThreadErrorCounter.size(); ++i)
+    {
+    m_ErrorCounter += m_ThreadErrorCounter[i];
+    m_ImageDeltaEnergy += m_ThreadDeltaEnergy[i];
+    }
+}
+
+template<class TInputImage, class TClassifiedImage>
+ITK_THREAD_RETURN_TYPE
+MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
+::ColorPassThreaderCallback(void * arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *        info = static_cast<ThreadInfoType *>(arg);
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  ColorPassStruct *       str = static_cast<ColorPassStruct *>(info->UserData);
+
+  // Split the output region as ImageSource does
+  LabelledImageRegionType splitRegion;
+  const itk::ThreadIdType total = str->Filter->SplitRequestedRegion(threadId, threadCount, splitRegion);
+
+  if (threadId < total)
+    {
+    str->Filter->ThreadedMinimizeColor(splitRegion, str->Color, threadId);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+*Update the pixels of one colour in a region
+*/
+template<class TInputImage, class TClassifiedImage>
+void
+MarkovRandomFieldFilter<TInputImage, TClassifiedImage>
+::ThreadedMinimizeColor(const LabelledImageRegionType& region,
+                        unsigned int color,
+                        itk::ThreadIdType threadId)
+{
+  SamplerType *   sampler = m_ThreadSamplers[threadId];
+  OptimizerType * optimizer = m_ThreadOptimizers[threadId];
+
+  // Pixels of the other colours in the neighborhoods are not modified
+  // during this pass
+  LabelledImageNeighborhoodIterator
+  labelledIterator(m_LabelledImageNeighborhoodRadius, this->GetOutput(), region);
+  InputImageNeighborhoodIterator
+  dataIterator(m_InputImageNeighborhoodRadius, this->GetInput(), region);
+
+  int    errorCounter = 0;
+  double deltaEnergy = 0.0;
+
+  for (labelledIterator.GoToBegin(), dataIterator.GoToBegin();
+       !labelledIterator.IsAtEnd();
+       ++labelledIterator, ++dataIterator)
+    {
+    if (this->GetPixelColor(labelledIterator.GetIndex()) != color)
+      {
+      continue;
+      }
+
+    sampler->Compute(dataIterator, labelledIterator);
+    if (optimizer->Compute(sampler->GetDeltaEnergy()))
+      {
+      labelledIterator.SetCenterPixel(sampler->GetValue());
+      ++errorCounter;
+      deltaEnergy += sampler->GetDeltaEnergy();
+      }
+    }
+
+  m_ThreadErrorCounter[threadId] += errorCounter;
+  m_ThreadDeltaEnergy[threadId] += deltaEnergy;
+}
+
 } // namespace otb
 
 #endif
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbImageFileReader.h"
+#include "otbImage.h"
+#include "otbMarkovRandomFieldFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "otbMRFEnergyPotts.h"
+#include "otbMRFEnergyGaussianClassification.h"
+#include "otbMRFOptimizerICM.h"
+#include "otbMRFOptimizerMetropolis.h"
+#include "otbMRFSamplerMAP.h"
+#include "otbMRFSamplerRandom.h"
+
+namespace
+{
+const unsigned int Dimension = 2;
+const unsigned int NumberOfClasses = 4;
+
+typedef double                                   InternalPixelType;
+typedef unsigned char                            LabelledPixelType;
+typedef otb::Image<InternalPixelType, Dimension> InputImageType;
+typedef otb::Image<LabelledPixelType, Dimension> LabelledImageType;
+
+typedef otb::MarkovRandomFieldFilter<InputImageType, LabelledImageType>         MarkovRandomFieldFilterType;
+typedef otb::MRFEnergyPotts<LabelledImageType, LabelledImageType>               EnergyRegularizationType;
+typedef otb::MRFEnergyGaussianClassification<InputImageType, LabelledImageType> EnergyFidelityType;
+
+MarkovRandomFieldFilterType::Pointer CreateFilter(InputImageType * input,
+                                                  MarkovRandomFieldFilterType::SamplerType * sampler,
+                                                  otb::MRFOptimizer * optimizer)
+{
+  EnergyRegularizationType::Pointer energyRegularization = EnergyRegularizationType::New();
+  EnergyFidelityType::Pointer       energyFidelity       = EnergyFidelityType::New();
+
+  energyFidelity->SetNumberOfParameters(2 * NumberOfClasses);
+  EnergyFidelityType::ParametersType parameters;
+  parameters.SetSize(energyFidelity->GetNumberOfParameters());
+  for (unsigned int i = 0; i < NumberOfClasses; ++i)
+    {
+    parameters[2 * i] = 10.0 + 70.0 * i; // mean
+    parameters[2 * i + 1] = 10.0;        // stdev
+    }
+  energyFidelity->SetParameters(parameters);
+
+  MarkovRandomFieldFilterType::Pointer markovFilter = MarkovRandomFieldFilterType::New();
+  markovFilter->SetNumberOfClasses(NumberOfClasses);
+  markovFilter->SetErrorTolerance(0.0);
+  markovFilter->SetLambda(1.0);
+  markovFilter->SetNeighborhoodRadius(1);
+  markovFilter->SetEnergyRegularization(energyRegularization);
+  markovFilter->SetEnergyFidelity(energyFidelity);
+  markovFilter->SetSampler(sampler);
+  markovFilter->SetOptimizer(optimizer);
+  markovFilter->SetInput(input);
+
+  return markovFilter;
+}
+
+bool CheckLabels(const LabelledImageType * image)
+{
+  itk::ImageRegionConstIterator<LabelledImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    if (it.Get() >= NumberOfClasses)
+      {
+      std::cerr << "Invalid label " << static_cast<int>(it.Get()) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+unsigned long CountDifferences(const LabelledImageType * image1, const LabelledImageType * image2)
+{
+  itk::ImageRegionConstIterator<LabelledImageType> it1(image1, image1->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<LabelledImageType> it2(image2, image2->GetLargestPossibleRegion());
+  unsigned long count = 0;
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+    {
+    if (it1.Get() != it2.Get())
+      {
+      ++count;
+      }
+    }
+  return count;
+}
+
+LabelledImageType::Pointer RunMetropolis(InputImageType * input, unsigned int nbThreads)
+{
+  typedef otb::MRFSamplerRandom<InputImageType, LabelledImageType> SamplerType;
+  typedef otb::MRFOptimizerMetropolis                              OptimizerType;
+
+  SamplerType::Pointer   sampler = SamplerType::New();
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetSingleParameter(1.0);
+
+  MarkovRandomFieldFilterType::Pointer markovFilter = CreateFilter(input, sampler, optimizer);
+  markovFilter->SetMaximumNumberOfIterations(10);
+  markovFilter->ParallelOptimizationOn();
+  markovFilter->SetNumberOfThreads(nbThreads);
+  markovFilter->InitializeSeed(2);
+  markovFilter->Update();
+
+  return markovFilter->GetOutput();
+}
+}
+
+int otbMarkovRandomFieldFilterParallel(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::ImageFileReader<InputImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->Update();
+
+  InputImageType::Pointer input = reader->GetOutput();
+
+  bool ok = true;
+
+  // ICM with the MAP sampler strictly decreases the energy, so that the
+  // parallel optimization must converge to a fixed point of the
+  // sequential one
+  typedef otb::MRFSamplerMAP<InputImageType, LabelledImageType> MAPSamplerType;
+  typedef otb::MRFOptimizerICM                                  ICMOptimizerType;
+
+  MarkovRandomFieldFilterType::Pointer parallelFilter =
+    CreateFilter(input, MAPSamplerType::New(), ICMOptimizerType::New());
+  parallelFilter->SetMaximumNumberOfIterations(200);
+  parallelFilter->ParallelOptimizationOn();
+  parallelFilter->SetNumberOfThreads(4);
+  parallelFilter->InitializeSeed(2);
+  parallelFilter->Update();
+
+  if (parallelFilter->GetStopCondition() != MarkovRandomFieldFilterType::ErrorTolerance)
+    {
+    std::cerr << "Parallel ICM did not converge in " << parallelFilter->GetNumberOfIterations()
+              << " iterations" << std::endl;
+    ok = false;
+    }
+  ok = CheckLabels(parallelFilter->GetOutput()) && ok;
+
+  MarkovRandomFieldFilterType::Pointer sequentialFilter =
+    CreateFilter(input, MAPSamplerType::New(), ICMOptimizerType::New());
+  sequentialFilter->SetMaximumNumberOfIterations(1);
+  sequentialFilter->SetTrainingInput(parallelFilter->GetOutput());
+  sequentialFilter->Update();
+
+  const unsigned long nbChanges = CountDifferences(parallelFilter->GetOutput(), sequentialFilter->GetOutput());
+  if (nbChanges != 0)
+    {
+    std::cerr << "Sequential ICM changed " << nbChanges << " pixels of the parallel result" << std::endl;
+    ok = false;
+    }
+
+  // Metropolis with per-thread random generators is reproducible for a
+  // given seed and number of threads
+  LabelledImageType::Pointer output1 = RunMetropolis(input, 3);
+  LabelledImageType::Pointer output2 = RunMetropolis(input, 3);
+
+  ok = CheckLabels(output1) && ok;
+
+  const unsigned long nbDifferences = CountDifferences(output1, output2);
+  if (nbDifferences != 0)
+    {
+    std::cerr << "Parallel Metropolis is not reproducible: " << nbDifferences
+              << " different pixels" << std::endl;
+    ok = false;
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
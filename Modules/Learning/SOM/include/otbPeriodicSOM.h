@@ -121,6 +121,11 @@ protected:
   {
     Superclass::Step(currentIteration);
   }
+  /** Batch mode is not supported: the batch update does not wrap the neighborhood around the map */
+  void BatchStep(unsigned int itkNotUsed(currentIteration)) ITK_OVERRIDE
+  {
+    itkExceptionMacro(<< "Batch mode is not supported by PeriodicSOM");
+  }
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE
   {
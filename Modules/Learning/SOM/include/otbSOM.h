@@ -24,6 +24,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkEuclideanDistanceMetric.h"
+#include "itkMultiThreader.h"
 
 #include "otbCzihoSOMLearningBehaviorFunctor.h"
 #include "otbCzihoSOMNeighborhoodBehaviorFunctor.h"
@@ -48,6 +49,12 @@ namespace otb
  * The SOMMap produced as output can be either initialized with a constant custom value or randomly
  * generated following a normal law. The seed for the random initialization can be modified.
  *
+ * By default, the map is updated after each sample. In batch mode (see SetBatchMode()), the
+ * best-response neurons of all the samples are first searched by all the threads of the filter
+ * with the map of the previous iteration, and then each neuron moves towards the mean of the
+ * samples won by its neighbors, weighted as in the sequential mode, by the learning coefficient.
+ * The result is independent from the order of the samples, but differs from the sequential one.
+ *
  * \sa SOMMap
  * \sa SOMActivationBuilder
  * \sa CzihoSOMLearningBehaviorFunctor
@@ -111,6 +118,11 @@ public:
   itkGetObjectMacro(ListSample, ListSampleType);
   itkSetObjectMacro(ListSample, ListSampleType);
 
+  /** Set/Get the batch training mode (default is false) */
+  itkSetMacro(BatchMode, bool);
+  itkGetMacro(BatchMode, bool);
+  itkBooleanMacro(BatchMode);
+
   void SetBetaFunctor(const SOMLearningBehaviorFunctorType& functor)
   {
     m_BetaFunctor = functor;
@@ -143,6 +155,16 @@ protected:
    * Step one iteration.
    */
   virtual void Step(unsigned int currentIteration);
+  /**
+   * Step one iteration of the batch training.
+   */
+  virtual void BatchStep(unsigned int currentIteration);
+  /**
+   * Search the winners of the samples [startIndex, stopIndex[ and
+   * accumulate the samples of each winner for the thread.
+   */
+  virtual void ThreadedAccumulateWinners(unsigned long startIndex, unsigned long stopIndex,
+                                         itk::ThreadIdType threadId);
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
@@ -173,6 +195,20 @@ private:
   SOMLearningBehaviorFunctorType m_BetaFunctor;
   /** Behavior of the Neighborhood extent */
   SOMNeighborhoodBehaviorFunctorType m_NeighborhoodSizeFunctor;
+  /** Batch training mode */
+  bool m_BatchMode;
+  /** Per-thread sums and numbers of the samples won by each neuron */
+  std::vector<std::vector<double> > m_ThreadSums;
+  std::vector<std::vector<double> > m_ThreadCounts;
+
+  /** Static function used as a "callback" by the MultiThreader in batch mode */
+  static ITK_THREAD_RETURN_TYPE BatchThreaderCallback(void *arg);
+
+  /** Internal structure used for passing image data into the threading library */
+  struct ThreadStruct
+  {
+    Self * Filter;
+  };
 
 };
 } // end namespace otb
@@ -29,6 +29,9 @@
 #include "itkImageRegionIterator.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace otb
 {
 /**
@@ -52,6 +55,7 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
   m_MaxWeight = static_cast<ValueType>(128.0);
   m_RandomInit = false;
   m_Seed = 123574651;
+  m_BatchMode = false;
 }
 /**
  * Destructor
@@ -140,6 +144,12 @@ void
 SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
 ::Step(unsigned int currentIteration)
 {
+  if (m_BatchMode)
+    {
+    this->BatchStep(currentIteration);
+    return;
+    }
+
   // Compute the new learning coefficient
   double newBeta = m_BetaFunctor(
     currentIteration, m_NumberOfIterations, m_BetaInit, m_BetaEnd);
@@ -157,6 +167,181 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
     UpdateMap(it.GetMeasurementVector(), newBeta, newSize);
     }
 }
+/**
+ * Step one iteration of the batch training.
+ */
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+void
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::BatchStep(unsigned int currentIteration)
+{
+  // Compute the new learning coefficient
+  double newBeta = m_BetaFunctor(
+    currentIteration, m_NumberOfIterations, m_BetaInit, m_BetaEnd);
+
+  // Compute the new neighborhood size
+  SizeType newSize = m_NeighborhoodSizeFunctor(
+    currentIteration, m_NumberOfIterations, m_NeighborhoodSizeInit);
+
+  otbMsgDebugMacro(<< "Beta: " << newBeta << ", radius: " << newSize);
+
+  MapPointerType     map = this->GetOutput(0);
+  const RegionType   mapRegion = map->GetLargestPossibleRegion();
+  const unsigned int nbComponents = map->GetNumberOfComponentsPerPixel();
+  const unsigned long nbNeurons = mapRegion.GetNumberOfPixels();
+
+  // Search the winners of all the samples with the current map
+  const itk::ThreadIdType nbThreads = this->GetNumberOfThreads();
+  m_ThreadSums.assign(nbThreads, std::vector<double>(nbNeurons * nbComponents, 0.));
+  m_ThreadCounts.assign(nbThreads, std::vector<double>(nbNeurons, 0.));
+
+  ThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(nbThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->BatchThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  std::vector<double>& sums = m_ThreadSums[0];
+  std::vector<double>& counts = m_ThreadCounts[0];
+  for (itk::ThreadIdType t = 1; t < nbThreads; ++t)
+    {
+    for (unsigned long k = 0; k < sums.size(); ++k)
+      {
+      sums[k] += m_ThreadSums[t][k];
+      }
+    for (unsigned long k = 0; k < counts.size(); ++k)
+      {
+      counts[k] += m_ThreadCounts[t][k];
+      }
+    }
+
+  // Neighborhood weights of this iteration, as in UpdateMap()
+  unsigned long kernelLength = 1;
+  for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+    {
+    kernelLength *= 2 * newSize[i] + 1;
+    }
+
+  std::vector<typename IndexType::OffsetType> kernelOffsets(kernelLength);
+  std::vector<double>                         kernelWeights(kernelLength);
+  for (unsigned long k = 0; k < kernelLength; ++k)
+    {
+    unsigned long remainder = k;
+    double        squaredDistance = 0.;
+    for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+      {
+      const unsigned long width = 2 * newSize[i] + 1;
+      kernelOffsets[k][i] = static_cast<itk::OffsetValueType>(remainder % width)
+                            - static_cast<itk::OffsetValueType>(newSize[i]);
+      remainder /= width;
+      squaredDistance += static_cast<double>(kernelOffsets[k][i] * kernelOffsets[k][i]);
+      }
+    kernelWeights[k] = 1. / (1. + std::sqrt(squaredDistance));
+    }
+
+  // Move each neuron towards the weighted mean of the samples won by its
+  // neighbors. Only the accumulated sums are read, so that the update of
+  // a neuron does not depend on the others.
+  std::vector<double> numerator(nbComponents);
+
+  itk::ImageRegionIteratorWithIndex<MapType> it(map, mapRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    std::fill(numerator.begin(), numerator.end(), 0.);
+    double denominator = 0.;
+
+    for (unsigned int k = 0; k < kernelOffsets.size(); ++k)
+      {
+      const IndexType neighbor = it.GetIndex() + kernelOffsets[k];
+      if (!mapRegion.IsInside(neighbor))
+        {
+        continue;
+        }
+      const itk::OffsetValueType neighborOffset = map->ComputeOffset(neighbor);
+      if (counts[neighborOffset] == 0.)
+        {
+        continue;
+        }
+      const double   weight = kernelWeights[k];
+      const double * neighborSum = &sums[neighborOffset * nbComponents];
+      denominator += weight * counts[neighborOffset];
+      for (unsigned int i = 0; i < nbComponents; ++i)
+        {
+        numerator[i] += weight * neighborSum[i];
+        }
+      }
+
+    if (denominator > 0.)
+      {
+      NeuronType neuron = it.Get();
+      for (unsigned int i = 0; i < nbComponents; ++i)
+        {
+        neuron[i] = neuron[i]
+                    + static_cast<typename NeuronType::ValueType>(
+          (numerator[i] / denominator - neuron[i]) * newBeta);
+        }
+      it.Set(neuron);
+      }
+    }
+}
+/**
+ * Search the winners of a range of samples
+ */
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+void
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::ThreadedAccumulateWinners(unsigned long startIndex, unsigned long stopIndex,
+                            itk::ThreadIdType threadId)
+{
+  MapPointerType      map = this->GetOutput(0);
+  const unsigned int  nbComponents = map->GetNumberOfComponentsPerPixel();
+  std::vector<double>& sums = m_ThreadSums[threadId];
+  std::vector<double>& counts = m_ThreadCounts[threadId];
+
+  for (unsigned long id = startIndex; id < stopIndex; ++id)
+    {
+    const typename ListSampleType::MeasurementVectorType& sample = m_ListSample->GetMeasurementVector(id);
+    const itk::OffsetValueType winner = map->ComputeOffset(map->GetWinner(sample));
+
+    double * winnerSum = &sums[winner * nbComponents];
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      winnerSum[i] += sample[i];
+      }
+    counts[winner] += 1.;
+    }
+}
+
+template <class TListSample, class TMap,
+    class TSOMLearningBehaviorFunctor,
+    class TSOMNeighborhoodBehaviorFunctor>
+ITK_THREAD_RETURN_TYPE
+SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>
+::BatchThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  ThreadStruct *          str = static_cast<ThreadStruct *>(info->UserData);
+
+  // Contiguous ranges of samples
+  const unsigned long nbSamples = str->Filter->m_ListSample->Size();
+  const unsigned long chunkSize = (nbSamples + threadCount - 1) / threadCount;
+  const unsigned long start = std::min(nbSamples, threadId * chunkSize);
+  const unsigned long stop = std::min(nbSamples, start + chunkSize);
+
+  if (start < stop)
+    {
+    str->Filter->ThreadedAccumulateWinners(start, stop, threadId);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
 /**
  *  Output information redefinition
  */
@@ -33,7 +33,8 @@ namespace otb
  *  This filter is streamed and threaded, allowing to classify huge images. Because the
  *  internal sample type has to be an itk::FixedArray, one must specify at compilation time
  *  the maximum sample dimension. It is up to the user to specify a MaxSampleDimension sufficiently
- *  high to integrate all its features. This filter internally use one SVMClassifier per thread.
+ *  high to integrate all its features. Each thread searches the winning neuron of its pixels
+ *  directly in the map (see SOMMap::GetWinner()).
  *
  * \sa SVMClassifier
  * \ingroup Streamed
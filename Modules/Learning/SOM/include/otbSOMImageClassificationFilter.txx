@@ -84,10 +84,8 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
   typedef itk::ImageRegionConstIterator<MaskImageType>  MaskIteratorType;
   typedef itk::ImageRegionIterator<OutputImageType>     OutputIteratorType;
 
-  ListSamplePointerType listSample = ListSampleType::New();
-  listSample->SetMeasurementVectorSize(inputPtr->GetNumberOfComponentsPerPixel());
-
-  InputIteratorType inIt(inputPtr, outputRegionForThread);
+  InputIteratorType  inIt(inputPtr, outputRegionForThread);
+  OutputIteratorType outIt(outputPtr, outputRegionForThread);
 
   MaskIteratorType maskIt;
   if (inputMaskPtr)
@@ -100,7 +98,15 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
                                      maxDimension);
   bool validPoint = true;
 
-  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  // Labels are computed as SOMClassifier does
+  typename SOMMapType::SizeType size = m_Map->GetLargestPossibleRegion().GetSize();
+
+  // The winner of each pixel is searched directly in the map, without
+  // building an intermediate list sample
+  SampleType sample;
+  sample.SetSize(sampleSize);
+
+  for (inIt.GoToBegin(), outIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++outIt)
     {
     if (inputMaskPtr)
       {
@@ -109,56 +115,18 @@ SOMImageClassificationFilter<TInputImage, TOutputImage, TSOMMap, TMaskImage>
       }
     if (validPoint)
       {
-      SampleType sample;
-      sample.SetSize(sampleSize);
-      sample.Fill(itk::NumericTraits<ValueType>::ZeroValue());
+      const typename InputImageType::PixelType & pixel = inIt.Get();
       for (unsigned int i = 0; i < sampleSize; ++i)
         {
-        sample[i] = inIt.Get()[i];
+        sample[i] = pixel[i];
         }
-      listSample->PushBack(sample);
-      }
-    }
-  ClassifierPointerType classifier = ClassifierType::New();
-  classifier->SetMap(m_Map);
-  classifier->SetSample(listSample);
-  classifier->Update();
-
-  typename ClassifierType::OutputType::Pointer       membershipSample = classifier->GetOutput();
-  typename ClassifierType::OutputType::ConstIterator sampleIter = membershipSample->Begin();
-  typename ClassifierType::OutputType::ConstIterator sampleLast = membershipSample->End();
-
-  OutputIteratorType outIt(outputPtr, outputRegionForThread);
-
-  outIt.GoToBegin();
-
-  while (!outIt.IsAtEnd() && (sampleIter != sampleLast))
-    {
-    outIt.Set(m_DefaultLabel);
-    ++outIt;
-    }
-
-  outIt.GoToBegin();
-
-  if (inputMaskPtr)
-    {
-    maskIt.GoToBegin();
-    }
-  validPoint = true;
-
-  while (!outIt.IsAtEnd() && (sampleIter != sampleLast))
-    {
-    if (inputMaskPtr)
-      {
-      validPoint = maskIt.Get() > 0;
-      ++maskIt;
+      typename SOMMapType::IndexType index = m_Map->GetWinner(sample);
+      outIt.Set(static_cast<LabelType>((index[1] * size[1]) + index[0]));
       }
-    if (validPoint)
+    else
       {
-      outIt.Set(sampleIter.GetClassLabel());
-      ++sampleIter;
+      outIt.Set(m_DefaultLabel);
       }
-    ++outIt;
     }
 }
 /**
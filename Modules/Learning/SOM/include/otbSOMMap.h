@@ -28,6 +28,23 @@
 
 namespace otb
 {
+namespace internal
+{
+/** Tell whether a distance is the Euclidean distance, for which SOMMap
+ *  scans its buffer directly instead of calling the distance metric */
+template <class TDistance>
+struct IsEuclideanDistance
+{
+  static const bool Value = false;
+};
+
+template <class TMeasurementVector>
+struct IsEuclideanDistance<itk::Statistics::EuclideanDistanceMetric<TMeasurementVector> >
+{
+  static const bool Value = true;
+};
+} // end namespace internal
+
 /**
  * \class SOMMap
  * \brief This class represent a Self Organizing Map.
@@ -43,6 +60,11 @@ namespace otb
  * The training is done via the SOM class, and the activation map can be produced with the SOMActivationBuilder
  * class.
  *
+ * With the Euclidean distance, the winning neuron is searched by a direct scan of the contiguous
+ * buffer of the map, which gives the same winner as the distance metric without any per-neuron
+ * allocation or virtual call. GetWinner() only reads the map, so that it can be called concurrently
+ * from several threads as long as the map is not modified.
+ *
  * \sa SOM
  * \sa SOMActivationBuilder
  *
@@ -89,6 +111,10 @@ public:
   IndexType GetWinner(const NeuronType& sample);
 
 protected:
+  /** Get the offset in the buffer of the winning neuron, for the
+   *  Euclidean distance */
+  itk::OffsetValueType GetEuclideanWinnerOffset(const NeuronType& sample) const;
+
   /** Constructor */
   SOMMap();
   /** Destructor */
@@ -24,6 +24,9 @@
 
 #include "otbSOMMap.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+
+#include <cmath>
 
 namespace otb
 {
@@ -52,6 +55,14 @@ typename SOMMap<TNeuron, TDistance, VMapDimension>
 SOMMap<TNeuron, TDistance, VMapDimension>
 ::GetWinner(const NeuronType& sample)
 {
+  // Direct scan of the buffer for the Euclidean distance
+  if (internal::IsEuclideanDistance<DistanceType>::Value
+      && this->GetBufferedRegion() == this->GetLargestPossibleRegion()
+      && sample.Size() == this->GetNumberOfComponentsPerPixel())
+    {
+    return this->ComputeIndex(this->GetEuclideanWinnerOffset(sample));
+    }
+
   // Some typedefs
   typedef itk::ImageRegionIteratorWithIndex<Self> IteratorType;
 
@@ -80,6 +91,56 @@ SOMMap<TNeuron, TDistance, VMapDimension>
   // Return the index of the winner
   return minPos;
 }
+/**
+ * Get the offset of the winning neuron in the buffer for the Euclidean
+ * distance. Squared distances are accumulated as EuclideanDistanceMetric
+ * does, and the square root is only taken to break near ties, so that the
+ * winner is the same as the one of the generic search.
+ * \param sample The sample
+ * \return The offset of the winning neuron.
+ */
+template <class TNeuron, class TDistance, unsigned int VMapDimension>
+itk::OffsetValueType
+SOMMap<TNeuron, TDistance, VMapDimension>
+::GetEuclideanWinnerOffset(const NeuronType& sample) const
+{
+  const typename Superclass::InternalPixelType * codebook = this->GetBufferPointer();
+  const unsigned int        nbComponents = this->GetNumberOfComponentsPerPixel();
+  const itk::SizeValueType  nbNeurons = this->GetBufferedRegion().GetNumberOfPixels();
+  const double              tieFactor = 1. + 4. * itk::NumericTraits<double>::epsilon();
+
+  itk::OffsetValueType minPos = 0;
+  double               minSquaredDistance = itk::NumericTraits<double>::max();
+  double               minDistance = itk::NumericTraits<double>::max();
+
+  for (itk::SizeValueType n = 0; n < nbNeurons; ++n, codebook += nbComponents)
+    {
+    double squaredDistance = 0.;
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      const double temp = sample[i] - codebook[i];
+      squaredDistance += temp * temp;
+      }
+
+    if (n == 0)
+      {
+      minSquaredDistance = squaredDistance;
+      minDistance = std::sqrt(squaredDistance);
+      }
+
+    // The last neuron at the minimum distance wins
+    if (squaredDistance <= minSquaredDistance
+        || (squaredDistance <= minSquaredDistance * tieFactor
+            && std::sqrt(squaredDistance) <= minDistance))
+      {
+      minSquaredDistance = squaredDistance;
+      minDistance = std::sqrt(squaredDistance);
+      minPos = n;
+      }
+    }
+  return minPos;
+}
+
 template <class TNeuron, class TDistance, unsigned int VMapDimension>
 void
 SOMMap<TNeuron, TDistance, VMapDimension>
@@ -107,6 +107,11 @@ protected:
   {
     Superclass::Step(currentIteration);
   }
+  /** Batch mode is not supported: the batch update does not handle missing values */
+  void BatchStep(unsigned int itkNotUsed(currentIteration)) ITK_OVERRIDE
+  {
+    itkExceptionMacro(<< "Batch mode is not supported by SOMWithMissingValue");
+  }
   /** PrintSelf method */
 void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbSOMMap.h"
+#include "otbSOM.h"
+#include "itkListSample.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef double                                              ComponentType;
+typedef itk::VariableLengthVector<ComponentType>            PixelType;
+typedef itk::Statistics::EuclideanDistanceMetric<PixelType> DistanceType;
+typedef otb::SOMMap<PixelType, DistanceType, Dimension>     MapType;
+typedef itk::Statistics::ListSample<PixelType>              ListSampleType;
+typedef otb::SOM<ListSampleType, MapType>                   SOMType;
+typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+// Straightforward search of the winner, as the generic path of SOMMap
+MapType::IndexType ReferenceWinner(MapType * map, const PixelType& sample)
+{
+  DistanceType::Pointer distance = DistanceType::New();
+  itk::ImageRegionIteratorWithIndex<MapType> it(map, map->GetLargestPossibleRegion());
+  it.GoToBegin();
+  MapType::IndexType minPos = it.GetIndex();
+  double minDistance = distance->Evaluate(sample, it.Get());
+  for (; !it.IsAtEnd(); ++it)
+    {
+    double tempDistance = distance->Evaluate(sample, it.Get());
+    if (tempDistance <= minDistance)
+      {
+      minDistance = tempDistance;
+      minPos = it.GetIndex();
+      }
+    }
+  return minPos;
+}
+
+SOMType::Pointer CreateSOM(ListSampleType * listSample, unsigned int nbThreads)
+{
+  SOMType::Pointer som = SOMType::New();
+  som->SetListSample(listSample);
+  SOMType::SizeType size;
+  size.Fill(5);
+  som->SetMapSize(size);
+  SOMType::SizeType radius;
+  radius.Fill(2);
+  som->SetNeighborhoodSizeInit(radius);
+  som->SetNumberOfIterations(20);
+  som->SetBetaInit(1.0);
+  som->SetBetaEnd(0.1);
+  som->SetMinWeight(0.0);
+  som->SetMaxWeight(1.0);
+  som->SetRandomInit(true);
+  som->SetSeed(1234);
+  som->BatchModeOn();
+  som->SetNumberOfThreads(nbThreads);
+  som->Update();
+  return som;
+}
+}
+
+int otbSOMMapEuclideanWinner(int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  // This test checks the direct search of the winner for the Euclidean
+  // distance against the generic one, including ties
+  const unsigned int nbComponents = 7;
+
+  MapType::Pointer map = MapType::New();
+  MapType::RegionType region;
+  MapType::IndexType  index;
+  MapType::SizeType   size;
+  index.Fill(0);
+  size[0] = 8;
+  size[1] = 6;
+  region.SetIndex(index);
+  region.SetSize(size);
+  map->SetNumberOfComponentsPerPixel(nbComponents);
+  map->SetRegions(region);
+  map->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(4321);
+
+  PixelType neuron(nbComponents);
+  itk::ImageRegionIteratorWithIndex<MapType> it(map, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      neuron[i] = generator->GetUniformVariate(0., 10.);
+      }
+    it.Set(neuron);
+    }
+
+  // Duplicated neurons: the last one must win
+  MapType::IndexType first, last;
+  first[0] = 1;
+  first[1] = 1;
+  last[0] = 6;
+  last[1] = 4;
+  map->SetPixel(last, map->GetPixel(first));
+
+  bool ok = true;
+  PixelType sample(nbComponents);
+  for (unsigned int n = 0; n < 1000; ++n)
+    {
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      sample[i] = generator->GetUniformVariate(-1., 11.);
+      }
+    if (n == 0)
+      {
+      sample = map->GetPixel(first);
+      }
+
+    MapType::IndexType winner = map->GetWinner(sample);
+    MapType::IndexType reference = ReferenceWinner(map, sample);
+    if (winner != reference)
+      {
+      std::cerr << "Sample " << n << ": winner " << winner << " instead of " << reference << std::endl;
+      ok = false;
+      }
+    }
+
+  if (map->GetWinner(map->GetPixel(first)) != last)
+    {
+    std::cerr << "Ties are not broken as the generic search does" << std::endl;
+    ok = false;
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbSOMBatch(int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  // This test trains a map in batch mode on three clusters, and checks
+  // that each cluster center is represented by a neuron and that the
+  // result does not depend on the number of threads
+  const unsigned int nbComponents = 4;
+  const double       centers[3][nbComponents] = {{0.2, 0.2, 0.2, 0.2},
+                                                 {0.8, 0.2, 0.8, 0.2},
+                                                 {0.5, 0.8, 0.5, 0.8}};
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(5678);
+
+  ListSampleType::Pointer listSample = ListSampleType::New();
+  listSample->SetMeasurementVectorSize(nbComponents);
+  PixelType sample(nbComponents);
+  for (unsigned int n = 0; n < 3000; ++n)
+    {
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      sample[i] = centers[n % 3][i] + 0.02 * generator->GetNormalVariate();
+      }
+    listSample->PushBack(sample);
+    }
+
+  SOMType::Pointer som1 = CreateSOM(listSample, 1);
+  SOMType::Pointer som4 = CreateSOM(listSample, 4);
+
+  bool ok = true;
+
+  DistanceType::Pointer distance = DistanceType::New();
+  for (unsigned int c = 0; c < 3; ++c)
+    {
+    PixelType center(nbComponents);
+    for (unsigned int i = 0; i < nbComponents; ++i)
+      {
+      center[i] = centers[c][i];
+      }
+    MapType::IndexType winner = som1->GetOutput()->GetWinner(center);
+    const double       d = distance->Evaluate(center, som1->GetOutput()->GetPixel(winner));
+    if (d > 0.05)
+      {
+      std::cerr << "Cluster " << c << " is at distance " << d << " of its nearest neuron" << std::endl;
+      ok = false;
+      }
+    }
+
+  itk::ImageRegionIteratorWithIndex<MapType> it1(som1->GetOutput(), som1->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionIteratorWithIndex<MapType> it4(som4->GetOutput(), som4->GetOutput()->GetLargestPossibleRegion());
+  for (it1.GoToBegin(), it4.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it4)
+    {
+    if (distance->Evaluate(it1.Get(), it4.Get()) > 1e-9)
+      {
+      std::cerr << "Neuron " << it1.GetIndex() << " differs with 1 and 4 threads: "
+                << it1.Get() << " vs " << it4.Get() << std::endl;
+      ok = false;
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -32,6 +32,8 @@ void RegisterTests()
   REGISTER_TEST(otbSOMWithMissingValueTest);
   REGISTER_TEST(otbSOMNew);
   REGISTER_TEST(otbSOMMap);
+  REGISTER_TEST(otbSOMMapEuclideanWinner);
+  REGISTER_TEST(otbSOMBatch);
   REGISTER_TEST(otbSOMWithMissingValueNew);
   REGISTER_TEST(otbSOMMapNew);
   REGISTER_TEST(otbPeriodicSOMTest);
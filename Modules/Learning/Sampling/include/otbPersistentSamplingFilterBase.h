@@ -128,12 +128,24 @@ protected:
                            RegionType& region,
                            itk::ThreadIdType& threadid);
 
-  /** Process a polygon : use pixels inside the polygon */
+  /** Process a polygon : use pixels inside the polygon. The pixels
+   *  are found row by row: for each ring, the edges crossing the row are
+   *  collected, and the columns where each crossing test changes are
+   *  found, so that the rows are covered by spans. The tests and the
+   *  order of the samples are the same as with IsSampleInsidePolygon()
+   *  on each pixel of the region, which is still used when the image
+   *  direction is not the identity. */
   virtual void ProcessPolygon(const ogr::Feature& feature,
                               OGRPolygon* polygon,
                               RegionType& region,
                               itk::ThreadIdType& threadid);
 
+  /** Process a polygon with IsSampleInsidePolygon() on each pixel */
+  void ProcessPolygonPerPixel(const ogr::Feature& feature,
+                              OGRPolygon* polygon,
+                              RegionType& region,
+                              itk::ThreadIdType& threadid);
+
   /** Generic method called for each matching pixel position (NOT IMPLEMENTED)*/
   virtual void ProcessSample(const ogr::Feature& feature,
                              typename TInputImage::IndexType& imgIndex,
@@ -148,6 +160,23 @@ protected:
   bool IsSampleInsidePolygon(OGRPolygon* poly,
                              OGRPoint* tmpPoint);
 
+  /** Set marks to value for the columns whose pixel center is inside
+   *  the ring, on the row at centerY. centersX are the abscissae of the
+   *  pixel centers, and only the columns in [firstColumn, lastColumn]
+   *  (inside the envelope of the ring) are considered. */
+  static void ScanRing(const OGRLinearRing* ring,
+                       double centerY,
+                       const std::vector<double>& centersX,
+                       long firstColumn,
+                       long lastColumn,
+                       unsigned char value,
+                       std::vector<unsigned char>& marks);
+
+  /** Crossing test of OGRLinearRing::isPointInRing(): does the edge
+   *  from (x2,y2) to (x1,y1), relative to the tested point, cross the
+   *  horizontal ray on its right ? */
+  static bool IsCrossingOnRight(double x1, double y1, double x2, double y2);
+
   /** Common function to test if a pixel crosses the line */
   bool IsSampleOnLine(OGRLineString* line,
                       typename TInputImage::PointType& position,
@@ -29,6 +29,8 @@
 #include "itkTimeProbe.h"
 #include "itkProgressReporter.h"
 
+#include <algorithm>
+
 namespace otb
 {
 
@@ -520,6 +522,106 @@ PersistentSamplingFilterBase<TInputImage,TMaskImage>
                  OGRPolygon* polygon,
                  RegionType& region,
                  itk::ThreadIdType& threadid)
+{
+  const TInputImage* img = this->GetInput();
+  const TMaskImage* mask = this->GetMask();
+
+  typename TInputImage::DirectionType identity;
+  identity.SetIdentity();
+  if (img->GetDirection() != identity)
+    {
+    this->ProcessPolygonPerPixel(feature,polygon,region,threadid);
+    return;
+    }
+
+  const OGRLinearRing* exteriorRing = polygon->getExteriorRing();
+  if (exteriorRing == ITK_NULLPTR || region.GetNumberOfPixels() == 0)
+    {
+    return;
+    }
+
+  // Pixel centers of the region: with an identity direction, the
+  // abscissa only depends on the column and the ordinate on the row, and
+  // both are the ones given by TransformIndexToPhysicalPoint()
+  typename TInputImage::IndexType imgIndex = region.GetIndex();
+  typename TInputImage::PointType imgPoint;
+  const long width = region.GetSize(0);
+  const long height = region.GetSize(1);
+  std::vector<double> centersX(width);
+  for (long c = 0; c < width; ++c)
+    {
+    imgIndex[0] = region.GetIndex(0) + c;
+    img->TransformIndexToPhysicalPoint(imgIndex,imgPoint);
+    centersX[c] = imgPoint[0];
+    }
+
+  // Rings and the columns inside their envelope
+  std::vector<const OGRLinearRing*> rings(1, exteriorRing);
+  for (int k=0 ; k<polygon->getNumInteriorRings() ; k++)
+    {
+    rings.push_back(polygon->getInteriorRing(k));
+    }
+  std::vector<OGREnvelope> envelopes(rings.size());
+  std::vector<long> firstColumns(rings.size(), 0);
+  std::vector<long> lastColumns(rings.size(), -1);
+  for (unsigned int r = 0; r < rings.size(); ++r)
+    {
+    rings[r]->getEnvelope(&envelopes[r]);
+    for (long c = 0; c < width; ++c)
+      {
+      if (centersX[c] >= envelopes[r].MinX && centersX[c] <= envelopes[r].MaxX)
+        {
+        if (lastColumns[r] < firstColumns[r])
+          {
+          firstColumns[r] = c;
+          }
+        lastColumns[r] = c;
+        }
+      }
+    }
+
+  std::vector<unsigned char> marks(width);
+  for (long row = 0; row < height; ++row)
+    {
+    imgIndex[0] = region.GetIndex(0);
+    imgIndex[1] = region.GetIndex(1) + row;
+    img->TransformIndexToPhysicalPoint(imgIndex,imgPoint);
+    const double centerY = imgPoint[1];
+
+    // Inside the exterior ring and outside the interior ones
+    std::fill(marks.begin(), marks.end(), 0);
+    for (unsigned int r = 0; r < rings.size(); ++r)
+      {
+      if (centerY >= envelopes[r].MinY && centerY <= envelopes[r].MaxY)
+        {
+        ScanRing(rings[r], centerY, centersX, firstColumns[r], lastColumns[r], r == 0 ? 1 : 0, marks);
+        }
+      }
+
+    imgPoint[1] = centerY;
+    for (long c = 0; c < width; ++c)
+      {
+      if (!marks[c])
+        {
+        continue;
+        }
+      imgIndex[0] = region.GetIndex(0) + c;
+      if ((mask == ITK_NULLPTR) || mask->GetPixel(imgIndex))
+        {
+        imgPoint[0] = centersX[c];
+        this->ProcessSample(feature,imgIndex, imgPoint, threadid);
+        }
+      }
+    }
+}
+
+template <class TInputImage, class TMaskImage>
+void
+PersistentSamplingFilterBase<TInputImage,TMaskImage>
+::ProcessPolygonPerPixel(const ogr::Feature& feature,
+                         OGRPolygon* polygon,
+                         RegionType& region,
+                         itk::ThreadIdType& threadid)
 {
   const TInputImage* img = this->GetInput();
   TMaskImage* mask = const_cast<TMaskImage*>(this->GetMask());
@@ -611,6 +713,90 @@ PersistentSamplingFilterBase<TInputImage,TMaskImage>
   return ret;
 }
 
+template <class TInputImage, class TMaskImage>
+void
+PersistentSamplingFilterBase<TInputImage,TMaskImage>
+::ScanRing(const OGRLinearRing* ring,
+           double centerY,
+           const std::vector<double>& centersX,
+           long firstColumn,
+           long lastColumn,
+           unsigned char value,
+           std::vector<unsigned char>& marks)
+{
+  // Rings with less than 4 points contain no point
+  const int nbPoints = ring->getNumPoints();
+  if (firstColumn > lastColumn || nbPoints < 4)
+    {
+    return;
+    }
+
+  // Parity of the crossings at the first column, and columns where the
+  // crossing test of an edge changes (it is monotonic along the row)
+  bool parity = false;
+  std::vector<long> toggles;
+  for (int i = 1; i < nbPoints; ++i)
+    {
+    const double y1 = ring->getY(i) - centerY;
+    const double y2 = ring->getY(i - 1) - centerY;
+    if (!(((y1 > 0) && (y2 <= 0)) || ((y2 > 0) && (y1 <= 0))))
+      {
+      continue;
+      }
+    const double pX1 = ring->getX(i);
+    const double pX2 = ring->getX(i - 1);
+
+    const bool firstTest = IsCrossingOnRight(pX1 - centersX[firstColumn], y1, pX2 - centersX[firstColumn], y2);
+    const bool lastTest = IsCrossingOnRight(pX1 - centersX[lastColumn], y1, pX2 - centersX[lastColumn], y2);
+    parity = (parity != firstTest);
+    if (firstTest == lastTest)
+      {
+      continue;
+      }
+
+    // Bisection of the first column with the other result
+    long low = firstColumn;
+    long high = lastColumn;
+    while (high - low > 1)
+      {
+      const long mid = (low + high) / 2;
+      if (IsCrossingOnRight(pX1 - centersX[mid], y1, pX2 - centersX[mid], y2) == firstTest)
+        {
+        low = mid;
+        }
+      else
+        {
+        high = mid;
+        }
+      }
+    toggles.push_back(high);
+    }
+  std::sort(toggles.begin(), toggles.end());
+
+  std::vector<long>::const_iterator toggleIt = toggles.begin();
+  for (long c = firstColumn; c <= lastColumn; ++c)
+    {
+    while (toggleIt != toggles.end() && *toggleIt == c)
+      {
+      parity = !parity;
+      ++toggleIt;
+      }
+    if (parity)
+      {
+      marks[c] = value;
+      }
+    }
+}
+
+template <class TInputImage, class TMaskImage>
+inline bool
+PersistentSamplingFilterBase<TInputImage,TMaskImage>
+::IsCrossingOnRight(double x1, double y1, double x2, double y2)
+{
+  const double intersection = (x1 * y2 - x2 * y1) / (y2 - y1);
+  return 0.0 < intersection;
+}
+
 template <class TInputImage, class TMaskImage>
 inline bool
 PersistentSamplingFilterBase<TInputImage,TMaskImage>
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbPersistentSamplingFilterBase.h"
+#include "otbImage.h"
+#include "otbMath.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace otb
+{
+/** Sampling filter recording the pixels covered by a polygon */
+class PolygonCoverageTestFilter
+  : public PersistentSamplingFilterBase<Image<float, 2> >
+{
+public:
+  typedef PolygonCoverageTestFilter                            Self;
+  typedef PersistentSamplingFilterBase<Image<float, 2> >      Superclass;
+  typedef itk::SmartPointer<Self>                              Pointer;
+  typedef itk::SmartPointer<const Self>                        ConstPointer;
+  typedef Image<float, 2>                                      ImageType;
+  typedef std::vector<ImageType::IndexType>                    IndexVectorType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PolygonCoverageTestFilter, PersistentSamplingFilterBase);
+
+  void Reset(void) ITK_OVERRIDE {}
+  void Synthetize(void) ITK_OVERRIDE {}
+
+  /** Pixels covered by the scanline coverage */
+  IndexVectorType Cover(const ogr::Feature & feature, OGRPolygon * polygon, RegionType region)
+  {
+    m_Samples.clear();
+    itk::ThreadIdType threadid = 0;
+    this->ProcessPolygon(feature, polygon, region, threadid);
+    return m_Samples;
+  }
+
+  /** Pixels covered with a point in polygon test on each pixel */
+  IndexVectorType CoverPerPixel(const ogr::Feature & feature, OGRPolygon * polygon, RegionType region)
+  {
+    m_Samples.clear();
+    itk::ThreadIdType threadid = 0;
+    this->ProcessPolygonPerPixel(feature, polygon, region, threadid);
+    return m_Samples;
+  }
+
+protected:
+  PolygonCoverageTestFilter() {}
+  ~PolygonCoverageTestFilter() ITK_OVERRIDE {}
+
+  void ProcessSample(const ogr::Feature&,
+                     ImageType::IndexType& imgIndex,
+                     ImageType::PointType& imgPoint,
+                     itk::ThreadIdType&) ITK_OVERRIDE
+  {
+    ImageType::PointType expected;
+    this->GetInput()->TransformIndexToPhysicalPoint(imgIndex, expected);
+    if (expected != imgPoint)
+      {
+      itkExceptionMacro(<< "Sample point " << imgPoint << " differs from " << expected);
+      }
+    m_Samples.push_back(imgIndex);
+  }
+
+private:
+  PolygonCoverageTestFilter(const Self &); //purposely not implemented
+  void operator =(const Self&); //purposely not implemented
+
+  IndexVectorType m_Samples;
+};
+}
+
+int otbPersistentSamplingFilterBasePolygonCoverage(int itkNotUsed(argc), char* itkNotUsed(argv) [])
+{
+  // This test checks that the scanline coverage of polygons gives the
+  // same samples, in the same order, as the point in polygon test on
+  // each pixel, including vertices and edges on pixel centers
+  typedef otb::PolygonCoverageTestFilter                         FilterType;
+  typedef FilterType::ImageType                                  ImageType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  ImageType::RegionType region;
+  region.SetSize(0, 120);
+  region.SetSize(1, 80);
+  ImageType::PointType origin;
+  origin[0] = 1000.25;
+  origin[1] = 2000.75;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = -0.5;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetOrigin(origin);
+  image->SetSpacing(spacing);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+
+  otb::ogr::DataSource::Pointer ogrDS = otb::ogr::DataSource::New();
+  otb::ogr::Layer layer = ogrDS->CreateLayer("layer", ITK_NULLPTR, wkbPolygon);
+  otb::ogr::Feature feature(layer.GetLayerDefn());
+
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(121212);
+
+  bool ok = true;
+  for (unsigned int k = 0; k < 300 && ok; ++k)
+    {
+    const double cx = origin[0] + generator->GetUniformVariate(-5., 65.);
+    const double cy = origin[1] - generator->GetUniformVariate(-5., 45.);
+    const double radius = generator->GetUniformVariate(1., 25.);
+
+    // Star shaped rings, with vertices snapped to pixel centers or
+    // pixel corners for one polygon out of two
+    OGRPolygon polygon;
+    OGRLinearRing outer;
+    OGRLinearRing inner;
+    const unsigned int nbPoints = 3 + k % 9;
+    for (unsigned int p = 0; p < nbPoints; ++p)
+      {
+      const double angle = 2. * CONST_PI * p / nbPoints;
+      const double r = radius * (p % 2 ? 0.5 : 1.) * generator->GetUniformVariate(0.7, 1.);
+      double x = cx + r * std::cos(angle);
+      double y = cy + r * std::sin(angle);
+      double xi = cx + 0.25 * r * std::cos(angle);
+      double yi = cy + 0.25 * r * std::sin(angle);
+      if (k % 2 == 0)
+        {
+        x = origin[0] + 0.25 * vcl_floor((x - origin[0]) / 0.25 + 0.5);
+        y = origin[1] + 0.25 * vcl_floor((y - origin[1]) / 0.25 + 0.5);
+        xi = origin[0] + 0.25 * vcl_floor((xi - origin[0]) / 0.25 + 0.5);
+        yi = origin[1] + 0.25 * vcl_floor((yi - origin[1]) / 0.25 + 0.5);
+        }
+      outer.addPoint(x, y);
+      inner.addPoint(xi, yi);
+      }
+    outer.closeRings();
+    inner.closeRings();
+    polygon.addRing(&outer);
+    if (k % 3 == 0)
+      {
+      polygon.addRing(&inner);
+      }
+
+    // Bounding region of the polygon, cropped to the image
+    OGREnvelope envelope;
+    polygon.getEnvelope(&envelope);
+    ImageType::PointType corner;
+    ImageType::IndexType start, end;
+    corner[0] = envelope.MinX;
+    corner[1] = envelope.MaxY;
+    image->TransformPhysicalPointToIndex(corner, start);
+    corner[0] = envelope.MaxX;
+    corner[1] = envelope.MinY;
+    image->TransformPhysicalPointToIndex(corner, end);
+    ImageType::RegionType polygonRegion;
+    polygonRegion.SetIndex(start);
+    polygonRegion.SetSize(0, end[0] - start[0] + 1);
+    polygonRegion.SetSize(1, end[1] - start[1] + 1);
+    if (!polygonRegion.Crop(region))
+      {
+      continue;
+      }
+
+    const FilterType::IndexVectorType reference = filter->CoverPerPixel(feature, &polygon, polygonRegion);
+    const FilterType::IndexVectorType samples = filter->Cover(feature, &polygon, polygonRegion);
+
+    if (samples != reference)
+      {
+      std::cerr << "Polygon " << k << ": " << samples.size() << " samples instead of "
+                << reference.size() << std::endl;
+      ok = false;
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
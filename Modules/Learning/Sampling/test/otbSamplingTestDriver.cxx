@@ -34,4 +34,5 @@ void RegisterTests()
   REGISTER_TEST(otbImageSampleExtractorFilterUpdate);
   REGISTER_TEST(otbSamplingRateCalculatorListNew);
   REGISTER_TEST(otbSamplingRateCalculatorList);
+  REGISTER_TEST(otbPersistentSamplingFilterBasePolygonCoverage);
 }
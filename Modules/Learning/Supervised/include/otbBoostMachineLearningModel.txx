@@ -137,6 +137,68 @@ BoostMachineLearningModel<TInputValue,TOutputValue>
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+BoostMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+#ifdef OTB_OPENCV_3
+  cv::Mat results;
+  m_BoostModel->predict(samples, results);
+  results.convertTo(results, CV_32F);
+
+  cv::Mat raw;
+  if (quality != ITK_NULLPTR)
+    {
+    m_BoostModel->predict(samples, raw, cv::ml::StatModel::RAW_OUTPUT);
+    raw.convertTo(raw, CV_32F);
+    }
+#else
+  // CvBoost has no batch prediction : rows of the batch matrix are
+  // predicted one by one, sharing the same missing mask
+  cv::Mat missing  = cv::Mat(1,samples.cols, CV_8U );
+  missing.setTo(0);
+#endif
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+#ifdef OTB_OPENCV_3
+    target[0] = static_cast<TOutputValue>(results.at<float>(i, 0));
+#else
+    target[0] = static_cast<TOutputValue>(m_BoostModel->predict(samples.row(i),missing));
+#endif
+    targets->SetMeasurementVector(startIndex + i, target);
+
+    if (quality != ITK_NULLPTR)
+      {
+      ConfidenceSampleType confidence;
+      confidence[0] = static_cast<ConfidenceValueType>(
+#ifdef OTB_OPENCV_3
+        raw.at<float>(i, 0)
+#else
+        m_BoostModel->predict(samples.row(i),missing,cv::Range::all(),false,true)
+#endif
+        );
+      quality->SetMeasurementVector(startIndex + i, confidence);
+      }
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 BoostMachineLearningModel<TInputValue,TOutputValue>
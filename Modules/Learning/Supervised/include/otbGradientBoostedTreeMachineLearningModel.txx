@@ -107,6 +107,40 @@ GradientBoostedTreeMachineLearningModel<TInputValue,TOutputValue>
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+GradientBoostedTreeMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  if (quality != ITK_NULLPTR && !this->m_ConfidenceIndex)
+    {
+    itkExceptionMacro("Confidence index not available for this classifier !");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+  // CvGBTrees has no batch prediction : rows of the batch matrix are
+  // predicted one by one, without copying them
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+    target[0] = static_cast<TOutputValue>(m_GBTreeModel->predict(samples.row(i)));
+    targets->SetMeasurementVector(startIndex + i, target);
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 GradientBoostedTreeMachineLearningModel<TInputValue,TOutputValue>
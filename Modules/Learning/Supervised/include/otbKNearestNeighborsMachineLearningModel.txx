@@ -45,6 +45,8 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
 {
   this->m_ConfidenceIndex = true;
   this->m_IsRegressionSupported = true;
+  // OpenCV already spreads the neighbors search of a batch on several threads
+  this->m_IsDoPredictBatchMultiThreaded = true;
 }
 
 
@@ -121,6 +123,62 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
 #else
   result = m_KNearestModel->find_nearest(sample, m_K,ITK_NULLPTR,ITK_NULLPTR,&nearest,ITK_NULLPTR);
 #endif
+  target[0] = static_cast<TTargetValue>(this->ApplyDecisionRule(nearest.ptr<float>(0), result, quality));
+  return target;
+}
+
+template <class TInputValue, class TTargetValue>
+void
+KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+  // Search the neighbors of the whole range at once
+  cv::Mat results(size,1,CV_32FC1);
+  cv::Mat nearest(size,m_K,CV_32FC1);
+#ifdef OTB_OPENCV_3
+  m_KNearestModel->findNearest(samples, m_K, results, nearest, cv::noArray());
+#else
+  m_KNearestModel->find_nearest(samples, m_K,&results,ITK_NULLPTR,&nearest,ITK_NULLPTR);
+#endif
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+    if (quality != ITK_NULLPTR)
+      {
+      ConfidenceSampleType confidence;
+      target[0] = static_cast<TTargetValue>(
+        this->ApplyDecisionRule(nearest.ptr<float>(i), results.at<float>(i,0), &confidence[0]));
+      quality->SetMeasurementVector(startIndex + i, confidence);
+      }
+    else
+      {
+      target[0] = static_cast<TTargetValue>(
+        this->ApplyDecisionRule(nearest.ptr<float>(i), results.at<float>(i,0), ITK_NULLPTR));
+      }
+    targets->SetMeasurementVector(startIndex + i, target);
+    }
+}
+
+template <class TInputValue, class TTargetValue>
+float
+KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
+::ApplyDecisionRule(const float * nearest, float result, ConfidenceValueType *quality) const
+{
   // compute quality if asked (only happens in classification mode)
   if (quality != ITK_NULLPTR)
     {
@@ -128,7 +186,7 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
     unsigned int accuracy = 0;
     for (int k=0 ; k < m_K ; ++k)
       {
-      if (nearest.at<float>(0,k) == result)
+      if (nearest[k] == result)
         {
         accuracy++;
         }
@@ -145,7 +203,7 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
     std::multiset<float> values;
     for (int k=0 ; k < m_K ; ++k)
       {
-      values.insert(nearest.at<float>(0,k));
+      values.insert(nearest[k]);
       }
     std::multiset<float>::iterator median = values.begin();
     int pos = (m_K >> 1);
@@ -153,8 +211,7 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
     result = *median;
     }
 
-  target[0] = static_cast<TTargetValue>(result);
-  return target;
+  return result;
 }
 
 template <class TInputValue, class TTargetValue>
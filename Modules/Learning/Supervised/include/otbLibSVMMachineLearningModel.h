@@ -47,6 +47,8 @@ public:
   typedef typename Superclass::TargetSampleType           TargetSampleType;
   typedef typename Superclass::TargetListSampleType       TargetListSampleType;
   typedef typename Superclass::ConfidenceValueType        ConfidenceValueType;
+  typedef typename Superclass::ConfidenceSampleType       ConfidenceSampleType;
+  typedef typename Superclass::ConfidenceListSampleType   ConfidenceListSampleType;
 
   /** enum to choose the way confidence is computed
    *   CM_INDEX : compute the difference between highest and second highest probability
@@ -274,6 +276,9 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType *quality=ITK_NULLPTR) const ITK_OVERRIDE;
 
+  /** Predict a range of samples at once */
+  void DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality = ITK_NULLPTR) const ITK_OVERRIDE;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
@@ -291,6 +296,13 @@ private:
 
   void OptimizeParameters(void);
 
+  /** Fill the libsvm nodes x (of size input.Size()+1) with the sample */
+  void FillNodes(const InputSampleType & input, struct svm_node * x) const;
+
+  /** Predict the sample stored in the nodes x. prob_estimates is a
+   *  scratch buffer holding at least nr_class values. */
+  TargetSampleType PredictNodes(const struct svm_node * x, double * prob_estimates, ConfidenceValueType *quality=ITK_NULLPTR) const;
+
   /** Container to hold the SVM model itself */
   struct svm_model* m_Model;
 
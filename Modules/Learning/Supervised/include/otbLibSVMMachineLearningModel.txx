@@ -21,7 +21,9 @@
 #ifndef otbLibSVMMachineLearningModel_txx
 #define otbLibSVMMachineLearningModel_txx
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
 #include "otbLibSVMMachineLearningModel.h"
 #include "otbSVMCrossValidationCostFunction.h"
 #include "otbExhaustiveExponentialOptimizer.h"
@@ -109,16 +111,75 @@ typename LibSVMMachineLearningModel<TInputValue,TOutputValue>
 LibSVMMachineLearningModel<TInputValue,TOutputValue>
 ::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
 {
-  TargetSampleType target;
-  target.Fill(0);
+  if (quality != ITK_NULLPTR && !this->m_ConfidenceIndex)
+    {
+    itkExceptionMacro("Confidence index not available for this classifier !");
+    }
 
-  // Get type and number of classes
-  int svm_type = svm_get_svm_type(m_Model);
+  // Allocate nodes
+  std::vector<struct svm_node> x(input.Size() + 1);
+  this->FillNodes(input, &x[0]);
+
+  std::vector<double> probEstimates(std::max(1, svm_get_nr_class(m_Model)));
+
+  return this->PredictNodes(&x[0], &probEstimates[0], quality);
+}
+
+template <class TInputValue, class TOutputValue>
+void
+LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
 
-  // Allocate nodes (/TODO if performances problems are related to too
-  // many allocations, a cache approach can be set)
-  struct svm_node * x = new struct svm_node[input.Size() + 1];
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
 
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  if (quality != ITK_NULLPTR && !this->m_ConfidenceIndex)
+    {
+    itkExceptionMacro("Confidence index not available for this classifier !");
+    }
+
+  // libsvm has no batch API : the nodes and the scratch buffers are
+  // allocated once and reused for every sample of the range
+  std::vector<struct svm_node> x(input->GetMeasurementVectorSize() + 1);
+
+  // CM_PROBA and CM_HYPER modes write several values, only the first one
+  // is kept in the confidence list sample
+  const unsigned int nr_class = std::max(1, svm_get_nr_class(m_Model));
+  std::vector<double> probEstimates(nr_class);
+  std::vector<ConfidenceValueType> confidences(std::max(nr_class, nr_class * (nr_class - 1) / 2));
+
+  for (unsigned int id = startIndex; id < startIndex + size; ++id)
+    {
+    this->FillNodes(input->GetMeasurementVector(id), &x[0]);
+
+    if (quality != ITK_NULLPTR)
+      {
+      targets->SetMeasurementVector(id, this->PredictNodes(&x[0], &probEstimates[0], &confidences[0]));
+
+      ConfidenceSampleType confidence;
+      confidence[0] = confidences[0];
+      quality->SetMeasurementVector(id, confidence);
+      }
+    else
+      {
+      targets->SetMeasurementVector(id, this->PredictNodes(&x[0], &probEstimates[0]));
+      }
+    }
+}
+
+template <class TInputValue, class TOutputValue>
+void
+LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::FillNodes(const InputSampleType & input, struct svm_node * x) const
+{
   // Fill the node
   for (unsigned int i = 0 ; i < input.Size() ; i++)
     {
@@ -129,20 +190,27 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
   // terminate node
   x[input.Size()].index = -1;
   x[input.Size()].value = 0;
+}
+
+template <class TInputValue, class TOutputValue>
+typename LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::TargetSampleType
+LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::PredictNodes(const struct svm_node * x, double * prob_estimates, ConfidenceValueType *quality) const
+{
+  TargetSampleType target;
+  target.Fill(0);
+
+  // Get type and number of classes
+  int svm_type = svm_get_svm_type(m_Model);
 
   if (quality != ITK_NULLPTR)
     {
-    if (!this->m_ConfidenceIndex)
-      {
-      itkExceptionMacro("Confidence index not available for this classifier !");
-      }
     if (this->m_ConfidenceMode == CM_INDEX)
       {
       if (svm_type == C_SVC || svm_type == NU_SVC)
         {
-        // Eventually allocate space for probabilities
         unsigned int nr_class = svm_get_nr_class(m_Model);
-        double *prob_estimates = new double[nr_class];
         // predict
         target[0] = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, prob_estimates));
         double maxProb = 0.0;
@@ -160,8 +228,6 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
             }
           }
         (*quality) = static_cast<ConfidenceValueType>(maxProb - secProb);
-
-        delete[] prob_estimates;
         }
       else
         {
@@ -187,10 +253,7 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
     // which gives different results than svm_predict()
     if (svm_check_probability_model(m_Model))
       {
-      unsigned int nr_class = svm_get_nr_class(m_Model);
-      double *prob_estimates = new double[nr_class];
       target[0] = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, prob_estimates));
-      delete[] prob_estimates;
       }
     else
       {
@@ -198,9 +261,6 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
       }
     }
 
-  // Free allocated memory
-  delete[] x;
-
   return target;
 }
 
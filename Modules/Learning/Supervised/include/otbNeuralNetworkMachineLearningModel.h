@@ -24,6 +24,8 @@
 #include "otbRequiresOpenCVCheck.h"
 #include "otbOpenCVUtils.h"
 
+#include <vector>
+
 #include "itkLightObject.h"
 #include "itkFixedArray.h"
 #include "otbMachineLearningModel.h"
@@ -48,6 +50,9 @@ public:
   typedef typename Superclass::TargetSampleType           TargetSampleType;
   typedef typename Superclass::TargetListSampleType       TargetListSampleType;
   typedef typename Superclass::ConfidenceValueType        ConfidenceValueType;
+  typedef typename Superclass::ConfidenceSampleType       ConfidenceSampleType;
+  typedef typename Superclass::ConfidenceListSampleType   ConfidenceListSampleType;
+  typedef typename Superclass::SampleStoreType            SampleStoreType;
 
   typedef std::map<TargetValueType, unsigned int>         MapOfLabelsType;
 
@@ -152,6 +157,30 @@ public:
   itkGetMacro(Epsilon, double);
   itkSetMacro(Epsilon, double);
 
+  /** Number of samples of the training batches. If not null, the
+   *  network is trained by mini-batches instead of on all the samples at
+   *  once: at each epoch, the samples are shuffled and the weights are
+   *  updated batch by batch, with at most BatchMaxIter iterations per
+   *  batch. This bounds the memory used by OpenCV. Note that the input
+   *  scaling of the network is estimated on the first batch.
+   * default is 0 (no batch)
+   */
+  itkGetMacro(BatchSize, unsigned long);
+  itkSetMacro(BatchSize, unsigned long);
+
+  /** Number of passes over all the batches when training by batches.
+   * default is 10
+   */
+  itkGetMacro(NumberOfEpochs, unsigned int);
+  itkSetMacro(NumberOfEpochs, unsigned int);
+
+  /** Maximum number of iterations on each batch when training by
+   * batches, replacing MaxIter in the termination criteria.
+   * default is 5
+   */
+  itkGetMacro(BatchMaxIter, int);
+  itkSetMacro(BatchMaxIter, int);
+
   /** Train the machine learning model */
   void Train() ITK_OVERRIDE;
 
@@ -179,9 +208,24 @@ protected:
 
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType *quality=ITK_NULLPTR) const ITK_OVERRIDE;
+
+  /** Predict a range of samples at once */
+  void DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality = ITK_NULLPTR) const ITK_OVERRIDE;
   
   void LabelsToMat(const TargetListSampleType * listSample, cv::Mat & output);
 
+  /** Build the map of labels from the labels of the training samples,
+   *  read from the sample store if it is used */
+  void BuildMapOfLabels();
+
+  /** Labels of nbSamples training samples of the given ids (the first
+   *  ones if ids is null), as a matrix of responses of the network (one
+   *  column per class in classification) */
+  void TrainingLabelsToMat(const unsigned long * ids, unsigned long nbSamples, cv::Mat & output) const;
+
+  /** Features of the training samples of the given ids */
+  void TrainingSamplesToMat(const std::vector<unsigned long> & ids, cv::Mat & output) const;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
@@ -191,10 +235,18 @@ private:
 
   void CreateNetwork();
   void SetupNetworkAndTrain(cv::Mat& labels);
+  /** Train the created network on some samples, with at most maxIter
+   *  iterations */
+  void TrainNetwork(const cv::Mat& samples, const cv::Mat& labels, bool updateWeights,
+                    int termCriteriaType, int maxIter);
+  /** Train the network batch by batch */
+  void TrainByBatches();
+  /** Convert a row of network responses to a label (highest response) */
+  TargetSampleType ResponseToTarget(const float * response, ConfidenceValueType *quality) const;
 #ifdef OTB_OPENCV_3
   cv::Ptr<cv::ml::ANN_MLP> m_ANNModel;
 #else
-  CvANN_MLP_TrainParams SetNetworkParameters();
+  CvANN_MLP_TrainParams SetNetworkParameters(int termCriteriaType, int maxIter);
   CvANN_MLP * m_ANNModel;
 #endif
   int m_TrainMethod;
@@ -209,6 +261,9 @@ private:
   int m_TermCriteriaType;
   int m_MaxIter;
   double m_Epsilon;
+  unsigned long m_BatchSize;
+  unsigned int m_NumberOfEpochs;
+  int m_BatchMaxIter;
 
   CvMat*             m_CvMatOfLabels;
   MapOfLabelsType    m_MapOfLabels;
@@ -21,9 +21,11 @@
 #ifndef otbNeuralNetworkMachineLearningModel_txx
 #define otbNeuralNetworkMachineLearningModel_txx
 
+#include <algorithm>
 #include <fstream>
 #include "otbNeuralNetworkMachineLearningModel.h"
 #include "itkMacro.h" // itkExceptionMacro
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 
 namespace otb
 {
@@ -47,10 +49,14 @@ NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::NeuralNetworkMachi
   m_TermCriteriaType(CV_TERMCRIT_ITER + CV_TERMCRIT_EPS),
   m_MaxIter(1000),
   m_Epsilon(0.01),
+  m_BatchSize(0),
+  m_NumberOfEpochs(10),
+  m_BatchMaxIter(5),
   m_CvMatOfLabels(ITK_NULLPTR)
 {
   this->m_ConfidenceIndex = true;
   this->m_IsRegressionSupported = true;
+  this->m_IsSampleStoreSupported = true;
 }
 
 template<class TInputValue, class TOutputValue>
@@ -144,6 +150,89 @@ void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::LabelsToMat(c
     }
 }
 
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::BuildMapOfLabels()
+{
+  m_MapOfLabels.clear();
+
+  const unsigned long nbSamples = this->GetNumberOfTrainingSamples();
+  for (unsigned long sampleIdx = 0; sampleIdx < nbSamples; ++sampleIdx)
+    {
+    const TargetValueType classLabel = this->GetTrainingLabel(sampleIdx);
+    if (m_MapOfLabels.count(classLabel) == 0)
+      {
+      m_MapOfLabels[classLabel] = -1;
+      }
+    }
+
+  const unsigned int nbClasses = m_MapOfLabels.size();
+  if (m_CvMatOfLabels)
+    {
+    cvReleaseMat(&m_CvMatOfLabels);
+    }
+  if (nbClasses == 0)
+    {
+    return;
+    }
+  m_CvMatOfLabels = cvCreateMat(1, nbClasses, CV_32SC1);
+
+  unsigned int itLabel = 0;
+  for (typename MapOfLabelsType::iterator itMapOfLabels = m_MapOfLabels.begin();
+       itMapOfLabels != m_MapOfLabels.end(); ++itMapOfLabels, ++itLabel)
+    {
+    itMapOfLabels->second = itLabel;
+    m_CvMatOfLabels->data.i[itLabel] = itMapOfLabels->first;
+    }
+}
+
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TrainingLabelsToMat(
+  const unsigned long * ids, unsigned long nbSamples, cv::Mat & output) const
+{
+  if (this->m_RegressionMode)
+    {
+    output.create(nbSamples, 1, CV_32FC1);
+    for (unsigned long i = 0; i < nbSamples; ++i)
+      {
+      output.at<float>(i, 0) = this->GetTrainingLabel(ids ? ids[i] : i);
+      }
+    return;
+    }
+
+  output.create(nbSamples, m_MapOfLabels.size(), CV_32FC1);
+  output.setTo(-m_Beta);
+  for (unsigned long i = 0; i < nbSamples; ++i)
+    {
+    output.at<float>(i, m_MapOfLabels.find(this->GetTrainingLabel(ids ? ids[i] : i))->second) = m_Beta;
+    }
+}
+
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TrainingSamplesToMat(
+  const std::vector<unsigned long> & ids, cv::Mat & output) const
+{
+  const unsigned int sampleSize = this->GetNumberOfTrainingFeatures();
+  output.create(ids.size(), sampleSize, CV_32FC1);
+
+  for (unsigned long i = 0; i < ids.size(); ++i)
+    {
+    float * row = output.ptr<float>(i);
+    if (this->UseTrainingSampleStore())
+      {
+      const InputValueType * sample = this->GetTrainingSampleStore()->GetSample(ids[i]);
+      std::copy(sample, sample + sampleSize, row);
+      }
+    else
+      {
+      const InputSampleType & sample = this->m_InputListSample->GetMeasurementVector(ids[i]);
+      for (unsigned int j = 0; j < sampleSize; ++j)
+        {
+        row[j] = static_cast<float>(sample[j]);
+        }
+      }
+    }
+}
+
 template<class TInputValue, class TOutputValue>
 void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::CreateNetwork()
 {
@@ -169,7 +258,7 @@ void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::CreateNetwork
 
 #ifndef OTB_OPENCV_3
 template<class TInputValue, class TOutputValue>
-CvANN_MLP_TrainParams NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::SetNetworkParameters()
+CvANN_MLP_TrainParams NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::SetNetworkParameters(int termCriteriaType, int maxIter)
 {
   CvANN_MLP_TrainParams params;
   params.train_method = m_TrainMethod;
@@ -177,7 +266,7 @@ CvANN_MLP_TrainParams NeuralNetworkMachineLearningModel<TInputValue, TOutputValu
   params.bp_moment_scale = m_BackPropMomentScale;
   params.rp_dw0 = m_RegPropDW0;
   params.rp_dw_min = m_RegPropDWMin;
-  CvTermCriteria term_crit = cvTermCriteria(m_TermCriteriaType, m_MaxIter, m_Epsilon);
+  CvTermCriteria term_crit = cvTermCriteria(termCriteriaType, maxIter, m_Epsilon);
   params.term_crit = term_crit;
   return params;
 }
@@ -186,12 +275,33 @@ CvANN_MLP_TrainParams NeuralNetworkMachineLearningModel<TInputValue, TOutputValu
 template<class TInputValue, class TOutputValue>
 void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::SetupNetworkAndTrain(cv::Mat& labels)
 {
-  //convert listsample to opencv matrix
+  //convert listsample to opencv matrix, or use the sample store
   cv::Mat samples;
-  otb::ListSampleToMat<InputListSampleType>(this->GetInputListSample(), samples);
+  if (this->UseTrainingSampleStore())
+    {
+    otb::SampleStoreToMat(this->GetTrainingSampleStore(), samples);
+    }
+  else
+    {
+    otb::ListSampleToMat<InputListSampleType>(this->GetInputListSample(), samples);
+    }
   this->CreateNetwork();
+  this->TrainNetwork(samples, labels, false, m_TermCriteriaType, m_MaxIter);
+}
+
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TrainNetwork(const cv::Mat& samples,
+                                                                                const cv::Mat& labels,
+                                                                                bool updateWeights,
+                                                                                int termCriteriaType,
+                                                                                int maxIter)
+{
 #ifdef OTB_OPENCV_3
   int flags = (this->m_RegressionMode ? 0 : cv::ml::ANN_MLP::NO_OUTPUT_SCALE);
+  if (updateWeights)
+    {
+    flags |= cv::ml::ANN_MLP::UPDATE_WEIGHTS;
+    }
   m_ANNModel->setTrainMethod(m_TrainMethod);
   m_ANNModel->setBackpropMomentumScale(m_BackPropMomentScale);
   m_ANNModel->setBackpropWeightScale(m_BackPropDWScale);
@@ -200,26 +310,102 @@ void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::SetupNetworkA
   m_ANNModel->setRpropDWMin(m_RegPropDWMin);
   //m_ANNModel->setRpropDWMinus( );
   //m_ANNModel->setRpropDWPlus( );
-  m_ANNModel->setTermCriteria(cv::TermCriteria(m_TermCriteriaType,m_MaxIter,m_Epsilon));
+  m_ANNModel->setTermCriteria(cv::TermCriteria(termCriteriaType,maxIter,m_Epsilon));
   m_ANNModel->train(cv::ml::TrainData::create(
     samples,
     cv::ml::ROW_SAMPLE,
     labels),
     flags);
 #else
-  CvANN_MLP_TrainParams params = this->SetNetworkParameters();
+  CvANN_MLP_TrainParams params = this->SetNetworkParameters(termCriteriaType, maxIter);
   //train the Neural network model
-  m_ANNModel->train(samples, labels, cv::Mat(), cv::Mat(), params);
+  m_ANNModel->train(samples, labels, cv::Mat(), cv::Mat(), params,
+                    updateWeights ? CvANN_MLP::UPDATE_WEIGHTS : 0);
 #endif
 }
 
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TrainByBatches()
+{
+  const unsigned long nbSamples = this->GetNumberOfTrainingSamples();
+  if (nbSamples == 0)
+    {
+    itkExceptionMacro(<< "No training sample");
+    }
+  if (m_NumberOfEpochs == 0)
+    {
+    itkExceptionMacro(<< "The number of epochs must be >= 1");
+    }
+
+  if (!this->m_RegressionMode)
+    {
+    this->BuildMapOfLabels();
+    }
+
+  // Visit the samples in a new random order at each epoch, reproducible
+  // from one run to the other, so that each batch holds samples of all
+  // the classes
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->SetSeed(121212);
+
+  std::vector<unsigned long> order(nbSamples);
+  for (unsigned long i = 0; i < nbSamples; ++i)
+    {
+    order[i] = i;
+    }
+
+  this->CreateNetwork();
+
+  // Each batch only moves the weights a few iterations towards its own
+  // optimum, the whole training set being visited at each epoch
+  const int batchTermCriteriaType = m_TermCriteriaType | CV_TERMCRIT_ITER;
+
+  std::vector<unsigned long> ids;
+  cv::Mat samples;
+  cv::Mat labels;
+  bool updateWeights = false;
+  for (unsigned int epoch = 0; epoch < m_NumberOfEpochs; ++epoch)
+    {
+    for (unsigned long i = nbSamples - 1; i > 0; --i)
+      {
+      std::swap(order[i], order[generator->GetIntegerVariate(i)]);
+      }
+
+    for (unsigned long start = 0; start < nbSamples; start += m_BatchSize)
+      {
+      const unsigned long end = std::min(nbSamples, start + m_BatchSize);
+      ids.assign(order.begin() + start, order.begin() + end);
+      this->TrainingSamplesToMat(ids, samples);
+      this->TrainingLabelsToMat(&ids[0], ids.size(), labels);
+      this->TrainNetwork(samples, labels, updateWeights, batchTermCriteriaType, m_BatchMaxIter);
+      updateWeights = true;
+      }
+    }
+}
+
 /** Train the machine learning model for classification*/
 template<class TInputValue, class TOutputValue>
 void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::Train()
 {
+  if (m_BatchSize > 0)
+    {
+    this->TrainByBatches();
+    return;
+    }
+
   //Transform the targets into a matrix of labels
   cv::Mat matOutputANN;
-  if (this->m_RegressionMode)
+  if (this->UseTrainingSampleStore())
+    {
+    if (!this->m_RegressionMode)
+      {
+      // MODE CLASSIFICATION : store the map between internal labels and output labels
+      this->BuildMapOfLabels();
+      }
+    this->TrainingLabelsToMat(ITK_NULLPTR, this->GetTrainingSampleStore()->Size(), matOutputANN);
+    }
+  else if (this->m_RegressionMode)
     {
     // MODE REGRESSION
     otb::ListSampleToMat<TargetListSampleType>(this->GetTargetListSample(), matOutputANN);
@@ -236,7 +422,6 @@ template<class TInputValue, class TOutputValue>
 typename NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TargetSampleType NeuralNetworkMachineLearningModel<
   TInputValue, TOutputValue>::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
 {
-  TargetSampleType target;
   //convert listsample to Mat
   cv::Mat sample;
 
@@ -245,8 +430,56 @@ typename NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TargetSam
   cv::Mat response; //(1, 1, CV_32FC1);
   m_ANNModel->predict(sample, response);
 
+  return this->ResponseToTarget(response.ptr<float>(0), quality);
+}
+
+template<class TInputValue, class TOutputValue>
+void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::DoPredictBatch(const InputListSampleType * input,
+  const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+  // One forward pass of the network on the whole range
+  cv::Mat responses;
+  m_ANNModel->predict(samples, responses);
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    if (quality != ITK_NULLPTR)
+      {
+      ConfidenceValueType confidence = 0;
+      targets->SetMeasurementVector(startIndex + i, this->ResponseToTarget(responses.ptr<float>(i), &confidence));
+      ConfidenceSampleType confidenceSample;
+      confidenceSample[0] = confidence;
+      quality->SetMeasurementVector(startIndex + i, confidenceSample);
+      }
+    else
+      {
+      targets->SetMeasurementVector(startIndex + i, this->ResponseToTarget(responses.ptr<float>(i), ITK_NULLPTR));
+      }
+    }
+}
+
+template<class TInputValue, class TOutputValue>
+typename NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TargetSampleType NeuralNetworkMachineLearningModel<
+  TInputValue, TOutputValue>::ResponseToTarget(const float * response, ConfidenceValueType *quality) const
+{
+  TargetSampleType target;
+
   float currentResponse = 0;
-  float maxResponse = response.at<float> (0, 0);
+  float maxResponse = response[0];
 
   if (this->m_RegressionMode)
     {
@@ -262,7 +495,7 @@ typename NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::TargetSam
   unsigned int nbClasses = m_CvMatOfLabels->cols;
   for (unsigned itLabel = 1; itLabel < nbClasses; ++itLabel)
     {
-    currentResponse = response.at<float> (0, itLabel);
+    currentResponse = response[itLabel];
     if (currentResponse > maxResponse)
       {
       secondResponse = maxResponse;
@@ -402,6 +635,9 @@ void NeuralNetworkMachineLearningModel<TInputValue, TOutputValue>::PrintSelf(std
 {
   // Call superclass implementation
   Superclass::PrintSelf(os, indent);
+  os << indent << "BatchSize: " << m_BatchSize << std::endl;
+  os << indent << "NumberOfEpochs: " << m_NumberOfEpochs << std::endl;
+  os << indent << "BatchMaxIter: " << m_BatchMaxIter << std::endl;
 }
 
 } //end namespace otb
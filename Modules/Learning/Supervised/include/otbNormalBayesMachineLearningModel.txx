@@ -38,6 +38,8 @@ NormalBayesMachineLearningModel<TInputValue,TOutputValue>
  m_NormalBayesModel (new CvNormalBayesClassifier)
 #endif 
 {
+  // OpenCV already spreads the prediction of a batch on several threads
+  this->m_IsDoPredictBatchMultiThreaded = true;
 }
 
 
@@ -110,6 +112,47 @@ NormalBayesMachineLearningModel<TInputValue,TOutputValue>
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+NormalBayesMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  if (quality != ITK_NULLPTR && !this->HasConfidenceIndex())
+    {
+    itkExceptionMacro("Confidence index not available for this classifier !");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+#ifdef OTB_OPENCV_3
+  cv::Mat results;
+  m_NormalBayesModel->predict(samples, results);
+#else
+  cv::Mat results(size, 1, CV_32FC1);
+  m_NormalBayesModel->predict(samples, &results);
+#endif
+  results.convertTo(results, CV_32F);
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+    target[0] = static_cast<TOutputValue>(results.at<float>(i, 0));
+    targets->SetMeasurementVector(startIndex + i, target);
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 NormalBayesMachineLearningModel<TInputValue,TOutputValue>
@@ -41,11 +41,14 @@
 #include <opencv2/ml/ml.hpp>
 #endif
 
+#include <limits>
+
 #include "otb_opencv_api.h"
 
 #include "OTBSupervisedExport.h"
 
 #include "itkListSample.h"
+#include "otbDenseSampleStore.h"
 
 #ifdef OTB_OPENCV_3
 #define CV_TYPE_NAME_ML_SVM         "opencv-ml-svm"
@@ -117,6 +120,82 @@ namespace otb
       }
   }
 
+  /** Converts the samples [startIndex, startIndex+size[ of a ListSample to a
+   *  cv::Mat, one sample per row */
+  template <class T> void ListSampleRangeToMat(const T * listSample, cv::Mat & output,
+                                               unsigned int startIndex, unsigned int size) {
+    const unsigned int sampleSize = listSample->GetMeasurementVectorSize();
+
+    output.create(size,sampleSize,CV_32FC1);
+
+    for(unsigned int sampleIdx = 0; sampleIdx < size; ++sampleIdx)
+      {
+      const typename T::MeasurementVectorType & sample =
+        listSample->GetMeasurementVector(startIndex + sampleIdx);
+      float * row = output.ptr<float>(sampleIdx);
+
+      for(unsigned int i = 0; i < sampleSize; ++i)
+        {
+        row[i] = static_cast<float>(sample[i]);
+        }
+      }
+  }
+
+  /** Converts the samples [startIndex, startIndex+size[ of a
+   *  DenseSampleStore to a cv::Mat, one sample per row. If the store
+   *  holds float values, the matrix uses the memory of the store without
+   *  copying it: the store must then outlive the matrix and must not be
+   *  modified while the matrix is used. */
+  template <class TInputValue, class TTargetValue>
+  void SampleStoreRangeToMat(const DenseSampleStore<TInputValue, TTargetValue> * store, cv::Mat & output,
+                             unsigned long startIndex, unsigned long size) {
+    const unsigned int sampleSize = store->GetNumberOfFeatures();
+
+    if (size == 0 || sampleSize == 0)
+      {
+      output.release();
+      return;
+      }
+
+    if (sizeof(TInputValue) == sizeof(float) && std::numeric_limits<TInputValue>::is_iec559)
+      {
+      output = cv::Mat(size, sampleSize, CV_32FC1,
+                       const_cast<TInputValue *>(store->GetSample(startIndex)));
+      return;
+      }
+
+    output.create(size,sampleSize,CV_32FC1);
+
+    for(unsigned long sampleIdx = 0; sampleIdx < size; ++sampleIdx)
+      {
+      const TInputValue * sample = store->GetSample(startIndex + sampleIdx);
+      float * row = output.ptr<float>(sampleIdx);
+
+      for(unsigned int i = 0; i < sampleSize; ++i)
+        {
+        row[i] = static_cast<float>(sample[i]);
+        }
+      }
+  }
+
+  /** Converts all the samples of a DenseSampleStore to a cv::Mat (see
+   *  SampleStoreRangeToMat) */
+  template <class TInputValue, class TTargetValue>
+  void SampleStoreToMat(const DenseSampleStore<TInputValue, TTargetValue> * store, cv::Mat & output) {
+    SampleStoreRangeToMat(store, output, 0, store->Size());
+  }
+
+  /** Converts the labels of a DenseSampleStore to a cv::Mat of one column */
+  template <class TInputValue, class TTargetValue>
+  void SampleStoreLabelsToMat(const DenseSampleStore<TInputValue, TTargetValue> * store, cv::Mat & output) {
+    output.create(store->Size(),1,CV_32FC1);
+
+    for(unsigned long sampleIdx = 0; sampleIdx < store->Size(); ++sampleIdx)
+      {
+      output.at<float>(sampleIdx,0) = static_cast<float>(store->GetLabel(sampleIdx));
+      }
+  }
+
   template <typename T> void ListSampleToMat(typename T::Pointer listSample, cv::Mat & output) {
     return ListSampleToMat(listSample.GetPointer(), output);
   }
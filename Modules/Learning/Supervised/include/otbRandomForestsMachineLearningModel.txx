@@ -193,6 +193,56 @@ RandomForestsMachineLearningModel<TInputValue,TOutputValue>
   return target[0];
 }
 
+template <class TInputValue, class TOutputValue>
+void
+RandomForestsMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+#ifdef OTB_OPENCV_3
+  cv::Mat results;
+  m_RFModel->predict(samples, results);
+  results.convertTo(results, CV_32F);
+#endif
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    // row() only builds a header on the batch matrix, no copy is done
+    const cv::Mat sample = samples.row(i);
+
+    TargetSampleType target;
+#ifdef OTB_OPENCV_3
+    target[0] = static_cast<TOutputValue>(results.at<float>(i, 0));
+#else
+    target[0] = static_cast<TOutputValue>(m_RFModel->predict(sample));
+#endif
+    targets->SetMeasurementVector(startIndex + i, target);
+
+    if (quality != ITK_NULLPTR)
+      {
+      ConfidenceSampleType confidence;
+      if(m_ComputeMargin)
+        confidence[0] = m_RFModel->predict_margin(sample);
+      else
+        confidence[0] = m_RFModel->predict_confidence(sample);
+      quality->SetMeasurementVector(startIndex + i, confidence);
+      }
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 RandomForestsMachineLearningModel<TInputValue,TOutputValue>
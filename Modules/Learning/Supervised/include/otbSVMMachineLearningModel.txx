@@ -58,6 +58,10 @@ SVMMachineLearningModel<TInputValue,TOutputValue>
 {
   this->m_ConfidenceIndex = true;
   this->m_IsRegressionSupported = true;
+#ifdef OTB_OPENCV_3
+  // OpenCV already spreads the prediction of a batch on several threads
+  this->m_IsDoPredictBatchMultiThreaded = true;
+#endif
 }
 
 
@@ -201,6 +205,56 @@ SVMMachineLearningModel<TInputValue,TOutputValue>
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+SVMMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * targets, ConfidenceListSampleType * quality) const
+{
+  assert(input != ITK_NULLPTR);
+  assert(targets != ITK_NULLPTR);
+
+  assert(input->Size()==targets->Size()&&"Input sample list and target label list do not have the same size.");
+  assert(((quality==ITK_NULLPTR)||(quality->Size()==input->Size()))&&"Quality samples list is not null and does not have the same size as input samples list");
+
+  if(startIndex+size>input->Size())
+    {
+    itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
+    }
+
+  cv::Mat samples;
+  otb::ListSampleRangeToMat(input, samples, startIndex, size);
+
+  cv::Mat results;
+  m_SVMModel->predict(samples, results);
+  results.convertTo(results, CV_32F);
+
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+    target[0] = static_cast<TOutputValue>(results.at<float>(i, 0));
+    targets->SetMeasurementVector(startIndex + i, target);
+    }
+
+  if (quality != ITK_NULLPTR)
+    {
+#ifdef OTB_OPENCV_3
+    cv::Mat raw;
+    m_SVMModel->predict(samples, raw, cv::ml::StatModel::RAW_OUTPUT);
+    raw.convertTo(raw, CV_32F);
+#endif
+    for (unsigned int i = 0; i < size; ++i)
+      {
+      ConfidenceSampleType confidence;
+#ifdef OTB_OPENCV_3
+      confidence[0] = static_cast<ConfidenceValueType>(raw.at<float>(i, 0));
+#else
+      confidence[0] = static_cast<ConfidenceValueType>(m_SVMModel->predict(samples.row(i), true));
+#endif
+      quality->SetMeasurementVector(startIndex + i, confidence);
+      }
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 SVMMachineLearningModel<TInputValue,TOutputValue>
@@ -77,6 +77,7 @@ public:
   typedef typename Superclass::ConfidenceValueType        ConfidenceValueType;
   typedef typename Superclass::ConfidenceSampleType       ConfidenceSampleType;
   typedef typename Superclass::ConfidenceListSampleType   ConfidenceListSampleType;
+  typedef typename Superclass::SampleStoreType            SampleStoreType;
   
   /** Run-time type information (and related methods). */
   itkNewMacro(Self);
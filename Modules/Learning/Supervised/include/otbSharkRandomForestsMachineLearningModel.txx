@@ -52,6 +52,7 @@ SharkRandomForestsMachineLearningModel<TInputValue,TOutputValue>
   this->m_ConfidenceIndex = true;
   this->m_IsRegressionSupported = false;
   this->m_IsDoPredictBatchMultiThreaded = true;
+  this->m_IsSampleStoreSupported = true;
 }
 
 
@@ -74,8 +75,17 @@ SharkRandomForestsMachineLearningModel<TInputValue,TOutputValue>
   std::vector<shark::RealVector> features;
   std::vector<unsigned int> class_labels;
 
-  Shark::ListSampleToSharkVector(this->GetInputListSample(), features);
-  Shark::ListSampleToSharkVector(this->GetTargetListSample(), class_labels);
+  if (this->UseTrainingSampleStore())
+    {
+    const SampleStoreType * store = this->GetTrainingSampleStore();
+    Shark::SampleStoreRangeToSharkVector(store, features, 0, store->Size());
+    Shark::SampleStoreRangeToSharkVector(store, class_labels, 0, store->Size());
+    }
+  else
+    {
+    Shark::ListSampleToSharkVector(this->GetInputListSample(), features);
+    Shark::ListSampleToSharkVector(this->GetTargetListSample(), class_labels);
+    }
   shark::ClassificationDataset TrainSamples = shark::createLabeledDataFromRange(features,class_labels);
 
   //Set parameters
@@ -46,6 +46,24 @@ typedef MachineLearningModelRegressionType::TargetListSampleType TargetListSampl
 
 typedef otb::ConfusionMatrixCalculator<TargetListSampleType, TargetListSampleType> ConfusionMatrixCalculatorType;
 
+// Check that batch prediction gives the same labels as sample by sample prediction
+bool CheckBatchPrediction(const MachineLearningModelType * classifier,
+                          const InputListSampleType * samples,
+                          const TargetListSampleType * predicted)
+{
+  for (unsigned int i = 0; i < samples->Size(); ++i)
+    {
+    const TargetValueType label = classifier->Predict(samples->GetMeasurementVector(i))[0];
+    if (label != predicted->GetMeasurementVector(i)[0])
+      {
+      std::cout << "Batch prediction of sample " << i << " (" << predicted->GetMeasurementVector(i)[0]
+                << ") differs from single prediction (" << label << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
 bool ReadDataFile(const std::string & infname, InputListSampleType * samples, TargetListSampleType * labels)
 {
   std::ifstream ifs;
@@ -218,6 +236,11 @@ int otbLibSVMMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
 
   cmCalculator->SetProducedLabels(predicted);
@@ -307,6 +330,11 @@ int otbSVMMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   classifier->Save(argv[2]);
 
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
@@ -454,6 +482,11 @@ int otbKNearestNeighborsMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
 
   cmCalculator->SetProducedLabels(predicted);
@@ -541,6 +574,11 @@ int otbRandomForestsMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
 
   cmCalculator->SetProducedLabels(predicted);
@@ -625,6 +663,11 @@ int otbBoostMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   classifier->Save(argv[2]);
 
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
@@ -715,6 +758,11 @@ int otbANNMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
 
   cmCalculator->SetProducedLabels(predicted);
@@ -792,6 +840,11 @@ int otbNormalBayesMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   classifier->Save(argv[2]);
 
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
@@ -869,6 +922,11 @@ int otbDecisionTreeMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   classifier->Save(argv[2]);
 
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
@@ -947,6 +1005,11 @@ int otbGradientBoostedTreeMachineLearningModel(int argc, char * argv[])
 
   TargetListSampleType::Pointer predicted = classifier->PredictBatch(samples, NULL);
 
+  if (!CheckBatchPrediction(classifier, samples, predicted))
+    {
+    return EXIT_FAILURE;
+    }
+
   classifier->Save(argv[2]);
 
   ConfusionMatrixCalculatorType::Pointer cmCalculator = ConfusionMatrixCalculatorType::New();
@@ -80,6 +80,7 @@ public:
   typedef typename Superclass::ConfidenceValueType        ConfidenceValueType;
   typedef typename Superclass::ConfidenceSampleType       ConfidenceSampleType;
   typedef typename Superclass::ConfidenceListSampleType   ConfidenceListSampleType;
+  typedef typename Superclass::SampleStoreType            SampleStoreType;
 
 
   typedef shark::HardClusteringModel<shark::RealVector>   ClusteringModelType;
@@ -121,6 +122,14 @@ public:
   itkGetMacro( Normalized, bool );
   itkSetMacro( Normalized, bool );
 
+  /** Number of samples of the batches of the mini-batch kMeans. If not
+   *  null, the centroids are updated batch by batch on samples visited
+   *  in a random order, the number of iterations being the number of
+   *  passes over the samples (at least one), and the samples are not copied. If null
+   *  (default), the shark kMeans runs on a copy of all the samples. */
+  itkGetMacro( BatchSize, unsigned long );
+  itkSetMacro( BatchSize, unsigned long );
+
 protected:
   /** Constructor */
   SharkKMeansMachineLearningModel();
@@ -139,6 +148,12 @@ protected:
   template<typename DataType>
   DataType NormalizeData(const DataType &data) const;
 
+  /** Mini-batch kMeans */
+  void TrainByBatches();
+
+  /** Copy a training sample, from the sample store if it is used */
+  void GetTrainingSample(unsigned long id, shark::RealVector &sample) const;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream &os, itk::Indent indent) const;
 
@@ -150,6 +165,7 @@ private:
   bool m_Normalized;
   unsigned int m_K;
   unsigned int m_MaximumNumberOfIterations;
+  unsigned long m_BatchSize;
   bool m_CanRead;
 
 
@@ -20,9 +20,13 @@
 #ifndef otbSharkKMeansMachineLearningModel_txx
 #define otbSharkKMeansMachineLearningModel_txx
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include "boost/make_shared.hpp"
 #include "itkMacro.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "otbSharkKMeansMachineLearningModel.h"
 
 #if defined(__GNUC__) || defined(__clang__)
@@ -52,8 +56,10 @@ namespace otb
 template<class TInputValue, class TOutputValue>
 SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
 ::SharkKMeansMachineLearningModel() :
-        m_Normalized( false ), m_K(2), m_MaximumNumberOfIterations( 10 )
+        m_Normalized( false ), m_K(2), m_MaximumNumberOfIterations( 10 ), m_BatchSize( 0 )
 {
+  this->m_IsSampleStoreSupported = true;
+
   // Default set HardClusteringModel
   m_ClusteringModel = boost::make_shared<ClusteringModelType>( &m_Centroids );
 }
@@ -71,9 +77,24 @@ void
 SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
 ::Train()
 {
+  if( m_BatchSize > 0 )
+    {
+    TrainByBatches();
+    m_ClusteringModel = boost::make_shared<ClusteringModelType>( &m_Centroids );
+    return;
+    }
+
   // Parse input data and convert to Shark Data
   std::vector<shark::RealVector> vector_data;
-  otb::Shark::ListSampleToSharkVector( this->GetInputListSample(), vector_data );
+  if( this->UseTrainingSampleStore() )
+    {
+    const SampleStoreType * store = this->GetTrainingSampleStore();
+    otb::Shark::SampleStoreRangeToSharkVector( store, vector_data, 0, store->Size() );
+    }
+  else
+    {
+    otb::Shark::ListSampleToSharkVector( this->GetInputListSample(), vector_data );
+    }
   shark::Data<shark::RealVector> data = shark::createDataFromRange( vector_data );
 
   // Normalized input value if necessary
@@ -85,6 +106,156 @@ SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
   m_ClusteringModel = boost::make_shared<ClusteringModelType>( &m_Centroids );
 }
 
+template<class TInputValue, class TOutputValue>
+void
+SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
+::GetTrainingSample(unsigned long id, shark::RealVector &sample) const
+{
+  const unsigned int nbFeatures = this->GetNumberOfTrainingFeatures();
+  sample.resize( nbFeatures );
+  if( this->UseTrainingSampleStore() )
+    {
+    const InputValueType * values = this->GetTrainingSampleStore()->GetSample( id );
+    std::copy( values, values + nbFeatures, sample.begin() );
+    }
+  else
+    {
+    const InputSampleType &values = this->m_InputListSample->GetMeasurementVector( id );
+    for( unsigned int i = 0; i < nbFeatures; ++i )
+      {
+      sample[i] = values[i];
+      }
+    }
+}
+
+template<class TInputValue, class TOutputValue>
+void
+SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
+::TrainByBatches()
+{
+  // Mini-batch kMeans (D. Sculley, Web-scale k-means clustering, 2010):
+  // each sample of a batch moves its nearest centroid, found before the
+  // update of the batch, with a learning rate decreasing with the
+  // number of samples assigned to the centroid.
+  const unsigned long nbSamples = this->GetNumberOfTrainingSamples();
+  const unsigned int nbFeatures = this->GetNumberOfTrainingFeatures();
+  if( nbSamples < m_K || m_K == 0 )
+    {
+    itkExceptionMacro( << "Not enough samples (" << nbSamples << ") for " << m_K << " clusters" );
+    }
+
+  shark::RealVector sample;
+
+  // Shift and scale of the features, as with the normalizer trained by
+  // NormalizeComponentsUnitVariance
+  shark::RealVector shifts( nbFeatures, 0. );
+  shark::RealVector scales( nbFeatures, 1. );
+  if( m_Normalized )
+    {
+    shark::RealVector sums( nbFeatures, 0. );
+    shark::RealVector squaredSums( nbFeatures, 0. );
+    for( unsigned long id = 0; id < nbSamples; ++id )
+      {
+      GetTrainingSample( id, sample );
+      for( unsigned int i = 0; i < nbFeatures; ++i )
+        {
+        sums[i] += sample[i];
+        squaredSums[i] += sample[i] * sample[i];
+        }
+      }
+    for( unsigned int i = 0; i < nbFeatures; ++i )
+      {
+      shifts[i] = sums[i] / nbSamples;
+      const double variance = std::max( 0., squaredSums[i] / nbSamples - shifts[i] * shifts[i] );
+      scales[i] = variance > 0. ? 1. / std::sqrt( variance ) : 0.;
+      }
+    }
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->SetSeed( 121212 );
+
+  std::vector<unsigned long> order( nbSamples );
+  for( unsigned long id = 0; id < nbSamples; ++id )
+    {
+    order[id] = id;
+    }
+
+  // The centroids are initialized with K distinct random samples
+  std::vector<shark::RealVector> centroids( m_K );
+  for( unsigned int k = 0; k < m_K; ++k )
+    {
+    std::swap( order[k], order[k + generator->GetIntegerVariate( nbSamples - 1 - k )] );
+    GetTrainingSample( order[k], sample );
+    centroids[k].resize( nbFeatures );
+    for( unsigned int i = 0; i < nbFeatures; ++i )
+      {
+      centroids[k][i] = ( sample[i] - shifts[i] ) * scales[i];
+      }
+    }
+
+  std::vector<unsigned long> counts( m_K, 0 );
+  std::vector<shark::RealVector> batch;
+  std::vector<unsigned int> assignments;
+
+  // An unlimited number of iterations has no meaning here: a single
+  // pass is done
+  const unsigned int nbPasses = std::max( 1U, m_MaximumNumberOfIterations );
+  for( unsigned int iteration = 0; iteration < nbPasses; ++iteration )
+    {
+    for( unsigned long id = nbSamples - 1; id > 0; --id )
+      {
+      std::swap( order[id], order[generator->GetIntegerVariate( id )] );
+      }
+
+    for( unsigned long start = 0; start < nbSamples; start += m_BatchSize )
+      {
+      const unsigned long end = std::min( nbSamples, start + m_BatchSize );
+      batch.resize( end - start );
+      assignments.resize( end - start );
+
+      for( unsigned long b = 0; b < end - start; ++b )
+        {
+        GetTrainingSample( order[start + b], sample );
+        batch[b].resize( nbFeatures );
+        for( unsigned int i = 0; i < nbFeatures; ++i )
+          {
+          batch[b][i] = ( sample[i] - shifts[i] ) * scales[i];
+          }
+
+        double bestDistance = std::numeric_limits<double>::max();
+        for( unsigned int k = 0; k < m_K; ++k )
+          {
+          double distance = 0.;
+          for( unsigned int i = 0; i < nbFeatures; ++i )
+            {
+            const double diff = batch[b][i] - centroids[k][i];
+            distance += diff * diff;
+            }
+          if( distance < bestDistance )
+            {
+            bestDistance = distance;
+            assignments[b] = k;
+            }
+          }
+        }
+
+      for( unsigned long b = 0; b < end - start; ++b )
+        {
+        const unsigned int k = assignments[b];
+        ++counts[k];
+        const double rate = 1. / counts[k];
+        for( unsigned int i = 0; i < nbFeatures; ++i )
+          {
+          centroids[k][i] += rate * ( batch[b][i] - centroids[k][i] );
+          }
+        }
+      }
+    }
+
+  m_Centroids.setCentroids( shark::createDataFromRange( centroids ) );
+}
+
 template<class TInputValue, class TOutputValue>
 template<typename DataType>
 DataType
@@ -252,6 +423,7 @@ SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
 {
   // Call superclass implementation
   Superclass::PrintSelf( os, indent );
+  os << indent << "BatchSize: " << m_BatchSize << std::endl;
 }
 } //end namespace otb
 
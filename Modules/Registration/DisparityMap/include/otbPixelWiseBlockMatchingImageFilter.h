@@ -215,6 +215,11 @@ public:
       }
     }
 
+  double GetP() const
+    {
+    return m_P;
+    }
+
   // Implement the Lp metric
   inline MetricValueType operator()(ConstNeighborhoodIteratorType & a, ConstNeighborhoodIteratorType & b) const
   {
@@ -234,6 +239,131 @@ private:
   double m_P;
 };
 
+/** \class BlockMatchingBoxSums
+ *  \brief Decomposition of a block-matching metric into window sums
+ *
+ *  Some block-matching metrics only depend on the sums, over the block,
+ *  of terms computed independently at each pixel from the left and right
+ *  values. For those metrics, the PixelWiseBlockMatchingImageFilter can
+ *  compute the block sums with running sums, at a cost which does not
+ *  depend on the block radius (see SetUseBoxFiltering()).
+ *
+ *  This default version is used for the metrics which can not be
+ *  decomposed. It is specialized for SSDBlockMatching, NCCBlockMatching
+ *  and LPBlockMatching.
+ *
+ * \ingroup OTBDisparityMap
+ */
+template <class TBlockMatchingFunctor>
+class BlockMatchingBoxSums
+{
+public:
+  /** Can the metric be computed from block sums */
+  static const bool IsDecomposable = false;
+
+  /** Number of terms summed over the block */
+  static const unsigned int NumberOfTerms = 1;
+
+  /** Compute the terms of a pixel from the left and right values */
+  static inline void ComputeTerms(const TBlockMatchingFunctor &, double, double, double * terms)
+  {
+    terms[0] = 0.;
+  }
+
+  /** Compute the metric from the block sums of the terms and the number
+   *  of pixels in the block */
+  static inline double Evaluate(const TBlockMatchingFunctor &, const double *, double)
+  {
+    return 0.;
+  }
+};
+
+/** SSD: sum of (a-b)^2 */
+template <class TInputImage, class TOutputMetricImage>
+class BlockMatchingBoxSums<SSDBlockMatching<TInputImage,TOutputMetricImage> >
+{
+public:
+  static const bool IsDecomposable = true;
+  static const unsigned int NumberOfTerms = 1;
+
+  static inline void ComputeTerms(const SSDBlockMatching<TInputImage,TOutputMetricImage> &,
+                                  double a, double b, double * terms)
+  {
+    terms[0] = (a-b)*(a-b);
+  }
+
+  static inline double Evaluate(const SSDBlockMatching<TInputImage,TOutputMetricImage> &,
+                                const double * sums, double)
+  {
+    return sums[0];
+  }
+};
+
+/** Lp pseudo-norm: sum of |a-b|^p */
+template <class TInputImage, class TOutputMetricImage>
+class BlockMatchingBoxSums<LPBlockMatching<TInputImage,TOutputMetricImage> >
+{
+public:
+  static const bool IsDecomposable = true;
+  static const unsigned int NumberOfTerms = 1;
+
+  static inline void ComputeTerms(const LPBlockMatching<TInputImage,TOutputMetricImage> & functor,
+                                  double a, double b, double * terms)
+  {
+    terms[0] = vcl_pow(vcl_abs(a-b), functor.GetP());
+  }
+
+  static inline double Evaluate(const LPBlockMatching<TInputImage,TOutputMetricImage> &,
+                                const double * sums, double)
+  {
+    return sums[0];
+  }
+};
+
+/** NCC: sums of a, b, a^2, b^2 and ab */
+template <class TInputImage, class TOutputMetricImage>
+class BlockMatchingBoxSums<NCCBlockMatching<TInputImage,TOutputMetricImage> >
+{
+public:
+  static const bool IsDecomposable = true;
+  static const unsigned int NumberOfTerms = 5;
+
+  static inline void ComputeTerms(const NCCBlockMatching<TInputImage,TOutputMetricImage> &,
+                                  double a, double b, double * terms)
+  {
+    terms[0] = a;
+    terms[1] = b;
+    terms[2] = a*a;
+    terms[3] = b*b;
+    terms[4] = a*b;
+  }
+
+  static inline double Evaluate(const NCCBlockMatching<TInputImage,TOutputMetricImage> &,
+                                const double * sums, double size)
+  {
+    // Centered sums. Variances lost in the rounding of the sums of
+    // squares are considered null, as for a constant block.
+    double sigmaA = sums[2] - sums[0]*sums[0]/size;
+    double sigmaB = sums[3] - sums[1]*sums[1]/size;
+    double cov = sums[4] - sums[0]*sums[1]/size;
+
+    if(sigmaA <= 1e-12 * sums[2] || sigmaB <= 1e-12 * sums[3])
+      {
+      return 0.;
+      }
+
+    cov/=size-1;
+    sigmaA = vcl_sqrt(sigmaA/(size-1));
+    sigmaB = vcl_sqrt(sigmaB/(size-1));
+
+    if(sigmaA > 1e-20 && sigmaB > 1e-20)
+      {
+      return vcl_abs(cov)/(sigmaA*sigmaB);
+      }
+    return 0.;
+  }
+};
+
 } // End Namespace Functor
 
 /** \class PixelWiseBlockMatchingImageFilter
@@ -278,6 +408,14 @@ private:
  *  metric value and a disparity corresponding to the minimum allowed
  *  disparity.
  *
+ *  When the metric can be computed from sums over the block of per-pixel
+ *  terms (see Functor::BlockMatchingBoxSums), the UseBoxFiltering flag
+ *  enables a faster computation: for each disparity, the terms are
+ *  computed once per pixel and summed over the blocks with running sums,
+ *  so that the cost does not depend on the radius. Results may differ
+ *  from the direct computation by floating point rounding, so this is
+ *  off by default.
+ *
  *  The disparity exploration can also be reduced thanks to initial disparity
  *  maps. The user can provide initial disparity estimate (using the same image
  *  type and size as the output disparities), or global disparity values. Then
@@ -333,6 +471,8 @@ public:
 
   typedef itk::ConstNeighborhoodIterator<TInputImage>       ConstNeighborhoodIteratorType;
 
+  typedef Functor::BlockMatchingBoxSums<TBlockMatchingFunctor> BoxSumsType;
+
   /** Set left input */
   void SetLeftInput( const TInputImage * image);
 
@@ -394,6 +534,12 @@ public:
   itkGetConstReferenceMacro(Minimize,bool);
   itkBooleanMacro(Minimize);
 
+  /** Set/Get the use of running block sums, for the metrics which
+   *  support it (ignored otherwise) */
+  itkSetMacro(UseBoxFiltering, bool);
+  itkGetConstReferenceMacro(UseBoxFiltering, bool);
+  itkBooleanMacro(UseBoxFiltering);
+
   /** Set/Get the exploration radius in the disparity space */
   itkSetMacro(ExplorationRadius, SizeType);
   itkGetConstReferenceMacro(ExplorationRadius, SizeType);
@@ -465,6 +611,13 @@ private:
   PixelWiseBlockMatchingImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemeFnted
 
+  /** Threaded generate data, using running block sums */
+  void BoxFilteredThreadedGenerateData(const RegionType & outputRegionForThread, itk::ThreadIdType threadId);
+
+  /** Check if a disparity is in the exploration range of a pixel, given
+   *  its initial disparities */
+  bool IsExplored(int hdisparity, int vdisparity, DisparityPixelType initHDisp, DisparityPixelType initVDisp) const;
+
   /** The radius of the blocks */
   SizeType                      m_Radius;
 
@@ -489,6 +642,9 @@ private:
   /** Block-matching functor */
   BlockMatchingFunctorType      m_Functor;
 
+  /** Use running block sums if the metric supports it */
+  bool                          m_UseBoxFiltering;
+
   /** Initial horizontal disparity (0 by default, used if an exploration radius is set and if no input horizontal
     disparity map is given) */
   int                           m_InitHorizontalDisparity;
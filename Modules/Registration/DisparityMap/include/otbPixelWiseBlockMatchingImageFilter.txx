@@ -25,6 +25,9 @@
 #include "itkProgressReporter.h"
 #include "itkConstantBoundaryCondition.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace otb
 {
 template <class TInputImage, class TOutputMetricImage,
@@ -68,6 +71,9 @@ TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
   // Default grid index
   m_GridIndex[0] = 0;
   m_GridIndex[1] = 0;
+
+  // Direct computation of the metric by default
+  m_UseBoxFiltering = false;
 }
 
 
@@ -552,6 +558,12 @@ TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
   TOutputDisparityImage * outHDispPtr   = this->GetHorizontalDisparityOutput();
   TOutputDisparityImage * outVDispPtr   = this->GetVerticalDisparityOutput();
 
+  if (m_UseBoxFiltering && BoxSumsType::IsDecomposable)
+    {
+    this->BoxFilteredThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
   // Set-up progress reporting (this is not exact, since we do not
   // account for pixels that are out of range for a given disparity
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels()*(m_MaximumHorizontalDisparity - m_MinimumHorizontalDisparity + 1)*(m_MaximumVerticalDisparity - m_MinimumVerticalDisparity + 1),100);
@@ -674,40 +686,20 @@ TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
           {
           if(!inRightMaskPtr || (inRightMaskPtr && inRightMaskIt.Get() > 0) )
             {
-            int estimatedMinHDisp = m_MinimumHorizontalDisparity;
-            int estimatedMinVDisp = m_MinimumVerticalDisparity;
-            int estimatedMaxHDisp = m_MaximumHorizontalDisparity;
-            int estimatedMaxVDisp = m_MaximumVerticalDisparity;
+            bool explored = true;
             if (useExplorationRadius)
               {
-              // compute disparity bounds from initial position and exploration radius
               if (useInitDispMaps)
                 {
-                estimatedMinHDisp = inHDispIt.Get() - m_ExplorationRadius[0];
-                estimatedMinVDisp = inVDispIt.Get() - m_ExplorationRadius[1];
-                estimatedMaxHDisp = inHDispIt.Get() + m_ExplorationRadius[0];
-                estimatedMaxVDisp = inVDispIt.Get() + m_ExplorationRadius[1];
+                explored = this->IsExplored(hdisparity, vdisparity, inHDispIt.Get(), inVDispIt.Get());
                 }
               else
                 {
-                estimatedMinHDisp = m_InitHorizontalDisparity - m_ExplorationRadius[0];
-                estimatedMinVDisp = m_InitVerticalDisparity - m_ExplorationRadius[1];
-                estimatedMaxHDisp = m_InitHorizontalDisparity + m_ExplorationRadius[0];
-                estimatedMaxVDisp = m_InitVerticalDisparity + m_ExplorationRadius[1];
-                }
-              // clamp to the minimum disparities
-              if (estimatedMinHDisp < m_MinimumHorizontalDisparity)
-                {
-                estimatedMinHDisp = m_MinimumHorizontalDisparity;
-                }
-              if (estimatedMinVDisp < m_MinimumVerticalDisparity)
-                {
-                estimatedMinVDisp = m_MinimumVerticalDisparity;
+                explored = this->IsExplored(hdisparity, vdisparity, m_InitHorizontalDisparity, m_InitVerticalDisparity);
                 }
               }
 
-            if (vdisparity >= estimatedMinVDisp && vdisparity <= estimatedMaxVDisp &&
-                hdisparity >= estimatedMinHDisp && hdisparity <= estimatedMaxHDisp)
+            if (explored)
               {
               // Compute the block matching value
             double metric = m_Functor(leftIt,rightIt);
@@ -766,6 +758,248 @@ TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
     }
 }
 
+template <class TInputImage, class TOutputMetricImage,
+class TOutputDisparityImage, class TMaskImage, class TBlockMatchingFunctor>
+bool
+PixelWiseBlockMatchingImageFilter<TInputImage,TOutputMetricImage,
+TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
+::IsExplored(int hdisparity, int vdisparity, DisparityPixelType initHDisp, DisparityPixelType initVDisp) const
+{
+  // compute disparity bounds from initial position and exploration radius
+  int estimatedMinHDisp = initHDisp - m_ExplorationRadius[0];
+  int estimatedMinVDisp = initVDisp - m_ExplorationRadius[1];
+  int estimatedMaxHDisp = initHDisp + m_ExplorationRadius[0];
+  int estimatedMaxVDisp = initVDisp + m_ExplorationRadius[1];
+
+  // clamp to the minimum disparities
+  if (estimatedMinHDisp < m_MinimumHorizontalDisparity)
+    {
+    estimatedMinHDisp = m_MinimumHorizontalDisparity;
+    }
+  if (estimatedMinVDisp < m_MinimumVerticalDisparity)
+    {
+    estimatedMinVDisp = m_MinimumVerticalDisparity;
+    }
+
+  return (vdisparity >= estimatedMinVDisp && vdisparity <= estimatedMaxVDisp &&
+          hdisparity >= estimatedMinHDisp && hdisparity <= estimatedMaxHDisp);
+}
+
+template <class TInputImage, class TOutputMetricImage,
+class TOutputDisparityImage, class TMaskImage, class TBlockMatchingFunctor>
+void
+PixelWiseBlockMatchingImageFilter<TInputImage,TOutputMetricImage,
+TOutputDisparityImage,TMaskImage,TBlockMatchingFunctor>
+::BoxFilteredThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const unsigned int nbTerms = BoxSumsType::NumberOfTerms;
+
+  // Retrieve pointers
+  const TInputImage *     inLeftPtr    = this->GetLeftInput();
+  const TInputImage *     inRightPtr   = this->GetRightInput();
+  const TMaskImage  *     inLeftMaskPtr    = this->GetLeftMaskInput();
+  const TMaskImage  *     inRightMaskPtr    = this->GetRightMaskInput();
+  const TOutputDisparityImage * inHDispPtr = this->GetHorizontalDisparityInput();
+  const TOutputDisparityImage * inVDispPtr = this->GetVerticalDisparityInput();
+  TOutputMetricImage    * outMetricPtr = this->GetMetricOutput();
+  TOutputDisparityImage * outHDispPtr   = this->GetHorizontalDisparityOutput();
+  TOutputDisparityImage * outVDispPtr   = this->GetVerticalDisparityOutput();
+
+  const RegionType leftBufferedRegion = inLeftPtr->GetBufferedRegion();
+  const RegionType rightBufferedRegion = inRightPtr->GetBufferedRegion();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels()*(m_MaximumHorizontalDisparity - m_MinimumHorizontalDisparity + 1)*(m_MaximumVerticalDisparity - m_MinimumVerticalDisparity + 1),100);
+
+  // Handle initialization properly
+  typename InputMaskImageType::Pointer initMaskPtr = InputMaskImageType::New();
+  initMaskPtr->SetRegions(outputRegionForThread);
+  initMaskPtr->Allocate();
+  initMaskPtr->FillBuffer(0);
+
+  RegionType fullRegionForThread = this->ConvertSubsampledToFullRegion(outputRegionForThread, this->m_Step, this->m_GridIndex);
+
+  bool useExplorationRadius = (m_ExplorationRadius[0] >= 1 || m_ExplorationRadius[1] >= 1);
+  bool useInitDispMaps = useExplorationRadius && inHDispPtr && inVDispPtr;
+
+  DisparityPixelType stepDisparityInv = 1. / static_cast<DisparityPixelType>(this->m_Step);
+
+  const long radiusX = m_Radius[0];
+  const long radiusY = m_Radius[1];
+  const double blockSize = (2*radiusX+1)*(2*radiusY+1);
+
+  // Terms of a padded line, block sums along the lines, and block sums
+  std::vector<double> lineTerms;
+  std::vector<double> lineSums;
+  std::vector<double> blockSums;
+
+  for(int vdisparity = m_MinimumVerticalDisparity; vdisparity <= m_MaximumVerticalDisparity; ++vdisparity)
+    {
+  for(int hdisparity = m_MinimumHorizontalDisparity; hdisparity <= m_MaximumHorizontalDisparity; ++hdisparity)
+    {
+    // Same regions as the direct computation
+    IndexType rightRequestedRegionIndex = fullRegionForThread.GetIndex();
+    rightRequestedRegionIndex[0]+=hdisparity;
+    rightRequestedRegionIndex[1]+=vdisparity;
+
+    RegionType inputRightRegion;
+    inputRightRegion.SetIndex(rightRequestedRegionIndex);
+    inputRightRegion.SetSize(fullRegionForThread.GetSize());
+    inputRightRegion.Crop(inRightPtr->GetLargestPossibleRegion());
+
+    IndexType leftRequestedRegionIndex = inputRightRegion.GetIndex();
+    leftRequestedRegionIndex[0]-=hdisparity;
+    leftRequestedRegionIndex[1]-=vdisparity;
+
+    RegionType inputLeftRegion;
+    inputLeftRegion.SetIndex(leftRequestedRegionIndex);
+    inputLeftRegion.SetSize(inputRightRegion.GetSize());
+
+    RegionType outputRegion = this->ConvertFullToSubsampledRegion(inputLeftRegion, this->m_Step, this->m_GridIndex);
+
+    const long sizeX = inputLeftRegion.GetSize(0);
+    const long sizeY = inputLeftRegion.GetSize(1);
+    if (sizeX == 0 || sizeY == 0 || outputRegion.GetNumberOfPixels() == 0)
+      {
+      continue;
+      }
+
+    const long paddedSizeX = sizeX + 2*radiusX;
+    const long paddedSizeY = sizeY + 2*radiusY;
+
+    lineTerms.resize(paddedSizeX*nbTerms);
+    lineSums.resize(paddedSizeY*sizeX*nbTerms);
+    blockSums.resize(sizeX*nbTerms);
+
+    // Sums of the terms along the lines of the padded region. Pixels
+    // outside of the buffered regions are null, as with the constant
+    // boundary condition of the direct computation.
+    IndexType leftIndex, rightIndex;
+    for(long y = 0; y < paddedSizeY; ++y)
+      {
+      leftIndex[1] = inputLeftRegion.GetIndex(1) - radiusY + y;
+      rightIndex[1] = leftIndex[1] + vdisparity;
+
+      for(long x = 0; x < paddedSizeX; ++x)
+        {
+        leftIndex[0] = inputLeftRegion.GetIndex(0) - radiusX + x;
+        rightIndex[0] = leftIndex[0] + hdisparity;
+
+        double a = leftBufferedRegion.IsInside(leftIndex) ? static_cast<double>(inLeftPtr->GetPixel(leftIndex)) : 0.;
+        double b = rightBufferedRegion.IsInside(rightIndex) ? static_cast<double>(inRightPtr->GetPixel(rightIndex)) : 0.;
+
+        BoxSumsType::ComputeTerms(m_Functor, a, b, &lineTerms[x*nbTerms]);
+        }
+
+      double * sums = &lineSums[y*sizeX*nbTerms];
+      for(unsigned int k = 0; k < nbTerms; ++k)
+        {
+        sums[k] = 0.;
+        }
+      for(long x = 0; x <= 2*radiusX; ++x)
+        {
+        for(unsigned int k = 0; k < nbTerms; ++k)
+          {
+          sums[k] += lineTerms[x*nbTerms+k];
+          }
+        }
+      for(long x = 1; x < sizeX; ++x)
+        {
+        for(unsigned int k = 0; k < nbTerms; ++k)
+          {
+          sums[x*nbTerms+k] = sums[(x-1)*nbTerms+k] + lineTerms[(x+2*radiusX)*nbTerms+k] - lineTerms[(x-1)*nbTerms+k];
+          }
+        }
+      }
+
+    // Block sums, sliding along the columns
+    std::fill(blockSums.begin(), blockSums.end(), 0.);
+    for(long y = 0; y <= 2*radiusY; ++y)
+      {
+      for(long i = 0; i < sizeX*static_cast<long>(nbTerms); ++i)
+        {
+        blockSums[i] += lineSums[y*sizeX*nbTerms+i];
+        }
+      }
+
+    itk::ImageRegionIterator<TOutputMetricImage>    outMetricIt(outMetricPtr,outputRegion);
+    itk::ImageRegionIterator<TOutputDisparityImage> outHDispIt(outHDispPtr,outputRegion);
+    itk::ImageRegionIterator<TOutputDisparityImage> outVDispIt(outVDispPtr,outputRegion);
+    itk::ImageRegionIterator<TMaskImage>            initIt(initMaskPtr,outputRegion);
+    outMetricIt.GoToBegin();
+    outHDispIt.GoToBegin();
+    outVDispIt.GoToBegin();
+    initIt.GoToBegin();
+
+    for(long y = 0; y < sizeY; ++y)
+      {
+      if (y > 0)
+        {
+        const double * added = &lineSums[(y+2*radiusY)*sizeX*nbTerms];
+        const double * removed = &lineSums[(y-1)*sizeX*nbTerms];
+        for(long i = 0; i < sizeX*static_cast<long>(nbTerms); ++i)
+          {
+          blockSums[i] += added[i] - removed[i];
+          }
+        }
+
+      leftIndex[1] = inputLeftRegion.GetIndex(1) + y;
+      if ((leftIndex[1] - this->m_GridIndex[1] + this->m_Step) % this->m_Step != 0)
+        {
+        continue;
+        }
+
+      for(long x = 0; x < sizeX; ++x)
+        {
+        leftIndex[0] = inputLeftRegion.GetIndex(0) + x;
+        if ((leftIndex[0] - this->m_GridIndex[0] + this->m_Step) % this->m_Step != 0)
+          {
+          continue;
+          }
+
+        rightIndex[0] = leftIndex[0] + hdisparity;
+        rightIndex[1] = leftIndex[1] + vdisparity;
+
+        // If the masks are present and valid, and the disparity is explored
+        bool valid = (!inLeftMaskPtr || inLeftMaskPtr->GetPixel(leftIndex) > 0)
+          && (!inRightMaskPtr || inRightMaskPtr->GetPixel(rightIndex) > 0);
+        if (valid && useExplorationRadius)
+          {
+          if (useInitDispMaps)
+            {
+            valid = this->IsExplored(hdisparity, vdisparity, inHDispPtr->GetPixel(leftIndex), inVDispPtr->GetPixel(leftIndex));
+            }
+          else
+            {
+            valid = this->IsExplored(hdisparity, vdisparity, m_InitHorizontalDisparity, m_InitVerticalDisparity);
+            }
+          }
+
+        if (valid)
+          {
+          double metric = BoxSumsType::Evaluate(m_Functor, &blockSums[x*nbTerms], blockSize);
+
+          if(initIt.Get()==0
+             || (m_Minimize && metric < outMetricIt.Get())
+             || (!m_Minimize && metric > outMetricIt.Get()))
+            {
+            outHDispIt.Set(static_cast<DisparityPixelType>(hdisparity) * stepDisparityInv);
+            outVDispIt.Set(static_cast<DisparityPixelType>(vdisparity) * stepDisparityInv);
+            outMetricIt.Set(metric);
+            initIt.Set(1);
+            }
+          }
+
+        ++outMetricIt;
+        ++outHDispIt;
+        ++outVDispIt;
+        ++initIt;
+        progress.CompletedPixel();
+        }
+      }
+    }
+    }
+}
+
 template <class TInputImage, class TOutputMetricImage,
 class TOutputDisparityImage, class TMaskImage, class TBlockMatchingFunctor>
 typename PixelWiseBlockMatchingImageFilter<TInputImage,TOutputMetricImage,
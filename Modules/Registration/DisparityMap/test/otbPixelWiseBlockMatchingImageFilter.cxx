@@ -23,6 +23,9 @@
 #include "otbImageFileReader.h"
 #include "otbImageFileWriter.h"
 #include "otbStandardWriterWatcher.h"
+#include "itkImageRegionIterator.h"
+
+#include <algorithm>
 
 typedef otb::Image<unsigned short>                    ImageType;
 typedef otb::Image<float>                             FloatImageType;
@@ -126,3 +129,87 @@ int otbPixelWiseBlockMatchingImageFilterNCC(int argc, char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+template <class TFilter>
+int CheckBoxFiltering(bool minimize)
+{
+  typedef typename TFilter::InputImageType InputImageType;
+
+  // Random left image, and right image shifted by 3 pixels
+  typename InputImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 61);
+  region.SetSize(1, 43);
+
+  typename InputImageType::Pointer left = InputImageType::New();
+  left->SetRegions(region);
+  left->Allocate();
+  typename InputImageType::Pointer right = InputImageType::New();
+  right->SetRegions(region);
+  right->Allocate();
+
+  srand(0);
+  itk::ImageRegionIterator<InputImageType> leftIt(left, region);
+  for (leftIt.GoToBegin(); !leftIt.IsAtEnd(); ++leftIt)
+    {
+    leftIt.Set(rand() % 1000);
+    }
+  itk::ImageRegionIterator<InputImageType> rightIt(right, region);
+  for (rightIt.GoToBegin(); !rightIt.IsAtEnd(); ++rightIt)
+    {
+    typename InputImageType::IndexType index = rightIt.GetIndex();
+    index[0] -= 3;
+    rightIt.Set(region.IsInside(index) ? left->GetPixel(index) : rand() % 1000);
+    }
+
+  typename TFilter::Pointer filters[2];
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+    filters[i] = TFilter::New();
+    filters[i]->SetLeftInput(left);
+    filters[i]->SetRightInput(right);
+    filters[i]->SetRadius(2);
+    filters[i]->SetMinimumHorizontalDisparity(-5);
+    filters[i]->SetMaximumHorizontalDisparity(5);
+    filters[i]->SetMinimumVerticalDisparity(-1);
+    filters[i]->SetMaximumVerticalDisparity(1);
+    filters[i]->SetMinimize(minimize);
+    filters[i]->SetNumberOfThreads(2);
+    }
+  filters[1]->UseBoxFilteringOn();
+  filters[0]->Update();
+  filters[1]->Update();
+
+  itk::ImageRegionConstIterator<FloatImageType> metricIt(filters[0]->GetMetricOutput(), region);
+  itk::ImageRegionConstIterator<FloatImageType> boxMetricIt(filters[1]->GetMetricOutput(), region);
+  itk::ImageRegionConstIterator<FloatImageType> hdispIt(filters[0]->GetHorizontalDisparityOutput(), region);
+  itk::ImageRegionConstIterator<FloatImageType> boxHDispIt(filters[1]->GetHorizontalDisparityOutput(), region);
+  itk::ImageRegionConstIterator<FloatImageType> vdispIt(filters[0]->GetVerticalDisparityOutput(), region);
+  itk::ImageRegionConstIterator<FloatImageType> boxVDispIt(filters[1]->GetVerticalDisparityOutput(), region);
+
+  for (metricIt.GoToBegin(), boxMetricIt.GoToBegin(), hdispIt.GoToBegin(), boxHDispIt.GoToBegin(),
+       vdispIt.GoToBegin(), boxVDispIt.GoToBegin(); !metricIt.IsAtEnd();
+       ++metricIt, ++boxMetricIt, ++hdispIt, ++boxHDispIt, ++vdispIt, ++boxVDispIt)
+    {
+    if (hdispIt.Get() != boxHDispIt.Get() || vdispIt.Get() != boxVDispIt.Get()
+        || vcl_abs(metricIt.Get() - boxMetricIt.Get()) > 1e-4 * std::max(1.f, vcl_abs(metricIt.Get())))
+      {
+      std::cerr << "Box filtering differs at " << metricIt.GetIndex() << ": disparity ("
+                << hdispIt.Get() << ", " << vdispIt.Get() << "), metric " << metricIt.Get()
+                << " instead of disparity (" << boxHDispIt.Get() << ", " << boxVDispIt.Get()
+                << "), metric " << boxMetricIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int otbPixelWiseBlockMatchingImageFilterBoxFiltering(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  if (CheckBoxFiltering<PixelWiseBlockMatchingImageFilterType>(true) == EXIT_FAILURE)
+    {
+    return EXIT_FAILURE;
+    }
+  return CheckBoxFiltering<PixelWiseNCCBlockMatchingImageFilterType>(false);
+}
@@ -55,6 +55,7 @@ public:
   typedef typename Superclass::DisplacementFieldPointerType DisplacementFieldPointerType;
   typedef typename Superclass::IndexType                   IndexType;
   typedef typename DisplacementFieldType::PixelType         PixelType;
+  typedef typename Superclass::OutputImageRegionType        OutputImageRegionType;
   typedef typename Superclass::ValueType                   ValueType;
   typedef typename Superclass::PointType                   PointType;
   typedef typename Superclass::IndexVectorType             IndexVectorType;
@@ -71,7 +72,7 @@ protected:
   /**PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Main computation method */
-  void GenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) ITK_OVERRIDE;
 
 private:
   NNearestPointsLinearInterpolateDisplacementFieldGenerator(const Self &); //purposely not implemented
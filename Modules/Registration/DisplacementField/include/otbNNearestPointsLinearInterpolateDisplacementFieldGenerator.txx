@@ -33,16 +33,14 @@ namespace otb
 template <class TPointSet, class TDisplacementField>
 void
 NNearestPointsLinearInterpolateDisplacementFieldGenerator<TPointSet, TDisplacementField>
-::GenerateData(void)
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType itkNotUsed(threadId))
 {
   DisplacementFieldPointerType outputPtr = this->GetOutput();
   PixelType defaultValue(2);
   defaultValue.Fill(this->GetDefaultValue());
-  outputPtr->Allocate();
-  outputPtr->FillBuffer(defaultValue);
 
   typedef itk::ImageRegionIteratorWithIndex<DisplacementFieldType> IteratorType;
-  IteratorType it(outputPtr, outputPtr->GetRequestedRegion());
+  IteratorType it(outputPtr, outputRegionForThread);
 
   for (it.GoToBegin(); !it.IsAtEnd(); ++it)
     {
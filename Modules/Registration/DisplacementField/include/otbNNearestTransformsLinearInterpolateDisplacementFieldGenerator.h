@@ -60,6 +60,7 @@ public:
   typedef typename Superclass::DisplacementFieldPointerType DisplacementFieldPointerType;
   typedef typename Superclass::IndexType                   IndexType;
   typedef typename DisplacementFieldType::PixelType         PixelType;
+  typedef typename Superclass::OutputImageRegionType        OutputImageRegionType;
   typedef typename Superclass::ValueType                   ValueType;
   typedef typename Superclass::PointType                   PointType;
   typedef typename Superclass::IndexVectorType             IndexVectorType;
@@ -78,7 +79,7 @@ protected:
   /**PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Main computation method */
-  void GenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) ITK_OVERRIDE;
 
 private:
   NNearestTransformsLinearInterpolateDisplacementFieldGenerator(const Self &); //purposely not implemented
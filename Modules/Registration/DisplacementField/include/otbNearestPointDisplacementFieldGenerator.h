@@ -57,6 +57,7 @@ public:
   typedef typename Superclass::DisplacementFieldPointerType DisplacementFieldPointerType;
   typedef typename Superclass::IndexType                   IndexType;
   typedef typename DisplacementFieldType::PixelType         PixelType;
+  typedef typename Superclass::OutputImageRegionType        OutputImageRegionType;
   typedef typename Superclass::ValueType                   ValueType;
   typedef typename Superclass::IndexVectorType             IndexVectorType;
 
@@ -68,7 +69,7 @@ protected:
   /**PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Main computation method */
-  void GenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) ITK_OVERRIDE;
 
 private:
   NearestPointDisplacementFieldGenerator(const Self &); //purposely not implemented
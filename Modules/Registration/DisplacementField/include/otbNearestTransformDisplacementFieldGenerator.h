@@ -58,6 +58,7 @@ public:
   typedef typename Superclass::IndexType                   IndexType;
   typedef typename Superclass::PointType                   PointType;
   typedef typename DisplacementFieldType::PixelType         PixelType;
+  typedef typename Superclass::OutputImageRegionType        OutputImageRegionType;
   typedef typename Superclass::ValueType                   ValueType;
   typedef typename Superclass::IndexVectorType             IndexVectorType;
   typedef typename Superclass::TransformType               TransformType;
@@ -71,7 +72,7 @@ protected:
   /**PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Main computation method */
-  void GenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) ITK_OVERRIDE;
 
 private:
   NearestTransformDisplacementFieldGenerator(const Self &); //purposely not implemented
@@ -31,16 +31,17 @@ namespace otb
 template <class TPointSet, class TDisplacementField>
 void
 NearestTransformDisplacementFieldGenerator<TPointSet, TDisplacementField>
-::GenerateData(void)
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
 {
   DisplacementFieldPointerType outputPtr = this->GetOutput();
   PixelType defaultValue(2);
   defaultValue.Fill(this->GetDefaultValue());
-  outputPtr->Allocate();
-  outputPtr->FillBuffer(defaultValue);
+
+  // The parameters of the transform are set for each pixel
+  TransformType * transform = this->GetThreadTransform(threadId);
 
   typedef itk::ImageRegionIteratorWithIndex<DisplacementFieldType> IteratorType;
-  IteratorType it(outputPtr, outputPtr->GetRequestedRegion());
+  IteratorType it(outputPtr, outputRegionForThread);
 
   for (it.GoToBegin(); !it.IsAtEnd(); ++it)
     {
@@ -48,16 +49,16 @@ NearestTransformDisplacementFieldGenerator<TPointSet, TDisplacementField>
     PixelType pixel(2);
     if (indexVector.size() >= 1)
       {
-      ParametersType params(this->GetTransform()->GetNumberOfParameters());
-      for (unsigned int i = 0; i < this->GetTransform()->GetNumberOfParameters(); ++i)
+      ParametersType params(transform->GetNumberOfParameters());
+      for (unsigned int i = 0; i < transform->GetNumberOfParameters(); ++i)
         {
         params[i] = this->GetPointSet()->GetPointData()->GetElement(indexVector[0])[i + 3];
         }
-      this->GetTransform()->SetParameters(params);
+      transform->SetParameters(params);
       PointType sourcePoint, targetPoint;
 
       outputPtr->TransformIndexToPhysicalPoint(it.GetIndex(), sourcePoint);
-      targetPoint = this->GetTransform()->TransformPoint(sourcePoint);
+      targetPoint = transform->TransformPoint(sourcePoint);
       pixel[0] = static_cast<ValueType>(targetPoint[0] - sourcePoint[0]);
       pixel[1] = static_cast<ValueType>(targetPoint[1] - sourcePoint[1]);
       }
@@ -22,6 +22,8 @@
 #define otbPointSetToDisplacementFieldGenerator_h
 
 #include "itkImageSource.h"
+#include <vector>
+#include <utility>
 
 namespace otb
 {
@@ -130,8 +132,15 @@ protected:
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
   /** Generate output information */
   void GenerateOutputInformation(void) ITK_OVERRIDE;
+  /** Index the valid points in a uniform grid before the threads start */
+  void BeforeThreadedGenerateData(void) ITK_OVERRIDE;
+  /** Release the grid of the valid points */
+  void AfterThreadedGenerateData(void) ITK_OVERRIDE;
   /**
    * Generate the n nearest valid point in point set, where a valid point has a sufficient metric value.
+   * The points are searched in the grid built by BeforeThreadedGenerateData() if any, and in the whole
+   * point set otherwise. Points at the same distance are sorted by their index in the point set.
+   * This method can be called concurrently by several threads.
    *  \param index The index of the pixel to compute.
    *  \param n The number of nearest point to seek.
    *  \return A vector containing the index of the nearest point from nearest to most far.
@@ -145,6 +154,16 @@ private:
   PointSetToDisplacementFieldGenerator(const Self &); //purposely not implemented
   void operator =(const Self&); //purposely not implemented
 
+  /** Squared distance and index in the point set of a neighbor */
+  typedef std::pair<double, unsigned int> NeighborType;
+  typedef std::vector<NeighborType>       NeighborVectorType;
+
+  /** Insert a point in the n nearest ones found so far */
+  static void InsertNeighbor(const NeighborType& neighbor, unsigned int n, NeighborVectorType& neighbors);
+
+  /** Column or row of the grid containing a coordinate */
+  long GetGridCell(double coordinate, unsigned int dimension) const;
+
   /**
    * The threshold of metric value.
    */
@@ -157,6 +176,18 @@ private:
   PointType m_OutputOrigin;
   /** Default value */
   ValueType m_DefaultValue;
+
+  /** Is the uniform grid of the valid points built ? */
+  bool m_PointsGridBuilt;
+  /** Origin and size of the grid, in index coordinates */
+  double m_GridOrigin[2];
+  long   m_GridSize[2];
+  double m_CellSize;
+  /** Position of the first point of each cell, the points being sorted by cell */
+  std::vector<unsigned long> m_CellStarts;
+  /** Index in the point set and position of the points, sorted by cell */
+  IndexVectorType        m_GridPointIds;
+  std::vector<PointType> m_GridPoints;
 };
 } // End namespace otb
 #ifndef OTB_MANUAL_INSTANTIATION
@@ -24,6 +24,9 @@
 #include "otbPointSetToDisplacementFieldGenerator.h"
 #include "otbMacro.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace otb
 {
 /**
@@ -40,6 +43,12 @@ PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
   m_OutputOrigin.Fill(0.);
   m_DefaultValue = 0;
 //  m_NearestPoints = PointSetType::New();
+  m_PointsGridBuilt = false;
+  m_GridOrigin[0] = 0.;
+  m_GridOrigin[1] = 0.;
+  m_GridSize[0] = 0;
+  m_GridSize[1] = 0;
+  m_CellSize = 1.;
 }
 /**
  * Set the pointset containing the disparity.
@@ -81,6 +90,130 @@ PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
   // Force the displacement field to have vector pixel of size 2.
   outputPtr->SetNumberOfComponentsPerPixel(2);
 }
+/**
+ * Index the valid points in a uniform grid, so that the nearest ones
+ * are searched in the neighboring cells only.
+ */
+template <class TPointSet, class TDisplacementField>
+void
+PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::BeforeThreadedGenerateData(void)
+{
+  IndexVectorType        ids;
+  std::vector<PointType> points;
+
+  typedef typename PointSetType::PointsContainer::ConstIterator PointSetIteratorType;
+
+  unsigned int         j = 0;
+  PointSetIteratorType it = this->GetPointSet()->GetPoints()->Begin();
+  for (; it != this->GetPointSet()->GetPoints()->End(); ++it)
+    {
+    if (vcl_abs(this->GetPointSet()->GetPointData()->GetElement(j)[0]) >= m_MetricThreshold)
+      {
+      PointType p;
+      p[0] = it.Value()[0];
+      p[1] = it.Value()[1];
+      ids.push_back(j);
+      points.push_back(p);
+      }
+    ++j;
+    }
+
+  m_CellStarts.clear();
+  m_GridPointIds.clear();
+  m_GridPoints.clear();
+  m_GridSize[0] = 0;
+  m_GridSize[1] = 0;
+  m_PointsGridBuilt = true;
+
+  if (points.empty())
+    {
+    return;
+    }
+
+  double minimum[2], maximum[2];
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    minimum[dim] = points[0][dim];
+    maximum[dim] = points[0][dim];
+    for (unsigned int i = 1; i < points.size(); ++i)
+      {
+      minimum[dim] = std::min(minimum[dim], points[i][dim]);
+      maximum[dim] = std::max(maximum[dim], points[i][dim]);
+      }
+    }
+
+  // About two points per cell
+  const double width = std::max(maximum[0] - minimum[0], 1.);
+  const double height = std::max(maximum[1] - minimum[1], 1.);
+  m_CellSize = vcl_sqrt(2. * width * height / points.size());
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    m_GridOrigin[dim] = minimum[dim];
+    m_GridSize[dim] = static_cast<long>((maximum[dim] - minimum[dim]) / m_CellSize) + 1;
+    }
+
+  // Sort the points by cell, keeping the order of the point set in each cell
+  std::vector<unsigned long> cells(points.size());
+  m_CellStarts.assign(m_GridSize[0] * m_GridSize[1] + 1, 0);
+  for (unsigned int i = 0; i < points.size(); ++i)
+    {
+    cells[i] = GetGridCell(points[i][1], 1) * m_GridSize[0] + GetGridCell(points[i][0], 0);
+    ++m_CellStarts[cells[i] + 1];
+    }
+  for (unsigned long c = 1; c < m_CellStarts.size(); ++c)
+    {
+    m_CellStarts[c] += m_CellStarts[c - 1];
+    }
+
+  std::vector<unsigned long> positions(m_CellStarts.begin(), m_CellStarts.end() - 1);
+  m_GridPointIds.resize(points.size());
+  m_GridPoints.resize(points.size());
+  for (unsigned int i = 0; i < points.size(); ++i)
+    {
+    const unsigned long position = positions[cells[i]]++;
+    m_GridPointIds[position] = ids[i];
+    m_GridPoints[position] = points[i];
+    }
+}
+
+template <class TPointSet, class TDisplacementField>
+void
+PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::AfterThreadedGenerateData(void)
+{
+  m_PointsGridBuilt = false;
+  m_CellStarts = std::vector<unsigned long>();
+  m_GridPointIds = IndexVectorType();
+  m_GridPoints = std::vector<PointType>();
+}
+
+template <class TPointSet, class TDisplacementField>
+long
+PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::GetGridCell(double coordinate, unsigned int dimension) const
+{
+  const long cell = static_cast<long>(vcl_floor((coordinate - m_GridOrigin[dimension]) / m_CellSize));
+  return std::min(std::max(cell, 0L), m_GridSize[dimension] - 1);
+}
+
+template <class TPointSet, class TDisplacementField>
+void
+PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::InsertNeighbor(const NeighborType& neighbor, unsigned int n, NeighborVectorType& neighbors)
+{
+  // Neighbors are sorted by distance, then by index in the point set
+  if (neighbors.size() == n && !(neighbor < neighbors.back()))
+    {
+    return;
+    }
+  neighbors.insert(std::upper_bound(neighbors.begin(), neighbors.end(), neighbor), neighbor);
+  if (neighbors.size() > n)
+    {
+    neighbors.pop_back();
+    }
+}
+
 /**
  * Generate the n nearest point in point set
  *  \param index The index of the pixel to compute.
@@ -93,42 +226,107 @@ typename PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
 PointSetToDisplacementFieldGenerator<TPointSet, TDisplacementField>
 ::GenerateNearestValidPointsPointSet(IndexType index, unsigned int n)
 {
-  typedef Functor::DistanceComparisonFunctor ComparisonFunctorType;
-  DistanceVectorType distanceVector;
-  IndexVectorType    indexVector;
-  IndexVectorType    sortVector;
-  unsigned int       i =  0;
-  unsigned int       j = 0;
+  NeighborVectorType neighbors;
+  IndexVectorType    output;
 
-  typedef typename PointSetType::PointsContainer::ConstIterator PointSetIteratorType;
+  if (n == 0)
+    {
+    return output;
+    }
 
-  PointSetIteratorType it = this->GetPointSet()->GetPoints()->Begin();
-  for (; it != this->GetPointSet()->GetPoints()->End(); ++it)
+  const double x = static_cast<double>(index[0]);
+  const double y = static_cast<double>(index[1]);
+
+  if (!m_PointsGridBuilt)
     {
-    PointType p;
-    p[0] = it.Value()[0];
-    p[1] = it.Value()[1];
-    if (vcl_abs(this->GetPointSet()->GetPointData()->GetElement(j)[0]) >= m_MetricThreshold)
-      {
+    typedef typename PointSetType::PointsContainer::ConstIterator PointSetIteratorType;
 
-      distanceVector.push_back(EuclideanDistanceMetric(index, p));
-      sortVector.push_back(i);
-      indexVector.push_back(j);
-      ++i;
+    unsigned int         j = 0;
+    PointSetIteratorType it = this->GetPointSet()->GetPoints()->Begin();
+    for (; it != this->GetPointSet()->GetPoints()->End(); ++it)
+      {
+      if (vcl_abs(this->GetPointSet()->GetPointData()->GetElement(j)[0]) >= m_MetricThreshold)
+        {
+        const double dx = x - it.Value()[0];
+        const double dy = y - it.Value()[1];
+        InsertNeighbor(NeighborType(dx * dx + dy * dy, j), n, neighbors);
+        }
+      ++j;
       }
-    ++j;
     }
+  else if (!m_GridPoints.empty())
+    {
+    // Visit the rings of cells around the one of the pixel, until the
+    // unvisited cells are farther than the n-th nearest point found
+    const long cx = GetGridCell(x, 0);
+    const long cy = GetGridCell(y, 1);
+
+    for (long r = 0;; ++r)
+      {
+      const long xmin = cx - r;
+      const long xmax = cx + r;
+      const long ymin = cy - r;
+      const long ymax = cy + r;
 
-  ComparisonFunctorType comp;
-  comp.SetDistanceVector(distanceVector);
-  sort(sortVector.begin(), sortVector.end(), comp);
+      for (long cellY = std::max(ymin, 0L); cellY <= std::min(ymax, m_GridSize[1] - 1); ++cellY)
+        {
+        const bool fullRow = (cellY == ymin || cellY == ymax);
+        for (long cellX = std::max(xmin, 0L); cellX <= std::min(xmax, m_GridSize[0] - 1); ++cellX)
+          {
+          if (!fullRow && cellX != xmin && cellX != xmax)
+            {
+            // Skip the inside of the ring
+            cellX = xmax - 1;
+            continue;
+            }
+          const unsigned long cell = cellY * m_GridSize[0] + cellX;
+          for (unsigned long p = m_CellStarts[cell]; p < m_CellStarts[cell + 1]; ++p)
+            {
+            const double dx = x - m_GridPoints[p][0];
+            const double dy = y - m_GridPoints[p][1];
+            InsertNeighbor(NeighborType(dx * dx + dy * dy, m_GridPointIds[p]), n, neighbors);
+            }
+          }
+        }
+
+      if (xmin <= 0 && ymin <= 0 && xmax >= m_GridSize[0] - 1 && ymax >= m_GridSize[1] - 1)
+        {
+        break;
+        }
+
+      if (neighbors.size() == n)
+        {
+        // Distance to the nearest unvisited cell. Points at the same
+        // distance as the n-th one may have a lower index.
+        double bound = std::numeric_limits<double>::max();
+        if (xmin > 0)
+          {
+          bound = std::min(bound, x - (m_GridOrigin[0] + xmin * m_CellSize));
+          }
+        if (xmax < m_GridSize[0] - 1)
+          {
+          bound = std::min(bound, m_GridOrigin[0] + (xmax + 1) * m_CellSize - x);
+          }
+        if (ymin > 0)
+          {
+          bound = std::min(bound, y - (m_GridOrigin[1] + ymin * m_CellSize));
+          }
+        if (ymax < m_GridSize[1] - 1)
+          {
+          bound = std::min(bound, m_GridOrigin[1] + (ymax + 1) * m_CellSize - y);
+          }
+        if (neighbors.back().first < bound * bound)
+          {
+          break;
+          }
+        }
+      }
+    }
 
   // building output vector
-  unsigned int    nbElements = (n < indexVector.size() ? n : indexVector.size());
-  IndexVectorType output;
-  for (i = 0; i < nbElements; ++i)
+  for (unsigned int i = 0; i < neighbors.size(); ++i)
     {
-    output.push_back(indexVector[sortVector[i]]);
+    output.push_back(neighbors[i].second);
     }
   return output;
 }
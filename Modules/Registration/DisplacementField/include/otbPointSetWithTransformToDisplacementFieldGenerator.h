@@ -87,6 +87,12 @@ protected:
   ~PointSetWithTransformToDisplacementFieldGenerator() ITK_OVERRIDE {}
   /**PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+  /** Copy the transform for each thread */
+  void BeforeThreadedGenerateData(void) ITK_OVERRIDE;
+  /** Release the copies of the transform */
+  void AfterThreadedGenerateData(void) ITK_OVERRIDE;
+  /** Copy of the transform whose parameters a thread can set */
+  TransformType * GetThreadTransform(itk::ThreadIdType threadId);
 
 private:
   PointSetWithTransformToDisplacementFieldGenerator(const Self &); //purposely not implemented
@@ -97,6 +103,9 @@ private:
    */
   TransformPointerType m_Transform;
 
+  /** One copy of the transform per thread */
+  std::vector<TransformPointerType> m_ThreadTransforms;
+
 };
 } // End namespace otb
 #ifndef OTB_MANUAL_INSTANTIATION
@@ -36,6 +36,47 @@ PointSetWithTransformToDisplacementFieldGenerator<TPointSet, TDisplacementField>
 {
   m_Transform = ITK_NULLPTR;    // has to be provided by the user
 }
+
+template <class TPointSet, class TDisplacementField>
+void
+PointSetWithTransformToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::BeforeThreadedGenerateData(void)
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  if (m_Transform.IsNull())
+    {
+    itkExceptionMacro(<< "No transform set.");
+    }
+
+  m_ThreadTransforms.resize(this->GetNumberOfThreads());
+  for (unsigned int i = 0; i < m_ThreadTransforms.size(); ++i)
+    {
+    m_ThreadTransforms[i] = dynamic_cast<TransformType *>(m_Transform->CreateAnother().GetPointer());
+    m_ThreadTransforms[i]->SetFixedParameters(m_Transform->GetFixedParameters());
+    m_ThreadTransforms[i]->SetParameters(m_Transform->GetParameters());
+    }
+}
+
+template <class TPointSet, class TDisplacementField>
+void
+PointSetWithTransformToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::AfterThreadedGenerateData(void)
+{
+  m_ThreadTransforms.clear();
+
+  Superclass::AfterThreadedGenerateData();
+}
+
+template <class TPointSet, class TDisplacementField>
+typename PointSetWithTransformToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::TransformType *
+PointSetWithTransformToDisplacementFieldGenerator<TPointSet, TDisplacementField>
+::GetThreadTransform(itk::ThreadIdType threadId)
+{
+  return m_ThreadTransforms[threadId];
+}
+
 /**
  * PrintSelf Method
  */
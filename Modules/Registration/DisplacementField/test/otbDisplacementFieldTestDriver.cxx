@@ -25,6 +25,7 @@ void RegisterTests()
   REGISTER_TEST(otbNearestTransformDisplacementFieldGeneratorNew);
   REGISTER_TEST(otbNNearestTransformsLinearInterpolateDisplacementFieldGenerator);
   REGISTER_TEST(otbNNearestPointsLinearInterpolateDisplacementFieldGenerator);
+  REGISTER_TEST(otbNNearestPointsLinearInterpolateDisplacementFieldGeneratorLarge);
   REGISTER_TEST(otbNearestPointDisplacementFieldGeneratorNew);
   REGISTER_TEST(otbPointSetToDisplacementFieldGeneratorNew);
   REGISTER_TEST(otbPointSetWithTransformToDisplacementFieldGeneratorNew);
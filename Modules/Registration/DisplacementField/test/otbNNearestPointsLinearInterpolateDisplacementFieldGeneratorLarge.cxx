@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "itkMacro.h"
+#include "itkPointSet.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "otbVectorImage.h"
+#include "otbNNearestPointsLinearInterpolateDisplacementFieldGenerator.h"
+
+#include <algorithm>
+#include <utility>
+
+int otbNNearestPointsLinearInterpolateDisplacementFieldGeneratorLarge(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  const unsigned int Dimension = 2;
+  typedef double                                                                                 PixelType;
+  typedef otb::VectorImage<PixelType, Dimension>                                                 ImageType;
+  typedef itk::Array<double>                                                                     ParamType;
+  typedef itk::PointSet<ParamType, Dimension>                                                    PointSetType;
+  typedef PointSetType::PointType                                                                PointType;
+  typedef otb::NNearestPointsLinearInterpolateDisplacementFieldGenerator<PointSetType, ImageType> FilterType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator                                 GeneratorType;
+
+  // This test checks that the nearest points searched in the grid of
+  // the filter, by several threads, are the ones of a linear scan
+  const unsigned int nbPoints = 20000;
+  const unsigned int nbNearestPoints = 4;
+  const double       thresh = 0.9;
+
+  ImageType::SizeType size;
+  size.Fill(150);
+
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(121212);
+
+  // Points on integer positions, so that many of them are at the same
+  // distance of a pixel, and some of them outside of the output
+  PointSetType::Pointer ps = PointSetType::New();
+  for (unsigned int i = 0; i < nbPoints; ++i)
+    {
+    PointType p;
+    p[0] = static_cast<double>(generator->GetIntegerVariate(199)) - 25.;
+    p[1] = static_cast<double>(generator->GetIntegerVariate(199)) - 25.;
+    ParamType pd(3);
+    pd[0] = generator->GetUniformVariate(0.8, 1.);
+    pd[1] = generator->GetUniformVariate(-10., 10.);
+    pd[2] = generator->GetUniformVariate(-10., 10.);
+    ps->SetPoint(i, p);
+    ps->SetPointData(i, pd);
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetOutputSize(size);
+  filter->SetMetricThreshold(thresh);
+  filter->SetNumberOfPoints(nbNearestPoints);
+  filter->SetPointSet(ps);
+  filter->SetNumberOfThreads(4);
+  filter->Update();
+
+  typedef std::pair<double, unsigned int> NeighborType;
+
+  for (unsigned int y = 0; y < size[1]; y += 7)
+    {
+    for (unsigned int x = 0; x < size[0]; x += 3)
+      {
+      // Valid points sorted by distance, then by index
+      std::vector<NeighborType> neighbors;
+      for (unsigned int i = 0; i < nbPoints; ++i)
+        {
+        if (ps->GetPointData()->GetElement(i)[0] >= thresh)
+          {
+          const double dx = x - ps->GetPoints()->GetElement(i)[0];
+          const double dy = y - ps->GetPoints()->GetElement(i)[1];
+          neighbors.push_back(NeighborType(dx * dx + dy * dy, i));
+          }
+        }
+      std::partial_sort(neighbors.begin(), neighbors.begin() + nbNearestPoints, neighbors.end());
+
+      double xdisplacement = 0, ydisplacement = 0, normalization = 0;
+      for (unsigned int k = 0; k < nbNearestPoints; ++k)
+        {
+        const double distance = std::max(vcl_sqrt(neighbors[k].first), 1e-15);
+        xdisplacement += ps->GetPointData()->GetElement(neighbors[k].second)[1] / distance;
+        ydisplacement += ps->GetPointData()->GetElement(neighbors[k].second)[2] / distance;
+        normalization += 1 / distance;
+        }
+
+      ImageType::IndexType index;
+      index[0] = x;
+      index[1] = y;
+      const ImageType::PixelType pixel = filter->GetOutput()->GetPixel(index);
+
+      if (vcl_abs(pixel[0] - xdisplacement / normalization) > 1e-9
+          || vcl_abs(pixel[1] - ydisplacement / normalization) > 1e-9)
+        {
+        std::cerr << "Pixel " << index << " is " << pixel << " instead of ["
+                  << xdisplacement / normalization << ", " << ydisplacement / normalization << "]" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -24,6 +24,8 @@
 #include "itkProcessObject.h"
 #include "otbOGRDataSourceWrapper.h"
 
+class GDALDataset;
+
 namespace otb
 {
 
@@ -37,6 +39,19 @@ namespace otb
  * \note The Use8Connected parameter can be turn on and it will be used in \c GDALPolygonize(). But be carreful, it
  * can create cross polygons !
  * \note It is a non-streamed version.
+ *
+ * When TileSize is not 0, the image is split into tiles of TileSize x
+ * TileSize pixels which are polygonized in parallel, each one by a
+ * \c GDALPolygonize() call in pixel coordinates. The polygons of a
+ * tile which do not reach an inner border of the tile are complete
+ * and copied as is. The ones reaching an inner border are merged per
+ * label, and the merged geometries are split back into one feature
+ * per polygon. The output does not depend on the number of threads:
+ * the features of the tiles come first, in tile order, then the merged
+ * features, by increasing label. Polygons are the same as with a
+ * single \c GDALPolygonize() call, up to the order of the features
+ * and of the vertices of the merged polygons (with 8-connectivity,
+ * regions touching diagonally across a seam are not merged).
  * \ingroup OBIA
  *
  *
@@ -107,6 +122,13 @@ public:
    */
   itkGetMacro(Use8Connected, bool);
 
+  /**
+   * Set/Get the size of the tiles polygonized in parallel. The default
+   * value 0 polygonizes the whole image with a single \c GDALPolygonize() call.
+   */
+  itkSetMacro(TileSize, unsigned int);
+  itkGetMacro(TileSize, unsigned int);
+
   /**
    * Get the output \c ogr::DataSource which is a "memory" datasource.
    */
@@ -127,13 +149,39 @@ protected:
   DataObjectPointer MakeOutput(DataObjectPointerArraySizeType idx) ITK_OVERRIDE;
   using Superclass::MakeOutput;
 
+  /** Polygonize the tiles in parallel and merge the polygons crossing
+   *  the seams into outputLayer */
+  void GenerateTiledData(OGRLayerType & outputLayer, const double * geoTransform);
+
+  /** Polygonize a tile into its layer */
+  void PolygonizeTile(unsigned int tile);
+
+  /** Open a GDAL MEM dataset on a region of the buffer of image, in
+   *  pixel coordinates relative to the buffered region */
+  static GDALDataset * OpenPixelDataset(const InputImageType * image, const RegionType & region);
+
+  /** Apply the geo transform to a polygon or multi-polygon in pixel
+   *  coordinates */
+  static void TransformGeometry(OGRGeometry * geometry, const double * geoTransform);
+
+  static ITK_THREAD_RETURN_TYPE PolygonizeThreaderCallback(void *arg);
+
+  struct ThreadStruct
+  {
+    Pointer Filter;
+  };
+
 private:
   LabelImageToOGRDataSourceFilter(const Self &);  //purposely not implemented
   void operator =(const Self&);      //purposely not implemented
 
   std::string m_FieldName;
   bool m_Use8Connected;
+  unsigned int m_TileSize;
 
+  /** Tiles and their polygonized layers (tiled mode) */
+  std::vector<RegionType>               m_Tiles;
+  std::vector<OGRDataSourcePointerType> m_TileDataSources;
 
 };
 
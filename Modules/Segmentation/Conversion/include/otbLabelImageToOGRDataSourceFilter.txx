@@ -32,11 +32,14 @@
 
 #include "stdint.h" //needed for uintptr_t
 
+#include <algorithm>
+#include <map>
+
 namespace otb
 {
 template <class TInputImage>
 LabelImageToOGRDataSourceFilter<TInputImage>
-::LabelImageToOGRDataSourceFilter() : m_FieldName("DN"), m_Use8Connected(false)
+::LabelImageToOGRDataSourceFilter() : m_FieldName("DN"), m_Use8Connected(false), m_TileSize(0)
 {
    this->SetNumberOfRequiredInputs(2);
    this->SetNumberOfRequiredInputs(1);
@@ -212,6 +215,14 @@ LabelImageToOGRDataSourceFilter<TInputImage>
     OGRFieldDefn field(m_FieldName.c_str(),OFTInteger);
     outputLayer.CreateField(field, true);
 
+    if (m_TileSize > 0)
+    {
+      GDALClose(dataset);
+      this->GenerateTiledData(outputLayer, geoTransform);
+      this->SetNthOutput(0,ogrDS);
+      return;
+    }
+
     //Call GDALPolygonize()
     char ** options;
     options = ITK_NULLPTR;
@@ -290,6 +301,265 @@ LabelImageToOGRDataSourceFilter<TInputImage>
 }
 
 
+template <class TInputImage>
+void
+LabelImageToOGRDataSourceFilter<TInputImage>
+::GenerateTiledData(OGRLayerType & outputLayer, const double * geoTransform)
+{
+  const RegionType region = this->GetInput()->GetBufferedRegion();
+  const SizeType size = region.GetSize();
+
+  // Tiles in raster order, with their polygonized layers
+  m_Tiles.clear();
+  m_TileDataSources.clear();
+  typedef typename SizeType::SizeValueType SizeValueType;
+  for (SizeValueType y = 0; y < size[1]; y += m_TileSize)
+    {
+    for (SizeValueType x = 0; x < size[0]; x += m_TileSize)
+      {
+      RegionType tile;
+      tile.SetIndex(0, region.GetIndex(0) + x);
+      tile.SetIndex(1, region.GetIndex(1) + y);
+      tile.SetSize(0, std::min<SizeValueType>(m_TileSize, size[0] - x));
+      tile.SetSize(1, std::min<SizeValueType>(m_TileSize, size[1] - y));
+      m_Tiles.push_back(tile);
+
+      OGRDataSourcePointerType tileDS = OGRDataSourceType::New();
+      OGRLayerType tileLayer = tileDS->CreateLayer("layer",ITK_NULLPTR,wkbPolygon);
+      OGRFieldDefn field(m_FieldName.c_str(),OFTInteger);
+      tileLayer.CreateField(field, true);
+      m_TileDataSources.push_back(tileDS);
+      }
+    }
+
+  ThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(
+    std::min<itk::ThreadIdType>(this->GetNumberOfThreads(), m_Tiles.size()));
+  this->GetMultiThreader()->SetSingleMethod(this->PolygonizeThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Polygons reaching an inner border of their tile, per label
+  typedef std::map<int, OGRMultiPolygon> SeamPolygonsMapType;
+  SeamPolygonsMapType seamPolygons;
+
+  for (unsigned int t = 0; t < m_Tiles.size(); ++t)
+    {
+    // Inner borders of the tile, in pixel coordinates
+    const double minX = m_Tiles[t].GetIndex(0) - region.GetIndex(0);
+    const double minY = m_Tiles[t].GetIndex(1) - region.GetIndex(1);
+    const double maxX = minX + m_Tiles[t].GetSize(0);
+    const double maxY = minY + m_Tiles[t].GetSize(1);
+    const bool innerMinX = minX > 0;
+    const bool innerMinY = minY > 0;
+    const bool innerMaxX = maxX < size[0];
+    const bool innerMaxY = maxY < size[1];
+
+    OGRLayerType tileLayer = m_TileDataSources[t]->GetLayerChecked(0);
+    for (typename OGRLayerType::const_iterator featIt = tileLayer.begin(); featIt != tileLayer.end(); ++featIt)
+      {
+      const OGRGeometry * geometry = featIt->GetGeometry();
+      if (geometry == ITK_NULLPTR)
+        {
+        continue;
+        }
+      const int label = featIt->ogr().GetFieldAsInteger(0);
+
+      OGREnvelope envelope;
+      geometry->getEnvelope(&envelope);
+      if ((innerMinX && envelope.MinX <= minX) || (innerMaxX && envelope.MaxX >= maxX)
+          || (innerMinY && envelope.MinY <= minY) || (innerMaxY && envelope.MaxY >= maxY))
+        {
+        seamPolygons[label].addGeometry(geometry);
+        continue;
+        }
+
+      ogr::UniqueGeometryPtr physical(geometry->clone());
+      TransformGeometry(physical.get(), geoTransform);
+
+      ogr::Feature dstFeature(outputLayer.GetLayerDefn());
+      dstFeature.ogr().SetField(0, label);
+      dstFeature.SetGeometryDirectly(otb::move(physical));
+      outputLayer.CreateFeature(dstFeature);
+      }
+    }
+
+  // Merge the polygons crossing the seams, and write one feature per
+  // resulting polygon
+  for (typename SeamPolygonsMapType::const_iterator it = seamPolygons.begin(); it != seamPolygons.end(); ++it)
+    {
+    ogr::UniqueGeometryPtr merged;
+    if (it->second.getNumGeometries() == 1)
+      {
+      merged.reset(it->second.getGeometryRef(0)->clone());
+      }
+    else
+      {
+      merged = ogr::UnionCascaded(it->second);
+      }
+
+    std::vector<const OGRGeometry *> polygons;
+    if (wkbFlatten(merged->getGeometryType()) == wkbPolygon)
+      {
+      polygons.push_back(merged.get());
+      }
+    else
+      {
+      const OGRGeometryCollection * collection = static_cast<const OGRGeometryCollection *>(merged.get());
+      for (int k = 0; k < collection->getNumGeometries(); ++k)
+        {
+        if (wkbFlatten(collection->getGeometryRef(k)->getGeometryType()) == wkbPolygon)
+          {
+          polygons.push_back(collection->getGeometryRef(k));
+          }
+        }
+      }
+
+    for (unsigned int k = 0; k < polygons.size(); ++k)
+      {
+      ogr::UniqueGeometryPtr physical(polygons[k]->clone());
+      TransformGeometry(physical.get(), geoTransform);
+
+      ogr::Feature dstFeature(outputLayer.GetLayerDefn());
+      dstFeature.ogr().SetField(0, it->first);
+      dstFeature.SetGeometryDirectly(otb::move(physical));
+      outputLayer.CreateFeature(dstFeature);
+      }
+    }
+
+  m_Tiles.clear();
+  m_TileDataSources.clear();
+}
+
+template <class TInputImage>
+void
+LabelImageToOGRDataSourceFilter<TInputImage>
+::PolygonizeTile(unsigned int tile)
+{
+  char ** options;
+  options = ITK_NULLPTR;
+  char * option[2];
+  std::string opt("8CONNECTED:8");
+  if (m_Use8Connected == true)
+  {
+    option[0] = const_cast<char *>(opt.c_str());
+    option[1] = ITK_NULLPTR;
+    options=option;
+  }
+
+  GDALDataset * dataset = OpenPixelDataset(this->GetInput(), m_Tiles[tile]);
+  OGRLayerType tileLayer = m_TileDataSources[tile]->GetLayerChecked(0);
+
+  typename InputImageType::ConstPointer inputMask = this->GetInputMask();
+  if (!inputMask.IsNull())
+  {
+    GDALDataset * maskDataset = OpenPixelDataset(inputMask, m_Tiles[tile]);
+    GDALPolygonize(dataset->GetRasterBand(1), maskDataset->GetRasterBand(1), &tileLayer.ogr(), 0, options, ITK_NULLPTR, ITK_NULLPTR);
+    GDALClose(maskDataset);
+  }
+  else
+  {
+    GDALPolygonize(dataset->GetRasterBand(1), ITK_NULLPTR, &tileLayer.ogr(), 0, options, ITK_NULLPTR, ITK_NULLPTR);
+  }
+
+  GDALClose(dataset);
+}
+
+template <class TInputImage>
+GDALDataset *
+LabelImageToOGRDataSourceFilter<TInputImage>
+::OpenPixelDataset(const InputImageType * image, const RegionType & region)
+{
+  const RegionType bufferedRegion = image->GetBufferedRegion();
+  const unsigned int nbBands = image->GetNumberOfComponentsPerPixel();
+  const unsigned int bytePerPixel = sizeof(InputPixelType);
+
+  const InputPixelType * buffer = image->GetBufferPointer() + image->ComputeOffset(region.GetIndex()) * nbBands;
+
+  // The lines of the tile are strided by the width of the buffer
+  std::ostringstream stream;
+  stream << "MEM:::"
+         <<  "DATAPOINTER=" << (uintptr_t)(buffer) << ","
+         <<  "PIXELS=" << region.GetSize(0) << ","
+         <<  "LINES=" << region.GetSize(1) << ","
+         <<  "BANDS=" << nbBands << ","
+         <<  "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<InputPixelType>()) << ","
+         <<  "PIXELOFFSET=" << bytePerPixel * nbBands << ","
+         <<  "LINEOFFSET=" << bytePerPixel * nbBands * bufferedRegion.GetSize(0) << ","
+         <<  "BANDOFFSET=" << bytePerPixel;
+
+  GDALDataset * dataset = static_cast<GDALDataset *> (GDALOpen(stream.str().c_str(), GA_ReadOnly));
+
+  // Integer pixel coordinates, relative to the buffered region, so that
+  // the borders of adjacent tiles match exactly
+  double geoTransform[6];
+  geoTransform[0] = static_cast<double>(region.GetIndex(0) - bufferedRegion.GetIndex(0));
+  geoTransform[1] = 1.;
+  geoTransform[2] = 0.;
+  geoTransform[3] = static_cast<double>(region.GetIndex(1) - bufferedRegion.GetIndex(1));
+  geoTransform[4] = 0.;
+  geoTransform[5] = 1.;
+  dataset->SetGeoTransform(geoTransform);
+
+  return dataset;
+}
+
+template <class TInputImage>
+void
+LabelImageToOGRDataSourceFilter<TInputImage>
+::TransformGeometry(OGRGeometry * geometry, const double * geoTransform)
+{
+  const OGRwkbGeometryType type = wkbFlatten(geometry->getGeometryType());
+  if (type == wkbMultiPolygon)
+    {
+    OGRMultiPolygon * multiPolygon = static_cast<OGRMultiPolygon *>(geometry);
+    for (int k = 0; k < multiPolygon->getNumGeometries(); ++k)
+      {
+      TransformGeometry(multiPolygon->getGeometryRef(k), geoTransform);
+      }
+    return;
+    }
+  if (type != wkbPolygon)
+    {
+    return;
+    }
+
+  OGRPolygon * polygon = static_cast<OGRPolygon *>(geometry);
+  for (int r = -1; r < polygon->getNumInteriorRings(); ++r)
+    {
+    OGRLinearRing * ring = (r < 0) ? polygon->getExteriorRing() : polygon->getInteriorRing(r);
+    for (int k = 0; k < ring->getNumPoints(); ++k)
+      {
+      // Same expression as GDALPolygonize() with the geo transform
+      const double x = ring->getX(k);
+      const double y = ring->getY(k);
+      ring->setPoint(k,
+                     geoTransform[0] + x * geoTransform[1] + y * geoTransform[2],
+                     geoTransform[3] + x * geoTransform[4] + y * geoTransform[5]);
+      }
+    }
+}
+
+template <class TInputImage>
+ITK_THREAD_RETURN_TYPE
+LabelImageToOGRDataSourceFilter<TInputImage>
+::PolygonizeThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const itk::ThreadIdType threadId = info->ThreadID;
+  const itk::ThreadIdType threadCount = info->NumberOfThreads;
+  ThreadStruct *          str = static_cast<ThreadStruct *>(info->UserData);
+
+  // Interleaved tiles, so that the threads work on the whole image
+  for (unsigned int tile = threadId; tile < str->Filter->m_Tiles.size(); tile += threadCount)
+    {
+    str->Filter->PolygonizeTile(tile);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 } // end namespace otb
 
 #endif
@@ -50,6 +50,21 @@ namespace otb {
  *    - Setting the Origin/Size/Spacing of the output image
  *    - Using an existing image as support via SetOutputParametersFromImage(ImageBase)
  *
+ *  By default, each requested region is burnt by a single call to \c
+ *  GDALRasterizeLayers(), which scans all the geometries. When
+ *  NativeRasterization is on, the geometries are read once into a grid
+ *  index, in the pixel coordinates of the largest possible region, and
+ *  the requested region is split between threads. Each thread only
+ *  fills the geometries intersecting its region, with a scanline
+ *  rasterization of their edge table (edges are stored with the integer
+ *  range of rows they cross). It uses the pixel center rule of GDAL: a
+ *  pixel is burnt if its center is inside the polygon, and features
+ *  are burnt in layer order. Polygonal geometries are filled natively,
+ *  other geometries are burnt with \c GDALRasterizeGeometries() in
+ *  the region of the thread. The result is the same as with GDAL,
+ *  except for pixels whose center lies exactly on a boundary (in
+ *  particular on horizontal edges, which GDAL burns).
+ *  The index is rebuilt when the filter or its inputs are modified.
  *
  * \ingroup OTBConversion
  */
@@ -136,6 +151,11 @@ public:
   itkGetConstReferenceMacro(BurnAttributeMode,bool);
   itkBooleanMacro(BurnAttributeMode);
 
+  /** Set/Get the NativeRasterization flag (default is off) */
+  itkSetMacro(NativeRasterization,bool);
+  itkGetConstReferenceMacro(NativeRasterization,bool);
+  itkBooleanMacro(NativeRasterization);
+
   /** Useful to set the output parameters from an existing image*/
   void SetOutputParametersFromImage(const ImageBaseType * image);
 
@@ -143,16 +163,70 @@ protected:
   void GenerateData() ITK_OVERRIDE;
 
   OGRDataSourceToLabelImageFilter();
-  ~OGRDataSourceToLabelImageFilter() ITK_OVERRIDE {}
+  ~OGRDataSourceToLabelImageFilter() ITK_OVERRIDE;
 
   void GenerateOutputInformation() ITK_OVERRIDE;
 
+  /** Build the index of the geometries if needed (native rasterization) */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Burn the geometries intersecting the region (native rasterization) */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            itk::ThreadIdType threadId) ITK_OVERRIDE;
+
   void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
 
 private:
   OGRDataSourceToLabelImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  /** Edge of a polygon, in pixel coordinates */
+  struct Edge
+  {
+    // Rows whose center is crossed by the edge: [RowStart, RowEnd)
+    long   RowStart;
+    long   RowEnd;
+    // Lower end and inverse slope
+    double X;
+    double Y;
+    double Slope;
+
+    bool operator<(const Edge & other) const
+    {
+      return RowStart < other.RowStart;
+    }
+  };
+
+  /** A geometry to burn */
+  struct IndexedFeature
+  {
+    double            Value;
+    // Bounding box in pixels, clipped to the output
+    long              MinX;
+    long              MinY;
+    long              MaxX;
+    long              MaxY;
+    // Edges of all the rings (polygonal geometries)
+    std::vector<Edge> Edges;
+    // Non polygonal geometry burnt by GDAL (owned), or null
+    OGRGeometry *     Geometry;
+  };
+
+  /** Read the geometries of the inputs into the grid index */
+  void BuildIndex();
+
+  /** Release the geometries of the index */
+  void ClearIndex();
+
+  /** Add a geometry (in the output projection) to the index */
+  void AddGeometry(const OGRGeometry * geometry, double value, const double * invGeoTransform);
+
+  /** Burn a polygonal feature in the region */
+  void FillPolygon(const IndexedFeature & feature, const OutputImageRegionType & region);
+
+  /** Burn a non polygonal feature in the region with GDAL */
+  void BurnGeometry(const IndexedFeature & feature, const OutputImageRegionType & region);
+
   std::vector< OGRLayerH >    m_SrcDataSetLayers;
   std::vector<int>            m_BandsToBurn;
 
@@ -168,6 +242,16 @@ private:
   OutputImageInternalPixelType  m_BackgroundValue;
   OutputImageInternalPixelType  m_ForegroundValue;
   bool                          m_BurnAttributeMode;
+  bool                          m_NativeRasterization;
+
+  // Grid index of the native rasterization
+  std::vector<IndexedFeature>             m_Features;
+  std::vector<std::vector<unsigned int> > m_Cells;
+  unsigned long                           m_CellSize;
+  unsigned long                           m_NumberOfCellsX;
+  unsigned long                           m_NumberOfCellsY;
+  double                                  m_GeoTransform[6];
+  itk::TimeStamp                          m_IndexTime;
 }; // end of class VectorDataToLabelImageFilter
 
 } // end of namespace otb
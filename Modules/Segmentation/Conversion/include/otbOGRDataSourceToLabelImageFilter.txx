@@ -29,8 +29,12 @@
 #include "otbMetaDataKey.h"
 
 #include "gdal_alg.h"
+#include "ogr_srs_api.h"
 #include "stdint.h" //needed for uintptr_t
 
+#include <algorithm>
+#include <cmath>
+
 namespace otb
 {
 template< class TOutputImage>
@@ -38,7 +42,11 @@ OGRDataSourceToLabelImageFilter<TOutputImage>
 ::OGRDataSourceToLabelImageFilter() : m_BurnAttribute("DN"),
                                       m_BackgroundValue(0),
                                       m_ForegroundValue(255),
-                                      m_BurnAttributeMode(true)
+                                      m_BurnAttributeMode(true),
+                                      m_NativeRasterization(false),
+                                      m_CellSize(256),
+                                      m_NumberOfCellsX(0),
+                                      m_NumberOfCellsY(0)
 {
   this->SetNumberOfRequiredInputs(1);
 
@@ -49,6 +57,14 @@ OGRDataSourceToLabelImageFilter<TOutputImage>
   m_BandsToBurn.clear();
   m_BandsToBurn.push_back(1);
 
+  std::fill(m_GeoTransform, m_GeoTransform + 6, 0.);
+}
+
+template< class TOutputImage>
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::~OGRDataSourceToLabelImageFilter()
+{
+  this->ClearIndex();
 }
 
 template< class TOutputImage>
@@ -161,6 +177,7 @@ OGRDataSourceToLabelImageFilter<TOutputImage>
                                          static_cast<std::string>(this->GetOutputProjectionRef()));
 
   // Generate the OGRLayers from the input OGRDataSource
+  m_SrcDataSetLayers.clear();
   for (unsigned int idx = 0; idx < this->GetNumberOfInputs(); ++idx)
     {
     OGRDataSourcePointerType ogrDS = dynamic_cast<OGRDataSourceType*>(this->itk::ProcessObject::GetInput(idx));
@@ -186,6 +203,13 @@ template< class TOutputImage>
 void
 OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateData()
 {
+  if (m_NativeRasterization)
+    {
+    // Multi-threaded rasterization through ThreadedGenerateData()
+    Superclass::GenerateData();
+    return;
+    }
+
   // Call Superclass GenerateData
   this->AllocateOutputs();
 
@@ -263,12 +287,445 @@ OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateData()
      }
 }
 
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  // The index is kept between the stream divisions
+  itk::ModifiedTimeType inputsTime = 0;
+  for (unsigned int idx = 0; idx < this->GetNumberOfInputs(); ++idx)
+    {
+    inputsTime = std::max(inputsTime, this->itk::ProcessObject::GetInput(idx)->GetMTime());
+    }
+
+  if (m_IndexTime.GetMTime() < this->GetMTime() || m_IndexTime.GetMTime() < inputsTime)
+    {
+    this->BuildIndex();
+    }
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType itkNotUsed(threadId))
+{
+  OutputImagePointer output = this->GetOutput();
+  const unsigned int nbBands = output->GetNumberOfComponentsPerPixel();
+  const OutputIndexType largestIndex = output->GetLargestPossibleRegion().GetIndex();
+
+  // Fill the region with the background value
+  OutputIndexType rowIndex = outputRegionForThread.GetIndex();
+  for (unsigned long row = 0; row < outputRegionForThread.GetSize(1); ++row)
+    {
+    rowIndex[1] = outputRegionForThread.GetIndex(1) + row;
+    OutputImageInternalPixelType * rowBuffer = output->GetBufferPointer() + output->ComputeOffset(rowIndex) * nbBands;
+    std::fill(rowBuffer, rowBuffer + outputRegionForThread.GetSize(0) * nbBands, m_BackgroundValue);
+    }
+
+  if (m_Features.empty())
+    {
+    return;
+    }
+
+  // Features in the cells intersecting the region, in layer order
+  const unsigned long minX = outputRegionForThread.GetIndex(0) - largestIndex[0];
+  const unsigned long minY = outputRegionForThread.GetIndex(1) - largestIndex[1];
+  const unsigned long maxX = minX + outputRegionForThread.GetSize(0) - 1;
+  const unsigned long maxY = minY + outputRegionForThread.GetSize(1) - 1;
+
+  std::vector<unsigned int> candidates;
+  for (unsigned long cy = minY / m_CellSize; cy <= maxY / m_CellSize; ++cy)
+    {
+    for (unsigned long cx = minX / m_CellSize; cx <= maxX / m_CellSize; ++cx)
+      {
+      const std::vector<unsigned int> & cell = m_Cells[cy * m_NumberOfCellsX + cx];
+      candidates.insert(candidates.end(), cell.begin(), cell.end());
+      }
+    }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  for (unsigned int k = 0; k < candidates.size(); ++k)
+    {
+    const IndexedFeature & feature = m_Features[candidates[k]];
+    if (feature.Geometry != ITK_NULLPTR)
+      {
+      this->BurnGeometry(feature, outputRegionForThread);
+      }
+    else
+      {
+      this->FillPolygon(feature, outputRegionForThread);
+      }
+    }
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::BuildIndex()
+{
+  this->ClearIndex();
+
+  OutputImagePointer output = this->GetOutput();
+  const OutputImageRegionType largestRegion = output->GetLargestPossibleRegion();
+
+  // Geo transform of the largest possible region, as in GenerateData()
+  OutputOriginType largestOrigin;
+  output->TransformIndexToPhysicalPoint(largestRegion.GetIndex(), largestOrigin);
+  m_GeoTransform[0] = largestOrigin[0] - 0.5 * output->GetSpacing()[0];
+  m_GeoTransform[3] = largestOrigin[1] - 0.5 * output->GetSpacing()[1];
+  m_GeoTransform[1] = output->GetSpacing()[0];
+  m_GeoTransform[5] = output->GetSpacing()[1];
+  m_GeoTransform[2] = 0.;
+  m_GeoTransform[4] = 0.;
+
+  double invGeoTransform[6];
+  if (!GDALInvGeoTransform(m_GeoTransform, invGeoTransform))
+    {
+    itkExceptionMacro(<< "Unable to invert the geo transform of the output image.");
+    }
+
+  m_NumberOfCellsX = (largestRegion.GetSize(0) + m_CellSize - 1) / m_CellSize;
+  m_NumberOfCellsY = (largestRegion.GetSize(1) + m_CellSize - 1) / m_CellSize;
+  m_Cells.assign(m_NumberOfCellsX * m_NumberOfCellsY, std::vector<unsigned int>());
+
+  // Layers are reprojected to the output projection, as GDALRasterizeLayers() does
+  OGRSpatialReference outputSRS;
+  bool hasOutputSRS = false;
+  const std::string projectionRef = output->GetProjectionRef();
+  if (!projectionRef.empty())
+    {
+    char * wkt = const_cast<char *>(projectionRef.c_str());
+    hasOutputSRS = (outputSRS.importFromWkt(&wkt) == OGRERR_NONE);
+    }
+
+  for (unsigned int idx = 0; idx < this->GetNumberOfInputs(); ++idx)
+    {
+    OGRDataSourcePointerType ogrDS = dynamic_cast<OGRDataSourceType*>(this->itk::ProcessObject::GetInput(idx));
+    const unsigned int nbLayers = ogrDS->GetLayersCount();
+
+    for (unsigned int l = 0; l < nbLayers; ++l)
+      {
+      OGRLayerType layer = ogrDS->GetLayer(l);
+
+      int burnField = -1;
+      if (m_BurnAttributeMode)
+        {
+        burnField = layer.GetLayerDefn().GetFieldIndex(m_BurnAttribute.c_str());
+        if (burnField < 0)
+          {
+          itkExceptionMacro(<< "Field " << m_BurnAttribute << " not found in OGR layer " << layer.ogr().GetName() << ".");
+          }
+        }
+
+      OGRCoordinateTransformation * transform = ITK_NULLPTR;
+      OGRSpatialReference * layerSRS = layer.ogr().GetSpatialRef();
+      if (hasOutputSRS && layerSRS != ITK_NULLPTR && !layerSRS->IsSame(&outputSRS))
+        {
+        transform = OGRCreateCoordinateTransformation(layerSRS, &outputSRS);
+        }
+
+      for (typename OGRLayerType::const_iterator featIt = layer.begin(); featIt != layer.end(); ++featIt)
+        {
+        const OGRGeometry * geometry = featIt->GetGeometry();
+        if (geometry == ITK_NULLPTR)
+          {
+          continue;
+          }
+
+        const double value = m_BurnAttributeMode ? featIt->ogr().GetFieldAsDouble(burnField)
+                                                 : static_cast<double>(m_ForegroundValue);
+
+        if (transform != ITK_NULLPTR)
+          {
+          ogr::UniqueGeometryPtr projected(geometry->clone());
+          if (projected->transform(transform) == OGRERR_NONE)
+            {
+            this->AddGeometry(projected.get(), value, invGeoTransform);
+            }
+          }
+        else
+          {
+          this->AddGeometry(geometry, value, invGeoTransform);
+          }
+        }
+
+      if (transform != ITK_NULLPTR)
+        {
+        OCTDestroyCoordinateTransformation(reinterpret_cast<OGRCoordinateTransformationH>(transform));
+        }
+      }
+    }
+
+  m_IndexTime.Modified();
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::ClearIndex()
+{
+  for (unsigned int k = 0; k < m_Features.size(); ++k)
+    {
+    if (m_Features[k].Geometry != ITK_NULLPTR)
+      {
+      OGRGeometryFactory::destroyGeometry(m_Features[k].Geometry);
+      }
+    }
+  m_Features.clear();
+  m_Cells.clear();
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::AddGeometry(const OGRGeometry * geometry, double value, const double * invGeoTransform)
+{
+  const OutputSizeType size = this->GetOutput()->GetLargestPossibleRegion().GetSize();
+
+  // Bounding box in pixels, with a margin of one pixel, clipped to the
+  // output (there is no rotation in the geo transform)
+  OGREnvelope envelope;
+  geometry->getEnvelope(&envelope);
+  const double x1 = invGeoTransform[0] + envelope.MinX * invGeoTransform[1];
+  const double x2 = invGeoTransform[0] + envelope.MaxX * invGeoTransform[1];
+  const double y1 = invGeoTransform[3] + envelope.MinY * invGeoTransform[5];
+  const double y2 = invGeoTransform[3] + envelope.MaxY * invGeoTransform[5];
+
+  const double minX = std::max(0., std::floor(std::min(x1, x2)) - 1.);
+  const double maxX = std::min(size[0] - 1., std::floor(std::max(x1, x2)) + 1.);
+  const double minY = std::max(0., std::floor(std::min(y1, y2)) - 1.);
+  const double maxY = std::min(size[1] - 1., std::floor(std::max(y1, y2)) + 1.);
+  if (minX > maxX || minY > maxY)
+    {
+    return;
+    }
+
+  IndexedFeature feature;
+  feature.Value = value;
+  feature.MinX = static_cast<long>(minX);
+  feature.MaxX = static_cast<long>(maxX);
+  feature.MinY = static_cast<long>(minY);
+  feature.MaxY = static_cast<long>(maxY);
+  feature.Geometry = ITK_NULLPTR;
+
+  std::vector<const OGRPolygon *> polygons;
+  const OGRwkbGeometryType type = wkbFlatten(geometry->getGeometryType());
+  if (type == wkbPolygon)
+    {
+    polygons.push_back(static_cast<const OGRPolygon *>(geometry));
+    }
+  else if (type == wkbMultiPolygon)
+    {
+    const OGRMultiPolygon * multiPolygon = static_cast<const OGRMultiPolygon *>(geometry);
+    for (int k = 0; k < multiPolygon->getNumGeometries(); ++k)
+      {
+      polygons.push_back(static_cast<const OGRPolygon *>(multiPolygon->getGeometryRef(k)));
+      }
+    }
+  else
+    {
+    feature.Geometry = geometry->clone();
+    }
+
+  // Edge table of all the rings: with the even-odd rule, holes and the
+  // parts of a multi-polygon are filled together
+  for (unsigned int p = 0; p < polygons.size(); ++p)
+    {
+    for (int r = -1; r < polygons[p]->getNumInteriorRings(); ++r)
+      {
+      const OGRLinearRing * ring = (r < 0) ? polygons[p]->getExteriorRing() : polygons[p]->getInteriorRing(r);
+      if (ring == ITK_NULLPTR)
+        {
+        continue;
+        }
+      const int nbPoints = ring->getNumPoints();
+      for (int k = 0; k < nbPoints; ++k)
+        {
+        const int next = (k + 1) % nbPoints;
+        double xa = invGeoTransform[0] + ring->getX(k) * invGeoTransform[1] + ring->getY(k) * invGeoTransform[2];
+        double ya = invGeoTransform[3] + ring->getX(k) * invGeoTransform[4] + ring->getY(k) * invGeoTransform[5];
+        double xb = invGeoTransform[0] + ring->getX(next) * invGeoTransform[1] + ring->getY(next) * invGeoTransform[2];
+        double yb = invGeoTransform[3] + ring->getX(next) * invGeoTransform[4] + ring->getY(next) * invGeoTransform[5];
+        if (ya == yb)
+          {
+          continue;
+          }
+        if (ya > yb)
+          {
+          std::swap(xa, xb);
+          std::swap(ya, yb);
+          }
+
+        // Rows whose center y + 0.5 is in [ya, yb), clipped to the output
+        const double rowStart = std::max(-1., std::ceil(ya - 0.5));
+        const double rowEnd = std::min(size[1] + 1., std::ceil(yb - 0.5));
+        if (rowStart >= rowEnd)
+          {
+          continue;
+          }
+
+        Edge edge;
+        edge.RowStart = static_cast<long>(rowStart);
+        edge.RowEnd = static_cast<long>(rowEnd);
+        edge.X = xa;
+        edge.Y = ya;
+        edge.Slope = (xb - xa) / (yb - ya);
+        feature.Edges.push_back(edge);
+        }
+      }
+    }
+  std::sort(feature.Edges.begin(), feature.Edges.end());
+
+  if (feature.Geometry == ITK_NULLPTR && feature.Edges.empty())
+    {
+    return;
+    }
+
+  const unsigned int index = m_Features.size();
+  m_Features.push_back(feature);
+
+  for (unsigned long cy = feature.MinY / m_CellSize; cy <= feature.MaxY / m_CellSize; ++cy)
+    {
+    for (unsigned long cx = feature.MinX / m_CellSize; cx <= feature.MaxX / m_CellSize; ++cx)
+      {
+      m_Cells[cy * m_NumberOfCellsX + cx].push_back(index);
+      }
+    }
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::FillPolygon(const IndexedFeature & feature, const OutputImageRegionType & region)
+{
+  OutputImagePointer output = this->GetOutput();
+  const unsigned int nbBands = output->GetNumberOfComponentsPerPixel();
+  const OutputIndexType largestIndex = output->GetLargestPossibleRegion().GetIndex();
+  const OutputImageInternalPixelType value = static_cast<OutputImageInternalPixelType>(feature.Value);
+
+  // Rows and columns of the feature in the region
+  const long regionMinX = region.GetIndex(0) - largestIndex[0];
+  const long regionMinY = region.GetIndex(1) - largestIndex[1];
+  const long colBegin = std::max(regionMinX, feature.MinX);
+  const long colEnd = std::min(regionMinX + static_cast<long>(region.GetSize(0)) - 1, feature.MaxX);
+  const long rowBegin = std::max(regionMinY, feature.MinY);
+  const long rowEnd = std::min(regionMinY + static_cast<long>(region.GetSize(1)) - 1, feature.MaxY);
+  if (colBegin > colEnd || rowBegin > rowEnd)
+    {
+    return;
+    }
+
+  std::vector<const Edge *> active;
+  std::vector<double> crossings;
+  unsigned int nextEdge = 0;
+
+  for (long row = rowBegin; row <= rowEnd; ++row)
+    {
+    // Update the active edges
+    while (nextEdge < feature.Edges.size() && feature.Edges[nextEdge].RowStart <= row)
+      {
+      active.push_back(&feature.Edges[nextEdge]);
+      ++nextEdge;
+      }
+    unsigned int nbActive = 0;
+    for (unsigned int k = 0; k < active.size(); ++k)
+      {
+      if (active[k]->RowEnd > row)
+        {
+        active[nbActive++] = active[k];
+        }
+      }
+    active.resize(nbActive);
+
+    const double center = row + 0.5;
+    crossings.clear();
+    for (unsigned int k = 0; k < active.size(); ++k)
+      {
+      crossings.push_back(active[k]->X + (center - active[k]->Y) * active[k]->Slope);
+      }
+    std::sort(crossings.begin(), crossings.end());
+
+    OutputIndexType index;
+    index[1] = largestIndex[1] + row;
+    for (unsigned int k = 0; k + 1 < crossings.size(); k += 2)
+      {
+      // Pixels whose center is between the crossings, rounded as GDAL does
+      const double start = std::max(static_cast<double>(colBegin), std::floor(crossings[k] + 0.5));
+      const double end = std::min(static_cast<double>(colEnd), std::floor(crossings[k + 1] + 0.5) - 1.);
+      if (start > end)
+        {
+        continue;
+        }
+
+      index[0] = largestIndex[0] + static_cast<long>(start);
+      OutputImageInternalPixelType * pixel = output->GetBufferPointer() + output->ComputeOffset(index) * nbBands;
+      std::fill(pixel, pixel + (static_cast<long>(end) - static_cast<long>(start) + 1) * nbBands, value);
+      }
+    }
+}
+
+template< class TOutputImage>
+void
+OGRDataSourceToLabelImageFilter<TOutputImage>
+::BurnGeometry(const IndexedFeature & feature, const OutputImageRegionType & region)
+{
+  OutputImagePointer output = this->GetOutput();
+  const unsigned int nbBands = output->GetNumberOfComponentsPerPixel();
+  const OutputIndexType largestIndex = output->GetLargestPossibleRegion().GetIndex();
+  const OutputImageRegionType bufferedRegion = output->GetBufferedRegion();
+
+  // MEM dataset on the region, whose lines are strided by the width of
+  // the buffer
+  std::ostringstream stream;
+  stream << "MEM:::"
+         <<  "DATAPOINTER=" << (uintptr_t)(output->GetBufferPointer() + output->ComputeOffset(region.GetIndex()) * nbBands) << ","
+         <<  "PIXELS=" << region.GetSize()[0] << ","
+         <<  "LINES=" << region.GetSize()[1]<< ","
+         <<  "BANDS=" << nbBands << ","
+         <<  "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<OutputImageInternalPixelType>()) << ","
+         <<  "PIXELOFFSET=" << sizeof(OutputImageInternalPixelType) *  nbBands << ","
+         <<  "LINEOFFSET=" << sizeof(OutputImageInternalPixelType)*nbBands*bufferedRegion.GetSize()[0] << ","
+         <<  "BANDOFFSET=" << sizeof(OutputImageInternalPixelType);
+
+  GDALDatasetH dataset = GDALOpen(stream.str().c_str(), GA_Update);
+  if (dataset == ITK_NULLPTR)
+    {
+    return;
+    }
+
+  double geoTransform[6];
+  geoTransform[0] = m_GeoTransform[0] + (region.GetIndex(0) - largestIndex[0]) * m_GeoTransform[1];
+  geoTransform[1] = m_GeoTransform[1];
+  geoTransform[2] = 0.;
+  geoTransform[3] = m_GeoTransform[3] + (region.GetIndex(1) - largestIndex[1]) * m_GeoTransform[5];
+  geoTransform[4] = 0.;
+  geoTransform[5] = m_GeoTransform[5];
+  GDALSetGeoTransform(dataset, geoTransform);
+
+  std::vector<int> bands(nbBands);
+  for (unsigned int band = 0; band < nbBands; ++band)
+    {
+    bands[band] = band + 1;
+    }
+  std::vector<double> burnValues(nbBands, feature.Value);
+  OGRGeometryH geometry = reinterpret_cast<OGRGeometryH>(feature.Geometry);
+
+  GDALRasterizeGeometries(dataset, nbBands, &bands[0], 1, &geometry,
+                          ITK_NULLPTR, ITK_NULLPTR, &burnValues[0],
+                          ITK_NULLPTR, ITK_NULLPTR, ITK_NULLPTR);
+  GDALClose(dataset);
+}
+
 template< class TOutputImage>
 void
 OGRDataSourceToLabelImageFilter<TOutputImage>
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "NativeRasterization: " << m_NativeRasterization << std::endl;
 }
 
 } // end namespace otb
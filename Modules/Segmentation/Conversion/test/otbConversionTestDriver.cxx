@@ -25,11 +25,13 @@ void RegisterTests()
   REGISTER_TEST(otbVectorDataToLabelMapFilter);
   REGISTER_TEST(otbOGRDataSourceToLabelImageFilterNew);
   REGISTER_TEST(otbOGRDataSourceToLabelImageFilter);
+  REGISTER_TEST(otbOGRDataSourceToLabelImageFilterNative);
   REGISTER_TEST(otbVectorDataToLabelMapFilterNew);
   REGISTER_TEST(otbLabelImageToVectorDataFilterNew);
   REGISTER_TEST(otbLabelImageToVectorDataFilter);
   REGISTER_TEST(otbLabelImageToOGRDataSourceFilterNew);
   REGISTER_TEST(otbLabelImageToOGRDataSourceFilter);
+  REGISTER_TEST(otbLabelImageToOGRDataSourceFilterTiled);
   REGISTER_TEST(otbVectorDataToLabelImageFilterNew);
   REGISTER_TEST(otbVectorDataToLabelImageFilter);
   REGISTER_TEST(otbPolygonizationRasterizationTest);
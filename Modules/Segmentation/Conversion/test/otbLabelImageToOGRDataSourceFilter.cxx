@@ -24,6 +24,11 @@
 #include "otbImage.h"
 #include "otbImageFileReader.h"
 #include "otbVectorDataFileWriter.h"
+#include "otbOGRDataSourceToLabelImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+#include <cmath>
+#include <map>
 
 int otbLabelImageToOGRDataSourceFilterNew(int itkNotUsed(argc), char * itkNotUsed(argv) [])
 {
@@ -69,3 +74,103 @@ int otbLabelImageToOGRDataSourceFilter(int argc, char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+namespace
+{
+typedef otb::ogr::DataSource OGRDataSourceType;
+
+// Area of the polygons per label
+std::map<int, double> ComputeAreas(const OGRDataSourceType * ds, unsigned long & nbFeatures)
+{
+  std::map<int, double> areas;
+  nbFeatures = 0;
+  otb::ogr::Layer layer = ds->GetLayerChecked(0);
+  for (otb::ogr::Layer::const_iterator featIt = layer.begin(); featIt != layer.end(); ++featIt)
+    {
+    const OGRPolygon * polygon = dynamic_cast<const OGRPolygon *>(featIt->GetGeometry());
+    if (polygon != ITK_NULLPTR)
+      {
+      areas[featIt->ogr().GetFieldAsInteger(0)] += polygon->get_Area();
+      }
+    ++nbFeatures;
+    }
+  return areas;
+}
+}
+
+int otbLabelImageToOGRDataSourceFilterTiled(int argc, char * argv[])
+{
+  if (argc != 3)
+    {
+    std::cerr << "Usage: " << argv[0];
+    std::cerr << " inputLabelImageFile tileSize" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<unsigned int, 2>                                 InputLabelImageType;
+  typedef otb::LabelImageToOGRDataSourceFilter<InputLabelImageType>   FilterType;
+  typedef otb::ImageFileReader<InputLabelImageType>                   LabelImageReaderType;
+  typedef otb::OGRDataSourceToLabelImageFilter<InputLabelImageType>   RasterizationFilterType;
+
+  LabelImageReaderType::Pointer reader = LabelImageReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->Update();
+
+  FilterType::Pointer reference = FilterType::New();
+  reference->SetInput(reader->GetOutput());
+  reference->Update();
+
+  FilterType::Pointer tiled = FilterType::New();
+  tiled->SetInput(reader->GetOutput());
+  tiled->SetTileSize(atoi(argv[2]));
+  tiled->SetNumberOfThreads(4);
+  tiled->Update();
+
+  // Same polygons as the single GDALPolygonize() call
+  unsigned long nbRefFeatures = 0;
+  unsigned long nbTiledFeatures = 0;
+  const std::map<int, double> refAreas = ComputeAreas(reference->GetOutput(), nbRefFeatures);
+  const std::map<int, double> tiledAreas = ComputeAreas(tiled->GetOutput(), nbTiledFeatures);
+
+  bool ok = true;
+  if (nbRefFeatures != nbTiledFeatures || refAreas.size() != tiledAreas.size())
+    {
+    std::cerr << "Tiled polygonization gives " << nbTiledFeatures << " features for " << tiledAreas.size()
+              << " labels instead of " << nbRefFeatures << " features for " << refAreas.size() << " labels" << std::endl;
+    ok = false;
+    }
+  for (std::map<int, double>::const_iterator it = refAreas.begin(); it != refAreas.end(); ++it)
+    {
+    std::map<int, double>::const_iterator tiledIt = tiledAreas.find(it->first);
+    if (tiledIt == tiledAreas.end() || std::abs(tiledIt->second - it->second) > 1e-6 * it->second)
+      {
+      std::cerr << "Area of label " << it->first << " differs: " << it->second << " vs "
+                << (tiledIt == tiledAreas.end() ? 0. : tiledIt->second) << std::endl;
+      ok = false;
+      }
+    }
+
+  // The rasterization of the merged polygons gives back the labels
+  RasterizationFilterType::Pointer rasterization = RasterizationFilterType::New();
+  rasterization->AddOGRDataSource(tiled->GetOutput());
+  rasterization->SetOutputParametersFromImage(reader->GetOutput());
+  rasterization->SetBurnAttribute("DN");
+  rasterization->Update();
+
+  itk::ImageRegionConstIteratorWithIndex<InputLabelImageType> itRef(reader->GetOutput(),
+                                                                    reader->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIteratorWithIndex<InputLabelImageType> itTest(rasterization->GetOutput(),
+                                                                     rasterization->GetOutput()->GetLargestPossibleRegion());
+  for (itRef.GoToBegin(), itTest.GoToBegin(); !itRef.IsAtEnd() && !itTest.IsAtEnd(); ++itRef, ++itTest)
+    {
+    if (itRef.Get() != itTest.Get())
+      {
+      std::cerr << "Pixel at position " << itRef.GetIndex() << " differs : in=" << itRef.Get()
+                << " while out=" << itTest.Get() << std::endl;
+      ok = false;
+      break;
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
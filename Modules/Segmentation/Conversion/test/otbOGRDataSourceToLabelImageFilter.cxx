@@ -19,12 +19,15 @@
  */
 
 #include "otbImage.h"
+#include "otbMath.h"
 #include "otbImageFileReader.h"
 #include "otbImageFileWriter.h"
 
 
 #include "otbOGRDataSourceToLabelImageFilter.h"
 #include "otbStandardOneLineFilterWatcher.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 
 typedef otb::Image<unsigned int, 2>                           ImageType;
 typedef otb::ImageFileReader<ImageType>                       ReaderType;
@@ -38,7 +41,7 @@ int otbOGRDataSourceToLabelImageFilterNew(int itkNotUsed(argc), char * itkNotUse
   return EXIT_SUCCESS;
 }
 
-int otbOGRDataSourceToLabelImageFilter(int itkNotUsed(argc), char * argv[])
+int otbOGRDataSourceToLabelImageFilter(int argc, char * argv[])
 {
 
   ReaderType::Pointer reader = ReaderType::New();
@@ -59,6 +62,10 @@ int otbOGRDataSourceToLabelImageFilter(int itkNotUsed(argc), char * argv[])
   rasterization->SetBurnAttributeMode(mode);
   rasterization->SetBackgroundValue(background);
   rasterization->SetForegroundValue(foreground);
+  if (argc > 7)
+    {
+    rasterization->SetNativeRasterization(atoi(argv[7]));
+    }
 
   /*otb::StandardOneLineFilterWatcher * watch = new otb::StandardOneLineFilterWatcher(rasterization.GetPointer(),
                                                                           "rasterization"); */
@@ -70,3 +77,124 @@ int otbOGRDataSourceToLabelImageFilter(int itkNotUsed(argc), char * argv[])
 
 return EXIT_SUCCESS;
 }
+
+int otbOGRDataSourceToLabelImageFilterNative(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  // This test checks the native rasterization against GDAL on random
+  // polygons (with holes and multi-polygons), in several stream
+  // divisions
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::GetInstance();
+  generator->SetSeed(121212);
+
+  otb::ogr::DataSource::Pointer ogrDS = otb::ogr::DataSource::New();
+  otb::ogr::Layer layer = ogrDS->CreateLayer("layer", ITK_NULLPTR, wkbUnknown);
+  OGRFieldDefn field("DN", OFTInteger);
+  layer.CreateField(field, true);
+
+  for (unsigned int k = 0; k < 200; ++k)
+    {
+    const double cx = generator->GetUniformVariate(-20., 320.);
+    const double cy = generator->GetUniformVariate(-20., 220.);
+    const double radius = generator->GetUniformVariate(1., 40.);
+
+    OGRPolygon polygon;
+    OGRLinearRing outer;
+    OGRLinearRing inner;
+    const unsigned int nbPoints = 3 + k % 6;
+    for (unsigned int p = 0; p < nbPoints; ++p)
+      {
+      const double angle = 2. * CONST_PI * p / nbPoints;
+      const double r = radius * generator->GetUniformVariate(0.6, 1.);
+      outer.addPoint(cx + r * std::cos(angle), cy + r * std::sin(angle));
+      inner.addPoint(cx + 0.3 * r * std::cos(angle), cy + 0.3 * r * std::sin(angle));
+      }
+    outer.closeRings();
+    inner.closeRings();
+    polygon.addRing(&outer);
+    if (k % 3 == 0)
+      {
+      polygon.addRing(&inner);
+      }
+
+    otb::ogr::Feature feature(layer.GetLayerDefn());
+    feature.ogr().SetField(0, static_cast<int>(k + 1));
+    if (k % 5 == 0)
+      {
+      OGRMultiPolygon multiPolygon;
+      multiPolygon.addGeometry(&polygon);
+      OGRPolygon * moved = static_cast<OGRPolygon *>(polygon.clone());
+      for (int r = -1; r < moved->getNumInteriorRings(); ++r)
+        {
+        OGRLinearRing * ring = (r < 0) ? moved->getExteriorRing() : moved->getInteriorRing(r);
+        for (int p = 0; p < ring->getNumPoints(); ++p)
+          {
+          ring->setPoint(p, ring->getX(p) + 2.5 * radius, ring->getY(p) + 0.37);
+          }
+        }
+      multiPolygon.addGeometryDirectly(moved);
+      feature.SetGeometry(&multiPolygon);
+      }
+    else
+      {
+      feature.SetGeometry(&polygon);
+      }
+    layer.CreateFeature(feature);
+    }
+
+  ImageType::SizeType size;
+  size[0] = 301;
+  size[1] = 203;
+  ImageType::PointType origin;
+  origin[0] = 0.5;
+  origin[1] = 0.5;
+  ImageType::SpacingType spacing;
+  spacing.Fill(1.);
+
+  RasterizationFilterType::Pointer reference = RasterizationFilterType::New();
+  reference->AddOGRDataSource(ogrDS);
+  reference->SetOutputSize(size);
+  reference->SetOutputOrigin(origin);
+  reference->SetOutputSpacing(spacing);
+  reference->SetBackgroundValue(0);
+  reference->Update();
+
+  RasterizationFilterType::Pointer native = RasterizationFilterType::New();
+  native->AddOGRDataSource(ogrDS);
+  native->SetOutputSize(size);
+  native->SetOutputOrigin(origin);
+  native->SetOutputSpacing(spacing);
+  native->SetBackgroundValue(0);
+  native->SetNativeRasterization(true);
+  native->SetNumberOfThreads(3);
+  native->UpdateOutputInformation();
+
+  // Stream divisions of different heights, with an offset in x
+  const unsigned int divisions[5][4] = {{0, 0, 301, 203}, {0, 0, 301, 17}, {7, 17, 250, 90}, {0, 107, 301, 96}, {290, 0, 11, 203}};
+  bool ok = true;
+  for (unsigned int d = 0; d < 5 && ok; ++d)
+    {
+    ImageType::RegionType region;
+    region.SetIndex(0, divisions[d][0]);
+    region.SetIndex(1, divisions[d][1]);
+    region.SetSize(0, divisions[d][2]);
+    region.SetSize(1, divisions[d][3]);
+    native->GetOutput()->SetRequestedRegion(region);
+    native->Update();
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> itRef(reference->GetOutput(), region);
+    itk::ImageRegionConstIteratorWithIndex<ImageType> itTest(native->GetOutput(), region);
+    for (itRef.GoToBegin(), itTest.GoToBegin(); !itRef.IsAtEnd(); ++itRef, ++itTest)
+      {
+      if (itRef.Get() != itTest.Get())
+        {
+        std::cerr << "Division " << d << ", pixel " << itRef.GetIndex() << ": native rasterization gives "
+                  << itTest.Get() << " instead of " << itRef.Get() << std::endl;
+        ok = false;
+        break;
+        }
+      }
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
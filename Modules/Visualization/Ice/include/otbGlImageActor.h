@@ -30,6 +30,7 @@
 #include "otbGenericRSTransform.h"
 #include "otbGeoInterface.h"
 #include "otbGlActor.h"
+#include "otbGlImageTileLoader.h"
 #include "otbImageFileReader.h"
 #include "otbImageSettings.h"
 #include "otbMultiChannelExtractROI.h"
@@ -128,6 +129,19 @@ public:
   itkSetMacro(SoftwareRendering, bool );
   itkGetMacro(SoftwareRendering, bool );
 
+  // Asynchronous loading: tiles (and a ring of tiles around the
+  // viewport) are read by the workers of the tile loader, and only
+  // uploaded to GPU in Render(). The view has to be rendered again
+  // while HasPendingTiles() is true. Default is off.
+  itkBooleanMacro(AsynchronousLoading);
+  itkSetMacro(AsynchronousLoading, bool);
+  itkGetMacro(AsynchronousLoading, bool);
+
+  itkGetObjectMacro(TileLoader, GlImageTileLoader);
+
+  // Are there tiles being loaded or waiting for upload ?
+  bool HasPendingTiles() const;
+
   void CreateShader();
 
   void SetResolutionAlgorithm(ResolutionAlgorithm::type alg)
@@ -262,6 +276,12 @@ private:
 
   // Load tile to GPU
   void LoadTile(Tile& tile);
+
+  // Upload a produced tile to GPU
+  void UploadTile(Tile& tile, GlImageTileLoader::TileData& data);
+
+  // Upload the tiles produced by the tile loader
+  void UploadProducedTiles();
   
   // Unload tile from GPU
   void UnloadTile(Tile& tile);
@@ -319,6 +339,10 @@ private:
 
   bool m_SoftwareRendering;
 
+  GlImageTileLoader::Pointer m_TileLoader;
+
+  bool m_AsynchronousLoading;
+
 }; // End class GlImageActor
 
 } // End namespace otb
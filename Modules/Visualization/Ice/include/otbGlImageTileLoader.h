@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otb_GlImageTileLoader_h
+#define otb_GlImageTileLoader_h
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+
+#include "otbImageFileReader.h"
+#include "otbVectorImage.h"
+
+#include "OTBIceExport.h"
+
+namespace otb
+{
+
+/** \class GlImageTileLoader
+ *
+ * \brief Background production of the tiles displayed by GlImageActor
+ *
+ * This class reads the tiles of an image (extraction of the three
+ * displayed channels at a given overview level) in a pool of worker
+ * threads, and converts them to the BGRA buffers uploaded as
+ * textures. It does not make any OpenGL call, so that it can be used
+ * (and tested) without any display: the texture upload is left to the
+ * caller, in the thread owning the OpenGL context.
+ *
+ * Each call to Request() replaces the set of wanted tiles: the
+ * visible ones are always queued, then the prefetched ones as long as
+ * the number of pending tiles is lower than
+ * MaximumNumberOfPendingTiles. Queued tiles which are not requested
+ * anymore are cancelled, and tiles being read are dropped when
+ * finished. Produced tiles are retrieved with GetProducedTiles().
+ *
+ * Each worker owns its reader, opened on the overview given by the
+ * resolution of the tile (see GetResolutionFileName()). Workers are
+ * spawned on the first request.
+ *
+ * \sa GlImageActor
+ *
+ * \ingroup OTBIce
+ */
+class OTBIce_EXPORT GlImageTileLoader
+  : public itk::Object
+{
+public:
+  typedef GlImageTileLoader                               Self;
+  typedef itk::Object                                     Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  itkNewMacro(Self);
+
+  itkTypeMacro(GlImageTileLoader, itk::Object);
+
+  typedef VectorImage<float>                              VectorImageType;
+  typedef VectorImageType::RegionType                     RegionType;
+  typedef ImageFileReader<VectorImageType>                ReaderType;
+
+  /** Identification of a tile */
+  struct TileKey
+  {
+    TileKey()
+      : m_ImageRegion(),
+        m_Resolution(0),
+        m_RedIdx(1),
+        m_GreenIdx(2),
+        m_BlueIdx(3)
+    {}
+
+    bool operator==(const TileKey & other) const
+    {
+      return m_ImageRegion == other.m_ImageRegion
+        && m_Resolution == other.m_Resolution
+        && m_RedIdx == other.m_RedIdx
+        && m_GreenIdx == other.m_GreenIdx
+        && m_BlueIdx == other.m_BlueIdx;
+    }
+
+    RegionType m_ImageRegion;
+    unsigned int m_Resolution;
+    unsigned int m_RedIdx;
+    unsigned int m_GreenIdx;
+    unsigned int m_BlueIdx;
+  };
+
+  /** A produced tile */
+  struct TileData
+  {
+    TileKey m_Key;
+    VectorImageType::Pointer m_Image;
+    // BGRA texture buffer (empty if ProduceTextureBuffer is off)
+    std::vector<float> m_Buffer;
+  };
+
+  typedef std::vector<TileKey>                            TileKeyVectorType;
+  typedef std::vector<TileData>                           TileDataVectorType;
+
+  /** Set the image file. Pending and produced tiles are discarded. */
+  void SetFileName(const std::string & filename);
+  std::string GetFileName() const;
+
+  /** Set/Get the number of worker threads (at least 1). Running
+   *  workers are stopped, and new ones are spawned on the next
+   *  request. */
+  void SetNumberOfWorkers(unsigned int nbWorkers);
+  itkGetConstMacro(NumberOfWorkers, unsigned int);
+
+  /** Set/Get the bound of the number of queued and in progress tiles
+   *  used to limit prefetching */
+  itkSetMacro(MaximumNumberOfPendingTiles, unsigned int);
+  itkGetConstMacro(MaximumNumberOfPendingTiles, unsigned int);
+
+  /** Set/Get whether the BGRA texture buffer of the tiles is computed
+   *  (default is on) */
+  itkSetMacro(ProduceTextureBuffer, bool);
+  itkGetConstMacro(ProduceTextureBuffer, bool);
+  itkBooleanMacro(ProduceTextureBuffer);
+
+  /** Replace the wanted tiles. Tiles in progress or already produced
+   *  are not queued again. */
+  void Request(const TileKeyVectorType & visible, const TileKeyVectorType & prefetch);
+
+  /** Move the produced tiles at the end of tiles, and return their
+   *  number */
+  unsigned int GetProducedTiles(TileDataVectorType & tiles);
+
+  /** Number of queued and in progress tiles */
+  unsigned int GetNumberOfPendingTiles() const;
+
+  /** Number of produced tiles not retrieved yet */
+  unsigned int GetNumberOfProducedTiles() const;
+
+  /** Is the tile queued or in progress ? */
+  bool IsPending(const TileKey & key) const;
+
+  /** Block until there are no more queued or in progress tiles */
+  void WaitForPendingTiles();
+
+  /** Cancel queued and in progress tiles */
+  void CancelPendingTiles();
+
+  /** Stop the workers, after the tiles in progress */
+  void StopWorkers();
+
+  /** Read a tile with the given reader, which must be opened on the
+   *  resolution of the tile */
+  static void ProduceTile(ReaderType * reader, const TileKey & key,
+                          bool textureBuffer, TileData & tile);
+
+  /** Fill the BGRA texture buffer of a tile from its image */
+  static void ComputeTextureBuffer(TileData & tile);
+
+  /** Extended filename to read the given overview level of filename */
+  static std::string GetResolutionFileName(const std::string & filename,
+                                           unsigned int resolution);
+
+protected:
+  GlImageTileLoader();
+
+  ~GlImageTileLoader() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const ITK_OVERRIDE;
+
+private:
+  // prevent implementation
+  GlImageTileLoader(const Self&);
+  void operator=(const Self&);
+
+  /** A tile being read */
+  struct InProgressTile
+  {
+    TileKey m_Key;
+    unsigned long m_Generation;
+    bool m_Cancelled;
+  };
+
+  typedef std::deque<TileKey>                             TileKeyQueueType;
+  typedef std::vector<InProgressTile>                     InProgressVectorType;
+
+  /** Spawn the workers if needed (lock must be held) */
+  void StartWorkers();
+
+  /** Discard queued, in progress and produced tiles (lock must be
+   *  held) */
+  void ClearTiles();
+
+  /** Main loop of the workers */
+  void RunWorker();
+
+  static ITK_THREAD_RETURN_TYPE WorkerCallback(void * arg);
+
+  std::string m_FileName;
+
+  unsigned int m_NumberOfWorkers;
+  unsigned int m_MaximumNumberOfPendingTiles;
+  bool m_ProduceTextureBuffer;
+
+  TileKeyQueueType m_Queue;
+  InProgressVectorType m_InProgress;
+  TileDataVectorType m_Produced;
+
+  itk::MultiThreader::Pointer m_Threader;
+  std::vector<itk::ThreadIdType> m_WorkerIds;
+  bool m_Stop;
+
+  // Incremented when the tiles are cleared
+  unsigned long m_Generation;
+
+  mutable itk::SimpleMutexLock m_Lock;
+  itk::ConditionVariable::Pointer m_Condition;
+
+}; // End class GlImageTileLoader
+
+} // End namespace otb
+
+#endif
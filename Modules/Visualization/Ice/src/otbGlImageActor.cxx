@@ -54,7 +54,9 @@ GlImageActor::GlImageActor()
     m_ViewportForwardRotationTransform(RigidTransformType::New()),
     m_ViewportBackwardRotationTransform(RigidTransformType::New()),
     m_ResolutionAlgorithm(ResolutionAlgorithm::Nearest),
-    m_SoftwareRendering(false)
+    m_SoftwareRendering(false),
+    m_TileLoader(GlImageTileLoader::New()),
+    m_AsynchronousLoading(false)
 {}
 
 GlImageActor
@@ -140,6 +142,8 @@ void GlImageActor::Initialize(const std::string & filename)
 
   m_FileName = filename;
 
+  m_TileLoader->SetFileName(m_FileName);
+
   m_FileReader = ReaderType::New();
   m_FileReader->SetFileName(m_FileName);
   m_FileReader->GetOutput()->UpdateOutputInformation();
@@ -266,24 +270,32 @@ void GlImageActor::UpdateData()
   SizeType tileSize;
   tileSize.Fill(m_TileSize);
   Tile newTile;
+
+  // In asynchronous mode, the ring of tiles around the viewport is
+  // prefetched
+  const int ring = m_AsynchronousLoading ? 1 : 0;
+
+  GlImageTileLoader::TileKeyVectorType visibleKeys;
+  GlImageTileLoader::TileKeyVectorType prefetchKeys;
   
-   for(unsigned int i = 0; i < nbTilesX; ++i)
+   for(int i = -ring; i < static_cast<int>(nbTilesX) + ring; ++i)
     {
-    for(unsigned int j = 0; j<nbTilesY; ++j)
+    for(int j = -ring; j < static_cast<int>(nbTilesY) + ring; ++j)
       {
       
       newTile.m_TextureId = 0;
 
       IndexType tileIndex;
-      tileIndex[0] = static_cast<unsigned int>(tileStartX+i*m_TileSize);
-      tileIndex[1] = static_cast<unsigned int>(tileStartY+j*m_TileSize);
+      tileIndex[0] = static_cast<itk::IndexValueType>(tileStartX) + i*static_cast<itk::IndexValueType>(m_TileSize);
+      tileIndex[1] = static_cast<itk::IndexValueType>(tileStartY) + j*static_cast<itk::IndexValueType>(m_TileSize);
       
       newTile.m_ImageRegion.SetSize(tileSize);
       newTile.m_ImageRegion.SetIndex(tileIndex);
 
-      newTile.m_ImageRegion.Crop( largest );
-
-      ImageRegionToViewportQuad(newTile.m_ImageRegion,newTile.m_UL,newTile.m_UR,newTile.m_LL,newTile.m_LR,false);
+      if(!newTile.m_ImageRegion.Crop( largest ))
+        {
+        continue;
+        }
 
       newTile.m_RedIdx = m_RedIdx;
       newTile.m_GreenIdx = m_GreenIdx;
@@ -291,13 +303,51 @@ void GlImageActor::UpdateData()
       newTile.m_Resolution = m_CurrentResolution;
       newTile.m_TileSize = m_TileSize;
 
-      if(!TileAlreadyLoaded(newTile))
+      if(TileAlreadyLoaded(newTile))
+        {
+        continue;
+        }
+
+      if(m_AsynchronousLoading)
+        {
+        GlImageTileLoader::TileKey key;
+        key.m_ImageRegion = newTile.m_ImageRegion;
+        key.m_Resolution = newTile.m_Resolution;
+        key.m_RedIdx = newTile.m_RedIdx;
+        key.m_GreenIdx = newTile.m_GreenIdx;
+        key.m_BlueIdx = newTile.m_BlueIdx;
+
+        if(i >= 0 && j >= 0 && i < static_cast<int>(nbTilesX) && j < static_cast<int>(nbTilesY))
+          {
+          visibleKeys.push_back(key);
+          }
+        else
+          {
+          prefetchKeys.push_back(key);
+          }
+        }
+      else
         {
+        ImageRegionToViewportQuad(newTile.m_ImageRegion,newTile.m_UL,newTile.m_UR,newTile.m_LL,newTile.m_LR,false);
+
         LoadTile(newTile);
         }
       }
     }
 
+  if(m_AsynchronousLoading)
+    {
+    // Produced tiles are uploaded by Render()
+    m_TileLoader->SetProduceTextureBuffer(!m_SoftwareRendering);
+    m_TileLoader->Request(visibleKeys,prefetchKeys);
+    }
+}
+
+bool GlImageActor::HasPendingTiles() const
+{
+  return m_AsynchronousLoading
+    && (m_TileLoader->GetNumberOfPendingTiles() > 0
+        || m_TileLoader->GetNumberOfProducedTiles() > 0);
 }
 
 bool GlImageActor::TileAlreadyLoaded(const Tile& tile)
@@ -326,6 +376,11 @@ void GlImageActor::Render()
   //   << "\tpixel: " << m_SoftwareRendering << std::endl
   //   << "\ttile: " << m_TileSize << std::endl;
 
+  if( m_AsynchronousLoading )
+    {
+    UploadProducedTiles();
+    }
+
   if( !m_SoftwareRendering && !m_Shader.IsNull() )
     {
     // std::cout << "\tGLSL" << std::endl;
@@ -507,40 +562,33 @@ void GlImageActor::LoadTile(Tile& tile)
   //   << "]"
   //   << std::endl;
 
-  ExtractROIFilterType::Pointer extract = ExtractROIFilterType::New();
+  GlImageTileLoader::TileKey key;
+  key.m_ImageRegion = tile.m_ImageRegion;
+  key.m_Resolution = tile.m_Resolution;
+  key.m_RedIdx = tile.m_RedIdx;
+  key.m_GreenIdx = tile.m_GreenIdx;
+  key.m_BlueIdx = tile.m_BlueIdx;
 
-  extract->SetInput(m_FileReader->GetOutput());
-  extract->SetExtractionRegion(tile.m_ImageRegion);
-  extract->SetChannel(tile.m_RedIdx);
-  extract->SetChannel(tile.m_GreenIdx);
-  extract->SetChannel(tile.m_BlueIdx);
+  GlImageTileLoader::TileData data;
 
   // std::cout << "ExtractROIFilter::Update()...";
-  extract->Update();
+  GlImageTileLoader::ProduceTile(m_FileReader,key,!m_SoftwareRendering,data);
   // std::cout << "\tDONE\n";
 
-  tile.m_Image = extract->GetOutput();
+  UploadTile(tile,data);
+}
+
+void GlImageActor::UploadTile(Tile& tile, GlImageTileLoader::TileData& data)
+{
+  tile.m_Image = data.m_Image;
 
   if(!m_SoftwareRendering)
     {
-    itk::ImageRegionConstIterator<VectorImageType> it(extract->GetOutput(),extract->GetOutput()->GetLargestPossibleRegion());
-    
-    float * buffer = new float[4*extract->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels()];
-    
-    unsigned int idx = 0;
-    
-    for(it.GoToBegin();!it.IsAtEnd();++it)
+    if(data.m_Buffer.empty())
       {
-      buffer[idx] = static_cast<float>(it.Get()[2]);
-      ++idx;
-      buffer[idx] = static_cast<float>(it.Get()[1]);
-      ++idx;
-      buffer[idx] = static_cast<float>(it.Get()[0]);
-      ++idx;
-      buffer[idx] = 255.;
-      ++idx;
+      GlImageTileLoader::ComputeTextureBuffer(data);
       }
-    
+
     // Now load the texture
     assert( tile.m_TextureId==0 );
 
@@ -573,20 +621,51 @@ void GlImageActor::LoadTile(Tile& tile)
 // #endif
     glTexImage2D(
       GL_TEXTURE_2D, 0, GL_RGB32F,
-      extract->GetOutput()->GetLargestPossibleRegion().GetSize()[0],
-      extract->GetOutput()->GetLargestPossibleRegion().GetSize()[1], 
+      data.m_Image->GetLargestPossibleRegion().GetSize()[0],
+      data.m_Image->GetLargestPossibleRegion().GetSize()[1], 
       0, GL_BGRA, GL_FLOAT,
-      buffer);
+      &data.m_Buffer[0]);
     
     tile.m_Loaded = true;
-    
-    delete [] buffer;
     }
     
     // And push to loaded texture
     m_LoadedTiles.push_back(tile);
 }
   
+void GlImageActor::UploadProducedTiles()
+{
+  GlImageTileLoader::TileDataVectorType produced;
+
+  m_TileLoader->GetProducedTiles(produced);
+
+  for(GlImageTileLoader::TileDataVectorType::iterator it = produced.begin();
+      it != produced.end(); ++it)
+    {
+    Tile tile;
+    tile.m_ImageRegion = it->m_Key.m_ImageRegion;
+    tile.m_Resolution = it->m_Key.m_Resolution;
+    tile.m_RedIdx = it->m_Key.m_RedIdx;
+    tile.m_GreenIdx = it->m_Key.m_GreenIdx;
+    tile.m_BlueIdx = it->m_Key.m_BlueIdx;
+    tile.m_TileSize = m_TileSize;
+
+    // Skip tiles requested for a previous state of the actor
+    if(tile.m_Resolution != m_CurrentResolution
+       || tile.m_RedIdx != m_RedIdx
+       || tile.m_GreenIdx != m_GreenIdx
+       || tile.m_BlueIdx != m_BlueIdx
+       || TileAlreadyLoaded(tile))
+      {
+      continue;
+      }
+
+    ImageRegionToViewportQuad(tile.m_ImageRegion,tile.m_UL,tile.m_UR,tile.m_LL,tile.m_LR,false);
+
+    UploadTile(tile,*it);
+    }
+}
+  
 void GlImageActor::UnloadTile(Tile& tile)
 {
   // std::cout << std::hex << this << std::dec << "::UnloadTile()" << std::endl;
@@ -624,6 +703,12 @@ void GlImageActor::CleanLoadedTiles()
   
   this->ViewportExtentToImageRegion(ulx,uly,lrx,lry,requested);
 
+  // Keep the prefetched tiles around the viewport
+  if(m_AsynchronousLoading)
+    {
+    requested.PadByRadius(m_TileSize);
+    }
+
   for(TileVectorType::iterator it = m_LoadedTiles.begin();
   it!=m_LoadedTiles.end();++it)
     {
@@ -1039,15 +1124,7 @@ void GlImageActor::UpdateResolution()
     {
     m_CurrentResolution = newResolution;
     
-    std::ostringstream extFilename;
-    extFilename<<m_FileName;
-    if ( m_FileName.find('?') == std::string::npos )
-      {
-      extFilename << '?';
-      }
-    extFilename<<"&resol="<<m_CurrentResolution;
-
-    m_FileReader->SetFileName(extFilename.str());
+    m_FileReader->SetFileName(GlImageTileLoader::GetResolutionFileName(m_FileName,m_CurrentResolution));
     m_FileReader->GetOutput()->UpdateOutputInformation();
   // std::cout << "Switched to resolution: " << m_CurrentResolution <<
   // std::endl;
@@ -0,0 +1,487 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGlImageTileLoader.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "itkImageRegionConstIterator.h"
+
+#include "otbMacro.h"
+#include "otbMultiChannelExtractROI.h"
+
+namespace otb
+{
+
+namespace
+{
+typedef GlImageTileLoader::TileKey           TileKey;
+typedef GlImageTileLoader::TileData          TileData;
+typedef GlImageTileLoader::TileKeyVectorType TileKeyVectorType;
+
+bool Contains(const TileKeyVectorType & keys, const TileKey & key)
+{
+  return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+// Move a tile without copying its texture buffer
+void MoveTile(TileData & from, TileData & to)
+{
+  to.m_Key = from.m_Key;
+  to.m_Image = from.m_Image;
+  to.m_Buffer.swap(from.m_Buffer);
+  from.m_Image = GlImageTileLoader::VectorImageType::Pointer();
+}
+}
+
+GlImageTileLoader::GlImageTileLoader()
+  : m_FileName(),
+    m_NumberOfWorkers(2),
+    m_MaximumNumberOfPendingTiles(64),
+    m_ProduceTextureBuffer(true),
+    m_Queue(),
+    m_InProgress(),
+    m_Produced(),
+    m_Threader(itk::MultiThreader::New()),
+    m_WorkerIds(),
+    m_Stop(false),
+    m_Generation(0),
+    m_Condition(itk::ConditionVariable::New())
+{}
+
+GlImageTileLoader::~GlImageTileLoader()
+{
+  StopWorkers();
+}
+
+void GlImageTileLoader::SetFileName(const std::string & filename)
+{
+  m_Lock.Lock();
+  ClearTiles();
+  m_FileName = filename;
+  m_Lock.Unlock();
+
+  this->Modified();
+}
+
+std::string GlImageTileLoader::GetFileName() const
+{
+  m_Lock.Lock();
+  std::string filename = m_FileName;
+  m_Lock.Unlock();
+
+  return filename;
+}
+
+void GlImageTileLoader::SetNumberOfWorkers(unsigned int nbWorkers)
+{
+  nbWorkers = std::max(nbWorkers, 1U);
+
+  if(nbWorkers != m_NumberOfWorkers)
+    {
+    StopWorkers();
+    m_NumberOfWorkers = nbWorkers;
+    this->Modified();
+    }
+}
+
+void GlImageTileLoader::Request(const TileKeyVectorType & visible, const TileKeyVectorType & prefetch)
+{
+  m_Lock.Lock();
+
+  StartWorkers();
+
+  // Drop produced tiles which are not wanted anymore
+  TileDataVectorType produced;
+  for(TileDataVectorType::iterator it = m_Produced.begin();
+      it != m_Produced.end(); ++it)
+    {
+    if(Contains(visible, it->m_Key) || Contains(prefetch, it->m_Key))
+      {
+      produced.push_back(TileData());
+      MoveTile(*it, produced.back());
+      }
+    }
+  m_Produced.swap(produced);
+
+  // Tiles in progress are kept only if they are still wanted
+  unsigned int nbPending = 0;
+  for(InProgressVectorType::iterator it = m_InProgress.begin();
+      it != m_InProgress.end(); ++it)
+    {
+    it->m_Cancelled = it->m_Generation != m_Generation
+      || (!Contains(visible, it->m_Key) && !Contains(prefetch, it->m_Key));
+
+    if(!it->m_Cancelled)
+      {
+      ++nbPending;
+      }
+    }
+
+  // Then queue the remaining ones, visible tiles first
+  m_Queue.clear();
+
+  for(unsigned int pass = 0; pass < 2; ++pass)
+    {
+    const TileKeyVectorType & keys = pass == 0 ? visible : prefetch;
+
+    for(TileKeyVectorType::const_iterator it = keys.begin();
+        it != keys.end(); ++it)
+      {
+      if(pass == 1 && nbPending >= m_MaximumNumberOfPendingTiles)
+        {
+        break;
+        }
+
+      bool scheduled = std::find(m_Queue.begin(), m_Queue.end(), *it) != m_Queue.end();
+
+      for(InProgressVectorType::const_iterator ipIt = m_InProgress.begin();
+          !scheduled && ipIt != m_InProgress.end(); ++ipIt)
+        {
+        scheduled = !ipIt->m_Cancelled && ipIt->m_Key == *it;
+        }
+
+      for(TileDataVectorType::const_iterator pIt = m_Produced.begin();
+          !scheduled && pIt != m_Produced.end(); ++pIt)
+        {
+        scheduled = pIt->m_Key == *it;
+        }
+
+      if(!scheduled)
+        {
+        m_Queue.push_back(*it);
+        ++nbPending;
+        }
+      }
+    }
+
+  m_Lock.Unlock();
+
+  m_Condition->Broadcast();
+}
+
+unsigned int GlImageTileLoader::GetProducedTiles(TileDataVectorType & tiles)
+{
+  m_Lock.Lock();
+
+  const unsigned int nbTiles = m_Produced.size();
+
+  for(TileDataVectorType::iterator it = m_Produced.begin();
+      it != m_Produced.end(); ++it)
+    {
+    tiles.push_back(TileData());
+    MoveTile(*it, tiles.back());
+    }
+  m_Produced.clear();
+
+  m_Lock.Unlock();
+
+  return nbTiles;
+}
+
+unsigned int GlImageTileLoader::GetNumberOfPendingTiles() const
+{
+  m_Lock.Lock();
+
+  unsigned int nbPending = m_Queue.size();
+
+  for(InProgressVectorType::const_iterator it = m_InProgress.begin();
+      it != m_InProgress.end(); ++it)
+    {
+    if(!it->m_Cancelled)
+      {
+      ++nbPending;
+      }
+    }
+
+  m_Lock.Unlock();
+
+  return nbPending;
+}
+
+unsigned int GlImageTileLoader::GetNumberOfProducedTiles() const
+{
+  m_Lock.Lock();
+  const unsigned int nbProduced = m_Produced.size();
+  m_Lock.Unlock();
+
+  return nbProduced;
+}
+
+bool GlImageTileLoader::IsPending(const TileKey & key) const
+{
+  m_Lock.Lock();
+
+  bool pending = std::find(m_Queue.begin(), m_Queue.end(), key) != m_Queue.end();
+
+  for(InProgressVectorType::const_iterator it = m_InProgress.begin();
+      !pending && it != m_InProgress.end(); ++it)
+    {
+    pending = !it->m_Cancelled && it->m_Key == key;
+    }
+
+  m_Lock.Unlock();
+
+  return pending;
+}
+
+void GlImageTileLoader::WaitForPendingTiles()
+{
+  m_Lock.Lock();
+
+  if(!m_Queue.empty())
+    {
+    StartWorkers();
+    }
+
+  while(!m_Queue.empty() || !m_InProgress.empty())
+    {
+    m_Condition->Wait(&m_Lock);
+    }
+
+  m_Lock.Unlock();
+}
+
+void GlImageTileLoader::CancelPendingTiles()
+{
+  m_Lock.Lock();
+
+  m_Queue.clear();
+
+  for(InProgressVectorType::iterator it = m_InProgress.begin();
+      it != m_InProgress.end(); ++it)
+    {
+    it->m_Cancelled = true;
+    }
+
+  m_Lock.Unlock();
+}
+
+void GlImageTileLoader::StopWorkers()
+{
+  m_Lock.Lock();
+  m_Stop = true;
+  std::vector<itk::ThreadIdType> workerIds;
+  workerIds.swap(m_WorkerIds);
+  m_Lock.Unlock();
+
+  m_Condition->Broadcast();
+
+  // Wait for the tiles in progress
+  for(std::vector<itk::ThreadIdType>::const_iterator it = workerIds.begin();
+      it != workerIds.end(); ++it)
+    {
+    m_Threader->TerminateThread(*it);
+    }
+
+  m_Lock.Lock();
+  m_Stop = false;
+  m_Lock.Unlock();
+}
+
+void GlImageTileLoader::StartWorkers()
+{
+  if(!m_WorkerIds.empty())
+    {
+    return;
+    }
+
+  for(unsigned int i = 0; i < m_NumberOfWorkers; ++i)
+    {
+    m_WorkerIds.push_back(m_Threader->SpawnThread(WorkerCallback, this));
+    }
+}
+
+void GlImageTileLoader::ClearTiles()
+{
+  m_Queue.clear();
+  m_Produced.clear();
+
+  // Tiles in progress are from a previous generation and will be
+  // dropped by the workers
+  ++m_Generation;
+
+  for(InProgressVectorType::iterator it = m_InProgress.begin();
+      it != m_InProgress.end(); ++it)
+    {
+    it->m_Cancelled = true;
+    }
+}
+
+ITK_THREAD_RETURN_TYPE GlImageTileLoader::WorkerCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  Self * loader = static_cast<Self *>(info->UserData);
+
+  loader->RunWorker();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void GlImageTileLoader::RunWorker()
+{
+  ReaderType::Pointer reader;
+  std::string readerFileName;
+
+  m_Lock.Lock();
+
+  while(true)
+    {
+    while(!m_Stop && m_Queue.empty())
+      {
+      m_Condition->Wait(&m_Lock);
+      }
+
+    if(m_Stop)
+      {
+      break;
+      }
+
+    InProgressTile current;
+    current.m_Key = m_Queue.front();
+    current.m_Generation = m_Generation;
+    current.m_Cancelled = false;
+
+    m_Queue.pop_front();
+    m_InProgress.push_back(current);
+
+    const std::string filename = GetResolutionFileName(m_FileName, current.m_Key.m_Resolution);
+    const bool textureBuffer = m_ProduceTextureBuffer;
+
+    m_Lock.Unlock();
+
+    TileData tile;
+    bool success = true;
+
+    try
+      {
+      if(reader.IsNull())
+        {
+        reader = ReaderType::New();
+        }
+
+      if(filename != readerFileName)
+        {
+        reader->SetFileName(filename);
+        readerFileName = filename;
+        }
+
+      ProduceTile(reader, current.m_Key, textureBuffer, tile);
+      }
+    catch(itk::ExceptionObject & err)
+      {
+      otbMsgDevMacro(<< "Failed to load tile of " << filename << ": " << err);
+      success = false;
+      }
+
+    m_Lock.Lock();
+
+    for(InProgressVectorType::iterator it = m_InProgress.begin();
+        it != m_InProgress.end(); ++it)
+      {
+      if(it->m_Generation == current.m_Generation && it->m_Key == current.m_Key)
+        {
+        if(success && !it->m_Cancelled)
+          {
+          m_Produced.push_back(TileData());
+          MoveTile(tile, m_Produced.back());
+          }
+
+        m_InProgress.erase(it);
+        break;
+        }
+      }
+
+    // Wake up WaitForPendingTiles()
+    m_Condition->Broadcast();
+    }
+
+  m_Lock.Unlock();
+}
+
+void GlImageTileLoader::ProduceTile(ReaderType * reader, const TileKey & key,
+                                    bool textureBuffer, TileData & tile)
+{
+  typedef MultiChannelExtractROI<float,float> ExtractROIFilterType;
+
+  ExtractROIFilterType::Pointer extract = ExtractROIFilterType::New();
+
+  extract->SetInput(reader->GetOutput());
+  extract->SetExtractionRegion(key.m_ImageRegion);
+  extract->SetChannel(key.m_RedIdx);
+  extract->SetChannel(key.m_GreenIdx);
+  extract->SetChannel(key.m_BlueIdx);
+
+  extract->Update();
+
+  tile.m_Key = key;
+  tile.m_Image = extract->GetOutput();
+  tile.m_Image->DisconnectPipeline();
+  tile.m_Buffer.clear();
+
+  if(textureBuffer)
+    {
+    ComputeTextureBuffer(tile);
+    }
+}
+
+void GlImageTileLoader::ComputeTextureBuffer(TileData & tile)
+{
+  tile.m_Buffer.resize(4*tile.m_Image->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  itk::ImageRegionConstIterator<VectorImageType> it(tile.m_Image,tile.m_Image->GetLargestPossibleRegion());
+
+  unsigned int idx = 0;
+
+  for(it.GoToBegin();!it.IsAtEnd();++it)
+    {
+    const VectorImageType::PixelType & pixel = it.Get();
+    tile.m_Buffer[idx++] = static_cast<float>(pixel[2]);
+    tile.m_Buffer[idx++] = static_cast<float>(pixel[1]);
+    tile.m_Buffer[idx++] = static_cast<float>(pixel[0]);
+    tile.m_Buffer[idx++] = 255.;
+    }
+}
+
+std::string GlImageTileLoader::GetResolutionFileName(const std::string & filename,
+                                                     unsigned int resolution)
+{
+  std::ostringstream extFilename;
+  extFilename<<filename;
+  if ( filename.find('?') == std::string::npos )
+    {
+    extFilename << '?';
+    }
+  extFilename<<"&resol="<<resolution;
+
+  return extFilename.str();
+}
+
+void GlImageTileLoader::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "NumberOfWorkers: " << m_NumberOfWorkers << std::endl;
+  os << indent << "MaximumNumberOfPendingTiles: " << m_MaximumNumberOfPendingTiles << std::endl;
+  os << indent << "ProduceTextureBuffer: " << m_ProduceTextureBuffer << std::endl;
+}
+
+} // End namespace otb
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include "otbGlImageTileLoader.h"
+
+namespace
+{
+typedef otb::GlImageTileLoader LoaderType;
+
+LoaderType::TileKeyVectorType CreateKeys(const LoaderType::RegionType & largest,
+                                         unsigned int tileSize, unsigned int nbTiles,
+                                         unsigned int start)
+{
+  LoaderType::TileKeyVectorType keys;
+
+  for(unsigned int j = 0; j < nbTiles; ++j)
+    {
+    for(unsigned int i = 0; i < nbTiles; ++i)
+      {
+      LoaderType::TileKey key;
+      key.m_ImageRegion.SetIndex(0, (start + i) * tileSize);
+      key.m_ImageRegion.SetIndex(1, (start + j) * tileSize);
+      key.m_ImageRegion.SetSize(0, tileSize);
+      key.m_ImageRegion.SetSize(1, tileSize);
+      key.m_RedIdx = 3;
+      key.m_GreenIdx = 2;
+      key.m_BlueIdx = 1;
+
+      if(key.m_ImageRegion.Crop(largest))
+        {
+        keys.push_back(key);
+        }
+      }
+    }
+
+  return keys;
+}
+}
+
+int otbGlImageTileLoader(int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // This test checks the tiles produced in background against the
+  // synchronous production, the cancellation of the requests and the
+  // bound of the prefetching, without any display
+  LoaderType::ReaderType::Pointer reader = LoaderType::ReaderType::New();
+  reader->SetFileName(LoaderType::GetResolutionFileName(argv[1], 0));
+  reader->UpdateOutputInformation();
+
+  const LoaderType::RegionType largest = reader->GetOutput()->GetLargestPossibleRegion();
+  const unsigned int tileSize = 64;
+
+  LoaderType::Pointer loader = LoaderType::New();
+  loader->SetFileName(argv[1]);
+  loader->SetNumberOfWorkers(3);
+
+  bool ok = true;
+
+  // Production
+  LoaderType::TileKeyVectorType visible = CreateKeys(largest, tileSize, 2, 1);
+  LoaderType::TileKeyVectorType ring = CreateKeys(largest, tileSize, 4, 0);
+  LoaderType::TileKeyVectorType prefetch;
+
+  for(LoaderType::TileKeyVectorType::const_iterator it = ring.begin(); it != ring.end(); ++it)
+    {
+    if(std::find(visible.begin(), visible.end(), *it) == visible.end())
+      {
+      prefetch.push_back(*it);
+      }
+    }
+
+  loader->Request(visible, prefetch);
+  loader->WaitForPendingTiles();
+
+  // Tiles already produced are not queued again
+  loader->Request(visible, prefetch);
+
+  if(loader->GetNumberOfPendingTiles() != 0)
+    {
+    std::cerr << "Produced tiles should not be requested again" << std::endl;
+    ok = false;
+    }
+
+  LoaderType::TileDataVectorType tiles;
+  loader->GetProducedTiles(tiles);
+
+  if(tiles.size() != visible.size() + prefetch.size())
+    {
+    std::cerr << tiles.size() << " tiles produced instead of "
+              << visible.size() + prefetch.size() << std::endl;
+    ok = false;
+    }
+
+  for(LoaderType::TileDataVectorType::const_iterator it = tiles.begin(); it != tiles.end(); ++it)
+    {
+    LoaderType::TileData reference;
+    LoaderType::ProduceTile(reader, it->m_Key, true, reference);
+
+    if(it->m_Buffer != reference.m_Buffer)
+      {
+      std::cerr << "Tile " << it->m_Key.m_ImageRegion.GetIndex() << " differs from the synchronous one" << std::endl;
+      ok = false;
+      }
+    }
+
+  // Cancellation
+  loader->Request(visible, prefetch);
+  loader->Request(LoaderType::TileKeyVectorType(), LoaderType::TileKeyVectorType());
+  loader->WaitForPendingTiles();
+
+  tiles.clear();
+  if(loader->GetProducedTiles(tiles) != 0)
+    {
+    std::cerr << tiles.size() << " tiles produced after cancellation" << std::endl;
+    ok = false;
+    }
+
+  // Bounded prefetching
+  loader->SetMaximumNumberOfPendingTiles(visible.size() + 2);
+  loader->Request(visible, prefetch);
+  loader->WaitForPendingTiles();
+
+  tiles.clear();
+  if(loader->GetProducedTiles(tiles) != visible.size() + 2)
+    {
+    std::cerr << tiles.size() << " tiles produced with a bounded queue instead of "
+              << visible.size() + 2 << std::endl;
+    ok = false;
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
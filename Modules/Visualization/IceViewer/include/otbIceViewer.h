@@ -97,6 +97,9 @@ protected:
   // Update all shaders with current color and position
   void UpdateShaderColorAndPosition();
 
+  // Are image actors still loading tiles ?
+  bool HasPendingTiles();
+
 private:
   // Static callbacks
   static void static_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
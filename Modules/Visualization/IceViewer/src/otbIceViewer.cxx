@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include <otbImageMetadataInterfaceFactory.h>
+#include <itksys/SystemTools.hxx>
 
 #include "otbGlROIActor.h"
 #include "otbGlVectorActor.h"
@@ -98,6 +99,7 @@ void IceViewer::AddImage(const std::string & fname, const std::string & key, con
 					     glslVersion ) )
     actor->CreateShader();
 
+  actor->AsynchronousLoadingOn();
   actor->Initialize(fname);
   actor->SetVisible(true);
 
@@ -365,11 +367,38 @@ void IceViewer::Start()
 
     // Swap buffers
     glfwSwapBuffers(m_Window);
-     
-    glfwWaitEvents();
+
+    // Keep on rendering while tiles are loaded in background
+    if(this->HasPendingTiles())
+      {
+      itksys::SystemTools::Delay(10);
+      glfwPollEvents();
+      }
+    else
+      {
+      glfwWaitEvents();
+      }
     }
 }
 
+bool IceViewer::HasPendingTiles()
+{
+  std::vector<std::string> renderingOrder = m_View->GetRenderingOrder();
+
+  for(std::vector<std::string>::iterator it = renderingOrder.begin();
+      it!=renderingOrder.end();++it)
+    {
+    otb::GlImageActor::Pointer currentActor = dynamic_cast<otb::GlImageActor*>(m_View->GetActor(*it).GetPointer());
+
+    if(currentActor.IsNotNull() && currentActor->GetVisible() && currentActor->HasPendingTiles())
+      {
+      return true;
+      }
+    }
+
+  return false;
+}
+
 void IceViewer::DrawHud()
 {
   double posx, posy, vpx, vpy,hudposx,hudposy,hudvpx,hudvpy;
@@ -42,6 +42,8 @@
 
 #include "otbMacro.h"
 #include "otbWrapperTypes.h"
+#include "otbConfigurationManager.h"
+#include "otbPipelineProfiler.h"
 #include <exception>
 #include "itkMacro.h"
 
@@ -495,6 +497,23 @@ int Application::ExecuteAndWriteOutput()
   this->AfterExecuteAndWriteOutputs();
 
   m_Chrono.Stop();
+
+  // Export the profiling report
+  PipelineProfiler & profiler = PipelineProfiler::GetInstance();
+  if (profiler.IsEnabled())
+    {
+    const std::string profilingFile = ConfigurationManager::GetProfilingFile();
+    if (profiler.Write(profilingFile, ConfigurationManager::GetProfilingFormat()))
+      {
+      otbAppLogINFO("Profiling report written to " << profilingFile);
+      }
+    else
+      {
+      otbAppLogWARNING("Could not write the profiling report to " << profilingFile);
+      }
+    profiler.Clear();
+    }
+
   return status;
 }
 
@@ -1658,6 +1677,9 @@ Application::AddProcess(itk::ProcessObject* object, std::string description)
   m_ProgressSource = object;
   m_ProgressSourceDescription = description;
 
+  // Profile the process and its upstream pipeline
+  PipelineProfiler::GetInstance().Watch(object);
+
   AddProcessToWatchEvent event;
   event.SetProcess(object);
   event.SetProcessDescription(description);